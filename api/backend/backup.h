@@ -0,0 +1,83 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::system_clock
+#include <condition_variable> // std::condition_variable
+#include <cstdint> // uint64_t
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#define BACKUP_DIR "backups" // Folder snapshots are written to, next to the database they're of
+#define BACKUP_INTERVAL_S 300 // How often a snapshot is taken, if anything was written since the last one
+#define BACKUP_KEEP_COUNT 24 // Snapshots kept of each database, the oldest is deleted once there are more
+#define BACKUP_STEP_PAGES 64 // Pages copied per backup step
+#define BACKUP_STEP_SLEEP_MS 2 // Pause between backup steps, so a snapshot never hogs the disk
+
+/**
+ * @struct BackupSnapshot
+ * @brief A snapshot written by the backup service.
+ *
+ * @param path  Path of the snapshot file.
+ * @param taken When the snapshot was taken.
+ * @param bytes Size of the snapshot file.
+ */
+struct BackupSnapshot {
+    std::string path;
+    std::chrono::system_clock::time_point taken;
+    uint64_t bytes;
+};
+
+/**
+ * @class BackupService
+ * @brief Takes rotating snapshots of the database while it's in use, and restores them.
+ *
+ * Snapshots are copied with the SQLite online backup API on a background thread, through a
+ * read-only connection of its own. The copy runs inside one read transaction, so the snapshot
+ * is the database as it was at a single point in time, and `BACKUP_STEP_PAGES` pages are
+ * copied at a time. In WAL mode a reader never holds a lock writers wait on, so data entry
+ * carries on at full speed while a snapshot is written.
+ *
+ * Every `BACKUP_INTERVAL_S` seconds a snapshot is taken if the database was written since the
+ * last one. Each is written to a temporary file and renamed into place once complete, so a
+ * snapshot in `BACKUP_DIR` is never half written. Only the newest `BACKUP_KEEP_COUNT` are kept.
+ */
+class BackupService {
+public:
+    BackupService(MainFrame* mainFrame, DataBase* db);
+    ~BackupService();
+
+    void Start(); // take snapshots every BACKUP_INTERVAL_S seconds in the background
+    void Stop();
+    inline bool IsRunning() const { return this->m_running; }
+
+    bool TakeSnapshot(std::string& path); // blocks until written, path is set to the snapshot's file
+    std::vector<BackupSnapshot> GetSnapshots(); // every snapshot of the database, newest first
+    bool RestoreSnapshot(const std::string& path); // UI thread only, snapshots the database as it is first
+private:
+    void RunSchedule(); // loop of the background thread
+    std::string NewSnapshotPath() const; // path of a snapshot taken now
+    bool WriteSnapshot(const std::string& path); // copy the database to 'path' in steps
+    void RemoveOldSnapshots();
+    std::string SnapshotFolder() const;
+    std::string SnapshotPrefix() const; // file name every snapshot of the database starts with
+
+    MainFrame* m_mainFrame;
+    DataBase* m_db;
+
+    std::thread m_thread;
+    std::mutex m_scheduleMutex; // guards waking the schedule
+    std::condition_variable m_wake;
+    std::mutex m_snapshotMutex; // one snapshot is written at a time
+    std::atomic<bool> m_running = false;
+    std::atomic<bool> m_stopping = false;
+    uint64_t m_snapshotVersion = 0; // data version of the database the last snapshot was taken at
+    bool m_hasSnapshot = false; // a snapshot was taken since the service started
+};
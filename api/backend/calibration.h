@@ -0,0 +1,60 @@
+#pragma once
+
+// ML
+#include <cereal/types/vector.hpp> // serializing std::vector
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <vector> // std::vector
+
+#define CALIBRATION_PLATT_ITERATIONS 100 // Most Newton steps taken fitting the Platt sigmoid
+#define CALIBRATION_MIN_POINTS 10 // Fewest held out predictions a calibration is fitted from
+
+/**
+ * @brief How raw vote fractions are mapped to probabilities.
+ */
+enum CalibrationMethod {
+    kCalibrationNone = 0, // use the fraction of trees voting for a red win as is
+    kCalibrationPlatt, // fit a sigmoid to the vote fraction, smooth but can't bend
+    kCalibrationIsotonic, // fit a non-decreasing curve, follows the data closely given enough of it
+};
+
+/**
+ * @class Calibrator
+ * @brief Maps the vote fraction of a forest to a calibrated probability.
+ *
+ * A forest's vote fractions are rarely the true chances of winning: with few trees and small
+ * leaves they bunch up near 0 and 1. The calibrator is fitted on predictions of matches the
+ * forest wasn't trained on, both as a Platt sigmoid and as an isotonic regression, so either
+ * can be applied without fitting again.
+ *
+ * The isotonic fit uses pool adjacent violators, keeping the mean vote fraction and observed
+ * win rate of each pooled block, and interpolates linearly between blocks.
+ */
+class Calibrator {
+public:
+    bool Fit(const std::vector<double>& scores, const std::vector<size_t>& labels); // false if there isn't enough data, leaving it uncalibrated
+    double Apply(double score, CalibrationMethod method) const; // calibrated chance of class 1 given a vote fraction
+    inline bool IsFitted() const { return this->m_fitted; }
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t version) {
+        ar(CEREAL_NVP(m_fitted));
+        ar(CEREAL_NVP(m_plattA));
+        ar(CEREAL_NVP(m_plattB));
+        ar(CEREAL_NVP(m_isotonicScores));
+        ar(CEREAL_NVP(m_isotonicValues));
+    }
+private:
+    void FitPlatt(const std::vector<double>& scores, const std::vector<size_t>& labels);
+    void FitIsotonic(const std::vector<double>& scores, const std::vector<size_t>& labels);
+
+    bool m_fitted = false;
+
+    // P(class 1) = 1 / (1 + exp(A * score + B))
+    double m_plattA = 0.0;
+    double m_plattB = 0.0;
+
+    std::vector<double> m_isotonicScores; // mean score of each block, increasing
+    std::vector<double> m_isotonicValues; // observed rate of class 1 in each block, non-decreasing
+};
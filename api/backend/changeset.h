@@ -0,0 +1,122 @@
+#pragma once
+
+// Backend
+#include "backend/team.h"
+#include "backend/match.h"
+
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint64_t
+#include <string> // std::string
+#include <vector> // std::vector
+
+#define CHANGESET_MAGIC 0x53435246u // "FRCS" read as little endian, marks an encoded changeset
+#define CHANGESET_VERSION 1 // Bumped whenever the encoding changes
+
+/**
+ * @brief What a change does to the row it names.
+ */
+enum ChangeKind : uint8_t {
+    kChangeTeamUpsert = 1, // a scouted row was added or changed, and holds these values now
+    kChangeTeamDelete, // a scouted row was removed
+    kChangeMatchUpsert, // a match was added or changed, and holds these values now
+    kChangeMatchDelete, // a match was removed
+};
+
+/**
+ * @struct ChangeRecord
+ * @brief The state of one row after it changed.
+ *
+ * Scouted rows are named by team number, match number and scout, since every station gives
+ * its rows different uids. Matches are named by match number.
+ *
+ * @param kind   What happened to the row.
+ * @param team   Team number, match number and values of a scouted row. Unused for matches.
+ * @param scout  Station or scout that entered a scouted row. Never empty in a changeset.
+ * @param match  Match number, result and teams of a match. Unused for scouted rows.
+ */
+struct ChangeRecord {
+    ChangeKind kind = kChangeTeamUpsert;
+    Team team = {};
+    std::string scout = "";
+    Match match = {};
+};
+
+/**
+ * @struct Changeset
+ * @brief Every row a station changed between two points in its change log.
+ *
+ * Rows are recorded as they are now rather than as the edits that led there, so a row
+ * changed many times is sent once, and applying the same changeset twice changes nothing
+ * the second time.
+ *
+ * Encoded as a header followed by one record per row, with integers as LEB128 varints,
+ * so a typical scouted row takes around 20 bytes.
+ *
+ * @param origin   Station the changes were collected on.
+ * @param fromSeq  Changes logged after this entry of the origin's change log...
+ * @param toSeq    ...up to and including this one.
+ * @param records  The rows that changed.
+ */
+struct Changeset {
+    std::string origin = "";
+    uint64_t fromSeq = 0;
+    uint64_t toSeq = 0;
+    std::vector<ChangeRecord> records = {};
+
+    std::vector<uint8_t> Encode() const;
+    static bool Decode(const uint8_t* data, size_t size, Changeset& changeset); // false if the data isn't a whole changeset of this version
+};
+
+/**
+ * @struct SyncReport
+ * @brief What a sync moved between two stations.
+ *
+ * @param sent      Rows sent to the other station.
+ * @param received  Rows received from the other station.
+ * @param applied   Received rows that changed something here, the rest were already up to date.
+ */
+struct SyncReport {
+    size_t sent = 0;
+    size_t received = 0;
+    size_t applied = 0;
+};
+
+/**
+ * @class ByteWriter
+ * @brief Appends varints and strings to a byte buffer.
+ */
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& bytes);
+
+    void WriteByte(uint8_t value);
+    void WriteVarint(uint64_t value);
+    void WriteSigned(int64_t value); // zigzag encoded, so small negative numbers stay small
+    void WriteString(const std::string& value);
+    void WriteBytes(const std::vector<uint8_t>& value);
+private:
+    std::vector<uint8_t>& m_bytes;
+};
+
+/**
+ * @class ByteReader
+ * @brief Reads what a `ByteWriter` wrote, failing instead of reading past the end.
+ */
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size);
+
+    bool ReadByte(uint8_t& value);
+    bool ReadVarint(uint64_t& value);
+    bool ReadSigned(int64_t& value);
+    bool ReadString(std::string& value);
+    inline const uint8_t* Position() const { return this->m_data + this->m_offset; }
+    inline size_t Remaining() const { return this->m_size - this->m_offset; }
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+void WriteChangeRecord(ByteWriter& writer, const ChangeRecord& record);
+bool ReadChangeRecord(ByteReader& reader, ChangeRecord& record); // false if the data ends mid record or holds an unknown kind
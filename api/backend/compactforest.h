@@ -0,0 +1,84 @@
+#pragma once
+
+// ML
+#include <mlpack/core.hpp>
+
+// Backend
+#include "backend/forest.h"
+
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <memory> // std::shared_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+#define COMPACT_FOREST_MAGIC 0x43465243u // "CRFC" read as little endian, marks a compact forest file
+#define COMPACT_FOREST_VERSION 1 // Bumped whenever the file layout changes
+
+/**
+ * @struct CompactParity
+ * @brief How closely a compact forest follows the forest it was built from on a set of points.
+ *
+ * @param agreement           Fraction of points both forests predict the same class for.
+ * @param fullAccuracy        Fraction of points the full forest predicts correctly.
+ * @param compactAccuracy     Fraction of points the compact forest predicts correctly.
+ * @param maxVoteDifference   Largest difference in the fraction of votes for any class of any point.
+ */
+struct CompactParity {
+    double agreement = 0.0;
+    double fullAccuracy = 0.0;
+    double compactAccuracy = 0.0;
+    double maxVoteDifference = 0.0;
+};
+
+/**
+ * @class CompactForest
+ * @brief A read only copy of a `Forest` small enough for low memory laptops.
+ *
+ * An mlpack tree keeps a heap allocated node per split, each holding its class probabilities,
+ * split information and child pointers, and loading one goes through cereal's XML archive.
+ * Here every tree is flattened into one array of nodes in depth first order, so a node's left
+ * child is the node after it and only the offset to its right child is stored:
+ *
+ * - thresholds are quantized to `Level` (8 or 16 bits) on a per feature grid spanning the
+ *   range of the training data, and points are quantized once before walking the trees
+ * - split features are a byte, and a leaf stores the class it votes for in the same byte
+ * - the file is the raw arrays, read straight back into memory
+ *
+ * A threshold is found by searching the grid for the first level the mlpack node sends right,
+ * so the compact forest only disagrees with the full one for values within one grid step of a
+ * split. `CheckParity` measures how often that changes a prediction.
+ */
+template<typename Level>
+class CompactForest {
+public:
+    static std::shared_ptr<CompactForest> Build(const Forest& forest, const arma::mat& features); // quantization grid spans 'features', nullptr if the forest can't be packed
+    static std::shared_ptr<CompactForest> Load(const std::string& path); // nullptr if the file isn't a compact forest with this Level
+    bool Save(const std::string& path) const;
+
+    void Classify(const arma::mat& points, arma::Row<size_t>& predictions, arma::mat& probabilities) const; // one column of vote fractions per point, same as Forest
+    CompactParity CheckParity(const Forest& forest, const arma::mat& points, const arma::Row<size_t>& labels) const;
+
+    inline size_t TreeCount() const { return this->m_roots.size(); }
+    size_t MemoryBytes() const; // bytes taken by the model's arrays
+private:
+    // A split, or a leaf if 'right' is 0
+    struct Node {
+        uint16_t right; // offset from this node to its right child, its left child is the next node
+        Level threshold; // points whose quantized value is at least this go right
+        uint8_t feature; // feature split on, or the class voted for by a leaf
+    };
+
+    bool AppendTree(const Forest::Tree& node, size_t featureCount); // false if the tree is too large to pack
+    Level FindThreshold(const Forest::Tree& node, size_t feature, size_t featureCount) const;
+    double LevelValue(size_t feature, size_t level) const; // lowest value quantized to 'level'
+    Level Quantize(size_t feature, double value) const;
+
+    uint32_t m_numClasses = 0;
+    std::vector<double> m_offsets; // lowest training value of each feature
+    std::vector<double> m_scales; // grid levels per unit of each feature, 0 for a constant feature
+    std::vector<uint32_t> m_roots; // index of each tree's root node
+    std::vector<Node> m_nodes; // every tree, one after the other
+};
+
+using CompactForest8 = CompactForest<uint8_t>;
+using CompactForest16 = CompactForest<uint16_t>;
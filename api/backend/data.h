@@ -5,13 +5,75 @@
 
 #include <team.h>    // Team struct definition
 #include <match.h>   // Match struct definition
+#include <changeset.h> // Changeset, SyncReport
+#include <dataevents.h> // DataEventBus, DataEventBatch
+#include <listquery.h> // ListQuery, RangeFilter
 #include <sqlite3.h> // sqlite3_prepare_v2, sqlite3_exec, sqlite3_column_int, sqlite3_bind_int...
+#include <array>     // std::array
+#include <atomic>    // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstdint>   // uint64_t
+#include <mutex>     // std::mutex
+#include <optional>  // std::optional
+#include <thread>    // std::thread::id
 #include <vector>    // std::vector
 #include <string>    // std::string
 
 #define DB_PATH     "data.db" // Path to connect and save database file
 #define TEAM_TABLE  "Teams"   // Name of the Teams table to save Team info in
 #define MATCH_TABLE "Matches" // Name of the Matches table to save Match info in
+#define RATING_TABLE "Ratings" // Name of the Ratings table to save each team's rating history in
+#define CHANGE_TABLE "Changes" // Name of the table every write to Teams and Matches is logged in, for syncing
+#define SYNC_TABLE "SyncState" // Name of the table holding this station's name and how far it has synced with each peer
+#define UID_TABLE "UidSequence" // Name of the table holding this station's uid prefix and the next uid it hands out
+#define EVENT_INFO_TABLE "EventInfo" // Name of the table holding the key of the event the database is scouting
+
+#define UID_SEQUENCE_BITS 23 // A uid is the station's prefix (1-254) followed by this many bits counting up, 8 million rows per station
+#define MERGE_SCHEMA "merge" // Prefix of the schema names databases being merged are attached as
+#define DB_READ_CONNECTIONS 4 // Read-only connections background threads read through while the UI writes
+#define DB_BUSY_TIMEOUT_MS 5000 // How long a connection waits on another holding a lock before failing
+
+/**
+ * @brief What a merge does with a row both databases have but that differs between them.
+ */
+enum MergeConflictPolicy {
+    kMergeKeepExisting = 0, // keep the row already in this database
+    kMergeTakeIncoming, // overwrite it with the row being merged in
+};
+
+/**
+ * @struct MergeReport
+ * @brief What merging databases into this one changed.
+ *
+ * @param databasesMerged  Databases merged without errors.
+ * @param teamsAdded       Scouted rows copied over.
+ * @param teamsSkipped     Scouted rows already here, unchanged.
+ * @param teamConflicts    Scouted rows here for the same team, match and scout but with different values.
+ * @param matchesAdded     Matches copied over.
+ * @param matchesUpdated   Matches here that took a result or teams from a merged one.
+ * @param matchConflicts   Matches here with a different result or team in the same station.
+ * @param failed           Databases that couldn't be merged, none of their rows were.
+ */
+struct MergeReport {
+    int databasesMerged = 0;
+    int teamsAdded = 0;
+    int teamsSkipped = 0;
+    int teamConflicts = 0;
+    int matchesAdded = 0;
+    int matchesUpdated = 0;
+    int matchConflicts = 0;
+    std::vector<std::string> failed = {};
+};
+
+/**
+ * @struct RatingRecord
+ * @brief A team's rating after a match, as stored in the Ratings table.
+ */
+struct RatingRecord {
+    int teamNum;
+    int matchNum;
+    double rating;
+};
 
 /**
  * @class DataBase
@@ -24,11 +86,43 @@
  * The class handles establishing a connection to the database, ensuring the required tables exist, and ensuring data
  * integrity through the various add/remove/update functions. 
  *
+ * The database is kept in WAL mode. Everything on the thread that created the DataBase (the UI thread) goes through
+ * one writer connection. Reads from any other thread go through a pool of `DB_READ_CONNECTIONS` read-only
+ * connections instead, so background exports and analysis run alongside data entry without waiting on it or seeing
+ * half of a write. A `ReadSnapshot` pins several reads to the same point in time.
+ *
+ * Every row the writer touches is reported to the change subscribers, whatever wrote it: an edit, an import, a merge
+ * or another station's changes. Writes are collected until the UI thread is idle again and delivered as one batch,
+ * so the UI updates exactly the rows that changed, once per batch.
+ *
  * @see Team
  * @see Match
  */
 class DataBase {
 public:
+    /**
+     * @class ReadSnapshot
+     * @brief Pins every read the current thread makes through a DataBase to one point in time.
+     *
+     * While it's alive, the thread's reads run on one read-only connection inside one read
+     * transaction, so they all see the database as it was when the first of them ran, however
+     * much is written meanwhile. Snapshots nest, an inner one shares the outer one's transaction.
+     */
+    class ReadSnapshot {
+    public:
+        explicit ReadSnapshot(DataBase* db);
+        ~ReadSnapshot();
+        ReadSnapshot(const ReadSnapshot&) = delete;
+        ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+    private:
+        friend class DataBase;
+
+        DataBase* m_db;
+        sqlite3* m_connection = nullptr;
+        ReadSnapshot* m_outer = nullptr; // snapshot the thread held before this one
+        bool m_owned = false; // this snapshot leased the connection and began the transaction
+    };
+
     explicit DataBase(const std::string& dbPath, MainFrame* mainFrame);
     ~DataBase();
 
@@ -39,16 +133,63 @@ public:
     void RemoveTeamFromMatch(int teamNum, int matchNum); // Remove a team with teamNum from teams of match with matchNum
     void RemoveTeam(int uid); // Remove a team with teamNum from SQL DB
     void RemoveMatch(int matchNum); // Remove a match with matchNum from SQL DB
+    void RemoveTeams(const std::vector<int>& uids); // Remove every scouted row with one of these uids, and their teams from every match
+    void RemoveMatches(const std::vector<int>& matchNums); // Remove every match with one of these match numbers
     void UpdateTeam(const Team& team); // Update a team with teamNum from SQL DB
     void UpdateMatch(const Match& match); // Update a match with matchNum from SQL DB 
     Team GetTeam(int uid); // Get a Team struct from SQL DB of teamNum
     Match GetMatch(int matchNum); // Get a Match struct from SQL DB of matchNum
     std::vector<Team> GetTeams();
     std::vector<Match> GetMatches();
+    std::vector<Team> GetTeamsInMatch(int matchNum); // Get every scouted Team row recorded for match with matchNum
+    std::array<Team, 6> GetMatchTeams(const Match& match); // Get the scouted Team row of the team in each station of match
+    std::vector<Team> GetTeamEntries(int teamNum); // Get every scouted Team row recorded for team with teamNum
+    std::vector<Match> GetMatchesWithTeam(int teamNum); // Get every match team with teamNum is scheduled in
     double GetTeamWinRate(int teamNum);
 
+    // List views
+    std::vector<int> QueryTeamRows(const ListQuery& query); // uids of the scouted rows 'query' keeps, in its order
+    std::vector<int> QueryMatchRows(const ListQuery& query); // match numbers of the matches 'query' keeps, in its order
+    std::vector<Team> GetTeams(const std::vector<int>& uids); // the scouted rows with these uids, in no particular order
+    std::vector<Match> GetMatches(const std::vector<int>& matchNums); // the matches with these numbers, in no particular order
+    std::vector<Team> GetTeamsInMatches(const std::vector<int>& matchNums); // every scouted row recorded for these matches, in no particular order
+
+    // Rating history
+    void AddRatingHistory(const std::vector<RatingRecord>& records); // save ratings teams had after a match
+    void RemoveRatingHistory(int fromMatchNum); // remove ratings from match fromMatchNum onwards
+    std::vector<RatingRecord> GetRatingHistory(); // all saved ratings ordered by match number
+
+    // Backups
+    inline const std::string& GetPath() const { return this->m_dbPath; } // path of the .db file
+    bool RestoreFrom(const std::string& path); // replace every row with those of the snapshot at 'path'
+
+    // Merging
+    void MergeDataBases(const std::vector<std::string>& paths, MergeConflictPolicy policy, MergeReport& report); // merge other scouts' databases into this one
+
+    // Syncing
+    inline const std::string& GetStationName() const { return this->m_stationName; } // name this database labels its own rows with when syncing
+    Changeset GetChangesSince(uint64_t seq, const std::string& peer = ""); // every row changed after change log entry 'seq', as it is now, leaving out what 'peer' sent
+    bool ApplyChangeset(const Changeset& changeset, SyncReport& report); // false if it couldn't be applied, leaving nothing applied
+    uint64_t GetSentSeq(const std::string& peer); // last change log entry sent to 'peer'
+    void SetSentSeq(const std::string& peer, uint64_t seq);
+    uint64_t GetReceivedSeq(const std::string& peer); // last entry of the change log of 'peer' applied here
+    void CompactChangeLog(); // drop change log entries a later entry of the same row replaces
+
+    // Events
+    inline const std::string& GetEventKey() const { return this->m_eventKey; } // event this database scouts, empty if it was never labeled
+    void SetEventKey(const std::string& eventKey); // label this database with the event it scouts, if it isn't already
+
     // Generate a unique ID for a new team that is not in use
-    int GetNextTeamUID(); 
+    int GetNextTeamUID();
+    int ReserveTeamUIDs(int count); // first of 'count' consecutive uids no other row will get, 0 if this station ran out
+
+    // Bumped by every write to the Teams or Matches table, so results calculated from them can tell they're stale
+    inline uint64_t GetDataVersion() const { return this->m_dataVersion; }
+
+    // Change events
+    inline size_t SubscribeToChanges(DataEventBus::Subscriber subscriber) { return this->m_events.Subscribe(std::move(subscriber)); } // returns an id to unsubscribe with
+    inline void UnsubscribeFromChanges(size_t id) { this->m_events.Unsubscribe(id); }
+    inline void FlushChanges() { this->m_events.Deliver(); } // deliver the rows committed so far now instead of once the UI is idle
 
     // Conditional/exists/item1 in item2
     bool TeamExistsUID(int uid);
@@ -72,12 +213,75 @@ private:
     void CreateTables(); // create all required and used SQL tables
     void NewTeamTable(); // create blank Team SQL table
     void NewMatchesTable(); // create blank Matches SQL Table
+    void NewRatingsTable(); // create blank Ratings SQL Table
+    void UpgradeTeamTable(); // add the columns and indexes newer versions need to an existing Team SQL table
+    void NewChangeLog(); // create the change log SQL table and the triggers that fill it
+    void NewSyncTable(); // create the sync state SQL table, naming this station if it hasn't been
+    void NewUidSequence(); // create the uid sequence SQL table, picking this station's uid prefix if it hasn't been
+    void NewEventInfoTable(); // create the event info SQL table, reading which event this database scouts
+    void NewDataEvents(); // create the triggers that report writes to the change subscribers
+    static void RecordDataEvent(sqlite3_context* context, int argc, sqlite3_value** argv); // data_event(table, key, op) SQL function
+    static int CommitDataEvents(void* db); // commit hook, the transaction's writes will be delivered
+    static void RollbackDataEvents(void* db); // rollback hook, the transaction's writes are dropped
+    void BeginSavepoint(const std::string& name);
+    void ReleaseSavepoint(const std::string& name); // keep the writes since savepoint 'name' and leave it
+    void RollbackSavepoint(const std::string& name); // undo the writes since savepoint 'name' and leave it
+    uint64_t GetSyncValue(const std::string& peer, const char* column);
+    bool ColumnExists(const std::string& schema, const std::string& tableName, const std::string& column);
+    template<size_t N>
+    std::vector<int> QueryListRows(const char* tableName, const char* key, const std::array<const char*, N>& columns, const std::string& searchCondition, const ListQuery& query);
+    std::string AttachedEventKey(const std::string& schema); // event an attached database scouts, empty if it was never labeled
+    std::string AttachedStationName(const std::string& schema); // name an attached database labels its own rows with, empty if it never synced
+    bool MergeAttached(const std::string& schema, const std::string& scout, MergeConflictPolicy policy, MergeReport& report);
+    int RunMergeStatement(const std::string& query, const std::string& scout, MergeConflictPolicy policy); // rows changed, or the first column of a SELECT, -1 on error
     void AddQueryToHistory(sqlite3_stmt* stmt);
     void AddQueryToHistory(std::string query);
-    
+
+    /**
+     * @class ReadScope
+     * @brief The connection a single read runs on.
+     *
+     * The thread's snapshot if it holds one, the writer on the UI thread so it sees its own
+     * writes, otherwise a snapshot of its own, so reads it makes in turn share its connection.
+     */
+    class ReadScope {
+    public:
+        explicit ReadScope(DataBase* db);
+        inline sqlite3* Handle() const { return this->m_handle; }
+    private:
+        std::optional<ReadSnapshot> m_snapshot = std::nullopt;
+        sqlite3* m_handle = nullptr;
+    };
+
+    sqlite3* AcquireReader(); // blocks until a read-only connection is free, nullptr if none could be opened
+    void ReleaseReader(sqlite3* reader);
+    void CloseReaders();
+    inline bool OnOwnerThread() const { return std::this_thread::get_id() == this->m_ownerThread; }
+
+    // run 'call' on the UI thread, straight away if already on it, for logging from reads on other threads
+    template<typename F>
+    void OnUiThread(F call) {
+        if ( OnOwnerThread() )
+            call();
+        else
+            m_mainFrame->CallAfter(call);
+    }
+
+    void LogErrorMessage(const std::string& message); // log from any thread
+    void LogBackendMessage(const std::string& message); // log from any thread
+
     sqlite3* m_db; // SQL database
     std::vector<std::string> m_queryHistory = {}; // list of SQL querys for debugging purposes
     const std::string m_dbPath; // Path to the .db file. Set when DataBase is constructed
-    bool m_connected; // If the database is connected
+    bool m_connected = false; // If the database is connected
+    std::atomic<uint64_t> m_dataVersion = 0; // Number of writes to the Teams and Matches tables
+    std::string m_stationName = ""; // this database's name when syncing, saved in the sync state table
+    std::string m_eventKey = ""; // event this database scouts, saved in the event info table
+    std::thread::id m_ownerThread = std::this_thread::get_id(); // thread the DataBase was created on, the only one writing
+    std::mutex m_readerMutex; // guards m_idleReaders and m_readerCount
+    std::condition_variable m_readerFree;
+    std::vector<sqlite3*> m_idleReaders = {}; // read-only connections not leased out
+    size_t m_readerCount = 0; // read-only connections opened, leased or not
     MainFrame* m_mainFrame; // connect backend to frontend
+    DataEventBus m_events{ [this] { m_mainFrame->CallAfter([this] { FlushChanges(); }); } }; // rows committed since the last delivery
 };
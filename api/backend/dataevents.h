@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint> // uint8_t
+#include <functional> // std::function
+#include <map> // std::map
+#include <string> // std::string
+#include <utility> // std::pair
+#include <vector> // std::vector
+
+/**
+ * @brief What happened to a row, once every write to it since the last batch is combined.
+ */
+enum DataOp : uint8_t {
+    kDataInserted = 0, // the row is new
+    kDataUpdated, // the row was there and still is, but may hold other values
+    kDataDeleted, // the row was there and is gone
+};
+
+/**
+ * @struct DataEvent
+ * @brief A row of the Teams or Matches table that changed.
+ *
+ * @param table  Table the row is in.
+ * @param key    uid of a scouted row, match number of a match.
+ * @param op     What happened to it.
+ */
+struct DataEvent {
+    std::string table = "";
+    int key = 0;
+    DataOp op = kDataUpdated;
+};
+
+/**
+ * @struct DataEventBatch
+ * @brief Every row that changed between two deliveries, each listed once, in the order they first changed.
+ */
+struct DataEventBatch {
+    std::vector<DataEvent> events = {};
+
+    inline bool Empty() const { return this->events.empty(); }
+};
+
+/**
+ * @class DataEventBus
+ * @brief Collects the rows a database's committed writes touch and hands them to subscribers in batches.
+ *
+ * Writes are recorded as they happen but held with the transaction they were made in, and only
+ * count once it's committed. Rolling back the transaction, or rolling back to a savepoint in it,
+ * drops what was written since, so subscribers never hear about rows that didn't change.
+ *
+ * Committed writes are combined with the earlier writes to the same row, so a row inserted and
+ * edited a hundred times before the next delivery arrives as one insert. The first commit after
+ * a delivery calls the scheduler, which arranges for `Deliver` to be called once the writes in
+ * progress are done.
+ *
+ * Not thread safe, records and deliveries happen on the thread writing to the database.
+ */
+class DataEventBus {
+public:
+    using Subscriber = std::function<void(const DataEventBatch&)>;
+
+    explicit DataEventBus(std::function<void()> scheduler);
+
+    void Record(const std::string& table, int key, DataOp op); // a write in the open transaction
+    void Commit(); // the open transaction was committed, its writes will be delivered
+    void Rollback(); // the open transaction was rolled back, its writes are dropped
+    void BeginSavepoint();
+    void ReleaseSavepoint(); // the writes since the innermost savepoint become part of the transaction around it
+    void RollbackSavepoint(); // drop the writes since the innermost savepoint, and the savepoint
+    void Deliver(); // hand what was committed to every subscriber, nothing if nothing was
+
+    size_t Subscribe(Subscriber subscriber); // returns an id to unsubscribe with
+    void Unsubscribe(size_t id);
+private:
+    using Key = std::pair<std::string, int>;
+
+    void Merge(const DataEvent& event); // combine a committed write with the earlier writes to its row
+
+    std::function<void()> m_scheduler;
+    std::vector<DataEvent> m_uncommitted = {}; // writes of the open transaction, in the order they were made
+    std::vector<size_t> m_savepoints = {}; // where in m_uncommitted each open savepoint began, innermost last
+    std::map<Key, DataOp> m_pending = {}; // each changed row and what happened to it so far
+    std::vector<Key> m_order = {}; // rows in the order they first changed, may hold rows dropped since
+    std::vector<std::pair<size_t, Subscriber>> m_subscribers = {};
+    size_t m_nextId = 1;
+    bool m_scheduled = false;
+};
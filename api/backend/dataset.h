@@ -0,0 +1,120 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/matchfeatures.h"
+#include "backend/threadpool.h"
+
+#include <json.hpp> // nlohmann::json_sax
+
+#include <array> // std::array
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+ * @struct EventMatch
+ * @brief A match read from a saved FRC API match results file.
+ *
+ * @param matchNum       Match number within its tournament level.
+ * @param startTime      When the match was played, ISO 8601. Empty if not given.
+ * @param teams          Team number in each station, red 1-3 then blue 1-3. 0 if the station is empty.
+ * @param redScore       Final score of the red alliance, -1 if the match hasn't been played.
+ * @param blueScore      Final score of the blue alliance, -1 if the match hasn't been played.
+ */
+struct EventMatch {
+    int matchNum = 0;
+    std::string startTime = "";
+    std::array<int, 6> teams = {};
+    int redScore = -1;
+    int blueScore = -1;
+
+    inline bool Played() const { return this->redScore >= 0 && this->blueScore >= 0; }
+    Match ToMatch() const; // the teams and result as the app stores them
+};
+
+/**
+ * @class MatchFileHandler
+ * @brief SAX handler collecting the matches of an FRC API `/matches` response.
+ *
+ * Only the fields of `EventMatch` are kept, so a file is read in one pass
+ * without building a DOM of the whole response.
+ */
+class MatchFileHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit MatchFileHandler(std::vector<EventMatch>& matches);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) override;
+
+    inline const std::string& GetError() const { return this->m_error; }
+private:
+    void SetNumber(int value); // store 'value' in the field named by the current key
+    int Depth() const; // containers open around the current value
+
+    std::vector<EventMatch>& m_matches;
+    EventMatch m_match; // match being read
+    int m_teamNum = 0; // team being read
+    std::string m_station = ""; // station of the team being read, e.g "Red1"
+    std::string m_key = ""; // key of the current value
+    std::vector<bool> m_containers; // open containers, true for arrays
+    bool m_inMatches = false; // inside the "Matches" array
+    bool m_inTeams = false; // inside the "teams" array of a match
+    std::string m_error = "";
+};
+
+/**
+ * @class DatasetBuilder
+ * @brief Builds the match predictor's training set from saved FRC API match results.
+ *
+ * Each file is one event, as saved by `scripts/match_details.py`. The matches of an event
+ * are replayed in the order they were played and every played match becomes one training
+ * point, with features calculated only from the matches played before it. Win rate and Elo
+ * are rolled forward match by match with the same code the app uses (`Match::AllianceResult`
+ * and `EloRating::ApplyMatch`), so no point sees its own result or any later one.
+ *
+ * Every other feature, OPR included, is calculated in the app from scouted points, which the
+ * FRC API doesn't have. They are left at zero, the same as for a team that hasn't been scouted,
+ * rather than filled from official scores that mean something else than at prediction time.
+ *
+ * Events are independent, so they are built in parallel on the thread pool and joined in
+ * the order they were given. The same files always give the same training set.
+ */
+class DatasetBuilder {
+public:
+    DatasetBuilder(MainFrame* mainFrame, ThreadPool* threadPool);
+
+    static bool LoadEventFile(const std::string& path, std::vector<EventMatch>& matches, std::string& error);
+    static void BuildEvent(
+        std::vector<EventMatch> matches,
+        std::vector<MatchFeatures>& features,
+        std::vector<size_t>& labels
+    ); // one point per decided match, labels are 1 for a red win and 0 for a blue win
+
+    bool Build(
+        const std::vector<std::string>& paths,
+        std::vector<MatchFeatures>& features,
+        std::vector<size_t>& labels
+    ); // false if no file could be read
+    static bool WriteTrainingSet(
+        const std::string& featuresPath,
+        const std::string& labelsPath,
+        const std::vector<MatchFeatures>& features,
+        const std::vector<size_t>& labels
+    );
+private:
+    MainFrame* m_mainFrame;
+    ThreadPool* m_threadPool;
+};
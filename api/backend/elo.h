@@ -0,0 +1,62 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+#define ELO_INITIAL_RATING 1500.0 // Rating every team starts the event with
+#define ELO_K_FACTOR       32.0   // Largest rating change a single match can cause
+#define ELO_SCALE          400.0  // Rating difference at which the stronger alliance is 10x as likely to win
+
+/**
+ * @class EloRating
+ * @brief Online Elo rating engine for teams, updated alliance by alliance.
+ *
+ * Played matches are processed in match number order. The rating of an alliance is the
+ * average rating of its teams, and after each match every team on an alliance moves by
+ * the same amount: `K * (actual - expected)`, where actual is 1 for a win, 0.5 for a tie
+ * and 0 for a loss. Processing a match is therefore O(teams in match).
+ *
+ * The update itself only needs a map of ratings, so `DatasetBuilder` replays exported
+ * events with `ApplyMatch` and gets the same ratings the app would.
+ *
+ * The rating every team had after each match is saved to the Ratings table, so ratings
+ * don't have to be recalculated when the app starts. If an earlier result is corrected,
+ * `ReplayFrom` rewinds every team to its rating before that match and processes the
+ * remaining matches again.
+ */
+class EloRating {
+public:
+    EloRating(MainFrame* mainFrame, DataBase* dataBase);
+
+    void UpdateMatch(int matchNum); // a result was entered, changed or removed for match with matchNum
+    void ReplayFrom(int matchNum); // recalculate every rating from match with matchNum onwards
+
+    double GetTeamRating(int teamNum) const; // current rating of 'teamNum'
+    std::vector<RatingRecord> GetTeamHistory(int teamNum) const; // rating of 'teamNum' after each match it played
+    double RedWinProbability(const Match& match) const; // expected score of the red alliance in 'match'
+    inline const std::unordered_map<int, double>& GetRatings() const { return this->m_ratings; }
+
+    static double RedWinProbability(const std::unordered_map<int, double>& ratings, const Match& match); // expected score of the red alliance with 'ratings'
+    static void ApplyMatch(std::unordered_map<int, double>& ratings, const Match& match); // move 'ratings' of the teams in a played match
+private:
+    void Load(); // restore ratings and history from the database
+    std::vector<RatingRecord> ProcessMatch(const Match& match); // update ratings with a played match
+    static double AllianceRating(
+        const std::unordered_map<int, double>& ratings,
+        const Match& match,
+        int firstSlot
+    ); // average rating of teams from 'firstSlot' to 'firstSlot + 2'
+
+    std::unordered_map<int, double> m_ratings; // team number -> current rating
+    std::unordered_map<int, std::vector<RatingRecord>> m_history; // team number -> rating after each match played
+    int m_lastMatchNum = 0; // highest match number processed
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+};
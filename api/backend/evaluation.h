@@ -0,0 +1,106 @@
+#pragma once
+
+// ML
+#include <mlpack/core.hpp>
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/forest.h"
+#include "backend/threadpool.h"
+
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <string> // std::string
+#include <vector> // std::vector
+
+#define EVAL_REPORT_PATH "./model/evaluation.txt" // Where the evaluation report is written
+#define EVAL_FOLD_COUNT 5 // Folds each set of parameters is cross-validated with
+#define EVAL_CALIBRATION_BINS 10 // Buckets predicted probabilities are grouped into to check calibration
+#define EVAL_PROBABILITY_CLIP 1e-3 // Vote fractions are clipped to [clip, 1 - clip] so log-loss stays finite
+#define EVAL_ACCURACY_TOLERANCE 1.0 // Percentage points of accuracy a smaller forest may give up to be recommended
+
+/**
+ * @struct CalibrationBin
+ * @brief Predictions whose red win probability fell in the same bucket.
+ *
+ * @param count             Number of predictions in the bucket.
+ * @param meanPredicted     Mean predicted chance of a red win.
+ * @param observedRedWins   Fraction of the predictions where red actually won.
+ */
+struct CalibrationBin {
+    size_t count;
+    double meanPredicted;
+    double observedRedWins;
+};
+
+/**
+ * @struct EvaluationResult
+ * @brief How a set of forest parameters did across every fold.
+ *
+ * @param params            The parameters evaluated.
+ * @param accuracy          Percent of held out matches predicted correctly.
+ * @param logLoss           Mean negative log likelihood of the actual outcome.
+ * @param calibrationError  Expected calibration error, the count weighted gap between predicted and observed.
+ * @param calibration       Predictions grouped by predicted red win probability.
+ * @param trainMs           Mean wall time to train the forest of one fold.
+ * @param inferenceUs       Mean time to predict one match.
+ */
+struct EvaluationResult {
+    ForestParams params;
+    double accuracy;
+    double logLoss;
+    double calibrationError;
+    std::array<CalibrationBin, EVAL_CALIBRATION_BINS> calibration;
+    double trainMs;
+    double inferenceUs;
+};
+
+/**
+ * @class ModelEvaluator
+ * @brief k-fold cross-validation and hyperparameter search for the match prediction forest.
+ *
+ * Every set of parameters is trained and tested once per fold on the same shuffled folds, so
+ * results can be compared directly. The folds of a set run one after another, and the trees
+ * of each fold are trained on the whole thread pool.
+ *
+ * The recommended parameters are the smallest, fastest forest whose accuracy is within
+ * `EVAL_ACCURACY_TOLERANCE` of the best.
+ */
+class ModelEvaluator {
+public:
+    ModelEvaluator(MainFrame* mainFrame, ThreadPool* threadPool);
+
+    static std::vector<ForestParams> FullGrid(); // every combination of the searched parameters
+    static std::vector<ForestParams> RandomGrid(size_t count, uint64_t seed); // 'count' random combinations
+
+    EvaluationResult CrossValidate(
+        const arma::mat& features,
+        const arma::Row<size_t>& labels,
+        const ForestParams& params,
+        size_t foldCount,
+        uint64_t seed
+    );
+
+    std::vector<EvaluationResult> Search(
+        const arma::mat& features,
+        const arma::Row<size_t>& labels,
+        const std::vector<ForestParams>& grid,
+        size_t foldCount,
+        uint64_t seed
+    ); // results sorted by accuracy, empty if cancelled
+
+    static size_t Recommend(const std::vector<EvaluationResult>& results); // index of the recommended result
+    static bool WriteReport(const std::string& path, const std::vector<EvaluationResult>& results, size_t matchCount);
+
+    bool TryBeginRun(); // mark a run as started, false if one is already running
+    void EndRun(); // mark the current run as finished
+    inline bool IsRunning() const { return this->m_running; }
+    inline void Cancel() { this->m_cancel = true; }
+private:
+    MainFrame* m_mainFrame;
+    ThreadPool* m_threadPool;
+    std::atomic<bool> m_running = false;
+    std::atomic<bool> m_cancel = false;
+};
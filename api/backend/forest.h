@@ -0,0 +1,108 @@
+#pragma once
+
+// ML
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <cereal/types/vector.hpp> // serializing std::vector
+
+// Backend
+#include "backend/threadpool.h"
+
+#include <atomic> // std::atomic
+#include <cstdint> // uint64_t
+#include <functional> // std::function
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+
+/**
+ * @struct ForestParams
+ * @brief Hyperparameters of a forest.
+ *
+ * @param treeCount    Number of trees to train.
+ * @param minLeafSize  Fewest training points a leaf may hold.
+ * @param maxDepth     Deepest a tree may grow, 0 for no limit.
+ */
+struct ForestParams {
+    size_t treeCount;
+    size_t minLeafSize;
+    size_t maxDepth;
+};
+
+/**
+ * @class Forest
+ * @brief A random forest whose trees are trained in parallel on a thread pool.
+ *
+ * `mlpack::RandomForest` trains every tree in one call, with no way to report how far along
+ * it is or to stop it. This forest trains each tree as its own thread pool task, so training can
+ * report progress after every tree and be cancelled between trees. Each tree's bootstrap sample
+ * and split dimensions are drawn from random streams seeded by the tree's index, so the same seed
+ * and data give the same forest whichever worker trains each tree. A trained forest is never modified,
+ * so it can be shared between threads and swapped out whole when a new one is trained.
+ *
+ * Trees are kept oldest first, so `WarmStart` can bring a forest up to date with new training
+ * data by retraining a few of its oldest trees instead of all of them.
+ */
+class Forest {
+public:
+    // Same tree RandomForest uses: Gini impurity, considering a random sqrt(d) dimensions per split
+    using Tree = mlpack::DecisionTree<
+        mlpack::GiniGain,
+        mlpack::BestBinaryNumericSplit,
+        mlpack::AllCategoricalSplit,
+        mlpack::MultipleRandomDimensionSelect
+    >;
+
+    using Progress = std::function<void(size_t treesDone, size_t treeCount)>;
+
+    static std::shared_ptr<Forest> Train(
+        const arma::mat& features,
+        const arma::Row<size_t>& labels,
+        const ForestParams& params,
+        ThreadPool* threadPool,
+        uint64_t seed,
+        const Progress& progress,
+        const std::atomic<bool>& cancel
+    ); // nullptr if cancelled
+
+    static std::shared_ptr<Forest> WarmStart(
+        const Forest& base,
+        const arma::mat& features,
+        const arma::Row<size_t>& labels,
+        const ForestParams& params,
+        size_t replaceCount,
+        ThreadPool* threadPool,
+        uint64_t seed,
+        const Progress& progress,
+        const std::atomic<bool>& cancel
+    ); // copy of 'base' with its oldest 'replaceCount' trees retrained, nullptr if cancelled
+
+    size_t Classify(const arma::vec& point) const; // majority vote of every tree
+    void Classify(const arma::vec& point, size_t& prediction, arma::vec& probabilities) const; // majority vote and fraction of votes for each class
+    void Classify(const arma::mat& points, arma::Row<size_t>& predictions) const;
+    void Classify(const arma::mat& points, arma::Row<size_t>& predictions, arma::mat& probabilities) const; // one column of vote fractions per point
+    inline size_t TreeCount() const { return this->m_trees.size(); }
+    inline size_t NumClasses() const { return this->m_numClasses; }
+    inline const std::vector<Tree>& Trees() const { return this->m_trees; } // oldest first
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t version) {
+        ar(CEREAL_NVP(m_numClasses));
+        ar(CEREAL_NVP(m_trees));
+    }
+private:
+    static bool TrainTrees(
+        const arma::mat& features,
+        const arma::Row<size_t>& labels,
+        size_t numClasses,
+        const ForestParams& params,
+        size_t treeCount,
+        ThreadPool* threadPool,
+        uint64_t seed,
+        const Progress& progress,
+        const std::atomic<bool>& cancel,
+        std::vector<Tree>& trees
+    ); // false if cancelled
+
+    size_t m_numClasses = 0;
+    std::vector<Tree> m_trees;
+};
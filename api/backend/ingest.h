@@ -0,0 +1,116 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+#include "backend/changeset.h"
+#include "backend/netsocket.h"
+#include "backend/uicall.h"
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstdint> // uint8_t, uint16_t
+#include <deque> // std::deque
+#include <future> // std::promise
+#include <list> // std::list
+#include <memory> // std::shared_ptr
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#define INGEST_PORT 7023 // Port scouting clients submit rows on
+#define INGEST_MAX_CLIENTS 32 // Most scouting clients connected at once, more are turned away
+#define INGEST_MAX_ROWS 256 // Most rows in one submission
+#define INGEST_MAX_FRAME ( 64 * 1024 ) // Largest submission accepted, in bytes
+#define INGEST_BATCH_WINDOW_MS 25 // How long the writer waits for other submissions to write along with the first
+#define INGEST_MAX_BATCH_ROWS 1024 // Most rows written in one transaction
+#define INGEST_TIMEOUT_MS 60000 // How long a client may stay idle before it's dropped
+
+/**
+ * @brief The frames a scouting client and the ingest server exchange.
+ *
+ * SUBMIT: the scout's name, a row count, then the rows, each encoded with `WriteChangeRecord`.
+ * ACK: 1 if the rows were saved, 0 if not, the number of rows, and why they weren't saved.
+ *
+ * A client can send any number of submissions on one connection, each answered by an ACK
+ * once its rows are saved.
+ */
+enum IngestFrame : uint8_t {
+    kIngestSubmit = 1,
+    kIngestAck,
+};
+
+/**
+ * @class IngestServer
+ * @brief Accepts scouted rows from many scouting clients at once and saves them in batches.
+ *
+ * Every client is served by its own thread, which reads and validates its submissions and
+ * queues them. A single writer thread takes whatever is queued, waiting a moment for other
+ * clients submitting at the same time, and saves it all in one transaction on the UI thread.
+ * Each client's submission is acknowledged once it's saved, and the UI is told which teams
+ * and matches changed once per batch.
+ *
+ * Rows are saved like rows applied from another station: scouted rows are named by team,
+ * match and scout, and a row submitted twice is only written once.
+ */
+class IngestServer {
+public:
+    IngestServer(MainFrame* mainFrame, DataBase* db);
+    ~IngestServer();
+
+    bool Start(uint16_t port, bool loopbackOnly);
+    void Stop(); // drop every client, failing submissions not saved yet
+    inline bool IsRunning() const { return this->m_running; }
+    inline uint16_t Port() const { return this->m_port; }
+
+    static bool ValidateRecord(const ChangeRecord& record, std::string& error); // false with the reason if the row can't be saved
+    static bool Submit(const Socket& connection, const std::string& scout, const std::vector<ChangeRecord>& records, std::string& error); // client side, blocks until acknowledged
+private:
+    /**
+     * @struct Client
+     * @brief A connected scouting client and the thread serving it.
+     */
+    struct Client {
+        Socket socket;
+        std::thread thread;
+        std::atomic<bool> done = false;
+    };
+
+    /**
+     * @struct Submission
+     * @brief Rows queued for the writer, and how the client hears whether they were saved.
+     */
+    struct Submission {
+        std::string scout;
+        std::vector<ChangeRecord> records;
+        std::promise<std::string> saved; // empty once saved, otherwise why they weren't
+    };
+
+    void AcceptClients(); // accept loop of the server thread
+    void ServeClient(Client* client);
+    std::string Enqueue(const std::string& scout, std::vector<ChangeRecord> records); // blocks until written, empty if saved
+    void WriteBatches(); // loop of the writer thread
+    std::vector<std::string> WriteBatch(const std::vector<std::shared_ptr<Submission>>& batch); // UI thread, one result per submission
+    void ReapClients(bool all); // join the threads of clients that left, or of every client
+
+    MainFrame* m_mainFrame;
+    DataBase* m_db;
+
+    Socket m_listener;
+    std::thread m_acceptThread;
+    std::thread m_writerThread;
+    std::mutex m_clientMutex; // guards m_clients
+    std::list<std::unique_ptr<Client>> m_clients = {};
+
+    std::mutex m_queueMutex; // guards m_queue and m_queuedRows
+    std::condition_variable m_queueReady;
+    std::deque<std::shared_ptr<Submission>> m_queue = {};
+    size_t m_queuedRows = 0;
+
+    std::atomic<bool> m_running = false;
+    std::atomic<bool> m_stopping = false;
+    uint16_t m_port = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+ * @struct RangeFilter
+ * @brief Only keeps list rows with a value in a column between two numbers, both included.
+ *
+ * @param column  Column of the list view, as added by `AddTeamListColumns` or `AddMatchListColumns`.
+ * @param min     Smallest value kept.
+ * @param max     Largest value kept.
+ */
+struct RangeFilter {
+    int column = 0;
+    int min = 0;
+    int max = 0;
+};
+
+/**
+ * @struct ListQuery
+ * @brief Which rows a list view shows, and in what order.
+ *
+ * @param sortColumn  Column of the list view the rows are sorted by.
+ * @param ascending   Sort smallest first.
+ * @param teamSearch  Digits typed in the search box, only rows with a team number starting with them are kept.
+ * @param ranges      Every filter a row has to pass.
+ */
+struct ListQuery {
+    int sortColumn = 0;
+    bool ascending = true;
+    std::string teamSearch = "";
+    std::vector<RangeFilter> ranges = {};
+};
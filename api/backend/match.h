@@ -1,6 +1,6 @@
 #pragma once
 
-#include "team.h" // Team
+#include <sqlite3.h> // sqlite3_stmt
 #include <array> // array
 #include <cstdint> // uint8_t
 
@@ -11,7 +11,10 @@
  * This struct holds information about a match, including the teams participating,
  * match results, and utility functions for match management.
  *
- * @param teams      Array of up to 6 teams competing in the match.
+ * Only the team numbers are kept, so a whole season of matches stays small to read
+ * and copy. The scouted rows of the teams are read from the database when needed.
+ *
+ * @param teams      Team number in each station, red 1-3 then blue 1-3. 0 if the station is empty.
  * @param teamCount  Number of teams in the match (should not exceed 6).
  * @param matchNum   Unique identifier for the match.
  * @param played     Indicates whether the match has been played.
@@ -22,18 +25,20 @@
  * @note If both `redWin` and `blueWin` are true, the match is considered a tie.
  *
  * @function IsTie()    Determines if the match resulted in a tie.
+ * @function IsPlayed() Determines if the match has a result yet.
  * @function RedWon()   Determines if the red alliance won the match.
  * @function BlueWon()  Determines if the blue alliance won the match.
+ * @function AllianceResult() Scores the result of the match for one alliance.
  *
  * @function FromSQLStatment()  Creates a `Match` object from an SQLite database statement.
  * @function TeamInMatch()      Checks if a given team number is part of the match.
  * @function AddCompetitor()    Adds a team to the match (if space allows).
  * @function RemoveCompetitor() Removes a team from the match.
  *
- * @function Team1() - Team6()  Access individual teams in the match.
+ * @function Team1() - Team6()  Access the team number in each station of the match.
  */
 struct Match {
-    std::array<Team, 6> teams = { 0 }; // teams facing each other
+    std::array<int, 6> teams = {}; // numbers of the teams facing each other
     uint8_t teamCount; // number of teams in the match
 
     int matchNum; // unique number or match index
@@ -45,17 +50,19 @@ struct Match {
     const bool RedWon() const; // Return true if red alliance won, otherwise false
     const bool BlueWon() const; // Return true if blue alliance won, otherwise false
     const bool IsTie() const; // Return true if both blueWin and redWin are true, meaning a tie happened
+    const bool IsPlayed() const; // Return true if either alliance won, meaning the match has a result
+    double AllianceResult(bool red) const; // Return 1 for a win, 0.5 for a tie and 0 for a loss of the red or blue alliance
 
     static Match FromSQLStatment(sqlite3_stmt* stmt); // New Match struct from SQL db
     bool TeamInMatch(int teamNum); // return true or false whether or not the team number is in 'teams'
-    void AddCompetitor(Team team); // Add a team to the match
+    void AddCompetitor(int teamNum); // Add a team to the match
     void RemoveCompetitor(int teamNum); // Remove a team from the match
     bool RedAllianceTeam(int teamNum) const; // Check if a team is on the red alliance
 
-    const Team& Team1() const; // return Team from self.teams[0]
-    const Team& Team2() const; // return Team from self.teams[1]
-    const Team& Team3() const; // return Team from self.teams[2]
-    const Team& Team4() const; // return Team from self.teams[3]
-    const Team& Team5() const; // return Team from self.teams[4]
-    const Team& Team6() const; // return Team from self.teams[5]
+    int Team1() const; // return team number from self.teams[0]
+    int Team2() const; // return team number from self.teams[1]
+    int Team3() const; // return team number from self.teams[2]
+    int Team4() const; // return team number from self.teams[3]
+    int Team5() const; // return team number from self.teams[4]
+    int Team6() const; // return team number from self.teams[5]
 };
@@ -0,0 +1,79 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+#include "backend/opr.h"
+#include "backend/elo.h"
+
+#include <array> // std::array
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+/**
+ * @brief Index of each feature describing a single team.
+ *
+ * The scouting averages are cached per team, the ratings are
+ * read from their engines, which keep them up to date already.
+ */
+enum TeamFeatureIds {
+    kFeatureWinRate = 0, // fraction of played matches won
+    kFeatureCoralPoints, // average coral points scouted
+    kFeatureAutonomousPoints, // average autonomous points scouted
+    kFeatureHangRate, // fraction of scouted matches with a successful hang
+    kFeaturePenaltys, // average penalties scouted
+    kFeatureOverall, // average overall rating scouted
+    kFeatureOPR,
+    kFeatureElo,
+
+    kTeamFeatureCount
+};
+
+#define MATCH_FEATURE_COUNT ( kTeamFeatureCount * 4 ) // sum and max of every team feature, for both alliances
+
+using TeamFeatures = std::array<double, kTeamFeatureCount>;
+using MatchFeatures = std::array<double, MATCH_FEATURE_COUNT>;
+
+/**
+ * @class FeaturePipeline
+ * @brief Turns matches into the feature vectors the match predictor is trained on and predicts with.
+ *
+ * Every team is described by `kTeamFeatureCount` features. An alliance is described by the sum
+ * and the max of each feature over its teams, so the vector doesn't depend on the order teams
+ * are listed in or on their team numbers. A match is the red alliance followed by the blue one:
+ *
+ *     [ red sums | red maxes | blue sums | blue maxes ]
+ *
+ * The scouting averages of a team take a few queries to calculate, so they are cached until
+ * `Invalidate` is called for the team, e.g when one of its rows or one of its matches is written.
+ *
+ * Prediction goes through `GetMatchFeatures`, which uses everything played so far. Training goes
+ * through `GetFeaturesBeforeMatches`, which calculates the same features as they were before each
+ * match, so the model never learns from features that already include the result it's predicting.
+ */
+class FeaturePipeline {
+public:
+    FeaturePipeline(MainFrame* mainFrame, DataBase* dataBase, OPRCalculator* opr, EloRating* elo);
+
+    MatchFeatures GetMatchFeatures(const Match& match); // feature vector of 'match'
+    std::vector<MatchFeatures> GetFeaturesBeforeMatches(const std::vector<Match>& matches); // feature vector of each match from earlier matches only, for training
+    TeamFeatures GetTeamFeatures(int teamNum); // features of 'teamNum'
+    static MatchFeatures CombineAlliances(
+        const std::array<int, 6>& teamNums,
+        const std::array<TeamFeatures, 6>& teams
+    ); // sums and maxes of each alliance, empty slots have team number 0
+
+    inline void Invalidate(int teamNum) { this->m_cache.erase(teamNum); } // recalculate 'teamNum' next time it is used
+    inline void InvalidateAll() { this->m_cache.clear(); } // recalculate every team next time it is used
+private:
+    TeamFeatures CalculateScoutingFeatures(int teamNum); // the cached part of a team's features
+
+    std::unordered_map<int, TeamFeatures> m_cache; // team number -> scouting features, ratings left at zero
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+    OPRCalculator* m_opr;
+    EloRating* m_elo;
+};
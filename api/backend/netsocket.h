@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint> // intptr_t, uint8_t, uint16_t
+#include <string> // std::string
+#include <vector> // std::vector
+
+#define SOCKET_MAX_FRAME ( 64 * 1024 * 1024 ) // Largest frame accepted from a peer, in bytes
+
+/**
+ * @class Socket
+ * @brief A blocking TCP socket, on Winsock or BSD sockets.
+ *
+ * Owns its handle and closes it when destroyed, so it can only be moved. Messages are sent
+ * as frames: a 4 byte little endian length followed by that many bytes. The platform headers
+ * are only included by the source file, so including this doesn't pull windows.h in ahead
+ * of wxWidgets.
+ */
+class Socket {
+public:
+    Socket() = default;
+    ~Socket();
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    static Socket Listen(uint16_t port, bool loopbackOnly); // port 0 picks a free port, invalid if it couldn't listen
+    static Socket Connect(const std::string& host, uint16_t port); // invalid if it couldn't connect
+    Socket Accept() const; // blocks until a peer connects, invalid once shut down
+
+    bool SendAll(const void* data, size_t size) const;
+    bool ReceiveAll(void* data, size_t size) const;
+    bool SendFrame(const std::vector<uint8_t>& payload) const;
+    bool ReceiveFrame(std::vector<uint8_t>& payload, size_t maxSize = SOCKET_MAX_FRAME) const; // false if the peer left or sent a frame over maxSize
+    void SetTimeout(int milliseconds) const; // how long a send or receive may block, 0 for no limit
+
+    uint16_t LocalPort() const; // port the socket is bound to
+    inline bool IsValid() const { return this->m_handle != kInvalidHandle; }
+    void Shutdown(); // wake any thread blocked on the socket, it then fails
+    void Close();
+private:
+    static constexpr intptr_t kInvalidHandle = -1;
+
+    explicit Socket(intptr_t handle);
+    static bool Startup(); // start Winsock once per process, nothing to do elsewhere
+
+    intptr_t m_handle = kInvalidHandle; // SOCKET on Windows, a file descriptor elsewhere
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <array> // std::array
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+// Ridge term added to the diagonal of the normal equations so
+// teams that have only played alongside the same partners
+// (or not at all yet) still give a solvable system
+#define OPR_RIDGE 1e-3
+
+/**
+ * @struct OPRResult
+ * @brief Power ratings calculated for a single team.
+ *
+ * @param opr            Offensive Power Rating. Points the team contributes to its alliance.
+ * @param dpr            Defensive Power Rating. Points the team's opponents score against it.
+ * @param ccwm           Calculated Contribution to Winning Margin (opr - dpr).
+ * @param matchesPlayed  Number of played matches the ratings were calculated from.
+ */
+struct OPRResult {
+    double opr;
+    double dpr;
+    double ccwm;
+    int matchesPlayed;
+};
+
+/**
+ * @class OPRCalculator
+ * @brief Calculates OPR, DPR and CCWM for every team from the matches in the database.
+ *
+ * Every played match contributes two alliance rows to a sparse design matrix `A`
+ * (one column per team, three ones per row) with the alliance score and the opposing
+ * alliance score as the right hand sides. Alliance scores are the points scouted for
+ * the teams on that alliance in that match.
+ *
+ * Rather than storing `A`, the calculator accumulates the normal equations `A^T A` and `A^T b`
+ * directly. A match only touches a 3x3 block of `A^T A`, so matches can be added, edited or
+ * removed in constant time before the system is re-solved with a Cholesky factorization.
+ *
+ * @see OPRResult
+ */
+class OPRCalculator {
+public:
+    OPRCalculator(MainFrame* mainFrame, DataBase* dataBase);
+
+    void Recompute(); // rebuild the ratings from every match in the database
+    void UpdateMatch(int matchNum); // fold a new or edited match into the ratings
+    void UpdateMatches(const std::vector<int>& matchNums); // fold several new or edited matches into the ratings, solving once
+    void RemoveMatch(int matchNum); // take a removed match out of the ratings
+
+    OPRResult GetTeamOPR(int teamNum) const; // ratings for 'teamNum', all zero if unknown
+    inline const std::unordered_map<int, OPRResult>& GetResults() const { return this->m_results; }
+
+    static std::vector<std::vector<double>> SolveNormalEquations(
+        const std::vector<std::vector<double>>& normal,
+        const std::vector<std::vector<double>>& rhs
+    ); // solve A^T A x = b with the ridge term for each right hand side
+private:
+    // One row of the design matrix
+    struct AllianceRow {
+        std::array<int, 3> teams; // team numbers on the alliance, 0 if the slot is empty
+        double score; // points scored by the alliance
+        double opponentScore; // points scored against the alliance
+    };
+
+    std::vector<AllianceRow> BuildAllianceRows(const Match& match, const std::vector<Team>& observations);
+    void AccumulateRows(const std::vector<AllianceRow>& rows, double sign); // add (sign = 1) or subtract (sign = -1) rows
+    size_t TeamIndex(int teamNum); // column of 'teamNum' in the design matrix, adding one if needed
+    void Solve(); // solve the normal equations and store the results
+
+    std::unordered_map<int, std::vector<AllianceRow>> m_matchRows; // rows each match contributed, so they can be subtracted again
+    std::unordered_map<int, size_t> m_teamIndex; // team number -> column
+    std::vector<int> m_teamNums; // column -> team number
+    std::vector<std::vector<double>> m_normal; // A^T A
+    std::vector<double> m_offense; // A^T b with alliance scores
+    std::vector<double> m_defense; // A^T b with opponent scores
+    std::unordered_map<int, OPRResult> m_results; // team number -> ratings
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <array> // std::array
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+#define WIN_RANKING_POINTS 3 // Ranking points earned for winning a qualification match
+#define TIE_RANKING_POINTS 1 // Ranking points earned for tying a qualification match
+
+/**
+ * @struct TeamStanding
+ * @brief Where a team stands in the qualification rankings.
+ *
+ * A team's ranking points in a match are the ranking points scouted for it, the average of
+ * its rows if more than one scout watched it. A played match nobody scouted it in gives the
+ * ranking points of the result, `WIN_RANKING_POINTS` or `TIE_RANKING_POINTS`.
+ *
+ * @param teamNum                  Team number of the team.
+ * @param rank                     Place in the rankings, 1 being first.
+ * @param played                   Matches with a result the team was in.
+ * @param remaining                Matches the team is scheduled in without a result yet.
+ * @param wins                     Wins, losses and ties of the team's alliance.
+ * @param totalRankingPoints       Ranking points earned over every played match.
+ * @param rankingScore             Average ranking points per played match, what the rankings are sorted by.
+ * @param averagePoints            First tie-breaker, average scouted points per scouted match.
+ * @param averageAutonomousPoints  Second tie-breaker, average scouted autonomous points per scouted match.
+ * @param averageBonusRankingPoints Average ranking points scouted above those of the result, per scouted match.
+ */
+struct TeamStanding {
+    int teamNum = 0;
+    int rank = 0;
+    int played = 0;
+    int remaining = 0;
+    int wins = 0;
+    int losses = 0;
+    int ties = 0;
+    int totalRankingPoints = 0;
+    double rankingScore = 0.0;
+    double averagePoints = 0.0;
+    double averageAutonomousPoints = 0.0;
+    double averageBonusRankingPoints = 0.0;
+};
+
+/**
+ * @class RankingTable
+ * @brief Qualification standings of every scheduled team, kept up to date as matches and scouted rows change.
+ *
+ * Teams are ranked by ranking score, then average scouted points, then average scouted autonomous
+ * points, then lowest team number, so the order never changes between runs.
+ *
+ * The table is built from every match and scouted row once when the app starts. After that it's
+ * told which rows changed by the database's change batches. Each match remembers what it added to
+ * each of its teams, so a changed match or row only takes that match out of its teams' totals and
+ * adds it back as it is now, reading just the matches it touched. The teams are then sorted again,
+ * which costs the number of teams, not the number of matches. Looking up a team's standing is a
+ * single hash lookup.
+ *
+ * Only used from the UI thread, where the change batches are delivered.
+ *
+ * @see TeamStanding
+ */
+class RankingTable {
+public:
+    RankingTable(MainFrame* mainFrame, DataBase* dataBase);
+
+    void Reload(); // rebuild the standings from every match and scouted row, after the whole database was replaced
+    bool ApplyChanges(const DataEventBatch& batch); // fold changed matches and scouted rows into the standings, true if they changed
+
+    TeamStanding GetStanding(int teamNum) const; // rank 0 if 'teamNum' isn't scheduled in any match
+    inline const std::vector<TeamStanding>& GetStandings() const { return this->m_standings; } // every scheduled team, first place first
+    std::vector<Match> GetRemainingMatches() const; // every scheduled match without a result, in match number order
+
+    static bool RanksAbove(const TeamStanding& a, const TeamStanding& b); // true if 'a' is ranked above 'b'
+private:
+    // What a match added to the totals of the team in one of its stations
+    struct StationResult {
+        int teamNum = 0;
+        bool played = false;
+        bool won = false;
+        bool tied = false;
+        int rankingPoints = 0;
+        int bonusRankingPoints = 0; // scouted ranking points above those of the result
+        bool scouted = false; // the team was scouted in the match, so it has points
+        double points = 0.0;
+        double autonomousPoints = 0.0;
+    };
+
+    // A scheduled match and what it added to each of its teams
+    struct MatchEntry {
+        Match match = {};
+        std::vector<StationResult> stations = {};
+    };
+
+    // Sums of what every match added to a team
+    struct TeamTotals {
+        int scheduled = 0;
+        int played = 0;
+        int wins = 0;
+        int losses = 0;
+        int ties = 0;
+        int rankingPoints = 0;
+        int bonusRankingPoints = 0;
+        int scoutedMatches = 0;
+        double points = 0.0;
+        double autonomousPoints = 0.0;
+    };
+
+    void AddMatch(const Match& match, const std::vector<Team>& rows); // 'rows' are the scouted rows of the match
+    void RemoveMatch(int matchNum);
+    void AddStation(const StationResult& station, int sign); // add (sign = 1) or subtract (sign = -1) a station's result
+    void Rank(); // sort the teams and give each its rank
+
+    std::unordered_map<int, MatchEntry> m_matches = {}; // match number -> match and what it added
+    std::unordered_map<int, int> m_rowMatches = {}; // uid -> match number of the scouted row
+    std::unordered_map<int, TeamTotals> m_totals = {}; // team number -> sums
+    std::vector<TeamStanding> m_standings = {}; // first place first
+    std::unordered_map<int, size_t> m_index = {}; // team number -> position in m_standings
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+};
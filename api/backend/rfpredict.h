@@ -2,42 +2,188 @@
 
 // ML
 #include <mlpack/core.hpp>
-#include <mlpack/methods/random_forest/random_forest.hpp>
 
 // Frontend
 #include "frontend/mainframe.h"
 
 // Backend
 #include "backend/data.h"
+#include "backend/matchfeatures.h"
+#include "backend/forest.h"
+#include "backend/compactforest.h"
+#include "backend/calibration.h"
+#include "backend/threadpool.h"
+
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <cstdint> // uint64_t
+#include <memory> // std::shared_ptr
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <thread> // std::thread
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
 
 // Paths regarding model
 #define FEATURES_CSV_PATH "./model/feats.csv"
 #define LABELS_CSV_PATH "./model/labels.csv"
-#define MODEL_EXPORT_PATH "./model/model.xml"
+#define MODEL_EXPORT_PATH "./model/model_alliance.xml" // models trained on team numbers used "model.xml" and can't be loaded
+#define CALIBRATION_EXPORT_PATH "./model/calibration.xml" // calibration of the model at MODEL_EXPORT_PATH
+#define COMPACT_MODEL_EXPORT_PATH "./model/model_compact.bin" // quantized copy of the model at MODEL_EXPORT_PATH
+
+// Model parameters
+#define RF_TREE_COUNT 40 // Number of trees in the forest
+#define RF_MIN_LEAF_SIZE 6 // Fewest training points a leaf may hold
+#define RF_MAX_DEPTH 0 // Deepest a tree may grow, 0 for no limit
+#define RF_MIN_TRAINING_MATCHES 20 // Fewest played matches to train a model from
+#define RF_WARM_START_TREES 8 // Oldest trees retrained each time new match results are folded into the model
+
+#define PREDICTION_CACHE_SIZE 4096 // Most lineups whose predictions are kept in memory
+#define PREDICTION_BATCH_CHUNK 256 // Matches classified per thread pool task when predicting in bulk
+
+/**
+ * @brief The six teams of a match, red 1-3 then blue 1-3, with each alliance sorted.
+ *
+ * Predictions don't depend on the order teams are listed in within an alliance,
+ * so sorting lets every ordering of the same alliances share a cache entry.
+ */
+using Lineup = std::array<int, 6>;
 
+using CompactModel = CompactForest16; // CompactForest8 halves the thresholds again, at some cost in accuracy
+
+struct LineupHash {
+    size_t operator()(const Lineup& lineup) const;
+};
+
+/**
+ * @class RFPredictor
+ * @brief Predicts match outcomes with a random forest.
+ *
+ * Training runs on a background thread, with the trees trained in parallel on the thread pool,
+ * so the app stays usable while a model is trained. Progress is shown in the status bar and
+ * training can be cancelled. Predictions keep using the current model until the new one is
+ * finished, at which point it is swapped in atomically.
+ *
+ * With online updates enabled, every match result entered, corrected or removed is folded into
+ * the training data straight away and the model is warm started: only its `RF_WARM_START_TREES`
+ * oldest trees are retrained on the updated data, so it keeps up with the event without a full
+ * retrain. Updates that arrive while the model is training are coalesced into one.
+ *
+ * Predictions are the chance of a red win: the fraction of trees voting for red, calibrated on
+ * the matches held out when the model was trained (Platt by default, or isotonic). A warm started
+ * model keeps the calibration of the model it started from. Many matches can be predicted in one
+ * call, which classifies them in chunks on the thread pool.
+ *
+ * Every model trained is also saved as a `CompactModel`, with its agreement with the full model
+ * on the held out matches logged. With the compact model turned on, for laptops short on memory,
+ * only the compact model is loaded and predicted with. It can't be warm started, so online
+ * updates retrain the model from scratch.
+ *
+ * Predictions are cached by lineup, stamped with the database's data version and the model
+ * they came from, so asking about the same lineup again is answered from memory until a team
+ * or match is written or a new model is swapped in. Matches in the database are also cached
+ * by match number, and only dropped when that match changes.
+ */
 class RFPredictor {
 public:
-    RFPredictor(MainFrame* mainFrame, DataBase* dataBase);
+    RFPredictor(MainFrame* mainFrame, DataBase* dataBase, FeaturePipeline* features, ThreadPool* threadPool, bool compactModel = false);
+    ~RFPredictor();
 
     bool PredictMatchOutcome(int matchNum);
-    inline bool IsModelAvailable() const { return this->m_available; }
+    bool PredictMatchOutcome(const Match& match); // predict a match that may not be in the database, e.g a possible alliance
+    double PredictRedWinProbability(int matchNum);
+    double PredictRedWinProbability(const Match& match); // 0.5 if no model is available
+    std::vector<double> PredictRedWinProbabilities(const std::vector<Match>& matches); // chance of a red win in each match, must not be called from a thread pool task
+    void SetCalibration(CalibrationMethod method); // how vote fractions are turned into probabilities
+    inline CalibrationMethod GetCalibration() const { return this->m_calibrationMethod; }
+    void InvalidateMatch(int matchNum); // the teams or result of match with matchNum changed
+    void ClearPredictionCache(); // forget every cached match and prediction
+    inline bool IsModelAvailable() const { return this->m_forest.load() != nullptr || this->m_compact.load() != nullptr; }
+
+    bool StartTraining(); // train a new model in the background, false if already training
+    void CancelTraining(); // stop the current training job, keeping the current model
+    inline bool IsTraining() const { return this->m_training; }
+
+    inline void UpdateWithMatch(int matchNum) { UpdateWithMatches({ matchNum }); } // fold a newly played, corrected or removed match into the model
+    void UpdateWithMatches(std::vector<int> matchNums); // fold several matches into the model, warm starting once
+    void RebuildTrainingData(); // build every scouted match of the training data again after a bulk change, warm starting once
+    inline void SetOnlineUpdates(bool enabled) { this->m_onlineUpdates = enabled; }
+    inline bool OnlineUpdatesEnabled() const { return this->m_onlineUpdates; }
+    void SetCompactModel(bool enabled); // predict with the compact model and keep only it in memory
+    inline bool CompactModelEnabled() const { return this->m_compactModel; }
+
+    bool GetTrainingData(
+        arma::mat& features,
+        arma::Row<size_t>& labels,
+        std::vector<int>* matchNums = nullptr
+    ); // matches to train on, false if there aren't enough
 private:
-    bool LoadModel(const std::string& modelPath);
-    void TrainModel(
-        const std::string& featuresPath, 
-        const std::string& labelsPath
-    );
-    bool PredictMatchOutcome(
-        const Match& match,
-        std::vector<double> teamWinRates
+    bool LoadModel(const std::string& modelPath, const std::string& compactPath, const std::string& calibrationPath);
+    bool LoadTrainingSet(
+        const std::string& featuresPath,
+        const std::string& labelsPath,
+        arma::mat& features,
+        arma::Row<size_t>& labels
     );
+    void BuildTrainingSet(arma::mat& features, arma::Row<size_t>& labels, std::vector<int>& matchNums);
+    void LoadCurrentData(); // load the training data without training, so it can be updated match by match
+    void RebuildMatchColumns(); // build the scouted matches of the training data again, keeping exported ones
+    void RefitTrainingData(); // warm start on the updated training data, or train the first model once there's enough
+    bool StartWarmStart(); // retrain the oldest trees on the current training data in the background
+    void TrainModel(arma::mat features, arma::Row<size_t> labels); // runs on the training thread
+    void WarmStartModel(std::shared_ptr<const Forest> base, arma::mat features, arma::Row<size_t> labels); // runs on the training thread
+    std::shared_ptr<const CompactModel> BuildCompactModel(
+        const Forest& forest,
+        const arma::mat& features,
+        const arma::mat& checkFeatures,
+        const arma::Row<size_t>& checkLabels,
+        std::string& summary
+    ); // runs on the training thread, saves the compact model and describes how it compares
+    void FinishTrainingJob(); // runs on the training thread, starts any update that arrived meanwhile
+    void LogFromTraining(const std::string& msg); // log on the UI thread
+    void SwapModel(
+        std::shared_ptr<const Forest> forest,
+        std::shared_ptr<const CompactModel> compact,
+        std::shared_ptr<const Calibrator> calibrator
+    ); // make the new model the one used to predict
+    Match GetCachedMatch(int matchNum); // match with matchNum, from the cache if it hasn't changed
+    static Lineup MakeLineup(const Match& match);
+
+    // A prediction and the versions of the data and model it was made with
+    struct CachedPrediction {
+        double redWinProbability;
+        uint64_t dataVersion;
+        uint64_t modelVersion;
+    };
+
+    // the model used to predict. nullptr if no model is available,
+    // in which case all calls to predict match outcome will return 0.
+    std::atomic<std::shared_ptr<const Forest>> m_forest;
+    std::atomic<std::shared_ptr<const CompactModel>> m_compact; // used instead of m_forest with m_compactModel
+    std::atomic<std::shared_ptr<const Calibrator>> m_calibrator; // swapped in with m_forest, never nullptr once a model is
+    std::atomic<CalibrationMethod> m_calibrationMethod = kCalibrationPlatt;
+    std::atomic<bool> m_compactModel = false;
+
+    std::thread m_trainingThread;
+    std::atomic<bool> m_training = false;
+    std::atomic<bool> m_cancelTraining = false;
+    std::atomic<bool> m_pendingUpdate = false; // a match changed while training, warm start again when it's done
+    std::atomic<uint64_t> m_modelVersion = 0; // bumped every time a model is swapped in or the calibration changes
+
+    // cached predictions, shared by the UI and anything predicting in bulk
+    std::mutex m_cacheMutex;
+    std::unordered_map<Lineup, CachedPrediction, LineupHash> m_predictions;
+    std::unordered_map<int, Match> m_matches; // match number -> match as last read from the database
 
-    // if the random forest model is available to predict.
-    // if this is false all calls to predict match outcome
-    // will return 0.
-    bool m_available;
+    // training data of the current model, only touched on the UI thread
+    arma::mat m_dataFeatures;
+    arma::Row<size_t> m_dataLabels;
+    std::vector<int> m_dataMatchNums; // match number of each column, 0 for matches from an exported dataset
+    bool m_dataLoaded = false;
+    bool m_onlineUpdates = true;
 
-    mlpack::RandomForest<> m_rf;
     MainFrame* m_mainFrame;
     DataBase* m_dataBase;
+    FeaturePipeline* m_features;
+    ThreadPool* m_threadPool;
 };
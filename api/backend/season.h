@@ -0,0 +1,92 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <sqlite3.h> // sqlite3
+#include <string> // std::string
+#include <vector> // std::vector
+
+#define SEASON_DB_PATH "season.db" // Path of the database listing every event of the season
+#define SEASON_EVENT_TABLE "Events" // Name of the table listing each event and the database its data is in
+#define SEASON_EVENT_DIR "events" // Folder each event's database is created in, named after its event key
+#define SEASON_EVENT_SCHEMA "event" // Prefix of the schema names event databases are attached as
+#define DEFAULT_EVENT_KEY "default" // Key of the event scouted in DB_PATH before events were kept apart
+#define EVENT_KEY_MAX_LENGTH 32 // Longest event key, e.g "2025onto"
+
+/**
+ * @struct SeasonEvent
+ * @brief An event of the season, as listed in the Events table.
+ *
+ * @param eventKey Key of the event, e.g "2025onto". Lowercase letters and digits only.
+ * @param name     Name shown for the event, e.g "Ontario District Event 1".
+ * @param path     Database the event's teams and matches are scouted in.
+ */
+struct SeasonEvent {
+    std::string eventKey;
+    std::string name;
+    std::string path;
+};
+
+/**
+ * @struct EventTeamStats
+ * @brief What a team did at an event, or over the whole season, going by its scouted rows.
+ *
+ * @param eventKey             Event the stats are from. Empty for stats over the whole season.
+ * @param teamNum              Team number of the team.
+ * @param events               Events the team was scouted at, 1 for the stats of an event.
+ * @param rowsScouted          Scouted rows of the team the stats are calculated from.
+ * @param averagePoints        Average coral and autonomous points per scouted row.
+ * @param averageRankingPoints Average ranking points per scouted row.
+ * @param hangRate             Successful hangs per scouted row.
+ */
+struct EventTeamStats {
+    std::string eventKey;
+    int teamNum;
+    int events;
+    int rowsScouted;
+    double averagePoints;
+    double averageRankingPoints;
+    double hangRate;
+};
+
+/**
+ * @class Season
+ * @brief Keeps each event of the season in its own database, and answers questions across all of them.
+ *
+ * Every event is scouted in a database of its own, created in `SEASON_EVENT_DIR` and named after
+ * its event key, which is also written into it. The app only ever opens the current event's database,
+ * so however many events the season has, an event's queries read and write the same amount of data
+ * as if it was the only one. The season database only lists the events and which one is current.
+ *
+ * Questions across events attach the event databases to the season database, as many at once as
+ * SQLite allows, and aggregate each event separately before the results are combined. Every row
+ * read this way is labeled with the key of the event it came from.
+ *
+ * The season database is only used from the UI thread.
+ */
+class Season {
+public:
+    Season(MainFrame* mainFrame, const std::string& path);
+    ~Season();
+
+    DataBase* OpenCurrentEvent(); // connect to the current event's database, labeling it with the event key
+
+    bool AddEvent(const std::string& eventKey, const std::string& name); // list a new event, its database is created when it's first opened
+    bool SetCurrentEvent(const std::string& eventKey); // event opened the next time the app starts
+    SeasonEvent GetCurrentEvent();
+    std::vector<SeasonEvent> GetEvents(); // every event, in the order they were added
+
+    std::vector<EventTeamStats> GetSeasonTeamStats(); // each team's stats over every event it was scouted at, best average points first
+    std::vector<EventTeamStats> GetTeamEventStats(int teamNum); // stats of 'teamNum' at each event it was scouted at, in the order they were added
+private:
+    void CreateTables(); // create the events table, listing DB_PATH as the default event the first time
+    bool CollectEventStats(int teamNum); // fill temp.EventTeamStats from every event, only 'teamNum' if it isn't 0
+    bool AttachEvent(const SeasonEvent& event, const std::string& schema);
+
+    MainFrame* m_mainFrame;
+    sqlite3* m_db = nullptr;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+#include "backend/opr.h"
+#include "backend/rankings.h"
+#include "backend/threadpool.h"
+
+#include <functional> // std::function
+#include <unordered_set> // std::unordered_set
+#include <vector> // std::vector
+
+#define ALLIANCE_HANG_POINTS      12.0 // Points a successful hang is worth
+#define ALLIANCE_DEFENSE_WEIGHT   0.1  // Points per defense rating point of the alliance's best defender
+#define ALLIANCE_PENALTY_POINTS   2.0  // Points given to the opponents per penalty
+#define ALLIANCE_HEAD_TO_HEAD_COUNT 8  // Top candidates re-ranked by head-to-head predictions
+
+/**
+ * @struct TeamAggregate
+ * @brief Per-team averages the alliance score is built from.
+ *
+ * @param teamNum         Team number of the team.
+ * @param expectedPoints  Points the team adds to an alliance. Its OPR once it has played, otherwise its scouted average.
+ * @param hangRate        Fraction of scouted matches the team hung successfully in.
+ * @param defense         Average scouted defense rating (1-100).
+ * @param penaltys        Average penalties per scouted match.
+ */
+struct TeamAggregate {
+    int teamNum;
+    double expectedPoints;
+    double hangRate;
+    double defense;
+    double penaltys;
+};
+
+/**
+ * @struct PickCandidate
+ * @brief A team on the pick list and the best alliance it makes with the captain.
+ *
+ * @param teamNum         Team number of the candidate first pick.
+ * @param partnerTeamNum  Best second pick to go with the candidate, 0 if no team is left.
+ * @param score           Score of the captain, candidate and partner alliance.
+ * @param headToHeadWins  Expected wins against the other top alliances, -1 if not predicted.
+ * @param rank            Candidate's place in the qualification rankings, 0 if it isn't ranked.
+ */
+struct PickCandidate {
+    int teamNum;
+    int partnerTeamNum;
+    double score;
+    double headToHeadWins;
+    int rank = 0;
+};
+
+/**
+ * @class AllianceSelector
+ * @brief Builds a live pick list for alliance selection.
+ *
+ * An alliance is scored from the per-team aggregates as the expected points of each team,
+ * plus hang points, plus the defense of the alliance's best defender (only one robot plays
+ * defense), minus points given away in penalties.
+ *
+ * For every available team the selector finds the best second pick to go with the captain and
+ * that team. Candidates are searched in parallel on the thread pool, each with a branch-and-bound
+ * over second picks sorted by the most they could add, stopping as soon as no remaining team can
+ * beat the best alliance found. The top candidates can then be re-ranked by predicted
+ * head-to-head results against each other.
+ *
+ * Teams marked as picked are left out of every search, so the pick list updates as the
+ * selection ceremony goes on.
+ */
+class AllianceSelector {
+public:
+    using HeadToHead = std::function<std::vector<double>(const std::vector<Match>&)>; // chance of the red alliance winning each match
+
+    AllianceSelector(MainFrame* mainFrame, DataBase* dataBase, ThreadPool* threadPool, OPRCalculator* opr, RankingTable* rankings);
+
+    std::vector<PickCandidate> BuildPickList(int captainTeamNum, const HeadToHead& redWinProbabilities = nullptr);
+
+    void MarkPicked(int teamNum); // leave 'teamNum' out of future pick lists
+    void UnmarkPicked(int teamNum); // make 'teamNum' available again
+    inline void ResetPicks() { this->m_picked.clear(); }
+    inline bool IsPicked(int teamNum) const { return this->m_picked.count(teamNum) > 0; }
+    inline int GetCaptain() const { return this->m_captainTeamNum; }
+    int NextCaptain() const; // highest ranked team that hasn't been picked, 0 if there is none
+private:
+    std::vector<TeamAggregate> GetAggregates(); // averages of every team in the database
+    void RankHeadToHead(std::vector<PickCandidate>& pickList, int captainTeamNum, const HeadToHead& redWinProbabilities);
+
+    std::unordered_set<int> m_picked; // team numbers already picked
+    int m_captainTeamNum = 0; // captain of the last pick list built
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+    ThreadPool* m_threadPool;
+    OPRCalculator* m_opr;
+    RankingTable* m_rankings;
+};
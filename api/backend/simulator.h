@@ -0,0 +1,96 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+#include "backend/rankings.h"
+#include "backend/threadpool.h"
+
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <cstdint> // uint64_t
+#include <functional> // std::function
+#include <vector> // std::vector
+
+#define SIMULATIONS_PER_TASK 10000 // Simulated events each thread pool task runs before merging its counts
+#define DEFAULT_SIMULATION_COUNT 1000000 // Simulated events per run when projecting rankings from the UI
+
+/**
+ * @struct EventSnapshot
+ * @brief Everything the simulator needs to know about the event, copied out of the database.
+ *
+ * Teams are referred to by their index in `teamNums` so the hot loop only touches small arrays.
+ *
+ * @param teamNums        Team number of every team in the schedule.
+ * @param standings       Current standing of each team, giving its ranking points, matches played,
+ *                        bonus ranking points and tie-breakers.
+ * @param tieProbability  Chance of an unplayed match ending in a tie, how often played ones did.
+ * @param remaining       Unplayed matches, with the index of each team (-1 for an empty slot)
+ *                        and the chance of the red alliance winning if it isn't a tie.
+ */
+struct EventSnapshot {
+    struct RemainingMatch {
+        std::array<int, 6> teams;
+        double redWinProbability;
+    };
+
+    std::vector<int> teamNums;
+    std::vector<TeamStanding> standings;
+    double tieProbability = 0.0;
+    std::vector<RemainingMatch> remaining;
+};
+
+/**
+ * @struct TeamProjection
+ * @brief Where a team finished across every simulated event.
+ *
+ * @param teamNum                Team number of the team.
+ * @param averageRank            Mean final rank, 1 being first.
+ * @param averageRankingPoints   Mean final ranking points.
+ * @param rankProbabilities      Chance of finishing at each rank, index 0 being first.
+ */
+struct TeamProjection {
+    int teamNum;
+    double averageRank;
+    double averageRankingPoints;
+    std::vector<double> rankProbabilities;
+};
+
+/**
+ * @class EventSimulator
+ * @brief Monte Carlo simulator projecting where each team will finish the qualification rankings.
+ *
+ * `TakeSnapshot` copies the current standings and the unplayed matches out of the ranking table,
+ * without reading the database. It asks the caller for the chance of red winning each unplayed
+ * match, e.g from Elo ratings or the Random Forest model. `Simulate` then plays out the remaining
+ * schedule many times across every core of the thread pool and counts how often each team
+ * finishes at each rank.
+ *
+ * The simulations are split into tasks of `SIMULATIONS_PER_TASK`. Every task has its own random
+ * number stream seeded from the run seed and the task's index, so a run is reproducible no matter
+ * which thread ends up running which task.
+ *
+ * A simulated match gives each team the ranking points of its result plus bonus ranking points,
+ * drawn so they average what the team has been scouted earning. The simulated standings are
+ * sorted with `RankingTable::RanksAbove`, like the real ones.
+ */
+class EventSimulator {
+public:
+    using WinProbability = std::function<double(const Match&)>; // chance of the red alliance winning a match
+
+    EventSimulator(MainFrame* mainFrame, DataBase* dataBase, ThreadPool* threadPool, RankingTable* rankings);
+
+    EventSnapshot TakeSnapshot(const WinProbability& redWinProbability); // must be called from the UI thread, where the standings are kept
+    std::vector<TeamProjection> Simulate(const EventSnapshot& snapshot, size_t simulationCount, uint64_t seed); // safe to call from any thread
+
+    bool TryBeginRun(); // mark a run as started, false if one is already running
+    void EndRun(); // mark the current run as finished
+private:
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+    ThreadPool* m_threadPool;
+    RankingTable* m_rankings;
+    std::atomic<bool> m_running = false;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+#include "backend/changeset.h"
+#include "backend/netsocket.h"
+#include "backend/uicall.h"
+
+#include <atomic> // std::atomic
+#include <cstdint> // uint16_t, uint64_t
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <thread> // std::thread
+
+#define SYNC_PORT 7022 // Port stations listen for syncs on
+#define SYNC_FILE_PEER "(file)" // Peer name exports to changeset files are tracked under
+#define SYNC_TIMEOUT_MS 15000 // How long a sync waits on the other station before giving up
+#define SYNC_FILE_EXTENSION "frcsync" // Extension of exported changeset files
+
+/**
+ * @brief The frames of a sync, in the order they're sent.
+ *
+ * 1. The connecting station sends HELLO with its name.
+ * 2. The listening station answers WELCOME with its name and how far into the
+ *    connecting station's change log it already is.
+ * 3. The connecting station sends CHANGES: how far into the listening station's change
+ *    log it already is, then its own changes past the point the listening station gave.
+ * 4. The listening station applies them and answers REPLY with its changes past the
+ *    point the connecting station gave.
+ */
+enum SyncFrame : uint8_t {
+    kSyncHello = 1,
+    kSyncWelcome,
+    kSyncChanges,
+    kSyncReply,
+};
+
+/**
+ * @class SyncService
+ * @brief Exchanges changesets with other scouting stations, through files or over TCP.
+ *
+ * Only the rows changed since the last exchange with a station are sent, going by the
+ * watermarks kept in the database's sync state table. Applying a changeset is idempotent,
+ * so a sync interrupted halfway can simply be run again.
+ *
+ * The database may only be used on the UI thread, so the sync threads hand every database
+ * call to it with `RunOnUiThread`.
+ */
+class SyncService {
+public:
+    SyncService(MainFrame* mainFrame, DataBase* db);
+    ~SyncService();
+
+    bool ExportChangesToFile(const std::string& path, bool everything, size_t& count); // count is set to the rows written
+    bool ApplyChangesFromFile(const std::string& path, SyncReport& report);
+
+    bool StartServer(uint16_t port, bool loopbackOnly); // listen for other stations syncing with this one
+    void StopServer();
+    inline bool IsServing() const { return this->m_serving; }
+    inline uint16_t ServerPort() const { return this->m_serverPort; }
+
+    bool StartSync(const std::string& host, uint16_t port); // sync with a station in the background, false if a sync is already running
+    bool SyncWith(const std::string& host, uint16_t port, SyncReport& report); // blocks, call off the UI thread
+private:
+    void ServeConnections(); // accept loop of the server thread
+    bool ServeConnection(const Socket& connection);
+    bool ExchangeWith(const Socket& connection, SyncReport& report); // the connecting side of a sync, from HELLO to REPLY
+
+    MainFrame* m_mainFrame;
+    DataBase* m_db;
+
+    Socket m_listener;
+    std::thread m_serverThread;
+    std::thread m_syncThread;
+    std::mutex m_connectionMutex; // guards m_connection and m_outbound
+    Socket* m_connection = nullptr; // connection the server thread is serving, so StopServer can wake it
+    Socket* m_outbound = nullptr; // connection the sync thread is syncing over, so the destructor can wake it
+    std::atomic<bool> m_serving = false;
+    std::atomic<bool> m_syncing = false;
+    std::atomic<bool> m_stopping = false;
+    uint16_t m_serverPort = 0;
+};
@@ -51,5 +51,7 @@ struct Team {
     uint16_t overall; // 1-100
     uint16_t rankingPoints;
 
+    int PointsScored() const; // coral and autonomous points scored by the team in its match
+
     static Team FromSQLStatment(sqlite3_stmt* stmt); // Create a new Team struct from SQL DB
 };
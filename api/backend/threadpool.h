@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <deque> // std::deque
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+/**
+ * @class ThreadPool
+ * @brief A work-stealing pool of worker threads for CPU heavy analysis.
+ *
+ * Each worker owns a task queue. Workers take tasks from the back of their own queue
+ * (most recently submitted first, which keeps caches warm) and, when it runs dry, steal
+ * from the front of another worker's queue. Tasks submitted from a worker thread go to
+ * that worker's own queue, tasks submitted from any other thread are spread between the
+ * queues round robin.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    void Submit(std::function<void()> task); // queue a task to run on a worker
+    inline size_t ThreadCount() const { return this->m_threads.size(); }
+private:
+    // A worker's queue of tasks. Guarded by its own mutex so
+    // workers only contend when one of them is stealing.
+    struct TaskQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    void WorkerLoop(size_t index); // run tasks until the pool is destroyed
+    bool PopTask(size_t index, std::function<void()>& task); // take a task from the back of the worker's own queue
+    bool StealTask(size_t thief, std::function<void()>& task); // take a task from the front of another worker's queue
+
+    std::vector<std::unique_ptr<TaskQueue>> m_queues; // one per worker
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex; // guards sleeping and waking with the condition variables below
+    std::condition_variable m_taskAvailable; // signalled when a task is submitted or the pool stops
+
+    std::atomic<size_t> m_queued = 0; // tasks sitting in a queue
+    std::atomic<size_t> m_nextQueue = 0; // round robin queue for tasks submitted from outside the pool
+    bool m_stopping = false;
+};
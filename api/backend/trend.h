@@ -0,0 +1,102 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+// Backend
+#include "backend/data.h"
+
+#include <map> // std::map
+#include <unordered_map> // std::unordered_map
+#include <utility> // std::pair
+#include <vector> // std::vector
+
+#define TREND_WINDOW 5 // Most recent matches the rolling average and the trend slope are taken over
+#define TREND_EWMA_ALPHA 0.3 // Weight of a team's newest match in its exponentially weighted mean
+#define TREND_SPARKLINE_MATCHES 8 // Most recent matches drawn in a team's sparkline
+
+/**
+ * @struct TeamTrend
+ * @brief How a team has been doing over its most recent matches.
+ *
+ * Points are the coral and autonomous points scouted for the team in a match, the average
+ * of its rows if more than one scout watched it.
+ *
+ * @param teamNum        Team number of the team.
+ * @param matches        Matches the team was scouted in.
+ * @param lastMatchNum   Match number of the most recent of them.
+ * @param lastPoints     Points in the most recent match.
+ * @param windowAverage  Average points over the last `TREND_WINDOW` matches.
+ * @param weightedMean   Exponentially weighted mean of the points of every match, recent matches weigh the most.
+ * @param slope          Points gained per match over the last `TREND_WINDOW` matches, positive if improving.
+ */
+struct TeamTrend {
+    int teamNum = 0;
+    int matches = 0;
+    int lastMatchNum = 0;
+    double lastPoints = 0.0;
+    double windowAverage = 0.0;
+    double weightedMean = 0.0;
+    double slope = 0.0;
+};
+
+/**
+ * @class TrendIndex
+ * @brief Match by match history of every team's scouted points, with rolling stats kept up to date as rows change.
+ *
+ * The index holds each team's points keyed by match number, built from every scouted row once
+ * when the app starts. After that it's only told which rows changed, by the database's change
+ * batches, and reads just those rows, so it never scans the Teams table again.
+ *
+ * Each match keeps the weighted mean as it was after that match, the way the Ratings table keeps
+ * Elo ratings. A team's newest match only moves its weighted mean one step on, and a row scouted
+ * late for an earlier match rolls it forward from that match. The rolling average and the slope
+ * only read the last `TREND_WINDOW` matches, so a changed row costs at most one pass over a single
+ * team's matches, whatever the size of the table.
+ *
+ * Only used from the UI thread, where the change batches are delivered.
+ *
+ * @see TeamTrend
+ */
+class TrendIndex {
+public:
+    TrendIndex(MainFrame* mainFrame, DataBase* dataBase);
+
+    void Reload(); // rebuild the index from every scouted row, after the whole database was replaced
+    bool ApplyChanges(const DataEventBatch& batch); // fold changed scouted rows into the index, true if a team's history changed
+
+    TeamTrend GetTeamTrend(int teamNum) const; // all zero if 'teamNum' wasn't scouted
+    std::vector<TeamTrend> GetTrends() const; // every scouted team, most improving first
+    std::vector<std::pair<int, double>> GetTeamHistory(int teamNum, size_t count = 0) const; // match number and points of the last 'count' matches, every match if 0, oldest first
+private:
+    // Points scouted for a team in one match
+    struct MatchPoints {
+        double total = 0.0; // summed points of every row scouted for the team in the match
+        int rows = 0;
+        double weightedMean = 0.0; // the team's weighted mean after this match
+
+        inline double Points() const { return this->total / this->rows; }
+    };
+
+    // What a scouted row added to the index, so it can be taken out again
+    struct RowPoints {
+        int teamNum;
+        int matchNum;
+        double points;
+    };
+
+    struct TeamHistory {
+        std::map<int, MatchPoints> matches = {}; // match number -> points scouted in it
+        TeamTrend trend = {};
+    };
+
+    void AddRow(const Team& team, std::unordered_map<int, int>& changedFrom);
+    void RemoveRow(int uid, std::unordered_map<int, int>& changedFrom);
+    void Update(int teamNum, int fromMatchNum); // roll the weighted mean forward from 'fromMatchNum' and recalculate the trend
+
+    std::unordered_map<int, TeamHistory> m_teams = {}; // team number -> history
+    std::unordered_map<int, RowPoints> m_rows = {}; // uid -> what the row added
+
+    MainFrame* m_mainFrame;
+    DataBase* m_dataBase;
+};
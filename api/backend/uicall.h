@@ -0,0 +1,45 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::milliseconds
+#include <functional> // std::function
+#include <future> // std::promise, std::future
+#include <memory> // std::shared_ptr
+
+/**
+ * @brief Runs a call on the UI thread and waits for it to finish.
+ *
+ * The database may only be used on the UI thread, so background threads serving other
+ * stations or scouts hand their database calls to it this way. Waiting gives up once
+ * 'stopping' is set, since the UI thread setting it can't run the call until it's done.
+ * The call is then skipped, as whatever it referenced is gone.
+ *
+ * @param mainFrame The main window, whose event loop runs the call.
+ * @param call The call to run.
+ * @param stopping Set when the caller's service is being stopped.
+ * @return true if the call ran, false if the service stopped first.
+ */
+inline bool RunOnUiThread(MainFrame* mainFrame, const std::function<void()>& call, const std::atomic<bool>& stopping) {
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> future = done->get_future();
+
+    // copied into the event, the caller's references may be gone by the time a late call runs
+    auto abandoned = std::make_shared<std::atomic<bool>>(false);
+    mainFrame->CallAfter([call, done, abandoned] {
+        if ( !*abandoned )
+            call();
+        done->set_value();
+    });
+
+    while ( future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready ) {
+        if ( stopping ) {
+            *abandoned = true;
+            return future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready;
+        }
+    }
+
+    return true;
+}
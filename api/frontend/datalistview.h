@@ -0,0 +1,52 @@
+#pragma once
+
+// WX Components
+#include <wx/listctrl.h> // wxListCtrl, wxItemAttr
+
+#include <functional> // std::function
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+#define LIST_PAGE_ROWS 64 // Rows read from the database at once when the list draws one it hasn't read yet
+
+/**
+ * @class DataListView
+ * @brief A virtual list view showing database rows named by their keys.
+ *
+ * The list only holds the keys of the rows it shows, in order, as returned by a list query.
+ * The cells of a row are read through the row fetcher the first time the row is drawn,
+ * a page of rows at a time, and kept until the row changes. Thousands of rows cost a
+ * vector of ints, and re-sorting or filtering them costs one query plus the visible rows.
+ */
+class DataListView : public wxListCtrl {
+public:
+    // fills 'cells' with the text of each column of the rows named by 'keys' that still exist
+    using RowFetcher = std::function<void(const std::vector<int>& keys, std::unordered_map<int, std::vector<wxString>>& cells)>;
+
+    DataListView(wxWindow* parent, wxWindowID id);
+
+    inline void SetRowFetcher(RowFetcher fetcher) { this->m_fetcher = std::move(fetcher); }
+    void SetRowColours(const wxColour& even, const wxColour& odd);
+
+    void SetRows(std::vector<int> keys); // show these rows, in this order, keeping the selected rows selected
+    void ForgetRow(int key); // read the row again the next time it's drawn
+    inline void ForgetRows() { this->m_cells.clear(); } // read every row again the next time it's drawn
+    long SelectKey(int key); // select and scroll to the row, -1 if it isn't shown
+
+    inline long RowCount() const { return static_cast< long >( this->m_keys.size() ); }
+    int KeyAt(long row) const; // 0 if there is no such row
+    long RowOf(int key) const; // -1 if the row isn't shown
+    std::vector<int> SelectedKeys() const; // keys of every selected row, top to bottom
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+    wxItemAttr* OnGetItemAttr(long item) const override;
+private:
+    void FetchPage(long row) const;
+
+    RowFetcher m_fetcher;
+    std::vector<int> m_keys = {}; // key of each row, in the order shown
+    std::unordered_map<int, long> m_rows = {}; // row each key is shown in
+    mutable std::unordered_map<int, std::vector<wxString>> m_cells = {}; // cells of the rows read so far, by key
+    mutable wxItemAttr m_evenAttr;
+    mutable wxItemAttr m_oddAttr;
+};
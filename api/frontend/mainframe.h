@@ -11,12 +11,20 @@
 // Backend
 #include "backend/team.h" // Team struct
 #include "backend/match.h" // Match struct
+#include "backend/dataevents.h" // DataEventBatch struct
+#include "backend/listquery.h" // ListQuery struct
 
 // Frontend
 #include "frontend/wxids.h"
 #include "frontend/colours.h" // Common wxColours
+#include "frontend/datalistview.h" // DataListView class
+
+#include <functional> // std::function
+#include <future> // std::future
+#include <vector> // std::vector
 
 #define APP_NAME "FRCScout"
+#define COMPACT_MODEL_CONFIG_KEY "CompactModel" // App setting remembering whether to predict with the compact model
 
 /**
  * @class MainFrame
@@ -48,6 +56,14 @@ public:
     void LogSQLQuery(std::string query); // add a completed query to SQL output
     void LogErrorMessage(std::string errorMsg); // print a red error message in output with prefix "ERROR>"
     void LogBackendMessage(std::string msg); // print a blue message in SQL output with prefix "MSG>"
+    void LogProgress(const std::string& task, size_t done, size_t total); // show how far along a background task is in the status bar
+
+    void ReloadAllData(); // recalculate the analysis after another station changed the data
+    void ShowIngestedData(
+        const std::vector<int>& teamNums,
+        const std::vector<int>& matchNums,
+        const std::vector<int>& rowMatchNums
+    ); // update the analysis after scouting clients submitted rows
 private:
     // Initialization
     void DisplayExistingData(); // display already existing data from the db to ui
@@ -76,12 +92,12 @@ private:
     void DefaultEditGrid(); // set the editing grid to default values
 
     // Create data
-    void CreateTeamRow(const Team& team); // create a row with info from 'team' in teamListView
-    void CreateMatchRow(const Match& match); // create a row with info from 'match' in matchListView
-    void RefreshTeamRow(int uid);
-    void RefreshMatchRow(int matchNum);
-    void FillMatchRow(int row, const Match& match);
-    void FillTeamRow(int row, const Team& team);
+    void RequeryTeamList(); // show the team rows m_teamQuery keeps, in its order
+    void RequeryMatchList(); // show the match rows m_matchQuery keeps, in its order
+    void ShowChangedRows(const DataEventBatch& batch); // update the rows a batch of database writes touched
+    std::vector<wxString> TeamRowCells(const Team& team); // text of each column of a team row
+    wxString TrendSparkline(int teamNum); // bars of the points 'teamNum' scored in its last few matches
+    std::vector<wxString> MatchRowCells(const Match& match); // text of each column of a match row
     wxMenuBar* CreateMenuBar(); // create menu bar which contains options like File, Export..
     const Team GetTeamFromRow(int row);
     const Match GetMatchFromRow(int row);
@@ -97,6 +113,10 @@ private:
     void OnTeamRowRightClicked(wxCommandEvent& event);
     void OnMatchRowRightClicked(wxCommandEvent& event);
     void OnListViewRightClick(wxCommandEvent& event);
+    void OnListColumnClicked(wxListEvent& event);
+    void OnListColumnRightClicked(wxListEvent& event);
+    void OnListSearch(wxCommandEvent& event);
+    void OnListKeyDown(wxListEvent& event);
     void OnToggleEditMode(wxCommandEvent& event);
     void OnCreateNewTeam(wxCommandEvent& event);
     void OnCreateNewMatch(wxCommandEvent& event);
@@ -112,7 +132,44 @@ private:
     void OnAddButton(wxCommandEvent& event);
     void OnImportTeamDataCSV(wxCommandEvent& event);
     void OnImportMatchDataCSV(wxCommandEvent& event);
+    void OnBuildTrainingSet(wxCommandEvent& event);
+    void OnMergeDataBases(wxCommandEvent& event);
+    void OnExportChanges(wxCommandEvent& event);
+    void OnApplyChanges(wxCommandEvent& event);
+    void OnSyncWithStation(wxCommandEvent& event);
+    void OnToggleServeSync(wxCommandEvent& event);
+    void OnToggleIngest(wxCommandEvent& event);
     void OnPredictMatch(wxCommandEvent& event);
+    void OnCalculateOPR(wxCommandEvent& event);
+    void OnShowEloRatings(wxCommandEvent& event);
+    void OnShowRankings(wxCommandEvent& event);
+    void OnSimulateEvent(wxCommandEvent& event);
+    void OnBuildPickList(wxCommandEvent& event);
+    void OnResetPicks(wxCommandEvent& event);
+    void OnMarkTeamPicked(wxCommandEvent& event);
+    void OnRetrainModel(wxCommandEvent& event);
+    void OnCancelTraining(wxCommandEvent& event);
+    void OnEvaluateModel(wxCommandEvent& event);
+    void OnToggleOnlineUpdates(wxCommandEvent& event);
+    void OnToggleCompactModel(wxCommandEvent& event);
+    void OnNewEvent(wxCommandEvent& event);
+    void OnSwitchEvent(wxCommandEvent& event);
+    void OnShowSeasonStats(wxCommandEvent& event);
+    void OnShowTeamSeason(wxCommandEvent& event);
+    void OnShowTeamTrends(wxCommandEvent& event);
+    void OnShowTeamHistory(wxCommandEvent& event);
+    void OnBackUpNow(wxCommandEvent& event);
+    void OnRestoreBackup(wxCommandEvent& event);
+    void OnToggleAutoBackup(wxCommandEvent& event);
+    void OnClose(wxCloseEvent& event); // stop the background services and delete the backend
+
+    // Analysis (events.cpp)
+    void RefreshMatchAnalysis(int matchNum); // keep ratings up to date after match with matchNum changed
+    void RefreshAllAnalysis(); // recalculate ratings after many matches changed at once
+    void RefreshTeamAnalysis(int teamNum); // drop cached features of team with teamNum after one of its rows changed
+    void LogPickList(int captainTeamNum); // log the pick list for captain with captainTeamNum
+    void RestartInEvent(const std::string& eventKey); // make the event current and start the app again in it
+    void RunInBackground(std::function<void()> task); // run 'task' on a thread of its own, waited for before the window closes
 
     bool m_darkModeTheme; 
     bool m_isEditModeEnabled;
@@ -120,8 +177,11 @@ private:
     int m_selectedMatchRow = -1; // match number of match that is currently selected
     int m_displayedTeamCount; // number of team rows in team list view
     int m_displayedMatchCount; // number of match rows in match list view
-    wxListCtrl* m_teamListView; // container that holds rows about teams
-    wxListCtrl* m_matchListView; // container that holds rows about matches
+    DataListView* m_teamListView; // container that holds rows about teams
+    DataListView* m_matchListView; // container that holds rows about matches
+    ListQuery m_teamQuery = {}; // sort, search and filters of m_teamListView
+    ListQuery m_matchQuery = {}; // sort, search and filters of m_matchListView
+    std::vector<std::future<void>> m_backgroundTasks = {}; // exports and analysis running off the UI thread
 
     /**
      * Ddatabase used by the frontend to communicate
@@ -139,5 +199,20 @@ private:
     */
     void* m_dataBase = nullptr;
 
+    void* m_season = nullptr; // Season*, lists the events of the season and opens the current one's database
+
     void* m_predictor = nullptr;
+
+    void* m_opr = nullptr; // OPRCalculator*, kept up to date as matches change
+    void* m_elo = nullptr; // EloRating*, kept up to date as match results change
+    void* m_features = nullptr; // FeaturePipeline*, caches the features of each team for the predictor
+    void* m_threadPool = nullptr; // ThreadPool*, shared by the CPU heavy analysis
+    void* m_simulator = nullptr; // EventSimulator*, projects final rankings
+    void* m_selector = nullptr; // AllianceSelector*, keeps track of picked teams during alliance selection
+    void* m_evaluator = nullptr; // ModelEvaluator*, cross-validates prediction model parameters
+    void* m_sync = nullptr; // SyncService*, exchanges changes with other scouting stations
+    void* m_ingest = nullptr; // IngestServer*, accepts rows from scouting clients on the network
+    void* m_backup = nullptr; // BackupService*, snapshots the database in the background
+    void* m_trends = nullptr; // TrendIndex*, every team's points match by match with rolling stats
+    void* m_rankings = nullptr; // RankingTable*, qualification standings kept up to date as matches change
 };
\ No newline at end of file
@@ -27,6 +27,13 @@ enum ItemIds {
     kExportMatchDataCSV,
     kImportTeamDataCSV,
     kImportMatchDataCSV,
+    kBuildTrainingSet, // import menu item for building the model's training set from saved FRC API match results
+    kMergeDataBases, // import menu item for merging other scouts' databases into this one
+    kExportChanges, // export menu item for writing the rows changed since the last export to a changeset file
+    kApplyChanges, // import menu item for applying a changeset file from another station
+    kSyncWithStation, // import menu item for syncing with another station over the network
+    kServeSync, // import menu item for letting other stations sync with this one
+    kServeIngest, // import menu item for accepting rows from scouting clients on the network
     kSQLHistoryTextBox,
     kEditingDataTitle, // e.g "Editing Team #1" title
     kEditingDataDesc, // e.g "Modify values for Team #1" description
@@ -34,6 +41,27 @@ enum ItemIds {
     kEditModeButton,
     kClearOutputButton,
     kPredictMatch, // right click context menu button for predicting match outcome
+    kCalculateOPR, // analysis menu item for calculating OPR, DPR and CCWM
+    kShowEloRatings, // analysis menu item for showing each team's Elo rating
+    kSimulateEvent, // analysis menu item for projecting final rankings
+    kBuildPickList, // analysis menu item for building an alliance selection pick list
+    kResetPicks, // analysis menu item for making every picked team available again
+    kMarkTeamPicked, // right click context menu button for marking a team as picked during alliance selection
+    kRetrainModel, // analysis menu item for training a new prediction model in the background
+    kCancelTraining, // analysis menu item for cancelling the prediction model being trained
+    kEvaluateModel, // analysis menu item for cross-validating prediction model parameters
+    kOnlineModelUpdates, // analysis menu item for updating the prediction model as match results are entered
+    kNewEvent, // file menu item for adding an event to the season
+    kSwitchEvent, // file menu item for scouting another event of the season
+    kShowSeasonStats, // analysis menu item for showing each team's stats over every event of the season
+    kShowTeamSeason, // right click context menu button for showing a team's stats at each event of the season
+    kBackUpNow, // file menu item for taking a snapshot of the database now
+    kRestoreBackup, // file menu item for rewinding the database to a snapshot
+    kAutoBackup, // file menu item for taking snapshots of the database every few minutes
+    kShowTeamTrends, // analysis menu item for showing which teams are improving over their recent matches
+    kShowTeamHistory, // right click context menu button for showing a team's points in each match it was scouted in
+    kShowRankings, // analysis menu item for showing the current qualification rankings
+    kCompactModel, // analysis menu item for predicting with the compact model, for laptops short on memory
 };
 
 /**
@@ -56,6 +84,7 @@ enum TeamGridRowIds {
     kRowDriverSkill,
     kRowPenaltys,
     kRowRankingPoints,
+    kRowTrend, // team list only, sparkline of the team's recent matches. Not a row of the editing grid
 };
 
 /**
@@ -2,12 +2,21 @@ import requests
 import base64
 import json
 import os
+import sys
 from dotenv import load_dotenv
-import string
 
 load_dotenv()
 
-url = "https://frc-api.firstinspires.org/v3.0/2024/matches/ONWAT?tournamentLevel=Playoff"
+# usage: python match_details.py <season> <event code> [tournament level]
+# e.g python match_details.py 2024 ONWAT Qualification
+#
+# saves the FRC API match results of the event to <season>_<event>_<level>.json,
+# which the app reads with Import > Build Training Set From FRC API Results
+season = sys.argv[1] if len(sys.argv) > 1 else "2024"
+event = sys.argv[2] if len(sys.argv) > 2 else "ONWAT"
+level = sys.argv[3] if len(sys.argv) > 3 else "Qualification"
+
+url = f"https://frc-api.firstinspires.org/v3.0/{season}/matches/{event}?tournamentLevel={level}"
 
 username = os.getenv("API_USERNAME")
 api_key = os.getenv("API_KEY")
@@ -17,39 +26,15 @@ encodedCreds = base64.b64encode(creds.encode()).decode()
 
 headers = {
     "Authorization": f"Basic {encodedCreds}",
-    "If-Modified-Since": "" 
+    "If-Modified-Since": ""
 }
 
 
-response = requests.get(url, headers=headers).json()
-
-# convert json values to import values that can be used to train ml model
-# match #, red win, blue win, red 1, red 2, red 3, blue....
-
-for match in response["Matches"]:
-    # statistics
-    redScore = match["scoreRedFinal"]
-    blueScore = match["scoreBlueFinal"]
-    if redScore == None or blueScore == None:
-        continue
-    
-    redWin = int(redScore > blueScore)
-    blueWin = int(blueScore > redScore)
-    
-    # info
-    matchNum = match["matchNumber"]
-
-    # teams
-    teams = match["teams"]
-    redTeams = []
-    blueTeams = []
-    for team in teams:
-        teamNumber = team["teamNumber"]
-        if "Red" in team["station"]:
-            redTeams.append(teamNumber)
-        elif "Blue" in team["station"]:
-            blueTeams.append(teamNumber)
-
-    matchInfo = [matchNum, redWin, blueWin, *redTeams, *blueTeams]
-    print(matchInfo)
-    
+response = requests.get(url, headers=headers)
+response.raise_for_status()
+
+path = f"{season}_{event}_{level}.json"
+with open(path, "w") as file:
+    json.dump(response.json(), file)
+
+print(f"Saved {len(response.json()['Matches'])} matches to {path}")
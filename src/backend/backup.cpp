@@ -0,0 +1,277 @@
+#include "backup.h"
+
+#include <algorithm> // std::sort
+#include <cstdio> // std::sscanf
+#include <filesystem> // std::filesystem
+#include <format> // std::format
+
+BackupService::BackupService(MainFrame* mainFrame, DataBase* db) : m_mainFrame(mainFrame), m_db(db) {}
+
+BackupService::~BackupService() {
+    Stop();
+}
+
+/**
+ * @brief Starts taking snapshots in the background, the first one straight away.
+ *
+ * Snapshot files left half written by a run of the app that was closed in the middle
+ * of one are removed.
+ */
+void BackupService::Start() {
+    if ( m_running )
+        return;
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+
+    std::error_code err;
+    for ( const auto& entry : std::filesystem::directory_iterator(SnapshotFolder(), err) ) {
+        if ( entry.path().extension() == ".tmp" && entry.path().filename().string().starts_with(SnapshotPrefix()) )
+            std::filesystem::remove(entry.path(), err);
+    }
+
+    m_stopping = false;
+    m_running = true;
+    m_thread = std::thread(&BackupService::RunSchedule, this);
+}
+
+/**
+ * @brief Stops taking snapshots, waiting for one being written to finish.
+ */
+void BackupService::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_scheduleMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+
+    m_running = false;
+}
+
+/**
+ * @brief Takes a snapshot every `BACKUP_INTERVAL_S` seconds, if the database was written since the last one.
+ */
+void BackupService::RunSchedule() {
+    while ( !m_stopping ) {
+        bool changed;
+        {
+            std::lock_guard<std::mutex> lock(m_snapshotMutex);
+            changed = !m_hasSnapshot || m_db->GetDataVersion() != m_snapshotVersion;
+        }
+
+        if ( changed ) {
+            std::string path;
+            TakeSnapshot(path);
+        }
+
+        std::unique_lock<std::mutex> lock(m_scheduleMutex);
+        m_wake.wait_for(lock, std::chrono::seconds(BACKUP_INTERVAL_S), [this] { return m_stopping.load(); });
+    }
+}
+
+/**
+ * @brief Takes a snapshot of the database now, then deletes the oldest snapshots past `BACKUP_KEEP_COUNT`.
+ *
+ * Can be called from any thread, including while the schedule is writing one.
+ *
+ * @param path Set to the path of the snapshot.
+ * @return true if the snapshot was written.
+ */
+bool BackupService::TakeSnapshot(std::string& path) {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+
+    path = NewSnapshotPath();
+
+    const uint64_t version = m_db->GetDataVersion();
+    if ( !WriteSnapshot(path) )
+        return false;
+
+    m_snapshotVersion = version;
+    m_hasSnapshot = true;
+
+    RemoveOldSnapshots();
+    return true;
+}
+
+/**
+ * @brief Picks the path of a snapshot taken now.
+ *
+ * @return The path, in `BACKUP_DIR`, which is created if it doesn't exist yet.
+ */
+std::string BackupService::NewSnapshotPath() const {
+    const std::string folder = SnapshotFolder();
+    std::error_code err;
+    std::filesystem::create_directories(folder, err);
+
+    // named after when it was taken, in UTC, so the names sort in the order they were taken
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    const auto day = std::chrono::floor<std::chrono::days>(now);
+    const std::chrono::year_month_day date(day);
+    const std::chrono::hh_mm_ss time(now - day);
+
+    const std::string name = std::format(
+        "{}{:04}{:02}{:02}-{:02}{:02}{:02}", SnapshotPrefix(),
+        static_cast< int >( date.year() ), static_cast< unsigned >( date.month() ), static_cast< unsigned >( date.day() ),
+        time.hours().count(), time.minutes().count(), time.seconds().count()
+    );
+
+    std::string path = ( std::filesystem::path(folder) / ( name + ".db" ) ).string();
+    for ( int i = 2; std::filesystem::exists(path); i++ )
+        path = ( std::filesystem::path(folder) / std::format("{}-{}.db", name, i) ).string();
+
+    return path;
+}
+
+/**
+ * @brief Copies the database to a file, `BACKUP_STEP_PAGES` pages at a time.
+ *
+ * The copy is read through a read-only connection inside one read transaction, so every step
+ * copies pages of the same version of the database and the backup never has to start over
+ * because something was written meanwhile. It's written to 'path' with ".tmp" added, and
+ * renamed to 'path' once complete.
+ *
+ * @param path The snapshot file to write.
+ * @return true if the snapshot was written.
+ */
+bool BackupService::WriteSnapshot(const std::string& path) {
+    const std::string partial = path + ".tmp";
+
+    sqlite3* source;
+    if ( sqlite3_open_v2(m_db->GetPath().c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK ) {
+        m_mainFrame->CallAfter([this, error = std::string(sqlite3_errmsg(source))] {
+            m_mainFrame->LogErrorMessage("Failed to open the database to back it up: " + error);
+        });
+        sqlite3_close(source);
+        return false;
+    }
+
+    sqlite3_busy_timeout(source, DB_BUSY_TIMEOUT_MS);
+
+    sqlite3* snapshot;
+    if ( sqlite3_open(partial.c_str(), &snapshot) != SQLITE_OK ) {
+        m_mainFrame->CallAfter([this, partial] {
+            m_mainFrame->LogErrorMessage("Failed to create snapshot " + partial + ".");
+        });
+        sqlite3_close(snapshot);
+        sqlite3_close(source);
+        return false;
+    }
+
+    // pin every step to the same version of the database
+    sqlite3_exec(source, "BEGIN; SELECT COUNT(*) FROM sqlite_schema;", NULL, 0, nullptr);
+
+    int res = SQLITE_ERROR;
+    sqlite3_backup* backup = sqlite3_backup_init(snapshot, "main", source, "main");
+    if ( backup ) {
+        while ( ( res = sqlite3_backup_step(backup, BACKUP_STEP_PAGES) ) == SQLITE_OK || res == SQLITE_BUSY || res == SQLITE_LOCKED )
+            std::this_thread::sleep_for(std::chrono::milliseconds(BACKUP_STEP_SLEEP_MS));
+
+        sqlite3_backup_finish(backup);
+    }
+
+    sqlite3_exec(source, "COMMIT;", NULL, 0, nullptr);
+    sqlite3_close(source);
+
+    // a snapshot is a single file, without the database's write-ahead log
+    if ( res == SQLITE_DONE )
+        sqlite3_exec(snapshot, "PRAGMA journal_mode = DELETE;", NULL, 0, nullptr);
+
+    sqlite3_close(snapshot);
+
+    std::error_code err;
+    if ( res == SQLITE_DONE )
+        std::filesystem::rename(partial, path, err);
+
+    if ( res != SQLITE_DONE || err ) {
+        std::filesystem::remove(partial, err);
+        m_mainFrame->CallAfter([this, path, res] {
+            m_mainFrame->LogErrorMessage("Failed to write snapshot " + path + ": " + std::string(sqlite3_errstr(res)));
+        });
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Deletes the oldest snapshots of the database, keeping the newest `BACKUP_KEEP_COUNT`.
+ */
+void BackupService::RemoveOldSnapshots() {
+    const std::vector<BackupSnapshot> snapshots = GetSnapshots();
+
+    std::error_code err;
+    for ( size_t i = BACKUP_KEEP_COUNT; i < snapshots.size(); i++ )
+        std::filesystem::remove(snapshots[i].path, err);
+}
+
+/**
+ * @brief Lists every snapshot of the database.
+ *
+ * @return The snapshots, newest first.
+ */
+std::vector<BackupSnapshot> BackupService::GetSnapshots() {
+    std::vector<BackupSnapshot> snapshots = {};
+    const std::string prefix = SnapshotPrefix();
+
+    std::error_code err;
+    for ( const auto& entry : std::filesystem::directory_iterator(SnapshotFolder(), err) ) {
+        const std::string name = entry.path().filename().string();
+        if ( entry.path().extension() != ".db" || !name.starts_with(prefix) )
+            continue;
+
+        int year, month, day, hours, minutes, seconds;
+        if ( std::sscanf(name.c_str() + prefix.size(), "%4d%2d%2d-%2d%2d%2d", &year, &month, &day, &hours, &minutes, &seconds) != 6 )
+            continue;
+
+        BackupSnapshot snapshot = {};
+        snapshot.path = entry.path().string();
+        snapshot.taken = std::chrono::sys_days(std::chrono::year(year) / month / day) +
+            std::chrono::hours(hours) + std::chrono::minutes(minutes) + std::chrono::seconds(seconds);
+        snapshot.bytes = entry.file_size(err);
+        snapshots.push_back(snapshot);
+    }
+
+    // the same second can have more than one, "-2" sorts after the first
+    std::sort(snapshots.begin(), snapshots.end(), [](const BackupSnapshot& a, const BackupSnapshot& b) {
+        return ( a.taken != b.taken ) ? a.taken > b.taken : a.path > b.path;
+    });
+
+    return snapshots;
+}
+
+/**
+ * @brief Rewinds the database to a snapshot.
+ *
+ * The database is snapshotted as it is first, so the restore can itself be undone. Old
+ * snapshots aren't deleted until the next one, so the one being restored is still there.
+ *
+ * @param path The snapshot to restore.
+ * @return true if the database now holds the snapshot.
+ */
+bool BackupService::RestoreSnapshot(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+
+    if ( !WriteSnapshot(NewSnapshotPath()) ) {
+        m_mainFrame->LogErrorMessage("Not restoring, the database couldn't be backed up first.");
+        return false;
+    }
+
+    return m_db->RestoreFrom(path);
+}
+
+/**
+ * @brief Folder the database's snapshots are written to, `BACKUP_DIR` next to the database.
+ */
+std::string BackupService::SnapshotFolder() const {
+    return ( std::filesystem::path(m_db->GetPath()).parent_path() / BACKUP_DIR ).string();
+}
+
+/**
+ * @brief Start of the name of each of the database's snapshots, e.g "data-" for data.db.
+ */
+std::string BackupService::SnapshotPrefix() const {
+    return std::filesystem::path(m_db->GetPath()).stem().string() + "-";
+}
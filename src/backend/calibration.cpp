@@ -0,0 +1,202 @@
+#include "calibration.h"
+
+#include <algorithm> // std::sort, std::upper_bound
+#include <cmath> // std::exp, std::log, std::abs
+#include <numeric> // std::iota
+
+/**
+ * @brief Fits both calibrations to held out predictions.
+ *
+ * @param scores Vote fraction for class 1 of each prediction.
+ * @param labels Actual class of each prediction, 0 or 1.
+ * @return true if both classes appear and there are at least `CALIBRATION_MIN_POINTS`
+ *         predictions, otherwise false.
+ */
+bool Calibrator::Fit(const std::vector<double>& scores, const std::vector<size_t>& labels) {
+    m_fitted = false;
+    m_isotonicScores.clear();
+    m_isotonicValues.clear();
+
+    size_t positives = 0;
+    for ( size_t label : labels )
+        positives += ( label == 1 ) ? 1 : 0;
+
+    if ( scores.size() != labels.size() || scores.size() < CALIBRATION_MIN_POINTS || positives == 0 || positives == labels.size() )
+        return false;
+
+    FitPlatt(scores, labels);
+    FitIsotonic(scores, labels);
+
+    m_fitted = true;
+    return true;
+}
+
+/**
+ * @brief Calibrates a vote fraction.
+ *
+ * @param score Fraction of trees voting for class 1.
+ * @param method The calibration to apply. Ignored if the calibrator hasn't been fitted.
+ * @return The calibrated chance of class 1.
+ */
+double Calibrator::Apply(double score, CalibrationMethod method) const {
+    if ( !m_fitted || method == kCalibrationNone )
+        return score;
+
+    if ( method == kCalibrationPlatt )
+        return 1.0 / ( 1.0 + std::exp(m_plattA * score + m_plattB) );
+
+    // isotonic, flat past the first and last block
+    if ( score <= m_isotonicScores.front() )
+        return m_isotonicValues.front();
+    if ( score >= m_isotonicScores.back() )
+        return m_isotonicValues.back();
+
+    const size_t upper = std::upper_bound(m_isotonicScores.begin(), m_isotonicScores.end(), score) - m_isotonicScores.begin();
+    const size_t lower = upper - 1;
+    const double t = ( score - m_isotonicScores[lower] ) / ( m_isotonicScores[upper] - m_isotonicScores[lower] );
+
+    return m_isotonicValues[lower] + t * ( m_isotonicValues[upper] - m_isotonicValues[lower] );
+}
+
+/**
+ * @brief Fits the Platt sigmoid by Newton's method with a backtracking line search.
+ *
+ * Follows Lin, Lin and Weng's formulation, which uses smoothed targets so a perfectly
+ * separable set of scores doesn't push the sigmoid to a step.
+ *
+ * @param scores Vote fraction for class 1 of each prediction.
+ * @param labels Actual class of each prediction, 0 or 1.
+ */
+void Calibrator::FitPlatt(const std::vector<double>& scores, const std::vector<size_t>& labels) {
+    double positives = 0.0;
+    for ( size_t label : labels )
+        positives += ( label == 1 ) ? 1.0 : 0.0;
+    const double negatives = labels.size() - positives;
+
+    const double highTarget = ( positives + 1.0 ) / ( positives + 2.0 );
+    const double lowTarget = 1.0 / ( negatives + 2.0 );
+
+    // negative log likelihood of 'a' and 'b', computed without overflowing exp
+    auto Objective = [&](double a, double b) -> double {
+        double value = 0.0;
+        for ( size_t i = 0; i < scores.size(); i++ ) {
+            const double target = ( labels[i] == 1 ) ? highTarget : lowTarget;
+            const double x = scores[i] * a + b;
+            value += ( x >= 0.0 ) ? target * x + std::log(1.0 + std::exp(-x)) : ( target - 1.0 ) * x + std::log(1.0 + std::exp(x));
+        }
+
+        return value;
+    };
+
+    double a = 0.0;
+    double b = std::log(( negatives + 1.0 ) / ( positives + 1.0 ));
+    double value = Objective(a, b);
+
+    for ( int iteration = 0; iteration < CALIBRATION_PLATT_ITERATIONS; iteration++ ) {
+        // gradient and hessian, with a tiny ridge so the hessian stays invertible
+        double h11 = 1e-12, h22 = 1e-12, h21 = 0.0, g1 = 0.0, g2 = 0.0;
+        for ( size_t i = 0; i < scores.size(); i++ ) {
+            const double target = ( labels[i] == 1 ) ? highTarget : lowTarget;
+            const double x = scores[i] * a + b;
+            const double p = ( x >= 0.0 ) ? std::exp(-x) / ( 1.0 + std::exp(-x) ) : 1.0 / ( 1.0 + std::exp(x) );
+            const double q = 1.0 - p;
+
+            h11 += scores[i] * scores[i] * p * q;
+            h22 += p * q;
+            h21 += scores[i] * p * q;
+            g1 += scores[i] * ( target - p );
+            g2 += target - p;
+        }
+
+        if ( std::abs(g1) < 1e-5 && std::abs(g2) < 1e-5 )
+            break;
+
+        const double det = h11 * h22 - h21 * h21;
+        const double da = -( h22 * g1 - h21 * g2 ) / det;
+        const double db = -( -h21 * g1 + h11 * g2 ) / det;
+        const double slope = g1 * da + g2 * db;
+
+        double step = 1.0;
+        while ( step >= 1e-10 ) {
+            const double newValue = Objective(a + step * da, b + step * db);
+            if ( newValue < value + 1e-4 * step * slope ) {
+                a += step * da;
+                b += step * db;
+                value = newValue;
+                break;
+            }
+
+            step /= 2.0;
+        }
+
+        if ( step < 1e-10 ) // no step improves the fit
+            break;
+    }
+
+    m_plattA = a;
+    m_plattB = b;
+}
+
+/**
+ * @brief Fits the isotonic regression with pool adjacent violators.
+ *
+ * Predictions with the same score always share a block, so the fit is a function of the score.
+ *
+ * @param scores Vote fraction for class 1 of each prediction.
+ * @param labels Actual class of each prediction, 0 or 1.
+ */
+void Calibrator::FitIsotonic(const std::vector<double>& scores, const std::vector<size_t>& labels) {
+    std::vector<size_t> order(scores.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+
+    struct Block {
+        double scoreSum;
+        double labelSum;
+        double count;
+        double lastScore; // highest score in the block
+    };
+
+    std::vector<Block> blocks = {};
+    for ( size_t i : order ) {
+        const double label = ( labels[i] == 1 ) ? 1.0 : 0.0;
+        if ( !blocks.empty() && blocks.back().lastScore == scores[i] ) {
+            blocks.back().scoreSum += scores[i];
+            blocks.back().labelSum += label;
+            blocks.back().count += 1.0;
+        }
+        else {
+            blocks.push_back({ scores[i], label, 1.0, scores[i] });
+        }
+
+        // pool while the previous block has a higher rate than the last one
+        while ( blocks.size() > 1 ) {
+            const Block& last = blocks[blocks.size() - 1];
+            const Block& previous = blocks[blocks.size() - 2];
+            if ( previous.labelSum / previous.count <= last.labelSum / last.count )
+                break;
+
+            const Block pooled = {
+                previous.scoreSum + last.scoreSum,
+                previous.labelSum + last.labelSum,
+                previous.count + last.count,
+                last.lastScore
+            };
+            blocks.pop_back();
+            blocks.back() = pooled;
+        }
+    }
+
+    for ( const Block& block : blocks ) {
+        const double score = block.scoreSum / block.count;
+
+        // blocks can only share a mean score through rounding, keep the score increasing for interpolation
+        if ( !m_isotonicScores.empty() && score <= m_isotonicScores.back() ) {
+            m_isotonicValues.back() = block.labelSum / block.count;
+            continue;
+        }
+
+        m_isotonicScores.push_back(score);
+        m_isotonicValues.push_back(block.labelSum / block.count);
+    }
+}
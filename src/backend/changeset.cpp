@@ -0,0 +1,250 @@
+#include "changeset.h"
+
+/**
+ * @brief Encodes the changeset to bytes.
+ *
+ * @return The header, then each record: its kind, the row's name, and for an upsert its values.
+ */
+std::vector<uint8_t> Changeset::Encode() const {
+    std::vector<uint8_t> bytes = {};
+    ByteWriter writer(bytes);
+
+    writer.WriteVarint(CHANGESET_MAGIC);
+    writer.WriteVarint(CHANGESET_VERSION);
+    writer.WriteString(origin);
+    writer.WriteVarint(fromSeq);
+    writer.WriteVarint(toSeq);
+    writer.WriteVarint(records.size());
+
+    for ( const ChangeRecord& record : records )
+        WriteChangeRecord(writer, record);
+
+    return bytes;
+}
+
+/**
+ * @brief Decodes a changeset encoded with `Encode`.
+ *
+ * @param data The encoded changeset.
+ * @param size The number of bytes at 'data'.
+ * @param changeset Set to the decoded changeset.
+ * @return true if 'data' held a whole changeset of this version, otherwise false.
+ */
+bool Changeset::Decode(const uint8_t* data, size_t size, Changeset& changeset) {
+    ByteReader reader(data, size);
+    changeset = {};
+
+    uint64_t magic = 0, version = 0, count = 0;
+    if ( !reader.ReadVarint(magic) || !reader.ReadVarint(version) || magic != CHANGESET_MAGIC || version != CHANGESET_VERSION )
+        return false;
+
+    if ( !reader.ReadString(changeset.origin) || !reader.ReadVarint(changeset.fromSeq) ||
+         !reader.ReadVarint(changeset.toSeq) || !reader.ReadVarint(count) )
+        return false;
+
+    // every record takes at least two bytes, so a damaged count can't reserve more than the data could hold
+    if ( count > reader.Remaining() / 2 )
+        return false;
+    changeset.records.reserve(count);
+
+    for ( uint64_t i = 0; i < count; i++ ) {
+        ChangeRecord record = {};
+        if ( !ReadChangeRecord(reader, record) )
+            return false;
+
+        changeset.records.push_back(record);
+    }
+
+    return true;
+}
+
+ByteWriter::ByteWriter(std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+void ByteWriter::WriteByte(uint8_t value) {
+    m_bytes.push_back(value);
+}
+
+/**
+ * @brief Writes an unsigned integer 7 bits at a time, low bits first, with the top bit set on every byte but the last.
+ *
+ * @param value The integer to write.
+ */
+void ByteWriter::WriteVarint(uint64_t value) {
+    while ( value >= 0x80 ) {
+        m_bytes.push_back(static_cast< uint8_t >( value | 0x80 ));
+        value >>= 7;
+    }
+
+    m_bytes.push_back(static_cast< uint8_t >( value ));
+}
+
+void ByteWriter::WriteSigned(int64_t value) {
+    WriteVarint(( static_cast< uint64_t >( value ) << 1 ) ^ static_cast< uint64_t >( value >> 63 ));
+}
+
+void ByteWriter::WriteString(const std::string& value) {
+    WriteVarint(value.size());
+    m_bytes.insert(m_bytes.end(), value.begin(), value.end());
+}
+
+void ByteWriter::WriteBytes(const std::vector<uint8_t>& value) {
+    m_bytes.insert(m_bytes.end(), value.begin(), value.end());
+}
+
+ByteReader::ByteReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+bool ByteReader::ReadByte(uint8_t& value) {
+    if ( m_offset >= m_size )
+        return false;
+
+    value = m_data[m_offset++];
+    return true;
+}
+
+/**
+ * @brief Reads an integer written by `ByteWriter::WriteVarint`.
+ *
+ * @param value Set to the integer read.
+ * @return false if the data ends mid integer or the integer doesn't fit in 64 bits.
+ */
+bool ByteReader::ReadVarint(uint64_t& value) {
+    value = 0;
+    for ( int shift = 0; shift < 64; shift += 7 ) {
+        uint8_t byte = 0;
+        if ( !ReadByte(byte) )
+            return false;
+
+        value |= static_cast< uint64_t >( byte & 0x7F ) << shift;
+        if ( ( byte & 0x80 ) == 0 )
+            return true;
+    }
+
+    return false;
+}
+
+bool ByteReader::ReadSigned(int64_t& value) {
+    uint64_t encoded = 0;
+    if ( !ReadVarint(encoded) )
+        return false;
+
+    value = static_cast< int64_t >( encoded >> 1 ) ^ -static_cast< int64_t >( encoded & 1 );
+    return true;
+}
+
+bool ByteReader::ReadString(std::string& value) {
+    uint64_t length = 0;
+    if ( !ReadVarint(length) || length > Remaining() )
+        return false;
+
+    value.assign(reinterpret_cast< const char* >( m_data + m_offset ), static_cast< size_t >( length ));
+    m_offset += static_cast< size_t >( length );
+    return true;
+}
+
+/**
+ * @brief Writes one record of a changeset: its kind, the row's name, and for an upsert its values.
+ *
+ * @param writer Where to write the record.
+ * @param record The record to write.
+ */
+void WriteChangeRecord(ByteWriter& writer, const ChangeRecord& record) {
+    writer.WriteByte(record.kind);
+
+    if ( record.kind == kChangeTeamUpsert || record.kind == kChangeTeamDelete ) {
+        writer.WriteSigned(record.team.teamNum);
+        writer.WriteSigned(record.team.matchNum);
+        writer.WriteString(record.scout);
+
+        if ( record.kind == kChangeTeamDelete )
+            return;
+
+        const Team& team = record.team;
+        writer.WriteByte(( team.hangAttempt ? 1 : 0 ) | ( team.hangSuccess ? 2 : 0 ));
+        for ( uint16_t stat : { team.robotCycleSpeed, team.coralPoints, team.defense, team.autonomousPoints,
+                                team.driverSkill, team.penaltys, team.overall, team.rankingPoints } )
+            writer.WriteVarint(stat);
+    }
+    else {
+        writer.WriteSigned(record.match.matchNum);
+
+        if ( record.kind == kChangeMatchDelete )
+            return;
+
+        writer.WriteByte(( record.match.redWin ? 1 : 0 ) | ( record.match.blueWin ? 2 : 0 ));
+        for ( int team : record.match.teams )
+            writer.WriteSigned(team);
+    }
+}
+
+/**
+ * @brief Reads a record written by `WriteChangeRecord`.
+ *
+ * @param reader Where to read the record from.
+ * @param record Set to the record read.
+ * @return false if the data ends mid record or holds an unknown kind of record.
+ */
+bool ReadChangeRecord(ByteReader& reader, ChangeRecord& record) {
+    record = {};
+    uint8_t kind = 0, flags = 0;
+    int64_t value = 0;
+
+    if ( !reader.ReadByte(kind) )
+        return false;
+    record.kind = static_cast< ChangeKind >( kind );
+
+    if ( kind == kChangeTeamUpsert || kind == kChangeTeamDelete ) {
+        if ( !reader.ReadSigned(value) )
+            return false;
+        record.team.teamNum = static_cast< int >( value );
+        if ( !reader.ReadSigned(value) )
+            return false;
+        record.team.matchNum = static_cast< int >( value );
+        if ( !reader.ReadString(record.scout) )
+            return false;
+
+        if ( kind == kChangeTeamDelete )
+            return true;
+
+        if ( !reader.ReadByte(flags) )
+            return false;
+        record.team.hangAttempt = ( flags & 1 ) != 0;
+        record.team.hangSuccess = ( flags & 2 ) != 0;
+
+        Team& team = record.team;
+        for ( uint16_t* stat : { &team.robotCycleSpeed, &team.coralPoints, &team.defense, &team.autonomousPoints,
+                                 &team.driverSkill, &team.penaltys, &team.overall, &team.rankingPoints } ) {
+            uint64_t statValue = 0;
+            if ( !reader.ReadVarint(statValue) )
+                return false;
+            *stat = static_cast< uint16_t >( statValue );
+        }
+
+        return true;
+    }
+
+    if ( kind == kChangeMatchUpsert || kind == kChangeMatchDelete ) {
+        if ( !reader.ReadSigned(value) )
+            return false;
+        record.match.matchNum = static_cast< int >( value );
+
+        if ( kind == kChangeMatchDelete )
+            return true;
+
+        if ( !reader.ReadByte(flags) )
+            return false;
+        record.match.redWin = ( flags & 1 ) != 0;
+        record.match.blueWin = ( flags & 2 ) != 0;
+
+        for ( int& team : record.match.teams ) {
+            if ( !reader.ReadSigned(value) )
+                return false;
+            team = static_cast< int >( value );
+            if ( team != 0 )
+                record.match.teamCount++;
+        }
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,323 @@
+#include "compactforest.h"
+
+#include <algorithm> // std::min
+#include <fstream> // std::ifstream, std::ofstream
+#include <limits> // std::numeric_limits
+
+namespace {
+    // Writes the bytes of a trivially copyable value
+    template<typename T>
+    void WriteValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast< const char* >( &value ), sizeof(T));
+    }
+
+    // Reads the bytes of a trivially copyable value, false at the end of the file
+    template<typename T>
+    bool ReadValue(std::ifstream& file, T& value) {
+        return static_cast< bool >( file.read(reinterpret_cast< char* >( &value ), sizeof(T)) );
+    }
+}
+
+/**
+ * @brief Builds a compact copy of a forest.
+ *
+ * @param forest The forest to copy.
+ * @param features Points the quantization grid is fitted to, one per column. Normally the
+ *                 forest's training set, so every split falls inside the grid.
+ * @return The compact forest, or nullptr if it has more than 255 features or classes,
+ *         a tree with more than 65535 nodes, or a split that isn't binary.
+ */
+template<typename Level>
+std::shared_ptr<CompactForest<Level>> CompactForest<Level>::Build(const Forest& forest, const arma::mat& features) {
+    if ( features.n_rows > std::numeric_limits<uint8_t>::max() || forest.NumClasses() > std::numeric_limits<uint8_t>::max() )
+        return nullptr;
+
+    std::shared_ptr<CompactForest> compact = std::make_shared<CompactForest>();
+    compact->m_numClasses = static_cast< uint32_t >( forest.NumClasses() );
+    compact->m_offsets.assign(features.n_rows, 0.0);
+    compact->m_scales.assign(features.n_rows, 0.0);
+
+    for ( arma::uword feature = 0; feature < features.n_rows && features.n_cols > 0; feature++ ) {
+        const double low = features.row(feature).min();
+        const double high = features.row(feature).max();
+
+        compact->m_offsets[feature] = low;
+        if ( high > low )
+            compact->m_scales[feature] = std::numeric_limits<Level>::max() / ( high - low );
+    }
+
+    for ( const Forest::Tree& tree : forest.Trees() ) {
+        compact->m_roots.push_back(static_cast< uint32_t >( compact->m_nodes.size() ));
+        if ( !compact->AppendTree(tree, features.n_rows) )
+            return nullptr;
+    }
+
+    compact->m_nodes.shrink_to_fit();
+    return compact;
+}
+
+/**
+ * @brief Flattens a tree onto the end of the node array, depth first.
+ *
+ * @param node Root of the tree, or subtree, to flatten.
+ * @param featureCount The number of features a point has.
+ * @return true if the tree was flattened, false if it can't be packed.
+ */
+template<typename Level>
+bool CompactForest<Level>::AppendTree(const Forest::Tree& node, size_t featureCount) {
+    const size_t index = m_nodes.size();
+    m_nodes.push_back({ 0, 0, 0 });
+
+    if ( node.NumChildren() == 0 ) {
+        // a leaf votes for its majority class whatever the point
+        const arma::vec anyPoint(featureCount, arma::fill::zeros);
+        m_nodes[index].feature = static_cast< uint8_t >( node.Classify(anyPoint) );
+        return true;
+    }
+
+    if ( node.NumChildren() != 2 )
+        return false;
+
+    const size_t feature = node.SplitDimension();
+    m_nodes[index].feature = static_cast< uint8_t >( feature );
+    m_nodes[index].threshold = FindThreshold(node, feature, featureCount);
+
+    if ( !AppendTree(node.Child(0), featureCount) )
+        return false;
+
+    const size_t right = m_nodes.size() - index;
+    if ( right > std::numeric_limits<uint16_t>::max() )
+        return false;
+    m_nodes[index].right = static_cast< uint16_t >( right );
+
+    return AppendTree(node.Child(1), featureCount);
+}
+
+/**
+ * @brief Finds the first grid level a split sends right.
+ *
+ * The split is only asked which way a value goes, so this doesn't depend on how mlpack
+ * stores it. Binary numeric splits send values up to their split point left, so the
+ * direction only changes once along the grid and a binary search finds it.
+ *
+ * @param node The split.
+ * @param feature The feature it splits on.
+ * @param featureCount The number of features a point has.
+ * @return The lowest level sent right, or the highest level if every level goes left.
+ */
+template<typename Level>
+Level CompactForest<Level>::FindThreshold(const Forest::Tree& node, size_t feature, size_t featureCount) const {
+    arma::vec probe(featureCount, arma::fill::zeros);
+
+    size_t low = 0;
+    size_t high = static_cast< size_t >( std::numeric_limits<Level>::max() ) + 1;
+    while ( low < high ) {
+        const size_t mid = low + ( high - low ) / 2;
+        probe(feature) = LevelValue(feature, mid);
+
+        if ( node.CalculateDirection(probe) != 0 )
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return static_cast< Level >( std::min<size_t>(low, std::numeric_limits<Level>::max()) );
+}
+
+/**
+ * @param feature The feature the level belongs to.
+ * @param level A level of the feature's grid.
+ * @return The lowest value quantized to 'level'.
+ */
+template<typename Level>
+double CompactForest<Level>::LevelValue(size_t feature, size_t level) const {
+    if ( m_scales[feature] == 0.0 )
+        return m_offsets[feature];
+
+    return m_offsets[feature] + static_cast< double >( level ) / m_scales[feature];
+}
+
+/**
+ * @param feature The feature the value belongs to.
+ * @param value A value of the feature.
+ * @return The grid level of 'value', clamped to the grid.
+ */
+template<typename Level>
+Level CompactForest<Level>::Quantize(size_t feature, double value) const {
+    const double scaled = ( value - m_offsets[feature] ) * m_scales[feature];
+    if ( !( scaled > 0.0 ) )
+        return 0;
+    if ( scaled >= std::numeric_limits<Level>::max() )
+        return std::numeric_limits<Level>::max();
+
+    return static_cast< Level >( scaled );
+}
+
+/**
+ * @brief Predicts the class of several points along with how the trees voted.
+ *
+ * @param points The points to classify, one per column.
+ * @param predictions Set to the class of each point. Ties go to the lower class.
+ * @param probabilities Set to the fraction of trees that voted for each class, one column per point.
+ */
+template<typename Level>
+void CompactForest<Level>::Classify(const arma::mat& points, arma::Row<size_t>& predictions, arma::mat& probabilities) const {
+    predictions.set_size(points.n_cols);
+    probabilities.zeros(m_numClasses, points.n_cols);
+
+    std::vector<Level> levels(m_offsets.size());
+    for ( arma::uword col = 0; col < points.n_cols; col++ ) {
+        for ( size_t feature = 0; feature < levels.size(); feature++ )
+            levels[feature] = Quantize(feature, points(feature, col));
+
+        for ( uint32_t root : m_roots ) {
+            const Node* node = &m_nodes[root];
+            while ( node->right != 0 )
+                node += ( levels[node->feature] >= node->threshold ) ? node->right : 1;
+
+            probabilities(node->feature, col) += 1.0;
+        }
+
+        if ( !m_roots.empty() )
+            probabilities.col(col) /= static_cast< double >( m_roots.size() );
+
+        predictions(col) = probabilities.col(col).index_max();
+    }
+}
+
+/**
+ * @brief Compares the predictions of this forest with the forest it was built from.
+ *
+ * @param forest The full forest.
+ * @param points The points to compare on, one per column. Ideally ones neither forest was trained on.
+ * @param labels Actual class of each point.
+ * @return How closely the two forests agree, and how accurate each is.
+ */
+template<typename Level>
+CompactParity CompactForest<Level>::CheckParity(const Forest& forest, const arma::mat& points, const arma::Row<size_t>& labels) const {
+    CompactParity parity = {};
+    if ( points.n_cols == 0 )
+        return parity;
+
+    arma::Row<size_t> fullPredictions, compactPredictions;
+    arma::mat fullVotes, compactVotes;
+    forest.Classify(points, fullPredictions, fullVotes);
+    Classify(points, compactPredictions, compactVotes);
+
+    const double count = static_cast< double >( points.n_cols );
+    parity.agreement = arma::accu(fullPredictions == compactPredictions) / count;
+    parity.fullAccuracy = arma::accu(fullPredictions == labels) / count;
+    parity.compactAccuracy = arma::accu(compactPredictions == labels) / count;
+
+    if ( fullVotes.n_rows == compactVotes.n_rows )
+        parity.maxVoteDifference = arma::abs(fullVotes - compactVotes).max();
+
+    return parity;
+}
+
+/**
+ * @return Bytes taken by the nodes, roots and quantization grid.
+ */
+template<typename Level>
+size_t CompactForest<Level>::MemoryBytes() const {
+    return m_nodes.size() * sizeof(Node) +
+        m_roots.size() * sizeof(uint32_t) +
+        ( m_offsets.size() + m_scales.size() ) * sizeof(double);
+}
+
+/**
+ * @brief Saves the forest as its raw arrays.
+ *
+ * Nodes are written field by field, so the file doesn't depend on struct padding.
+ *
+ * @param path The file to write.
+ * @return true if the file was written, otherwise false.
+ */
+template<typename Level>
+bool CompactForest<Level>::Save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if ( !file )
+        return false;
+
+    WriteValue(file, static_cast< uint32_t >( COMPACT_FOREST_MAGIC ));
+    WriteValue(file, static_cast< uint32_t >( COMPACT_FOREST_VERSION ));
+    WriteValue(file, static_cast< uint32_t >( sizeof(Level) ));
+    WriteValue(file, m_numClasses);
+
+    WriteValue(file, static_cast< uint32_t >( m_offsets.size() ));
+    file.write(reinterpret_cast< const char* >( m_offsets.data() ), m_offsets.size() * sizeof(double));
+    file.write(reinterpret_cast< const char* >( m_scales.data() ), m_scales.size() * sizeof(double));
+
+    WriteValue(file, static_cast< uint32_t >( m_roots.size() ));
+    file.write(reinterpret_cast< const char* >( m_roots.data() ), m_roots.size() * sizeof(uint32_t));
+
+    WriteValue(file, static_cast< uint32_t >( m_nodes.size() ));
+    for ( const Node& node : m_nodes ) {
+        WriteValue(file, node.right);
+        WriteValue(file, node.threshold);
+        WriteValue(file, node.feature);
+    }
+
+    return static_cast< bool >( file );
+}
+
+/**
+ * @brief Loads a forest saved with `Save`.
+ *
+ * @param path The file to read.
+ * @return The forest, or nullptr if the file is missing, from another version,
+ *         quantized to a different number of bits, or damaged.
+ */
+template<typename Level>
+std::shared_ptr<CompactForest<Level>> CompactForest<Level>::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if ( !file )
+        return nullptr;
+
+    uint32_t magic = 0, version = 0, levelBytes = 0;
+    if ( !ReadValue(file, magic) || !ReadValue(file, version) || !ReadValue(file, levelBytes) )
+        return nullptr;
+    if ( magic != COMPACT_FOREST_MAGIC || version != COMPACT_FOREST_VERSION || levelBytes != sizeof(Level) )
+        return nullptr;
+
+    std::shared_ptr<CompactForest> compact = std::make_shared<CompactForest>();
+    uint32_t featureCount = 0, treeCount = 0, nodeCount = 0;
+
+    if ( !ReadValue(file, compact->m_numClasses) || !ReadValue(file, featureCount) )
+        return nullptr;
+
+    compact->m_offsets.resize(featureCount);
+    compact->m_scales.resize(featureCount);
+    file.read(reinterpret_cast< char* >( compact->m_offsets.data() ), featureCount * sizeof(double));
+    file.read(reinterpret_cast< char* >( compact->m_scales.data() ), featureCount * sizeof(double));
+
+    if ( !ReadValue(file, treeCount) )
+        return nullptr;
+    compact->m_roots.resize(treeCount);
+    file.read(reinterpret_cast< char* >( compact->m_roots.data() ), treeCount * sizeof(uint32_t));
+
+    if ( !ReadValue(file, nodeCount) )
+        return nullptr;
+    compact->m_nodes.resize(nodeCount);
+    for ( Node& node : compact->m_nodes ) {
+        if ( !ReadValue(file, node.right) || !ReadValue(file, node.threshold) || !ReadValue(file, node.feature) )
+            return nullptr;
+    }
+
+    // a damaged file mustn't send a walk outside the arrays
+    for ( uint32_t root : compact->m_roots ) {
+        if ( root >= nodeCount )
+            return nullptr;
+    }
+    for ( size_t i = 0; i < compact->m_nodes.size(); i++ ) {
+        const Node& node = compact->m_nodes[i];
+        const bool leaf = ( node.right == 0 );
+        if ( leaf ? node.feature >= compact->m_numClasses : ( node.feature >= featureCount || i + node.right >= nodeCount ) )
+            return nullptr;
+    }
+
+    return compact;
+}
+
+template class CompactForest<uint8_t>;
+template class CompactForest<uint16_t>;
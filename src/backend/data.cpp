@@ -4,7 +4,10 @@
 #include "team.h" // Team struct
 #include "match.h" // Match struct
 
-#include <filesystem> // filesystem::exists
+#include <algorithm> // std::find
+#include <array> // std::array
+#include <chrono> // std::chrono::steady_clock, std::chrono::milliseconds
+#include <filesystem> // filesystem::exists, filesystem::equivalent
 #include <iostream> // cout
 #include <fstream> // std::ofstream
 #include <string> // std::string
@@ -13,6 +16,63 @@
 #include <qrcodegen.hpp>
 #include <stb_image_write.h>
 
+namespace {
+    // Columns of a scouted row holding what was scouted, in the order they're stored
+    const std::array<const char*, 10> kTeamStatColumns = {
+        "hangAttempt", "hangSuccess", "robotCycleSpeed", "coralPoints", "defense",
+        "autonomousPoints", "driverSkill", "penaltys", "overall", "rankingPoints"
+    };
+
+    // Columns of a match holding the team in each station
+    const std::array<const char*, 6> kMatchStationColumns = { "team1", "team2", "team3", "team4", "team5", "team6" };
+
+    // Columns of the team list view, in the order `AddTeamListColumns` adds them
+    const std::array<const char*, 12> kTeamListColumns = {
+        "teamNum", "matchNum", "overall", "hangAttempt", "hangSuccess", "robotCycleSpeed",
+        "coralPoints", "defense", "autonomousPoints", "driverSkill", "penaltys", "rankingPoints"
+    };
+
+    // Columns of the match list view, in the order `AddMatchListColumns` adds them
+    const std::array<const char*, 9> kMatchListColumns = {
+        "matchNum", "redWin", "blueWin", "team1", "team2", "team3", "team4", "team5", "team6"
+    };
+
+    // "1, 2, 3", for an IN list of numbers
+    std::string JoinNumbers(const std::vector<int>& numbers) {
+        std::string joined = "";
+        for ( int number : numbers ) {
+            if ( !joined.empty() )
+                joined += ", ";
+            joined += std::to_string(number);
+        }
+
+        return joined;
+    }
+
+    // snapshot the thread is reading through, innermost first, whichever DataBase it belongs to
+    thread_local DataBase::ReadSnapshot* t_snapshot = nullptr;
+
+    /**
+     * @brief Formats each column and joins them, e.g "s.overall, s.defense" or "t.overall IS NOT s.overall OR ...".
+     *
+     * @param columns The column names.
+     * @param format Format of each column, with the name as argument {0}.
+     * @param separator Put between formatted columns.
+     * @return The joined columns.
+     */
+    template<size_t N>
+    std::string JoinColumns(const std::array<const char*, N>& columns, const std::string& format, const std::string& separator) {
+        std::string joined = "";
+        for ( const char* column : columns ) {
+            if ( !joined.empty() )
+                joined += separator;
+            joined += std::vformat(format, std::make_format_args(column));
+        }
+
+        return joined;
+    }
+}
+
 /**
  * @brief Constructs a DataBase object and initializes the database.
  *
@@ -64,7 +124,14 @@ void DataBase::CreateTables() {
     }
 
     NewTeamTable();
+    UpgradeTeamTable();
     NewMatchesTable();
+    NewRatingsTable();
+    NewChangeLog();
+    NewSyncTable();
+    NewUidSequence();
+    NewEventInfoTable();
+    NewDataEvents();
 }
 
 /**
@@ -83,6 +150,11 @@ void DataBase::Connect() {
         exit(-1);
     }
 
+    // readers don't block the writer in WAL mode, nor it them
+    sqlite3_exec(m_db, "PRAGMA journal_mode=WAL", NULL, 0, nullptr);
+    sqlite3_exec(m_db, "PRAGMA synchronous=NORMAL", NULL, 0, nullptr);
+    sqlite3_busy_timeout(m_db, DB_BUSY_TIMEOUT_MS);
+
     std::cout << "Connected to SQL DB" << std::endl;
     m_connected = true;
 }
@@ -95,6 +167,7 @@ void DataBase::Connect() {
 void DataBase::Disconnect() {
     std::cout << "Disconnecting from SQL DB" << std::endl;
 
+    CloseReaders();
     sqlite3_close(m_db);
     m_connected = false;
 }
@@ -121,6 +194,7 @@ void DataBase::NewTeamTable() {
         "penaltys INTEGER, "
         "overall INTEGER, "
         "rankingPoints INTEGER, "
+        "scout TEXT NOT NULL DEFAULT '', "
         "PRIMARY KEY (uid, teamNUm)"
         ");";
 
@@ -134,6 +208,32 @@ void DataBase::NewTeamTable() {
     std::cout << "Created blank team table." << std::endl;
 }
 
+/**
+ * @brief Brings a teams table created by an older version up to date.
+ *
+ * Adds the `scout` column, which records whose database a merged row came from
+ * (empty for rows entered here), and the index merges look observations up by.
+ */
+void DataBase::UpgradeTeamTable() {
+    if ( !ColumnExists("main", TEAM_TABLE, "scout") ) {
+        const char* query = "ALTER TABLE " TEAM_TABLE " ADD COLUMN scout TEXT NOT NULL DEFAULT ''";
+        if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+            std::cout << "Failed to add scout column to team table. Aborting." << std::endl;
+            exit(-1);
+        }
+
+        AddQueryToHistory(query);
+    }
+
+    const char* query = "CREATE INDEX IF NOT EXISTS TeamObservations ON " TEAM_TABLE " (teamNum, matchNum, scout)";
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to index team table. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+}
+
 /**
  * @brief Creates the matches table in the database.
  *
@@ -164,6 +264,379 @@ void DataBase::NewMatchesTable() {
     std::cout << "Created blank matches table." << std::endl;
 }
 
+/**
+ * @brief Creates the ratings table in the database.
+ *
+ * This function creates a table to store the rating each team had after every
+ * match it played. The table is created only if it does not already exist.
+ */
+void DataBase::NewRatingsTable() {
+    const char* query =
+        "CREATE TABLE IF NOT EXISTS " RATING_TABLE " ("
+        "teamNum INTEGER, "
+        "matchNum INTEGER, "
+        "rating REAL, "
+        "PRIMARY KEY (teamNum, matchNum)"
+        ");";
+
+    int res = sqlite3_exec(m_db, query, NULL, 0, nullptr);
+    if ( res != SQLITE_OK ) {
+        std::cout << "Failed to create table. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+    std::cout << "Created blank ratings table." << std::endl;
+}
+
+/**
+ * @brief Creates the change log table and the triggers that log every write to the teams and matches tables.
+ *
+ * Each write logs the key of the row it touched (team number, match number and scout for a
+ * scouted row, match number for a match) with an increasing sequence number. The row itself
+ * is read when changes are sent, so only the latest entry of each row is ever needed, and the
+ * older ones are dropped by `CompactChangeLog`. Rows already in the database when the log is
+ * first created are logged straight away, so they're sent on the first sync too.
+ *
+ * Writes made by applying another station's changes are marked with that station as their
+ * origin, so they aren't sent straight back to it.
+ */
+void DataBase::NewChangeLog() {
+    const bool existed = TableExists(CHANGE_TABLE);
+
+    const char* query =
+        "CREATE TABLE IF NOT EXISTS " CHANGE_TABLE " ("
+        "seq INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "tableName TEXT NOT NULL, "
+        "teamNum INTEGER NOT NULL DEFAULT 0, "
+        "matchNum INTEGER NOT NULL DEFAULT 0, "
+        "scout TEXT NOT NULL DEFAULT '', "
+        "origin TEXT NOT NULL DEFAULT ''"
+        ");"
+
+        "CREATE TRIGGER IF NOT EXISTS LogTeamInsert AFTER INSERT ON " TEAM_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, teamNum, matchNum, scout) VALUES ('" TEAM_TABLE "', NEW.teamNum, NEW.matchNum, NEW.scout); "
+        "END;"
+
+        // a row moved to another team, match or scout is gone from its old key
+        "CREATE TRIGGER IF NOT EXISTS LogTeamUpdate AFTER UPDATE ON " TEAM_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, teamNum, matchNum, scout) "
+        "SELECT '" TEAM_TABLE "', OLD.teamNum, OLD.matchNum, OLD.scout "
+        "WHERE OLD.teamNum IS NOT NEW.teamNum OR OLD.matchNum IS NOT NEW.matchNum OR OLD.scout IS NOT NEW.scout; "
+        "INSERT INTO " CHANGE_TABLE " (tableName, teamNum, matchNum, scout) VALUES ('" TEAM_TABLE "', NEW.teamNum, NEW.matchNum, NEW.scout); "
+        "END;"
+
+        "CREATE TRIGGER IF NOT EXISTS LogTeamDelete AFTER DELETE ON " TEAM_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, teamNum, matchNum, scout) VALUES ('" TEAM_TABLE "', OLD.teamNum, OLD.matchNum, OLD.scout); "
+        "END;"
+
+        "CREATE TRIGGER IF NOT EXISTS LogMatchInsert AFTER INSERT ON " MATCH_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, matchNum) VALUES ('" MATCH_TABLE "', NEW.matchNum); "
+        "END;"
+
+        "CREATE TRIGGER IF NOT EXISTS LogMatchUpdate AFTER UPDATE ON " MATCH_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, matchNum) SELECT '" MATCH_TABLE "', OLD.matchNum WHERE OLD.matchNum IS NOT NEW.matchNum; "
+        "INSERT INTO " CHANGE_TABLE " (tableName, matchNum) VALUES ('" MATCH_TABLE "', NEW.matchNum); "
+        "END;"
+
+        "CREATE TRIGGER IF NOT EXISTS LogMatchDelete AFTER DELETE ON " MATCH_TABLE " BEGIN "
+        "INSERT INTO " CHANGE_TABLE " (tableName, matchNum) VALUES ('" MATCH_TABLE "', OLD.matchNum); "
+        "END;";
+
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create change log. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+
+    if ( existed ) {
+        CompactChangeLog();
+        return;
+    }
+
+    const char* seed =
+        "INSERT INTO " CHANGE_TABLE " (tableName, matchNum) SELECT '" MATCH_TABLE "', matchNum FROM " MATCH_TABLE ";"
+        "INSERT INTO " CHANGE_TABLE " (tableName, teamNum, matchNum, scout) "
+        "SELECT DISTINCT '" TEAM_TABLE "', teamNum, matchNum, scout FROM " TEAM_TABLE ";";
+
+    sqlite3_exec(m_db, seed, NULL, 0, nullptr);
+    AddQueryToHistory(seed);
+}
+
+/**
+ * @brief Creates the sync state table and names this station the first time it's created.
+ *
+ * The table holds one row per station: this one, marked by `self`, and every peer it has
+ * synced with, with the last change log entry sent to it and the last of its entries applied here.
+ */
+void DataBase::NewSyncTable() {
+    const char* query =
+        "CREATE TABLE IF NOT EXISTS " SYNC_TABLE " ("
+        "station TEXT PRIMARY KEY, "
+        "self INTEGER NOT NULL DEFAULT 0, "
+        "sentSeq INTEGER NOT NULL DEFAULT 0, "
+        "receivedSeq INTEGER NOT NULL DEFAULT 0"
+        ");";
+
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create sync table. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT station FROM " SYNC_TABLE " WHERE self = 1", -1, &stmt, nullptr) == SQLITE_OK ) {
+        if ( sqlite3_step(stmt) == SQLITE_ROW )
+            m_stationName = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+        sqlite3_finalize(stmt);
+    }
+
+    if ( !m_stationName.empty() )
+        return;
+
+    // every laptop's database is called data.db, so name the station randomly instead
+    std::random_device rd;
+    m_stationName = std::format("station-{:08x}", rd());
+
+    if ( sqlite3_prepare_v2(m_db, "INSERT INTO " SYNC_TABLE " (station, self) VALUES (?1, 1)", -1, &stmt, nullptr) == SQLITE_OK ) {
+        sqlite3_bind_text(stmt, 1, m_stationName.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+}
+
+/**
+ * @brief Creates the uid sequence table, the first time picking the uid prefix of this station.
+ *
+ * Every uid this station hands out starts with its prefix, picked from its name, so rows
+ * scouted on different stations are unlikely to share a uid even before they're merged.
+ * The sequence starts after the highest uid already using the prefix, and a trigger moves
+ * it past any uid written without reserving it, so a reserved uid is never in use.
+ */
+void DataBase::NewUidSequence() {
+    const std::string query = std::format(
+        "CREATE TABLE IF NOT EXISTS " UID_TABLE " ("
+        "prefix INTEGER NOT NULL, "
+        "nextUid INTEGER NOT NULL"
+        ");"
+
+        "CREATE TRIGGER IF NOT EXISTS KeepUidSequenceAhead AFTER INSERT ON " TEAM_TABLE " BEGIN "
+        "UPDATE " UID_TABLE " SET nextUid = NEW.uid + 1 WHERE NEW.uid >= nextUid AND NEW.uid < (prefix + 1) << {}; "
+        "END;",
+        UID_SEQUENCE_BITS
+    );
+
+    if ( sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create uid sequence. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+
+    // 1-254, so the highest uid still fits in an int
+    const int prefix = static_cast< int >( std::hash<std::string>{}( m_stationName ) % 254 ) + 1;
+
+    const std::string seed = std::format(
+        "INSERT INTO " UID_TABLE " (prefix, nextUid) "
+        "SELECT ?1, IFNULL((SELECT MAX(uid) + 1 FROM " TEAM_TABLE " WHERE uid >= ?1 << {0} AND uid < (?1 + 1) << {0}), ?1 << {0}) "
+        "WHERE NOT EXISTS (SELECT 1 FROM " UID_TABLE ")",
+        UID_SEQUENCE_BITS
+    );
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, seed.c_str(), -1, &stmt, nullptr) == SQLITE_OK ) {
+        sqlite3_bind_int(stmt, 1, prefix);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+}
+
+/**
+ * @brief Creates the event info table, and reads the key of the event this database scouts.
+ *
+ * A database is labeled with its event once, so a copy of it carried to another laptop
+ * still knows which event its rows are from.
+ */
+void DataBase::NewEventInfoTable() {
+    const char* query =
+        "CREATE TABLE IF NOT EXISTS " EVENT_INFO_TABLE " ("
+        "eventKey TEXT NOT NULL"
+        ");";
+
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create event info table. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    AddQueryToHistory(query);
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT eventKey FROM " EVENT_INFO_TABLE " LIMIT 1", -1, &stmt, nullptr) == SQLITE_OK ) {
+        if ( sqlite3_step(stmt) == SQLITE_ROW )
+            m_eventKey = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+        sqlite3_finalize(stmt);
+    }
+}
+
+/**
+ * @brief Labels this database with the event it scouts.
+ *
+ * Only the first label sticks, a database can't move to another event.
+ *
+ * @param eventKey Key of the event, e.g "2025onto".
+ */
+void DataBase::SetEventKey(const std::string& eventKey) {
+    if ( !m_eventKey.empty() ) {
+        if ( m_eventKey != eventKey )
+            m_mainFrame->LogErrorMessage(std::format("{} is scouting event {}, not {}.", m_dbPath, m_eventKey, eventKey));
+        return;
+    }
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "INSERT INTO " EVENT_INFO_TABLE " (eventKey) VALUES (?1)", -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return;
+    }
+
+    sqlite3_bind_text(stmt, 1, eventKey.c_str(), -1, SQLITE_TRANSIENT);
+    AddQueryToHistory(stmt);
+
+    if ( sqlite3_step(stmt) == SQLITE_DONE )
+        m_eventKey = eventKey;
+
+    sqlite3_finalize(stmt);
+}
+
+/**
+ * @brief Creates the triggers that report every write to the teams and matches tables.
+ *
+ * The triggers are temporary, they only live on this connection, and call `data_event`
+ * with the table, the row's key (uid of a scouted row, match number of a match) and what
+ * happened to it. A row whose key changed is reported as gone under its old key.
+ *
+ * The writes are only delivered once the transaction they were made in commits, which the
+ * commit and rollback hooks report. Savepoints aren't reported by SQLite, so they're made
+ * with `BeginSavepoint`, `ReleaseSavepoint` and `RollbackSavepoint`.
+ */
+void DataBase::NewDataEvents() {
+    if ( sqlite3_create_function_v2(m_db, "data_event", 3, SQLITE_UTF8, this, &DataBase::RecordDataEvent, nullptr, nullptr, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create data_event function. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    const std::string inserted = std::to_string(kDataInserted);
+    const std::string updated = std::to_string(kDataUpdated);
+    const std::string deleted = std::to_string(kDataDeleted);
+
+    const std::string query =
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventTeamInsert AFTER INSERT ON main." TEAM_TABLE " BEGIN "
+        "SELECT data_event('" TEAM_TABLE "', NEW.uid, " + inserted + "); "
+        "END;"
+
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventTeamUpdate AFTER UPDATE ON main." TEAM_TABLE " BEGIN "
+        "SELECT data_event('" TEAM_TABLE "', OLD.uid, " + deleted + ") WHERE OLD.uid IS NOT NEW.uid; "
+        "SELECT data_event('" TEAM_TABLE "', NEW.uid, " + updated + "); "
+        "END;"
+
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventTeamDelete AFTER DELETE ON main." TEAM_TABLE " BEGIN "
+        "SELECT data_event('" TEAM_TABLE "', OLD.uid, " + deleted + "); "
+        "END;"
+
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventMatchInsert AFTER INSERT ON main." MATCH_TABLE " BEGIN "
+        "SELECT data_event('" MATCH_TABLE "', NEW.matchNum, " + inserted + "); "
+        "END;"
+
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventMatchUpdate AFTER UPDATE ON main." MATCH_TABLE " BEGIN "
+        "SELECT data_event('" MATCH_TABLE "', OLD.matchNum, " + deleted + ") WHERE OLD.matchNum IS NOT NEW.matchNum; "
+        "SELECT data_event('" MATCH_TABLE "', NEW.matchNum, " + updated + "); "
+        "END;"
+
+        "CREATE TEMP TRIGGER IF NOT EXISTS EventMatchDelete AFTER DELETE ON main." MATCH_TABLE " BEGIN "
+        "SELECT data_event('" MATCH_TABLE "', OLD.matchNum, " + deleted + "); "
+        "END;";
+
+    if ( sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create data event triggers. Aborting." << std::endl;
+        exit(-1);
+    }
+
+    sqlite3_commit_hook(m_db, &DataBase::CommitDataEvents, this);
+    sqlite3_rollback_hook(m_db, &DataBase::RollbackDataEvents, this);
+
+    AddQueryToHistory(query);
+}
+
+/**
+ * @brief The `data_event(table, key, op)` SQL function the data event triggers call.
+ *
+ * Only the writer connection has it, so it always runs on the UI thread.
+ */
+void DataBase::RecordDataEvent(sqlite3_context* context, int argc, sqlite3_value** argv) {
+    DataBase* db = reinterpret_cast< DataBase* >( sqlite3_user_data(context) );
+
+    const unsigned char* table = sqlite3_value_text(argv[0]);
+    if ( table )
+        db->m_events.Record(reinterpret_cast< const char* >( table ), sqlite3_value_int(argv[1]), static_cast< DataOp >( sqlite3_value_int(argv[2]) ));
+
+    sqlite3_result_null(context);
+}
+
+/**
+ * @brief The commit hook of the writer connection, called as a transaction commits.
+ *
+ * Statements run outside an explicit transaction commit on their own, so this is called after each of them.
+ *
+ * @return 0, so the commit goes ahead.
+ */
+int DataBase::CommitDataEvents(void* db) {
+    reinterpret_cast< DataBase* >( db )->m_events.Commit();
+    return 0;
+}
+
+/**
+ * @brief The rollback hook of the writer connection, called as a transaction is rolled back.
+ */
+void DataBase::RollbackDataEvents(void* db) {
+    reinterpret_cast< DataBase* >( db )->m_events.Rollback();
+}
+
+/**
+ * @brief Starts a savepoint, which can be rolled back on its own.
+ *
+ * @param name Name of the savepoint.
+ */
+void DataBase::BeginSavepoint(const std::string& name) {
+    const std::string query = "SAVEPOINT " + name + ";";
+    if ( sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr) == SQLITE_OK )
+        m_events.BeginSavepoint();
+}
+
+/**
+ * @brief Keeps the writes made since a savepoint and leaves it.
+ *
+ * @param name Name of the savepoint.
+ */
+void DataBase::ReleaseSavepoint(const std::string& name) {
+    const std::string query = "RELEASE " + name + ";";
+    if ( sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr) == SQLITE_OK )
+        m_events.ReleaseSavepoint();
+}
+
+/**
+ * @brief Undoes the writes made since a savepoint and leaves it.
+ *
+ * @param name Name of the savepoint.
+ */
+void DataBase::RollbackSavepoint(const std::string& name) {
+    const std::string query = "ROLLBACK TO " + name + "; RELEASE " + name + ";";
+    if ( sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr) == SQLITE_OK )
+        m_events.RollbackSavepoint();
+}
+
 /**
  * @brief Adds an expanded SQL query to the query history.
  *
@@ -178,12 +651,12 @@ void DataBase::AddQueryToHistory(sqlite3_stmt* stmt) {
     if ( !stmt )
         return;
 
-    const char* expanded = sqlite3_expanded_sql(stmt);
+    char* expanded = sqlite3_expanded_sql(stmt);
     if ( !expanded )
         return;
 
-    this->m_queryHistory.push_back(expanded);
-    this->m_mainFrame->LogSQLQuery(expanded);
+    AddQueryToHistory(std::string(expanded));
+    sqlite3_free(expanded);
 }
 
 /**
@@ -195,8 +668,152 @@ void DataBase::AddQueryToHistory(sqlite3_stmt* stmt) {
  * @param query A pointer to a null-terminated SQL query string.
  */
 void DataBase::AddQueryToHistory(std::string query) {
-    this->m_queryHistory.push_back(query);
-    this->m_mainFrame->LogSQLQuery(query);
+    // reads on other threads log here too, the history belongs to the UI thread
+    OnUiThread([this, query] {
+        this->m_queryHistory.push_back(query);
+        this->m_mainFrame->LogSQLQuery(query);
+    });
+}
+
+/**
+ * @brief Leases a read-only connection from the pool.
+ *
+ * Connections are opened as they're first needed, up to `DB_READ_CONNECTIONS`. Once that
+ * many are leased, this waits for one to be released.
+ *
+ * @return The connection, nullptr if a new one couldn't be opened.
+ */
+sqlite3* DataBase::AcquireReader() {
+    std::unique_lock<std::mutex> lock(m_readerMutex);
+    m_readerFree.wait(lock, [this] { return !m_idleReaders.empty() || m_readerCount < DB_READ_CONNECTIONS; });
+
+    if ( !m_idleReaders.empty() ) {
+        sqlite3* reader = m_idleReaders.back();
+        m_idleReaders.pop_back();
+        return reader;
+    }
+
+    m_readerCount++;
+    lock.unlock();
+
+    sqlite3* reader = nullptr;
+    if ( sqlite3_open_v2(m_dbPath.c_str(), &reader, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK ) {
+        sqlite3_close(reader);
+
+        lock.lock();
+        m_readerCount--;
+        m_readerFree.notify_one();
+        return nullptr;
+    }
+
+    sqlite3_busy_timeout(reader, DB_BUSY_TIMEOUT_MS);
+    return reader;
+}
+
+/**
+ * @brief Returns a connection leased with `AcquireReader` to the pool.
+ *
+ * @param reader The connection.
+ */
+void DataBase::ReleaseReader(sqlite3* reader) {
+    {
+        std::lock_guard<std::mutex> lock(m_readerMutex);
+        m_idleReaders.push_back(reader);
+    }
+
+    m_readerFree.notify_one();
+}
+
+/**
+ * @brief Closes every read-only connection that isn't leased.
+ */
+void DataBase::CloseReaders() {
+    std::lock_guard<std::mutex> lock(m_readerMutex);
+    for ( sqlite3* reader : m_idleReaders )
+        sqlite3_close(reader);
+
+    m_readerCount -= m_idleReaders.size();
+    m_idleReaders.clear();
+}
+
+/**
+ * @brief Starts a read transaction every read on this thread runs in until the snapshot is destroyed.
+ *
+ * If the thread already holds a snapshot of the same database, its transaction is shared.
+ * If no read-only connection can be opened, reads fall back to running on their own.
+ *
+ * @param db The database to read.
+ */
+DataBase::ReadSnapshot::ReadSnapshot(DataBase* db) : m_db(db), m_outer(t_snapshot) {
+    for ( ReadSnapshot* outer = m_outer; outer; outer = outer->m_outer ) {
+        if ( outer->m_db == db ) {
+            m_connection = outer->m_connection;
+            break;
+        }
+    }
+
+    if ( !m_connection ) {
+        m_connection = db->AcquireReader();
+        if ( m_connection ) {
+            m_owned = true;
+
+            // a read transaction only takes its snapshot on its first read, so read straight away
+            sqlite3_exec(m_connection, "BEGIN", NULL, 0, nullptr);
+            sqlite3_exec(m_connection, "SELECT 1 FROM sqlite_schema LIMIT 1", NULL, 0, nullptr);
+        }
+    }
+
+    t_snapshot = this;
+}
+
+DataBase::ReadSnapshot::~ReadSnapshot() {
+    t_snapshot = m_outer;
+
+    if ( m_owned ) {
+        sqlite3_exec(m_connection, "COMMIT", NULL, 0, nullptr);
+        m_db->ReleaseReader(m_connection);
+    }
+}
+
+/**
+ * @brief Picks the connection a read runs on, leasing one if needed.
+ *
+ * @param db The database being read.
+ */
+DataBase::ReadScope::ReadScope(DataBase* db) {
+    for ( ReadSnapshot* snapshot = t_snapshot; snapshot; snapshot = snapshot->m_outer ) {
+        if ( snapshot->m_db == db && snapshot->m_connection ) {
+            m_handle = snapshot->m_connection;
+            return;
+        }
+    }
+
+    if ( !db->OnOwnerThread() ) {
+        m_snapshot.emplace(db);
+        m_handle = m_snapshot->m_connection;
+    }
+
+    // nothing could be leased, the writer is serialized so reading through it is still safe
+    if ( !m_handle )
+        m_handle = db->m_db;
+}
+
+/**
+ * @brief Logs an error to the UI, from whichever thread a read ran on.
+ *
+ * @param message The error.
+ */
+void DataBase::LogErrorMessage(const std::string& message) {
+    OnUiThread([this, message] { m_mainFrame->LogErrorMessage(message); });
+}
+
+/**
+ * @brief Logs a message to the UI, from whichever thread a read ran on.
+ *
+ * @param message The message.
+ */
+void DataBase::LogBackendMessage(const std::string& message) {
+    OnUiThread([this, message] { m_mainFrame->LogBackendMessage(message); });
 }
 
 /**
@@ -250,6 +867,7 @@ void DataBase::UpdateTeam(const Team& team) {
     }
 
     sqlite3_finalize(stmt);
+    m_dataVersion++;
 }
 
 /**
@@ -288,12 +906,12 @@ void DataBase::UpdateMatch(const Match& match) {
     // Bind each field of 'team' to sql query 'query'
     sqlite3_bind_int(stmt, 1, match.redWin);
     sqlite3_bind_int(stmt, 2, match.blueWin);
-    sqlite3_bind_int(stmt, 3, match.Team1().teamNum);
-    sqlite3_bind_int(stmt, 4, match.Team2().teamNum);
-    sqlite3_bind_int(stmt, 5, match.Team3().teamNum);
-    sqlite3_bind_int(stmt, 6, match.Team4().teamNum);
-    sqlite3_bind_int(stmt, 7, match.Team5().teamNum);
-    sqlite3_bind_int(stmt, 8, match.Team6().teamNum);
+    sqlite3_bind_int(stmt, 3, match.Team1());
+    sqlite3_bind_int(stmt, 4, match.Team2());
+    sqlite3_bind_int(stmt, 5, match.Team3());
+    sqlite3_bind_int(stmt, 6, match.Team4());
+    sqlite3_bind_int(stmt, 7, match.Team5());
+    sqlite3_bind_int(stmt, 8, match.Team6());
     sqlite3_bind_int(stmt, 9, match.matchNum);
 
     AddQueryToHistory(stmt);
@@ -307,6 +925,7 @@ void DataBase::UpdateMatch(const Match& match) {
     }
 
     sqlite3_finalize(stmt);
+    m_dataVersion++;
 
     std::cout << "Updated match with match number: " << match.matchNum << std::endl;
 }
@@ -327,6 +946,8 @@ void DataBase::UpdateMatch(const Match& match) {
  *       exit with an error message.
  */
 bool DataBase::TeamExists(int teamNum) {
+    ReadScope read(this);
+
     std::string query = 
         "SELECT 1 FROM " TEAM_TABLE " WHERE teamNum = " 
         + std::to_string(teamNum);
@@ -339,10 +960,10 @@ bool DataBase::TeamExists(int teamNum) {
     // having to set a bool in a callback variable depending 
     // if the row exists. TLDR: Simpler.
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db)) 
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle())) 
         );
         return false;
     }
@@ -361,15 +982,17 @@ bool DataBase::TeamExists(int teamNum) {
 }
 
 bool DataBase::TeamExistsUID(int uid) {
+    ReadScope read(this);
+
     std::string query =
         "SELECT 1 FROM " TEAM_TABLE " WHERE uid = "
         + std::to_string(uid);
 
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
         );
         return false;
     }
@@ -403,15 +1026,17 @@ bool DataBase::TeamExistsUID(int uid) {
  *       exit with an error message.
  */
 bool DataBase::MatchExists(int matchNum) {
+    ReadScope read(this);
+
     std::string query =
         "SELECT 1 FROM " MATCH_TABLE " WHERE matchNum = "
         + std::to_string(matchNum);
 
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
         );
         return false;
     }
@@ -445,8 +1070,8 @@ bool DataBase::TeamInMatch(int teamNum, const Match& match) {
     // iterate through each team comparing the 
     // team numbers to the one were looking for
     
-    for ( const Team& team : match.teams )
-        if ( team.teamNum == teamNum )
+    for ( int team : match.teams )
+        if ( team == teamNum )
            return true; // team is in match
     
     return false;
@@ -526,6 +1151,8 @@ void DataBase::AddTeam(Team& team) {
         return;
     }
 
+    m_dataVersion++;
+
     std::cout << "Added team to teams table." << std::endl;
 }
 
@@ -557,7 +1184,7 @@ void DataBase::AddTeamToMatch(int uid, int matchNum) {
     }
 
     // Add team and update match
-    match.AddCompetitor(team);
+    match.AddCompetitor(team.teamNum);
     UpdateMatch(match);
 }
 
@@ -590,12 +1217,12 @@ void DataBase::AddMatch(const Match& match) {
     sqlite3_bind_int(stmt, 1, match.matchNum);
     sqlite3_bind_int(stmt, 2, match.redWin);
     sqlite3_bind_int(stmt, 3, match.blueWin);
-    sqlite3_bind_int(stmt, 4, match.Team1().teamNum);
-    sqlite3_bind_int(stmt, 5, match.Team2().teamNum);
-    sqlite3_bind_int(stmt, 6, match.Team3().teamNum);
-    sqlite3_bind_int(stmt, 7, match.Team4().teamNum);
-    sqlite3_bind_int(stmt, 8, match.Team5().teamNum);
-    sqlite3_bind_int(stmt, 9, match.Team6().teamNum);
+    sqlite3_bind_int(stmt, 4, match.Team1());
+    sqlite3_bind_int(stmt, 5, match.Team2());
+    sqlite3_bind_int(stmt, 6, match.Team3());
+    sqlite3_bind_int(stmt, 7, match.Team4());
+    sqlite3_bind_int(stmt, 8, match.Team5());
+    sqlite3_bind_int(stmt, 9, match.Team6());
 
     AddQueryToHistory(stmt);
 
@@ -605,6 +1232,8 @@ void DataBase::AddMatch(const Match& match) {
         return;
     }
 
+    m_dataVersion++;
+
     std::cout << "Added match to matches table." << std::endl;
 }
 
@@ -624,274 +1253,1595 @@ void DataBase::RemoveTeamFromMatch(int teamNum, int matchNum) {
         return;
     }
 
-    if ( !TeamInMatch(teamNum, matchNum) ) {
-        std::cout << "Team not in match already. Cannot remove" << std::endl;
-        return;
-    }   
+    if ( !TeamInMatch(teamNum, matchNum) ) {
+        std::cout << "Team not in match already. Cannot remove" << std::endl;
+        return;
+    }   
+
+    Match match = GetMatch(matchNum);
+    match.RemoveCompetitor(teamNum);
+    
+    UpdateMatch(match);
+}
+
+/**
+ * @brief Removes a team from the database and all associated matches.
+ *
+ * @param uid The uid of the scouted row to be removed.
+ */
+void DataBase::RemoveTeam(int uid) {
+    RemoveTeams({ uid });
+}
+
+/**
+ * @brief Removes many scouted rows, and their teams from every match they're in, in one transaction.
+ *
+ * The rows are deleted in one statement, which returns the team numbers they held. One more
+ * statement then takes those teams out of every station of every match they're in, replacing
+ * the team number with 0, so the matches are never read back into C++.
+ *
+ * @param uids The uids of the scouted rows to be removed.
+ */
+void DataBase::RemoveTeams(const std::vector<int>& uids) {
+    if ( uids.empty() )
+        return;
+
+    sqlite3_exec(m_db, "BEGIN TRANSACTION;", NULL, 0, nullptr);
+
+    const std::string query = std::format("DELETE FROM {} WHERE uid IN ({}) RETURNING teamNum", TEAM_TABLE, JoinNumbers(uids));
+
+    sqlite3_stmt* stmt;
+    bool ok = ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK );
+
+    std::vector<int> teamNums = {};
+    if ( ok ) {
+        AddQueryToHistory(stmt);
+
+        int res;
+        while ( ( res = sqlite3_step(stmt) ) == SQLITE_ROW ) {
+            const int teamNum = sqlite3_column_int(stmt, 0);
+            if ( teamNum != 0 && std::find(teamNums.begin(), teamNums.end(), teamNum) == teamNums.end() )
+                teamNums.push_back(teamNum);
+        }
+
+        ok = ( res == SQLITE_DONE );
+        sqlite3_finalize(stmt);
+    }
+
+    // Remove the teams from matches if any, replace the teamnum with 0 in each station they're in
+    if ( ok && !teamNums.empty() ) {
+        const std::string removed = JoinNumbers(teamNums);
+        const std::string cascade = std::format(
+            "UPDATE {} SET {} WHERE {}",
+            MATCH_TABLE,
+            JoinColumns(kMatchStationColumns, "{0} = CASE WHEN {0} IN (" + removed + ") THEN 0 ELSE {0} END", ", "),
+            JoinColumns(kMatchStationColumns, "{0} IN (" + removed + ")", " OR ")
+        );
+
+        ok = ( sqlite3_exec(m_db, cascade.c_str(), NULL, 0, nullptr) == SQLITE_OK );
+        if ( ok )
+            AddQueryToHistory(cascade);
+    }
+
+    if ( !ok ) {
+        m_mainFrame->LogErrorMessage("Failed to delete the teams from team database: " + std::string(sqlite3_errmsg(m_db)));
+        sqlite3_exec(m_db, "ROLLBACK;", NULL, 0, nullptr);
+        return;
+    }
+
+    sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+
+    m_dataVersion++;
+
+    std::cout << "Removed " << uids.size() << " scouted rows of " << teamNums.size() << " teams." << std::endl;
+}
+
+/**
+ * @brief Removes a match from the database.
+ *
+ * This function deletes the specified match from the database based on the provided
+ * match number.
+ *
+ * @param matchNum The match number of the match to be removed.
+ */
+void DataBase::RemoveMatch(int matchNum) {
+    RemoveMatches({ matchNum });
+}
+
+/**
+ * @brief Removes many matches from the database in one statement.
+ *
+ * @param matchNums The match numbers of the matches to be removed.
+ */
+void DataBase::RemoveMatches(const std::vector<int>& matchNums) {
+    if ( matchNums.empty() )
+        return;
+
+    const std::string query = std::format("DELETE FROM {} WHERE matchNum IN ({})", MATCH_TABLE, JoinNumbers(matchNums));
+
+    int res = sqlite3_exec(m_db, query.c_str(), NULL, 0, NULL);
+    if ( res != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage("Failed to remove the matches from match database.");
+        return;
+    }
+
+    m_dataVersion++;
+
+    AddQueryToHistory(query);
+}
+
+/**
+ * @brief Retrieves a team from the database.
+ *
+ * This function queries the database to retrieve the team information based on the provided
+ * team number. If the team number is invalid or the team does not exist, an empty `Team`
+ * object is returned.
+ *
+ * @param teamNum The team number of the team to retrieve.
+ * @return A `Team` object containing the team's information.
+ */
+Team DataBase::GetTeam(int uid) {
+    ReadScope read(this);
+
+    Team team = {};
+
+    std::string query = std::format("SELECT * from {} WHERE uid = {}", TEAM_TABLE, uid);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return team;
+    }
+
+    AddQueryToHistory(stmt);
+
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        team = Team::FromSQLStatment(stmt);
+
+    sqlite3_finalize(stmt);
+
+    return team;
+}
+
+/**
+ * @brief Retrieves a match from the database.
+ *
+ * This function queries the database to retrieve a match's details based on the provided
+ * match number. The function will also populate the teams participating in the match
+ * if they exist in the database.
+ *
+ * @param matchNum The match number of the match to retrieve.
+ * @return A `Match` object containing the match's information, including teams.
+ */
+Match DataBase::GetMatch(int matchNum) {
+    ReadScope read(this);
+
+    Match match = {};
+
+    std::string query = std::format("SELECT * from {} WHERE matchNum = {}", MATCH_TABLE, matchNum);
+    
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle())) 
+        );
+        return match;
+    }
+
+    AddQueryToHistory(stmt);
+
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        match = Match::FromSQLStatment(stmt);
+    
+    sqlite3_finalize(stmt);
+
+    // No team infromation needs to be processed and checked
+    if ( match.teamCount == 0 )
+        return match;
+
+    return match;
+}
+
+/**
+ * @brief Retrieves all teams from the database.
+ *
+ * This function queries the database to select all rows from the `TEAM_TABLE`. It then iterates over each row
+ * in the result set, creating `Team` objects using the `Team::FromSQLStatement` function. These objects are
+ * added to a vector, which is returned to the caller.
+ *
+ * If there is an error in preparing the SQL statement, an error is logged, and an empty vector is returned.
+ *
+ * @return std::vector<Team> A vector containing all the teams retrieved from the database.
+ */
+std::vector<Team> DataBase::GetTeams() {
+    ReadScope read(this);
+
+    std::vector<Team> teams = {};
+    std::string query = std::format("SELECT * from {}", TEAM_TABLE);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        Team team = Team::FromSQLStatment(stmt);
+        teams.push_back(team);
+    }
+
+    sqlite3_finalize(stmt);
+    
+    LogBackendMessage("Found " + std::to_string(teams.size()) + " Teams");
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves all matches from the database.
+ *
+ * This function queries the database to select all rows from the `MATCH_TABLE`. It then iterates over each row
+ * in the result set, creating `Match` objects using the `Match::FromSQLStatement` function. These objects are
+ * added to a vector, which is returned to the caller.
+ *
+ * If there is an error in preparing the SQL statement, an error is logged, and an empty vector is returned.
+ *
+ * @return std::vector<Match> A vector containing all the matches retrieved from the database.
+ */
+std::vector<Match> DataBase::GetMatches() {
+    ReadScope read(this);
+
+    std::vector<Match> matches = {};
+    std::string query = std::format("SELECT * from {}", MATCH_TABLE);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return matches;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        Match match = Match::FromSQLStatment(stmt);
+        matches.push_back(match);
+    }
+
+    sqlite3_finalize(stmt);
+
+    LogBackendMessage("Found " + std::to_string(matches.size()) + " Matches");
+
+    return matches;
+}
+
+/**
+ * @brief Retrieves every scouted team row recorded for a match.
+ *
+ * A team may be scouted more than once in the same match (e.g by different scouts),
+ * so more than one row can be returned for the same team number.
+ *
+ * @param matchNum The match number the rows were scouted in.
+ * @return std::vector<Team> A vector containing the rows, empty if nothing was scouted.
+ */
+std::vector<Team> DataBase::GetTeamsInMatch(int matchNum) {
+    ReadScope read(this);
+
+    std::vector<Team> teams = {};
+    std::string query = std::format("SELECT * from {} WHERE matchNum = {}", TEAM_TABLE, matchNum);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        teams.push_back(Team::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves the scouted row of the team in each station of a match.
+ *
+ * A match only holds team numbers, this joins them to the rows scouted in the match
+ * when the stats are needed. If a team was scouted more than once, the first row is used.
+ *
+ * @param match The match to read the teams of.
+ * @return std::array<Team, 6> The row of each station, red 1-3 then blue 1-3. A station
+ *         with no scouted row only has its team number set, an empty station is all 0.
+ */
+std::array<Team, 6> DataBase::GetMatchTeams(const Match& match) {
+    std::array<Team, 6> teams = {};
+    for ( int i = 0; i < 6; i++ )
+        teams[i].teamNum = match.teams[i];
+
+    std::vector<int> teamNums = {};
+    for ( int teamNum : match.teams )
+        if ( teamNum != 0 )
+            teamNums.push_back(teamNum);
+
+    if ( teamNums.empty() )
+        return teams;
+
+    ReadScope read(this);
+
+    std::string query = std::format(
+        "SELECT * FROM {} WHERE matchNum = {} AND teamNum IN ({}) ORDER BY uid",
+        TEAM_TABLE, match.matchNum, JoinNumbers(teamNums)
+    );
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    std::array<bool, 6> scouted = {};
+    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        const Team team = Team::FromSQLStatment(stmt);
+        for ( int i = 0; i < 6; i++ ) {
+            if ( !scouted[i] && match.teams[i] == team.teamNum ) {
+                teams[i] = team;
+                scouted[i] = true;
+            }
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves every scouted row recorded for a team.
+ *
+ * @param teamNum The team number of the team.
+ * @return std::vector<Team> Every row in the `TEAM_TABLE` with the team number, one per match scouted.
+ */
+std::vector<Team> DataBase::GetTeamEntries(int teamNum) {
+    ReadScope read(this);
+
+    std::vector<Team> teams = {};
+    std::string query = std::format("SELECT * from {} WHERE teamNum = {}", TEAM_TABLE, teamNum);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        teams.push_back(Team::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves every match a team is scheduled in.
+ *
+ * @param teamNum The team number of the team.
+ * @return std::vector<Match> Every match in the `MATCH_TABLE` with the team in one of its six slots.
+ */
+std::vector<Match> DataBase::GetMatchesWithTeam(int teamNum) {
+    ReadScope read(this);
+
+    std::vector<Match> matches = {};
+    std::string query = std::format(
+        "SELECT * from {} WHERE {} IN (team1, team2, team3, team4, team5, team6)", MATCH_TABLE, teamNum
+    );
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return matches;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        matches.push_back(Match::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return matches;
+}
+
+/**
+ * @brief Calculates the win rate of a team based on their performance in matches.
+ *
+ * This function checks all matches in which the specified team participated,
+ * counts the number of wins and losses, and calculates the win rate as a percentage.
+ *
+ * @param uid The unique identifier of the team.
+ * @return The win rate of the team as a percent (e.g. 75% win rate).
+ */
+double DataBase::GetTeamWinRate(int teamNum) {
+    const std::vector<Match> matches = GetMatches();
+    
+    // statistics
+    double wins = 0;
+    int matchesPlayed = 0;
+
+    // check all matches team is in
+    for ( const Match& match : matches ) {
+        // team did not compete in match
+        if ( !TeamInMatch(teamNum, match) )
+            continue;
+
+        // team competed in match
+        matchesPlayed++;
+
+        // team won their match if they are on red alliance and red won
+        // otherwise, they lost
+        if ( match.RedWon() && match.RedAllianceTeam(teamNum) )
+            wins++;
+    }
+
+    // catch divide by zero error
+    if ( matchesPlayed == 0 )
+        return 0.0;
+
+    return (wins / matchesPlayed) * 100;
+}
+
+/**
+ * @brief Finds the scouted rows a team list view shows.
+ *
+ * Only the uids are read, the list view reads the rows it's drawing as it needs them.
+ *
+ * @param query Sort column and order, team number search and range filters.
+ * @return uids of the rows kept, sorted.
+ */
+std::vector<int> DataBase::QueryTeamRows(const ListQuery& query) {
+    return QueryListRows(TEAM_TABLE, "uid", kTeamListColumns, "CAST(teamNum AS TEXT) LIKE ?1", query);
+}
+
+/**
+ * @brief Finds the matches a match list view shows.
+ *
+ * The team number search keeps matches with a team in any station starting with the digits.
+ *
+ * @param query Sort column and order, team number search and range filters.
+ * @return Match numbers of the matches kept, sorted.
+ */
+std::vector<int> DataBase::QueryMatchRows(const ListQuery& query) {
+    return QueryListRows(MATCH_TABLE, "matchNum", kMatchListColumns, "(" + JoinColumns(kMatchStationColumns, "CAST({0} AS TEXT) LIKE ?1", " OR ") + ")", query);
+}
+
+/**
+ * @brief Runs a list view's query, returning the key of each row it keeps.
+ *
+ * Rows sorting the same are ordered by key, so they don't swap places between queries.
+ *
+ * @param tableName Table the rows are in.
+ * @param key Column naming each row.
+ * @param columns Columns of the list view, in order.
+ * @param searchCondition Condition keeping rows matching the search, with the search pattern as its first parameter.
+ * @param query Sort column and order, team number search and range filters.
+ * @return Keys of the rows kept, sorted.
+ */
+template<size_t N>
+std::vector<int> DataBase::QueryListRows(const char* tableName, const char* key, const std::array<const char*, N>& columns, const std::string& searchCondition, const ListQuery& query) {
+    ReadScope read(this);
+
+    std::vector<int> keys = {};
+
+    // values are bound, the search pattern as ?1 and range i as ?(2i + 2) and ?(2i + 3)
+    std::string conditions = query.teamSearch.empty() ? "1" : searchCondition;
+
+    for ( size_t i = 0; i < query.ranges.size(); i++ ) {
+        const RangeFilter& range = query.ranges[i];
+        if ( range.column < 0 || range.column >= static_cast< int >( N ) )
+            continue;
+
+        conditions += std::format(" AND {} BETWEEN ?{} AND ?{}", columns[range.column], i * 2 + 2, i * 2 + 3);
+    }
+
+    const int sortColumn = ( query.sortColumn >= 0 && query.sortColumn < static_cast< int >( N ) ) ? query.sortColumn : 0;
+    const std::string sql = std::format(
+        "SELECT {0} FROM {1} WHERE {2} ORDER BY {3} {4}, {0}",
+        key, tableName, conditions, columns[sortColumn], query.ascending ? "ASC" : "DESC"
+    );
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), sql.c_str(), -1, &stmt, nullptr);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return keys;
+    }
+
+    const std::string pattern = query.teamSearch + "%";
+    if ( !query.teamSearch.empty() )
+        sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_TRANSIENT);
+    for ( size_t i = 0; i < query.ranges.size(); i++ ) {
+        sqlite3_bind_int(stmt, static_cast< int >( i * 2 + 2 ), query.ranges[i].min);
+        sqlite3_bind_int(stmt, static_cast< int >( i * 2 + 3 ), query.ranges[i].max);
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        keys.push_back(sqlite3_column_int(stmt, 0));
+
+    sqlite3_finalize(stmt);
+
+    return keys;
+}
+
+/**
+ * @brief Retrieves the scouted rows with the given uids, in one query.
+ *
+ * @param uids uids of the rows.
+ * @return The rows found, in no particular order.
+ */
+std::vector<Team> DataBase::GetTeams(const std::vector<int>& uids) {
+    ReadScope read(this);
+
+    std::vector<Team> teams = {};
+    if ( uids.empty() )
+        return teams;
+
+    std::string query = std::format("SELECT * from {} WHERE uid IN ({})", TEAM_TABLE, JoinNumbers(uids));
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        teams.push_back(Team::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves every scouted row recorded for the given matches, in one query.
+ *
+ * @param matchNums Numbers of the matches.
+ * @return The scouted rows found, in no particular order.
+ */
+std::vector<Team> DataBase::GetTeamsInMatches(const std::vector<int>& matchNums) {
+    ReadScope read(this);
+
+    std::vector<Team> teams = {};
+    if ( matchNums.empty() )
+        return teams;
+
+    std::string query = std::format("SELECT * from {} WHERE matchNum IN ({})", TEAM_TABLE, JoinNumbers(matchNums));
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return teams;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        teams.push_back(Team::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return teams;
+}
+
+/**
+ * @brief Retrieves the matches with the given numbers, in one query.
+ *
+ * @param matchNums Numbers of the matches.
+ * @return The matches found, in no particular order.
+ */
+std::vector<Match> DataBase::GetMatches(const std::vector<int>& matchNums) {
+    ReadScope read(this);
+
+    std::vector<Match> matches = {};
+    if ( matchNums.empty() )
+        return matches;
+
+    std::string query = std::format("SELECT * from {} WHERE matchNum IN ({})", MATCH_TABLE, JoinNumbers(matchNums));
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return matches;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW )
+        matches.push_back(Match::FromSQLStatment(stmt));
+
+    sqlite3_finalize(stmt);
+
+    return matches;
+}
+
+/**
+ * @brief Saves the ratings teams had after a match.
+ *
+ * All records are written with a single prepared statement inside one transaction.
+ * A record for a team and match that already exists is replaced.
+ *
+ * @param records The ratings to save.
+ */
+void DataBase::AddRatingHistory(const std::vector<RatingRecord>& records) {
+    if ( records.empty() )
+        return;
+
+    const char* query =
+        "INSERT OR REPLACE INTO " RATING_TABLE " "
+        "(teamNum, matchNum, rating) "
+        "VALUES (?, ?, ?);";
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr);
+    if ( res != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return;
+    }
+
+    sqlite3_exec(m_db, "BEGIN TRANSACTION;", NULL, 0, nullptr);
+
+    for ( const RatingRecord& record : records ) {
+        sqlite3_bind_int(stmt, 1, record.teamNum);
+        sqlite3_bind_int(stmt, 2, record.matchNum);
+        sqlite3_bind_double(stmt, 3, record.rating);
+
+        if ( sqlite3_step(stmt) != SQLITE_DONE )
+            m_mainFrame->LogErrorMessage("Failed to save a rating to the ratings table.");
+
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+    sqlite3_finalize(stmt);
+}
+
+/**
+ * @brief Removes saved ratings from a match onwards.
+ *
+ * Used when an earlier match result is corrected and every
+ * rating from that match onwards has to be calculated again.
+ *
+ * @param fromMatchNum The first match number to remove ratings for.
+ */
+void DataBase::RemoveRatingHistory(int fromMatchNum) {
+    std::string query = std::format("DELETE FROM {} WHERE matchNum >= {}", RATING_TABLE, fromMatchNum);
+
+    int res = sqlite3_exec(m_db, query.c_str(), NULL, 0, NULL);
+    if ( res != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage("Failed to remove ratings from the ratings table.");
+        return;
+    }
+
+    AddQueryToHistory(query);
+}
+
+/**
+ * @brief Retrieves every saved rating.
+ *
+ * @return std::vector<RatingRecord> The saved ratings ordered by match number.
+ */
+std::vector<RatingRecord> DataBase::GetRatingHistory() {
+    ReadScope read(this);
+
+    std::vector<RatingRecord> records = {};
+    std::string query = std::format("SELECT teamNum, matchNum, rating from {} ORDER BY matchNum", RATING_TABLE);
+
+    sqlite3_stmt* stmt;
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
+    if ( res != SQLITE_OK ) {
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
+        );
+        return records;
+    }
+
+    AddQueryToHistory(stmt);
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        RatingRecord record = {};
+        record.teamNum = sqlite3_column_int(stmt, 0);
+        record.matchNum = sqlite3_column_int(stmt, 1);
+        record.rating = sqlite3_column_double(stmt, 2);
+        records.push_back(record);
+    }
+
+    sqlite3_finalize(stmt);
+
+    return records;
+}
+
+/**
+ * @brief Replaces the whole database with a snapshot of it, in one write transaction.
+ *
+ * The snapshot is copied in with the SQLite online backup API, so readers on the pool see either
+ * the database as it was or the snapshot, never a mix. The change log keeps counting up from where
+ * it was, so changes made after the restore still reach stations that synced before it. Only this
+ * station is rewound: rows other stations still have come back with the next sync.
+ *
+ * Nothing is reported to the change subscribers, every row may have changed.
+ *
+ * @param path The snapshot to restore.
+ * @return true if the database now holds the snapshot, false if it's unchanged.
+ */
+bool DataBase::RestoreFrom(const std::string& path) {
+    sqlite3* snapshot;
+    if ( sqlite3_open_v2(path.c_str(), &snapshot, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage("Failed to open snapshot " + path + ": " + std::string(sqlite3_errmsg(snapshot)));
+        sqlite3_close(snapshot);
+        return false;
+    }
+
+    int64_t lastSeq = 0;
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT seq FROM sqlite_sequence WHERE name = '" CHANGE_TABLE "'", -1, &stmt, nullptr) == SQLITE_OK ) {
+        if ( sqlite3_step(stmt) == SQLITE_ROW )
+            lastSeq = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_backup* backup = sqlite3_backup_init(m_db, "main", snapshot, "main");
+    if ( !backup ) {
+        m_mainFrame->LogErrorMessage("Failed to restore " + path + ": " + std::string(sqlite3_errmsg(m_db)));
+        sqlite3_close(snapshot);
+        return false;
+    }
+
+    // a reader on the pool may be in the middle of a read, wait for it like any other lock
+    const auto start = std::chrono::steady_clock::now();
+    int res;
+    while ( ( res = sqlite3_backup_step(backup, -1) ) == SQLITE_BUSY || res == SQLITE_LOCKED ) {
+        if ( std::chrono::steady_clock::now() - start > std::chrono::milliseconds(DB_BUSY_TIMEOUT_MS) )
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    sqlite3_backup_finish(backup);
+    sqlite3_close(snapshot);
+
+    if ( res != SQLITE_DONE ) {
+        m_mainFrame->LogErrorMessage("Failed to restore " + path + ": " + std::string(sqlite3_errstr(res)));
+        return false;
+    }
+
+    if ( sqlite3_prepare_v2(m_db, "UPDATE sqlite_sequence SET seq = MAX(seq, ?1) WHERE name = '" CHANGE_TABLE "'", -1, &stmt, nullptr) == SQLITE_OK ) {
+        sqlite3_bind_int64(stmt, 1, lastSeq);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+
+    m_dataVersion++;
+
+    return true;
+}
+
+/**
+ * @brief Merges other scouts' databases into this one.
+ *
+ * Each database is attached and merged with set based statements, so its rows are copied
+ * in a handful of statements instead of one per row. As many databases as SQLite allows
+ * attached at once are merged in one transaction, each inside its own savepoint, so a
+ * database that fails to merge leaves no rows behind and doesn't stop the others.
+ *
+ * Scouted rows are matched by team number, match number and scout. A row entered on a scout's
+ * laptop is labeled with that laptop's station name, the same label syncing gives it, and keeps
+ * its label if it's merged on again, so merging the same database twice adds nothing. Only a
+ * database without a station name is labeled with its file name (e.g "alice" for alice.db).
+ * Merged rows are given new uids from a block reserved for them. Matches are matched by match
+ * number. A result or team only the merged match has is always taken; when both have one and
+ * they differ, 'policy' decides.
+ *
+ * @param paths The databases to merge.
+ * @param policy What to do with rows both databases have but that differ.
+ * @param report Set to what the merge changed.
+ */
+void DataBase::MergeDataBases(const std::vector<std::string>& paths, MergeConflictPolicy policy, MergeReport& report) {
+    report = {};
+
+    const size_t batchSize = std::max(1, sqlite3_limit(m_db, SQLITE_LIMIT_ATTACHED, -1));
+
+    for ( size_t first = 0; first < paths.size(); first += batchSize ) {
+        const size_t last = std::min(first + batchSize, paths.size());
+
+        std::vector<std::pair<std::string, std::string>> attached = {}; // schema and path
+        for ( size_t i = first; i < last; i++ ) {
+            std::error_code err;
+            if ( std::filesystem::equivalent(paths[i], m_dbPath, err) ) {
+                m_mainFrame->LogErrorMessage("Can't merge " + paths[i] + " into itself.");
+                report.failed.push_back(paths[i]);
+                continue;
+            }
+
+            const std::string schema = MERGE_SCHEMA + std::to_string(attached.size());
+
+            sqlite3_stmt* stmt;
+            const std::string query = "ATTACH DATABASE ?1 AS " + schema;
+            if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK ) {
+                m_mainFrame->LogErrorMessage(
+                    std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+                );
+                report.failed.push_back(paths[i]);
+                continue;
+            }
+
+            sqlite3_bind_text(stmt, 1, paths[i].c_str(), -1, SQLITE_TRANSIENT);
+            AddQueryToHistory(stmt);
+
+            const int res = sqlite3_step(stmt);
+            sqlite3_finalize(stmt);
+            if ( res != SQLITE_DONE ) {
+                m_mainFrame->LogErrorMessage("Failed to open " + paths[i] + " for merging.");
+                report.failed.push_back(paths[i]);
+                continue;
+            }
+
+            // its rows would be mixed in with another event's
+            const std::string eventKey = AttachedEventKey(schema);
+            if ( !m_eventKey.empty() && !eventKey.empty() && eventKey != m_eventKey ) {
+                m_mainFrame->LogErrorMessage(std::format("Can't merge {}, it's scouting event {} not {}.", paths[i], eventKey, m_eventKey));
+                report.failed.push_back(paths[i]);
+
+                const std::string detach = "DETACH DATABASE " + schema;
+                sqlite3_exec(m_db, detach.c_str(), NULL, 0, nullptr);
+                continue;
+            }
+
+            attached.push_back({ schema, paths[i] });
+        }
+
+        sqlite3_exec(m_db, "BEGIN TRANSACTION;", NULL, 0, nullptr);
+
+        for ( const auto& [schema, path] : attached ) {
+            // every laptop's database is called data.db, so its file name only labels databases too old to have a station name
+            std::string scout = AttachedStationName(schema);
+            if ( scout.empty() )
+                scout = std::filesystem::path(path).stem().string();
+
+            BeginSavepoint("merge_database");
+
+            MergeReport counts = {};
+            if ( MergeAttached(schema, scout, policy, counts) ) {
+                ReleaseSavepoint("merge_database");
+
+                report.databasesMerged++;
+                report.teamsAdded += counts.teamsAdded;
+                report.teamsSkipped += counts.teamsSkipped;
+                report.teamConflicts += counts.teamConflicts;
+                report.matchesAdded += counts.matchesAdded;
+                report.matchesUpdated += counts.matchesUpdated;
+                report.matchConflicts += counts.matchConflicts;
+            }
+            else {
+                // read before the rollback replaces it
+                const std::string error = sqlite3_errmsg(m_db);
+                RollbackSavepoint("merge_database");
+
+                m_mainFrame->LogErrorMessage("Failed to merge " + path + ": " + error);
+                report.failed.push_back(path);
+            }
+        }
+
+        sqlite3_exec(m_db, "DROP TABLE IF EXISTS temp.MergeTeams;", NULL, 0, nullptr);
+        sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+
+        // databases read in a transaction can only be detached once it's over
+        for ( const auto& [schema, path] : attached ) {
+            const std::string query = "DETACH DATABASE " + schema;
+            sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr);
+        }
+    }
+
+    if ( report.teamsAdded + report.teamConflicts + report.matchesAdded + report.matchesUpdated > 0 )
+        m_dataVersion++;
+}
+
+/**
+ * @brief Reads the key of the event an attached database scouts.
+ *
+ * @param schema The schema the database is attached as.
+ * @return The event key, empty if the database was never labeled with one.
+ */
+std::string DataBase::AttachedEventKey(const std::string& schema) {
+    if ( !ColumnExists(schema, EVENT_INFO_TABLE, "eventKey") )
+        return "";
+
+    const std::string query = std::format("SELECT eventKey FROM {}.{} LIMIT 1", schema, EVENT_INFO_TABLE);
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK )
+        return "";
+
+    std::string eventKey = "";
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        eventKey = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+
+    sqlite3_finalize(stmt);
+
+    return eventKey;
+}
+
+/**
+ * @brief Reads the name an attached database labels its own rows with when syncing.
+ *
+ * @param schema The schema the database is attached as.
+ * @return The station name, empty if the database has no sync state table.
+ */
+std::string DataBase::AttachedStationName(const std::string& schema) {
+    if ( !ColumnExists(schema, SYNC_TABLE, "self") )
+        return "";
+
+    const std::string query = std::format("SELECT station FROM {}.{} WHERE self = 1", schema, SYNC_TABLE);
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK )
+        return "";
+
+    std::string station = "";
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        station = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
 
-    Match match = GetMatch(matchNum);
-    match.RemoveCompetitor(teamNum);
-    
-    UpdateMatch(match);
+    sqlite3_finalize(stmt);
+
+    return station;
 }
 
 /**
- * @brief Removes a team from the database and all associated matches.
+ * @brief Merges one attached database into this one.
  *
- * This function deletes the specified team from the database. It then iterates over all
- * matches and removes the team from any match in which it is a competitor, replacing
- * the team number with 0. The matches are updated accordingly.
+ * Must be called inside a transaction, nothing is undone here if a statement fails.
  *
- * @param teamNum The team number of the team to be removed.
+ * @param schema The name the database is attached as.
+ * @param scout The label given to its rows that were entered on it.
+ * @param policy What to do with rows both databases have but that differ.
+ * @param report Set to what merging it changed.
+ * @return true if the database was merged, false if a statement failed.
  */
-void DataBase::RemoveTeam(int uid) {
-    int teamNum = GetTeam(uid).teamNum;
+bool DataBase::MergeAttached(const std::string& schema, const std::string& scout, MergeConflictPolicy policy, MergeReport& report) {
+    const std::string observation = "t.teamNum = s.teamNum AND t.matchNum = s.matchNum AND t.scout = s.scout";
+    const std::string statsDiffer = "(" + JoinColumns(kTeamStatColumns, "t.{0} IS NOT s.{0}", " OR ") + ")";
+
+    if ( ColumnExists(schema, TEAM_TABLE, "teamNum") ) {
+        // the rows to merge, labeled with their scout, one per observation
+        const std::string scoutLabel = ColumnExists(schema, TEAM_TABLE, "scout") ? "COALESCE(NULLIF(scout, ''), ?1)" : "?1";
+        const std::string stage = std::format(
+            "CREATE TEMP TABLE MergeTeams AS "
+            "SELECT teamNum, matchNum, {0} AS scout, {1} FROM {2}.{3} "
+            "WHERE rowid IN (SELECT MAX(rowid) FROM {2}.{3} GROUP BY teamNum, matchNum, {0})",
+            scoutLabel, JoinColumns(kTeamStatColumns, "{}", ", "), schema, TEAM_TABLE
+        );
+
+        if ( RunMergeStatement("DROP TABLE IF EXISTS temp.MergeTeams", scout, policy) < 0 || RunMergeStatement(stage, scout, policy) < 0 )
+            return false;
+
+        const int matched = RunMergeStatement(std::format(
+            "SELECT COUNT(*) FROM temp.MergeTeams AS s WHERE EXISTS (SELECT 1 FROM main.{} AS t WHERE {})",
+            TEAM_TABLE, observation
+        ), scout, policy);
+        const int conflicts = RunMergeStatement(std::format(
+            "SELECT COUNT(*) FROM temp.MergeTeams AS s WHERE EXISTS (SELECT 1 FROM main.{} AS t WHERE {} AND {})",
+            TEAM_TABLE, observation, statsDiffer
+        ), scout, policy);
+        if ( matched < 0 || conflicts < 0 )
+            return false;
+
+        if ( policy == kMergeTakeIncoming && conflicts > 0 ) {
+            const std::string update = std::format(
+                "UPDATE main.{} AS t SET {} FROM temp.MergeTeams AS s WHERE {} AND {}",
+                TEAM_TABLE, JoinColumns(kTeamStatColumns, "{0} = s.{0}", ", "), observation, statsDiffer
+            );
+            if ( RunMergeStatement(update, scout, policy) < 0 )
+                return false;
+        }
 
-    std::string query = std::format("DELETE FROM {} WHERE uid = {}", TEAM_TABLE, uid);
+        const int staged = RunMergeStatement("SELECT COUNT(*) FROM temp.MergeTeams", scout, policy);
+        if ( staged < 0 )
+            return false;
+
+        // new rows get a block of uids reserved for them, in the transaction the merge runs in
+        int added = 0;
+        if ( staged > matched ) {
+            const int firstUid = ReserveTeamUIDs(staged - matched);
+            if ( firstUid == 0 )
+                return false;
+
+            const std::string insert = std::format(
+                "INSERT INTO main.{0} (uid, teamNum, matchNum, scout, {1}) "
+                "SELECT {4} - 1 + ROW_NUMBER() OVER (ORDER BY s.matchNum, s.teamNum, s.scout), "
+                "s.teamNum, s.matchNum, s.scout, {2} FROM temp.MergeTeams AS s "
+                "WHERE NOT EXISTS (SELECT 1 FROM main.{0} AS t WHERE {3})",
+                TEAM_TABLE, JoinColumns(kTeamStatColumns, "{}", ", "), JoinColumns(kTeamStatColumns, "s.{}", ", "), observation, firstUid
+            );
+
+            added = RunMergeStatement(insert, scout, policy);
+            if ( added < 0 )
+                return false;
+        }
 
-    int res = sqlite3_exec(m_db, query.c_str(), NULL, 0, NULL);
-    if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage("Failed to delete the team from team database.");
-        return;
+        report.teamsAdded = added;
+        report.teamConflicts = conflicts;
+        report.teamsSkipped = matched - conflicts;
     }
 
-    // Remove team from matches if any, replace the teamnum with 0 in each match
-    for ( Match& match : GetMatches() ) {
-        if ( !TeamInMatch(teamNum, match) )
-            continue;
-        
-        // Remove and update
-        match.RemoveCompetitor(teamNum);
-        UpdateMatch(match);
+    if ( ColumnExists(schema, MATCH_TABLE, "matchNum") ) {
+        // a side with a result or team only takes the other side's if it has none, or the policy says so
+        const std::string resultDiffers =
+            "((m.redWin OR m.blueWin) AND (s.redWin OR s.blueWin) AND (m.redWin IS NOT s.redWin OR m.blueWin IS NOT s.blueWin))";
+        const std::string takeResult =
+            "((s.redWin OR s.blueWin) AND (NOT (m.redWin OR m.blueWin) OR ?2) AND (m.redWin IS NOT s.redWin OR m.blueWin IS NOT s.blueWin))";
+
+        const int conflicts = RunMergeStatement(std::format(
+            "SELECT COUNT(*) FROM main.{0} AS m JOIN {1}.{0} AS s ON s.matchNum = m.matchNum WHERE {2} OR {3}",
+            MATCH_TABLE, schema, resultDiffers, JoinColumns(kMatchStationColumns, "(m.{0} <> 0 AND s.{0} <> 0 AND m.{0} <> s.{0})", " OR ")
+        ), scout, policy);
+        if ( conflicts < 0 )
+            return false;
+
+        const std::string update = std::format(
+            "UPDATE main.{0} AS m SET "
+            "redWin = CASE WHEN {2} THEN s.redWin ELSE m.redWin END, "
+            "blueWin = CASE WHEN {2} THEN s.blueWin ELSE m.blueWin END, {3} "
+            "FROM {1}.{0} AS s WHERE s.matchNum = m.matchNum AND ({2} OR {4})",
+            MATCH_TABLE, schema, takeResult,
+            JoinColumns(kMatchStationColumns, "{0} = CASE WHEN s.{0} <> 0 AND (m.{0} = 0 OR ?2) THEN s.{0} ELSE m.{0} END", ", "),
+            JoinColumns(kMatchStationColumns, "(s.{0} <> 0 AND (m.{0} = 0 OR ?2) AND s.{0} <> m.{0})", " OR ")
+        );
+
+        const int updated = RunMergeStatement(update, scout, policy);
+        if ( updated < 0 )
+            return false;
+
+        const std::string insert = std::format(
+            "INSERT INTO main.{0} (matchNum, redWin, blueWin, {2}) "
+            "SELECT s.matchNum, s.redWin, s.blueWin, {3} FROM {1}.{0} AS s "
+            "WHERE NOT EXISTS (SELECT 1 FROM main.{0} AS m WHERE m.matchNum = s.matchNum)",
+            MATCH_TABLE, schema, JoinColumns(kMatchStationColumns, "{}", ", "), JoinColumns(kMatchStationColumns, "s.{}", ", ")
+        );
+
+        const int added = RunMergeStatement(insert, scout, policy);
+        if ( added < 0 )
+            return false;
+
+        report.matchesAdded = added;
+        report.matchesUpdated = updated;
+        report.matchConflicts = conflicts;
     }
 
-    std::cout << "Removed team with team number: " << teamNum << std::endl;
+    return true;
 }
 
 /**
- * @brief Removes a match from the database.
+ * @brief Runs one statement of a merge.
  *
- * This function deletes the specified match from the database based on the provided
- * match number.
+ * `?1` in the statement is bound to the scout label and `?2` to whether merged rows win conflicts.
  *
- * @param matchNum The match number of the match to be removed.
+ * @param query The statement to run.
+ * @param scout The label of the database being merged.
+ * @param policy What to do with rows both databases have but that differ.
+ * @return The first column of the first row for a SELECT, otherwise the number of rows
+ *         changed. -1 if the statement failed.
  */
-void DataBase::RemoveMatch(int matchNum) {
-    std::string query = std::format("DELETE FROM {} WHERE matchNum = {}", MATCH_TABLE, matchNum);
+int DataBase::RunMergeStatement(const std::string& query, const std::string& scout, MergeConflictPolicy policy) {
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK )
+        return -1;
 
-    int res = sqlite3_exec(m_db, query.c_str(), NULL, 0, NULL);
-    if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage("Failed to remove the match from match database.");
-        return;
-    }
+    // binding a parameter the statement doesn't use is harmless
+    sqlite3_bind_text(stmt, 1, scout.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, policy == kMergeTakeIncoming);
 
-    AddQueryToHistory(query.c_str());
+    AddQueryToHistory(stmt);
+
+    int result = -1;
+    const int res = sqlite3_step(stmt);
+    if ( res == SQLITE_ROW )
+        result = sqlite3_column_int(stmt, 0);
+    else if ( res == SQLITE_DONE )
+        result = sqlite3_changes(m_db);
+
+    sqlite3_finalize(stmt);
+    return result;
 }
 
 /**
- * @brief Retrieves a team from the database.
- *
- * This function queries the database to retrieve the team information based on the provided
- * team number. If the team number is invalid or the team does not exist, an empty `Team`
- * object is returned.
+ * @brief Checks if a table in the database, or in an attached one, has a column.
  *
- * @param teamNum The team number of the team to retrieve.
- * @return A `Team` object containing the team's information.
+ * @param schema "main" for this database, otherwise the name a database is attached as.
+ * @param tableName The table to look in.
+ * @param column The column to look for.
+ * @return `true` if the table exists and has the column, `false` otherwise.
  */
-Team DataBase::GetTeam(int uid) {
-    Team team = {};
-
-    std::string query = std::format("SELECT * from {} WHERE uid = {}", TEAM_TABLE, uid);
+bool DataBase::ColumnExists(const std::string& schema, const std::string& tableName, const std::string& column) {
+    const char* query = "SELECT 1 FROM pragma_table_info(?1, ?2) WHERE name = ?3";
 
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
-    if ( res != SQLITE_OK ) {
+    if ( sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK ) {
         m_mainFrame->LogErrorMessage(
             std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
         );
-        return team;
+        return false;
     }
 
-    AddQueryToHistory(stmt);
-
-    if ( sqlite3_step(stmt) == SQLITE_ROW )
-        team = Team::FromSQLStatment(stmt);
+    sqlite3_bind_text(stmt, 1, tableName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, schema.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, column.c_str(), -1, SQLITE_TRANSIENT);
 
+    const bool exists = ( sqlite3_step(stmt) == SQLITE_ROW );
     sqlite3_finalize(stmt);
 
-    return team;
+    return exists;
 }
 
 /**
- * @brief Retrieves a match from the database.
+ * @brief Collects every row changed after an entry of the change log.
  *
- * This function queries the database to retrieve a match's details based on the provided
- * match number. The function will also populate the teams participating in the match
- * if they exist in the database.
+ * Each changed row is read as it is now, once no matter how many times it changed. A row
+ * that no longer exists is sent as a delete. Rows entered here are labeled with the station
+ * name. Everything is read in one transaction, so the changeset is a consistent snapshot.
  *
- * @param matchNum The match number of the match to retrieve.
- * @return A `Match` object containing the match's information, including teams.
+ * @param seq The last change log entry the receiver already has, 0 for everything.
+ * @param peer The receiver, whose own changes applied here are left out. Empty to leave nothing out.
+ * @return The changes, up to the newest entry of the change log.
  */
-Match DataBase::GetMatch(int matchNum) {
-    Match match = {};
+Changeset DataBase::GetChangesSince(uint64_t seq, const std::string& peer) {
+    Changeset changeset = {};
+    changeset.origin = m_stationName;
+    changeset.fromSeq = seq;
+    changeset.toSeq = seq;
+
+    sqlite3_exec(m_db, "BEGIN TRANSACTION;", NULL, 0, nullptr);
 
-    std::string query = std::format("SELECT * from {} WHERE matchNum = {}", MATCH_TABLE, matchNum);
-    
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
-    if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db)) 
-        );
-        return match;
+    if ( sqlite3_prepare_v2(m_db, "SELECT IFNULL(MAX(seq), 0) FROM " CHANGE_TABLE, -1, &stmt, nullptr) == SQLITE_OK ) {
+        if ( sqlite3_step(stmt) == SQLITE_ROW )
+            changeset.toSeq = static_cast< uint64_t >( sqlite3_column_int64(stmt, 0) );
+        sqlite3_finalize(stmt);
     }
 
-    AddQueryToHistory(stmt);
+    if ( changeset.toSeq <= seq ) {
+        sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+        changeset.toSeq = seq;
+        return changeset;
+    }
 
-    if ( sqlite3_step(stmt) == SQLITE_ROW )
-        match = Match::FromSQLStatment(stmt);
-    
-    sqlite3_finalize(stmt);
+    const std::string matchQuery = std::format(
+        "SELECT k.matchNum, m.matchNum IS NOT NULL, m.redWin, m.blueWin, {2} "
+        "FROM (SELECT matchNum, MAX(seq) AS seq, origin FROM {0} WHERE tableName = '{1}' AND seq > ?1 AND seq <= ?2 GROUP BY matchNum) AS k "
+        "LEFT JOIN {1} AS m ON m.matchNum = k.matchNum WHERE ?3 = '' OR k.origin <> ?3 ORDER BY k.seq",
+        CHANGE_TABLE, MATCH_TABLE, JoinColumns(kMatchStationColumns, "m.{}", ", ")
+    );
+
+    if ( sqlite3_prepare_v2(m_db, matchQuery.c_str(), -1, &stmt, nullptr) == SQLITE_OK ) {
+        sqlite3_bind_int64(stmt, 1, static_cast< sqlite3_int64 >( seq ));
+        sqlite3_bind_int64(stmt, 2, static_cast< sqlite3_int64 >( changeset.toSeq ));
+        sqlite3_bind_text(stmt, 3, peer.c_str(), -1, SQLITE_TRANSIENT);
+        AddQueryToHistory(stmt);
+
+        while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+            ChangeRecord record = {};
+            record.match.matchNum = sqlite3_column_int(stmt, 0);
+            record.kind = sqlite3_column_int(stmt, 1) ? kChangeMatchUpsert : kChangeMatchDelete;
+            record.match.redWin = sqlite3_column_int(stmt, 2);
+            record.match.blueWin = sqlite3_column_int(stmt, 3);
+            for ( int i = 0; i < 6; i++ )
+                record.match.teams[i] = sqlite3_column_int(stmt, 4 + i);
+
+            changeset.records.push_back(record);
+        }
 
-    // No team infromation needs to be processed and checked
-    if ( match.teamCount == 0 )
-        return match;
+        sqlite3_finalize(stmt);
+    }
 
-    return match;
+    // a key can have more than one row when a team was entered twice, the newest is sent
+    const std::string teamQuery = std::format(
+        "SELECT k.teamNum, k.matchNum, k.scout, t.uid IS NOT NULL, {2} "
+        "FROM (SELECT teamNum, matchNum, scout, MAX(seq) AS seq, origin FROM {0} WHERE tableName = '{1}' AND seq > ?1 AND seq <= ?2 "
+        "GROUP BY teamNum, matchNum, scout) AS k "
+        "LEFT JOIN {1} AS t ON t.rowid = "
+        "(SELECT MAX(rowid) FROM {1} WHERE teamNum = k.teamNum AND matchNum = k.matchNum AND scout = k.scout) "
+        "WHERE ?3 = '' OR k.origin <> ?3 ORDER BY k.seq",
+        CHANGE_TABLE, TEAM_TABLE, JoinColumns(kTeamStatColumns, "t.{}", ", ")
+    );
+
+    if ( sqlite3_prepare_v2(m_db, teamQuery.c_str(), -1, &stmt, nullptr) == SQLITE_OK ) {
+        sqlite3_bind_int64(stmt, 1, static_cast< sqlite3_int64 >( seq ));
+        sqlite3_bind_int64(stmt, 2, static_cast< sqlite3_int64 >( changeset.toSeq ));
+        sqlite3_bind_text(stmt, 3, peer.c_str(), -1, SQLITE_TRANSIENT);
+        AddQueryToHistory(stmt);
+
+        while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+            ChangeRecord record = {};
+            record.team.teamNum = sqlite3_column_int(stmt, 0);
+            record.team.matchNum = sqlite3_column_int(stmt, 1);
+            record.scout = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 2) );
+            record.kind = sqlite3_column_int(stmt, 3) ? kChangeTeamUpsert : kChangeTeamDelete;
+
+            if ( record.scout.empty() )
+                record.scout = m_stationName;
+
+            Team& team = record.team;
+            team.hangAttempt = sqlite3_column_int(stmt, 4);
+            team.hangSuccess = sqlite3_column_int(stmt, 5);
+            team.robotCycleSpeed = sqlite3_column_int(stmt, 6);
+            team.coralPoints = sqlite3_column_int(stmt, 7);
+            team.defense = sqlite3_column_int(stmt, 8);
+            team.autonomousPoints = sqlite3_column_int(stmt, 9);
+            team.driverSkill = sqlite3_column_int(stmt, 10);
+            team.penaltys = sqlite3_column_int(stmt, 11);
+            team.overall = sqlite3_column_int(stmt, 12);
+            team.rankingPoints = sqlite3_column_int(stmt, 13);
+
+            changeset.records.push_back(record);
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+
+    return changeset;
 }
 
 /**
- * @brief Retrieves all teams from the database.
- *
- * This function queries the database to select all rows from the `TEAM_TABLE`. It then iterates over each row
- * in the result set, creating `Team` objects using the `Team::FromSQLStatement` function. These objects are
- * added to a vector, which is returned to the caller.
+ * @brief Applies a changeset from another station.
  *
- * If there is an error in preparing the SQL statement, an error is logged, and an empty vector is returned.
+ * Rows are written only where they differ from what's here, so applying a changeset again,
+ * or one that came back around from another station, changes nothing and logs nothing. Rows
+ * labeled with this station's name are this station's own and are matched with its unlabeled
+ * rows. Everything is applied in one transaction along with the new watermark of the origin.
  *
- * @return std::vector<Team> A vector containing all the teams retrieved from the database.
+ * @param changeset The changes to apply.
+ * @param report Set to the number of rows received and the number that changed something.
+ * @return true if the changeset was applied, false if a write failed and nothing was applied.
  */
-std::vector<Team> DataBase::GetTeams() {
-    std::vector<Team> teams = {};
-    std::string query = std::format("SELECT * from {}", TEAM_TABLE);
+bool DataBase::ApplyChangeset(const Changeset& changeset, SyncReport& report) {
+    report.received = changeset.records.size();
+    report.applied = 0;
+
+    const std::string stats = JoinColumns(kTeamStatColumns, "{}", ", ");
+    const std::string key = "teamNum = ?1 AND matchNum = ?2 AND scout = ?3";
+
+    // ?1-?3 name the row, ?4 onwards are its stats in column order
+    std::string setStats = "", statsDiffer = "", statParams = "";
+    for ( size_t i = 0; i < kTeamStatColumns.size(); i++ ) {
+        const char* separator = ( i == 0 ) ? "" : ", ";
+        setStats += std::format("{}{} = ?{}", separator, kTeamStatColumns[i], i + 4);
+        statsDiffer += std::format("{}{} IS NOT ?{}", ( i == 0 ) ? "" : " OR ", kTeamStatColumns[i], i + 4);
+        statParams += std::format("{}?{}", separator, i + 4);
+    }
 
-    sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
-    if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
-        );
-        return teams;
+    const std::array<std::string, 5> queries = {
+        std::format("UPDATE {} SET {} WHERE {} AND ({})", TEAM_TABLE, setStats, key, statsDiffer),
+        std::format(
+            "INSERT INTO {0} (uid, teamNum, matchNum, scout, {1}) "
+            "SELECT (SELECT nextUid FROM " UID_TABLE "), ?1, ?2, ?3, {2} "
+            "WHERE NOT EXISTS (SELECT 1 FROM {0} WHERE {3})",
+            TEAM_TABLE, stats, statParams, key
+        ),
+        std::format("DELETE FROM {} WHERE {}", TEAM_TABLE, key),
+        std::format(
+            "INSERT INTO {0} (matchNum, redWin, blueWin, {1}) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9) "
+            "ON CONFLICT(matchNum) DO UPDATE SET redWin = excluded.redWin, blueWin = excluded.blueWin, {2} "
+            "WHERE redWin IS NOT excluded.redWin OR blueWin IS NOT excluded.blueWin OR {3}",
+            MATCH_TABLE, JoinColumns(kMatchStationColumns, "{}", ", "),
+            JoinColumns(kMatchStationColumns, "{0} = excluded.{0}", ", "),
+            JoinColumns(kMatchStationColumns, "{0} IS NOT excluded.{0}", " OR ")
+        ),
+        std::format("DELETE FROM {} WHERE matchNum = ?1", MATCH_TABLE)
+    };
+    enum { kUpdateTeam = 0, kInsertTeam, kDeleteTeam, kUpsertMatch, kDeleteMatch };
+
+    std::array<sqlite3_stmt*, 5> stmts = {};
+    auto Finalize = [&stmts] {
+        for ( sqlite3_stmt* stmt : stmts )
+            sqlite3_finalize(stmt);
+    };
+
+    for ( size_t i = 0; i < queries.size(); i++ ) {
+        if ( sqlite3_prepare_v2(m_db, queries[i].c_str(), -1, &stmts[i], nullptr) != SQLITE_OK ) {
+            m_mainFrame->LogErrorMessage(
+                std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+            );
+            Finalize();
+            return false;
+        }
     }
 
-    AddQueryToHistory(stmt);
+    // runs a statement once, adding the rows it changed to the report
+    auto Run = [this, &report](sqlite3_stmt* stmt) -> bool {
+        const bool done = ( sqlite3_step(stmt) == SQLITE_DONE );
+        if ( done )
+            report.applied += sqlite3_changes(m_db);
 
-    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
-        Team team = Team::FromSQLStatment(stmt);
-        teams.push_back(team);
+        sqlite3_reset(stmt);
+        return done;
+    };
+
+    sqlite3_exec(m_db, "BEGIN TRANSACTION;", NULL, 0, nullptr);
+
+    // entries logged past this one were written by this changeset
+    sqlite3_int64 lastSeq = 0;
+    sqlite3_stmt* seqStmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT IFNULL(MAX(seq), 0) FROM " CHANGE_TABLE, -1, &seqStmt, nullptr) == SQLITE_OK ) {
+        if ( sqlite3_step(seqStmt) == SQLITE_ROW )
+            lastSeq = sqlite3_column_int64(seqStmt, 0);
+        sqlite3_finalize(seqStmt);
     }
 
-    sqlite3_finalize(stmt);
-    
-    this->m_mainFrame->LogBackendMessage("Found " + std::to_string(teams.size()) + " Teams");
+    bool ok = true;
+    for ( const ChangeRecord& record : changeset.records ) {
+        if ( record.kind == kChangeTeamUpsert || record.kind == kChangeTeamDelete ) {
+            const std::string scout = ( record.scout == m_stationName ) ? "" : record.scout;
+            const Team& team = record.team;
 
-    return teams;
+            for ( int i : { kUpdateTeam, kInsertTeam, kDeleteTeam } ) {
+                sqlite3_bind_int(stmts[i], 1, team.teamNum);
+                sqlite3_bind_int(stmts[i], 2, team.matchNum);
+                sqlite3_bind_text(stmts[i], 3, scout.c_str(), -1, SQLITE_TRANSIENT);
+            }
+
+            if ( record.kind == kChangeTeamDelete ) {
+                ok = Run(stmts[kDeleteTeam]);
+            }
+            else {
+                const int values[10] = {
+                    team.hangAttempt, team.hangSuccess, team.robotCycleSpeed, team.coralPoints, team.defense,
+                    team.autonomousPoints, team.driverSkill, team.penaltys, team.overall, team.rankingPoints
+                };
+                for ( int i = 0; i < 10; i++ ) {
+                    sqlite3_bind_int(stmts[kUpdateTeam], i + 4, values[i]);
+                    sqlite3_bind_int(stmts[kInsertTeam], i + 4, values[i]);
+                }
+
+                // the update changes nothing if the row is missing or already up to date, the insert only runs if it's missing
+                ok = Run(stmts[kUpdateTeam]) && Run(stmts[kInsertTeam]);
+            }
+        }
+        else if ( record.kind == kChangeMatchUpsert ) {
+            sqlite3_bind_int(stmts[kUpsertMatch], 1, record.match.matchNum);
+            sqlite3_bind_int(stmts[kUpsertMatch], 2, record.match.redWin);
+            sqlite3_bind_int(stmts[kUpsertMatch], 3, record.match.blueWin);
+            for ( int i = 0; i < 6; i++ )
+                sqlite3_bind_int(stmts[kUpsertMatch], 4 + i, record.match.teams[i]);
+
+            ok = Run(stmts[kUpsertMatch]);
+        }
+        else {
+            sqlite3_bind_int(stmts[kDeleteMatch], 1, record.match.matchNum);
+            ok = Run(stmts[kDeleteMatch]);
+        }
+
+        if ( !ok )
+            break;
+    }
+
+    Finalize();
+
+    // mark what this changeset wrote as coming from its origin, and remember how far into the
+    // origin's change log this station is, unless the changes were its own
+    if ( ok && changeset.origin != m_stationName ) {
+        const char* queries[2] = {
+            "UPDATE " CHANGE_TABLE " SET origin = ?1 WHERE seq > ?2",
+            "INSERT INTO " SYNC_TABLE " (station, receivedSeq) VALUES (?1, ?2) "
+            "ON CONFLICT(station) DO UPDATE SET receivedSeq = MAX(receivedSeq, excluded.receivedSeq)"
+        };
+        const sqlite3_int64 values[2] = { lastSeq, static_cast< sqlite3_int64 >( changeset.toSeq ) };
+
+        for ( int i = 0; i < 2 && ok; i++ ) {
+            sqlite3_stmt* stmt;
+            ok = ( sqlite3_prepare_v2(m_db, queries[i], -1, &stmt, nullptr) == SQLITE_OK );
+            if ( !ok )
+                break;
+
+            sqlite3_bind_text(stmt, 1, changeset.origin.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 2, values[i]);
+            ok = ( sqlite3_step(stmt) == SQLITE_DONE );
+            sqlite3_finalize(stmt);
+        }
+    }
+
+    if ( !ok ) {
+        m_mainFrame->LogErrorMessage("Failed to apply changes from " + changeset.origin + ": " + std::string(sqlite3_errmsg(m_db)));
+        sqlite3_exec(m_db, "ROLLBACK;", NULL, 0, nullptr);
+        report.applied = 0;
+        return false;
+    }
+
+    sqlite3_exec(m_db, "COMMIT;", NULL, 0, nullptr);
+
+    if ( report.applied > 0 )
+        m_dataVersion++;
+
+    // every exchange ends here, so the log stays about as big as the tables between restarts
+    CompactChangeLog();
+
+    return true;
 }
 
 /**
- * @brief Retrieves all matches from the database.
+ * @brief Drops every change log entry a later entry of the same row replaces.
  *
- * This function queries the database to select all rows from the `MATCH_TABLE`. It then iterates over each row
- * in the result set, creating `Match` objects using the `Match::FromSQLStatement` function. These objects are
- * added to a vector, which is returned to the caller.
- *
- * If there is an error in preparing the SQL statement, an error is logged, and an empty vector is returned.
+ * Changes are sent by reading each logged row as it is now, so an older entry of a row adds
+ * nothing once it has a newer one: anyone asking for changes after the older entry also gets
+ * the newer one. Run when the database is opened, after every applied changeset and after
+ * every export, so edits made during an event don't grow the log without limit.
+ */
+void DataBase::CompactChangeLog() {
+    const char* query =
+        "DELETE FROM " CHANGE_TABLE " WHERE seq NOT IN "
+        "(SELECT MAX(seq) FROM " CHANGE_TABLE " GROUP BY tableName, teamNum, matchNum, scout)";
+
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage("Failed to compact the change log: " + std::string(sqlite3_errmsg(m_db)));
+        return;
+    }
+
+    AddQueryToHistory(query);
+}
+
+/**
+ * @brief Reads a number kept for a peer in the sync state table.
  *
- * @return std::vector<Match> A vector containing all the matches retrieved from the database.
+ * @param peer The peer's station name.
+ * @param column "sentSeq" or "receivedSeq".
+ * @return The number, 0 if the peer has never synced.
  */
-std::vector<Match> DataBase::GetMatches() {
-    std::vector<Match> matches = {};
-    std::string query = std::format("SELECT * from {}", MATCH_TABLE);
+uint64_t DataBase::GetSyncValue(const std::string& peer, const char* column) {
+    uint64_t value = 0;
+    const std::string query = std::format("SELECT {} FROM {} WHERE station = ?1", column, SYNC_TABLE);
 
     sqlite3_stmt* stmt;
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
-    if ( res != SQLITE_OK ) {
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK ) {
         m_mainFrame->LogErrorMessage(
             std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
         );
-        return matches;
+        return value;
     }
 
-    AddQueryToHistory(stmt);
-
-    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
-        Match match = Match::FromSQLStatment(stmt);
-        matches.push_back(match);
-    }
+    sqlite3_bind_text(stmt, 1, peer.c_str(), -1, SQLITE_TRANSIENT);
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        value = static_cast< uint64_t >( sqlite3_column_int64(stmt, 0) );
 
     sqlite3_finalize(stmt);
+    return value;
+}
 
-    this->m_mainFrame->LogBackendMessage("Found " + std::to_string(matches.size()) + " Matches");
+uint64_t DataBase::GetSentSeq(const std::string& peer) {
+    return GetSyncValue(peer, "sentSeq");
+}
 
-    return matches;
+uint64_t DataBase::GetReceivedSeq(const std::string& peer) {
+    return GetSyncValue(peer, "receivedSeq");
 }
 
 /**
- * @brief Calculates the win rate of a team based on their performance in matches.
+ * @brief Records the last change log entry sent to a peer.
  *
- * This function checks all matches in which the specified team participated,
- * counts the number of wins and losses, and calculates the win rate as a percentage.
- *
- * @param uid The unique identifier of the team.
- * @return The win rate of the team as a percent (e.g. 75% win rate).
+ * @param peer The peer's station name.
+ * @param seq The last entry sent.
  */
-double DataBase::GetTeamWinRate(int teamNum) {
-    const std::vector<Match> matches = GetMatches();
-    
-    // statistics
-    double wins = 0;
-    int matchesPlayed = 0;
-
-    // check all matches team is in
-    for ( const Match& match : matches ) {
-        // team did not compete in match
-        if ( !TeamInMatch(teamNum, match) )
-            continue;
-
-        // team competed in match
-        matchesPlayed++;
+void DataBase::SetSentSeq(const std::string& peer, uint64_t seq) {
+    const char* query =
+        "INSERT INTO " SYNC_TABLE " (station, sentSeq) VALUES (?1, ?2) "
+        "ON CONFLICT(station) DO UPDATE SET sentSeq = excluded.sentSeq";
 
-        // team won their match if they are on red alliance and red won
-        // otherwise, they lost
-        if ( match.RedWon() && match.RedAllianceTeam(teamNum) )
-            wins++;
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return;
     }
 
-    // catch divide by zero error
-    if ( matchesPlayed == 0 )
-        return 0.0;
+    sqlite3_bind_text(stmt, 1, peer.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, static_cast< sqlite3_int64 >( seq ));
+    AddQueryToHistory(stmt);
 
-    return (wins / matchesPlayed) * 100;
+    if ( sqlite3_step(stmt) != SQLITE_DONE )
+        m_mainFrame->LogErrorMessage("Failed to save how far " + peer + " has synced.");
+
+    sqlite3_finalize(stmt);
 }
 
 /**
  * @brief Generates a unique team UID (User Identifier) that does not already exist.
  *
- * This function generates a random 4-digit integer UID (between 1000 and 9999) using a random number generator.
- * It checks if the generated UID already exists using the `TeamExistsUID` function. If the UID exists, the process
- * repeats until a unique UID is found. The unique UID is then returned.
- *
- * @return int The unique team UID.
+ * @return int The unique team UID, 0 if this station ran out of them.
  */
 int DataBase::GetNextTeamUID() {
+    return ReserveTeamUIDs(1);
+}
+
+/**
+ * @brief Reserves a block of consecutive uids, for adding many rows at once.
+ *
+ * The block is taken off the uid sequence in one statement, so reserving never
+ * has to check which uids are in use, however many rows there are. Reserving in
+ * a transaction that is rolled back gives the block back.
+ *
+ * @param count How many uids to reserve.
+ * @return The first uid of the block, the rest follow it. 0 if this station ran out of uids.
+ */
+int DataBase::ReserveTeamUIDs(int count) {
+    if ( count <= 0 )
+        return 0;
+
+    const std::string query = std::format(
+        "UPDATE " UID_TABLE " SET nextUid = nextUid + ?1 WHERE nextUid + ?1 <= (prefix + 1) << {} RETURNING nextUid - ?1",
+        UID_SEQUENCE_BITS
+    );
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return 0;
+    }
+
+    sqlite3_bind_int(stmt, 1, count);
+
     int uid = 0;
+    if ( sqlite3_step(stmt) == SQLITE_ROW )
+        uid = sqlite3_column_int(stmt, 0);
+
+    sqlite3_finalize(stmt);
 
-    do {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1000, 9999);
-        uid = dis(gen);
-    } while ( TeamExistsUID(uid) );
+    if ( uid == 0 )
+        m_mainFrame->LogErrorMessage(std::format("This station can't hand out {} more uids.", count));
 
     return uid;
 }
@@ -906,13 +2856,15 @@ int DataBase::GetNextTeamUID() {
  * @return `true` if the table exists, `false` otherwise.
  */
 bool DataBase::TableExists(const std::string& tableName) {
+    ReadScope read(this);
+
     std::string query = "SELECT name FROM sqlite_master WHERE type='table' AND name='" + tableName + "';";
     sqlite3_stmt* stmt;
 
-    int res = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, NULL);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, NULL);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db)) 
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle())) 
         );
         return false;
     }
@@ -949,16 +2901,18 @@ bool DataBase::TableExists(const std::string& tableName) {
 void DataBase::ExportTableToJSON(const std::string& tableName, const std::string& outputFilename) {    
     using json = nlohmann::json;
 
+    ReadScope read(this);
+
     std::ofstream outFile(outputFilename);
     if ( !outFile )
         return;
 
     sqlite3_stmt* stmt;
     std::string query = "SELECT * FROM " + tableName + ";";
-    int res = sqlite3_prepare_v2(this->m_db, query.c_str(), -1, &stmt, nullptr);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, nullptr);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle()))
         );
         return;
     }
@@ -982,7 +2936,7 @@ void DataBase::ExportTableToJSON(const std::string& tableName, const std::string
     if ( outFile ) {
         outFile << records.dump(4);
         outFile.close();
-        this->m_mainFrame->LogBackendMessage("JSON data exported to " + outputFilename);
+        LogBackendMessage("JSON data exported to " + outputFilename);
     }
 
     sqlite3_finalize(stmt);
@@ -1001,13 +2955,15 @@ void DataBase::ExportTableToJSON(const std::string& tableName, const std::string
  * @note The output file is overwritten if it already exists.
  */
 void DataBase::ExportTableToCSV(const std::string& tableName, const std::string& outputFilename) {
+    ReadScope read(this);
+
     sqlite3_stmt* stmt;
     std::string query = "SELECT * FROM " + tableName + ";";
 
-    int res = sqlite3_prepare_v2(this->m_db, query.c_str(), -1, &stmt, nullptr);
+    int res = sqlite3_prepare_v2(read.Handle(), query.c_str(), -1, &stmt, nullptr);
     if ( res != SQLITE_OK ) {
-        m_mainFrame->LogErrorMessage(
-            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db)) 
+        LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(read.Handle())) 
         );
         return;
     }
@@ -1081,10 +3037,10 @@ void DataBase::ExportTOQRCode(const std::string& content, const std::string& out
     }
 
     if ( !stbi_write_png(outputFilename.c_str(), width, height, 3, image, width * 3) ) {
-        m_mainFrame->LogErrorMessage("Failed to write QR code to file.");
+        LogErrorMessage("Failed to write QR code to file.");
     }
 
-    m_mainFrame->LogBackendMessage("QR code generated and saved to " + outputFilename);
+    LogBackendMessage("QR code generated and saved to " + outputFilename);
 
     delete[] image;
 }
@@ -1117,6 +3073,8 @@ void DataBase::ImportTableFromCSV(const std::string& tableName, const std::strin
         return result;
     };
 
+    std::vector<Team> teams = {}; // added once every row is read, with a block of uids reserved for them
+
     while ( std::getline(csvfile, line) ) {
         std::vector<std::string> values = SplitString(line, ',');
 
@@ -1125,18 +3083,17 @@ void DataBase::ImportTableFromCSV(const std::string& tableName, const std::strin
             match.matchNum = std::stoi(values[0]);
             match.redWin = std::stoi(values[1]);
             match.blueWin = std::stoi(values[2]);
-            match.teams[0].teamNum = std::stoi(values[3]);
-            match.teams[1].teamNum = std::stoi(values[4]);
-            match.teams[2].teamNum = std::stoi(values[5]);
-            match.teams[3].teamNum = std::stoi(values[6]);
-            match.teams[4].teamNum = std::stoi(values[7]);
-            match.teams[5].teamNum = std::stoi(values[8]);
+            match.teams[0] = std::stoi(values[3]);
+            match.teams[1] = std::stoi(values[4]);
+            match.teams[2] = std::stoi(values[5]);
+            match.teams[3] = std::stoi(values[6]);
+            match.teams[4] = std::stoi(values[7]);
+            match.teams[5] = std::stoi(values[8]);
 
             AddMatch(match);
         }
         else if ( tableName == TEAM_TABLE ) {
             Team team = {};
-            team.uid = GetNextTeamUID();
             team.teamNum = std::stoi(values[0]);
             team.matchNum = std::stoi(values[1]);
             team.overall = std::stoi(values[2]);
@@ -1150,13 +3107,24 @@ void DataBase::ImportTableFromCSV(const std::string& tableName, const std::strin
             team.penaltys = std::stoi(values[10]);
             team.rankingPoints = std::stoi(values[11]);
 
-            AddTeam(team);
+            teams.push_back(team);
         }
         else {
             m_mainFrame->LogBackendMessage("Invalid table for import.");
             return;
         }
     }
+
+    if ( !teams.empty() ) {
+        int uid = ReserveTeamUIDs(static_cast< int >( teams.size() ));
+        if ( uid == 0 )
+            return;
+
+        for ( Team& team : teams ) {
+            team.uid = uid++;
+            AddTeam(team);
+        }
+    }
     m_mainFrame->LogBackendMessage("Data imported from " + inputFilename + " to " + tableName);
 }
 
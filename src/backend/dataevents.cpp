@@ -0,0 +1,142 @@
+#include "dataevents.h"
+
+#include <algorithm> // std::remove_if
+#include <set> // std::set
+
+DataEventBus::DataEventBus(std::function<void()> scheduler) : m_scheduler(std::move(scheduler)) {}
+
+/**
+ * @brief Records a write to a row, held until the transaction it was made in is committed.
+ *
+ * @param table Table the row is in.
+ * @param key uid of a scouted row, match number of a match.
+ * @param op What the write did.
+ */
+void DataEventBus::Record(const std::string& table, int key, DataOp op) {
+    m_uncommitted.push_back({ table, key, op });
+}
+
+/**
+ * @brief Combines the writes of the committed transaction with the earlier writes since the last delivery.
+ *
+ * Statements run outside an explicit transaction are committed on their own, one at a time.
+ */
+void DataEventBus::Commit() {
+    for ( const DataEvent& event : m_uncommitted )
+        Merge(event);
+
+    const bool written = !m_uncommitted.empty();
+    m_uncommitted.clear();
+    m_savepoints.clear();
+
+    if ( written && !m_scheduled && m_scheduler ) {
+        m_scheduled = true;
+        m_scheduler();
+    }
+}
+
+/**
+ * @brief Drops the writes of the transaction that was rolled back.
+ */
+void DataEventBus::Rollback() {
+    m_uncommitted.clear();
+    m_savepoints.clear();
+}
+
+/**
+ * @brief Marks where a savepoint began, so the writes after it can be dropped on their own.
+ */
+void DataEventBus::BeginSavepoint() {
+    m_savepoints.push_back(m_uncommitted.size());
+}
+
+/**
+ * @brief Keeps the writes since the innermost savepoint, as part of the transaction around it.
+ */
+void DataEventBus::ReleaseSavepoint() {
+    if ( !m_savepoints.empty() )
+        m_savepoints.pop_back();
+}
+
+/**
+ * @brief Drops the writes since the innermost savepoint, which is left.
+ */
+void DataEventBus::RollbackSavepoint() {
+    if ( m_savepoints.empty() )
+        return;
+
+    m_uncommitted.resize(m_savepoints.back());
+    m_savepoints.pop_back();
+}
+
+/**
+ * @brief Combines a committed write to a row with the earlier writes to it since the last delivery.
+ *
+ * @param event The write.
+ */
+void DataEventBus::Merge(const DataEvent& event) {
+    const Key row = { event.table, event.key };
+    const DataOp op = event.op;
+
+    auto it = m_pending.find(row);
+    if ( it == m_pending.end() ) {
+        m_pending.emplace(row, op);
+        m_order.push_back(row);
+    }
+    else {
+        const DataOp previous = it->second;
+
+        if ( previous == kDataInserted && op == kDataDeleted )
+            m_pending.erase(it); // never seen, nothing to tell
+        else if ( previous == kDataInserted )
+            it->second = kDataInserted; // still new, whatever it holds now
+        else if ( previous == kDataDeleted && op != kDataDeleted )
+            it->second = kDataUpdated; // gone and back again
+        else
+            it->second = op;
+    }
+}
+
+/**
+ * @brief Hands every row committed since the last delivery to the subscribers, as one batch.
+ *
+ * Rows written while the subscribers run are recorded for the next batch. Writes of a
+ * transaction still open aren't delivered, they wait for it to be committed.
+ */
+void DataEventBus::Deliver() {
+    m_scheduled = false;
+
+    DataEventBatch batch = {};
+    std::set<Key> delivered = {};
+    for ( const Key& row : m_order ) {
+        auto it = m_pending.find(row);
+        if ( it == m_pending.end() || !delivered.insert(row).second )
+            continue;
+
+        batch.events.push_back({ row.first, row.second, it->second });
+    }
+
+    m_pending.clear();
+    m_order.clear();
+
+    if ( batch.Empty() )
+        return;
+
+    // copied so a subscriber can unsubscribe while being called
+    const std::vector<std::pair<size_t, Subscriber>> subscribers = m_subscribers;
+    for ( const auto& [id, subscriber] : subscribers )
+        subscriber(batch);
+}
+
+size_t DataEventBus::Subscribe(Subscriber subscriber) {
+    const size_t id = m_nextId++;
+    m_subscribers.emplace_back(id, std::move(subscriber));
+    return id;
+}
+
+void DataEventBus::Unsubscribe(size_t id) {
+    m_subscribers.erase(
+        std::remove_if(m_subscribers.begin(), m_subscribers.end(), [id](const auto& subscriber) { return subscriber.first == id; }),
+        m_subscribers.end()
+    );
+}
@@ -0,0 +1,373 @@
+#include "dataset.h"
+
+// Backend
+#include "backend/elo.h"
+
+#include <algorithm> // std::stable_sort, std::all_of, std::count_if
+#include <cmath> // std::lround
+#include <format> // std::format
+#include <fstream> // std::ifstream, std::ofstream
+#include <latch> // std::latch
+#include <unordered_map> // std::unordered_map
+
+/**
+ * @brief Converts the match to how the app stores it, so it can be replayed by the rating code.
+ *
+ * @return The match with its teams and winner. Both alliances win a tie and neither wins an unplayed match.
+ */
+Match EventMatch::ToMatch() const {
+    Match match = {};
+    match.matchNum = this->matchNum;
+    match.teams = this->teams;
+    match.teamCount = static_cast< uint8_t >( std::count_if(this->teams.begin(), this->teams.end(), [](int teamNum) {
+        return teamNum != 0;
+    }) );
+    match.redWin = Played() && this->redScore >= this->blueScore;
+    match.blueWin = Played() && this->blueScore >= this->redScore;
+
+    return match;
+}
+
+MatchFileHandler::MatchFileHandler(std::vector<EventMatch>& matches)
+    : m_matches(matches)
+{
+}
+
+/**
+ * @brief Containers open around the current value, 1 for the fields of the response itself.
+ */
+int MatchFileHandler::Depth() const {
+    return static_cast< int >( m_containers.size() );
+}
+
+/**
+ * @brief Stores a number in the field of the match or team being read named by the current key.
+ *
+ * @param value The number read.
+ */
+void MatchFileHandler::SetNumber(int value) {
+    if ( m_inTeams && Depth() == 5 ) {
+        if ( m_key == "teamNumber" )
+            m_teamNum = value;
+
+        return;
+    }
+
+    if ( !m_inMatches || Depth() != 3 )
+        return;
+
+    if ( m_key == "matchNumber" )
+        m_match.matchNum = value;
+    else if ( m_key == "scoreRedFinal" )
+        m_match.redScore = value;
+    else if ( m_key == "scoreBlueFinal" )
+        m_match.blueScore = value;
+}
+
+bool MatchFileHandler::null() {
+    return true; // unplayed matches have null scores, which are already -1
+}
+
+bool MatchFileHandler::boolean(bool val) {
+    return true;
+}
+
+bool MatchFileHandler::number_integer(number_integer_t val) {
+    SetNumber(static_cast< int >( val ));
+    return true;
+}
+
+bool MatchFileHandler::number_unsigned(number_unsigned_t val) {
+    SetNumber(static_cast< int >( val ));
+    return true;
+}
+
+bool MatchFileHandler::number_float(number_float_t val, const string_t& s) {
+    SetNumber(static_cast< int >( std::lround(val) ));
+    return true;
+}
+
+bool MatchFileHandler::string(string_t& val) {
+    if ( m_inTeams && Depth() == 5 && m_key == "station" )
+        m_station = val;
+    else if ( m_inMatches && Depth() == 3 && m_key == "actualStartTime" )
+        m_match.startTime = val;
+
+    return true;
+}
+
+bool MatchFileHandler::binary(binary_t& val) {
+    return true;
+}
+
+bool MatchFileHandler::start_object(std::size_t elements) {
+    m_containers.push_back(false);
+
+    if ( m_inTeams && Depth() == 5 ) {
+        m_teamNum = 0;
+        m_station = "";
+    }
+    else if ( m_inMatches && Depth() == 3 ) {
+        m_match = {};
+    }
+
+    return true;
+}
+
+bool MatchFileHandler::key(string_t& val) {
+    m_key = val;
+    return true;
+}
+
+bool MatchFileHandler::end_object() {
+    if ( m_inTeams && Depth() == 5 ) {
+        // "Red1" - "Red3" fill slots 0 - 2, "Blue1" - "Blue3" fill slots 3 - 5
+        const bool red = m_station.starts_with("Red");
+        const bool blue = m_station.starts_with("Blue");
+        const int position = m_station.empty() ? 0 : m_station.back() - '0';
+
+        if ( ( red || blue ) && position >= 1 && position <= 3 )
+            m_match.teams[( blue ? 3 : 0 ) + position - 1] = m_teamNum;
+    }
+    else if ( m_inMatches && Depth() == 3 ) {
+        m_matches.push_back(m_match);
+    }
+
+    m_containers.pop_back();
+    return true;
+}
+
+bool MatchFileHandler::start_array(std::size_t elements) {
+    if ( Depth() == 1 && m_key == "Matches" )
+        m_inMatches = true;
+    else if ( m_inMatches && Depth() == 3 && m_key == "teams" )
+        m_inTeams = true;
+
+    m_containers.push_back(true);
+    return true;
+}
+
+bool MatchFileHandler::end_array() {
+    m_containers.pop_back();
+
+    if ( Depth() == 1 )
+        m_inMatches = false;
+    else if ( Depth() == 3 )
+        m_inTeams = false;
+
+    return true;
+}
+
+bool MatchFileHandler::parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) {
+    m_error = ex.what();
+    return false;
+}
+
+DatasetBuilder::DatasetBuilder(MainFrame* mainFrame, ThreadPool* threadPool)
+    : m_mainFrame(mainFrame), m_threadPool(threadPool)
+{
+}
+
+/**
+ * @brief Reads the matches of a saved FRC API `/matches` response.
+ *
+ * @param path Path to the JSON file.
+ * @param matches Set to the matches in the file, in the order they are listed.
+ * @param error Set to why the file couldn't be read.
+ * @return true if the file was read, otherwise false.
+ */
+bool DatasetBuilder::LoadEventFile(const std::string& path, std::vector<EventMatch>& matches, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if ( !file ) {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    matches.clear();
+    MatchFileHandler handler(matches);
+    if ( !nlohmann::json::sax_parse(file, &handler) ) {
+        error = "Could not read " + path + ": " + handler.GetError();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replays the matches of an event, turning each played match into a training point.
+ *
+ * Matches are replayed in the order they started, or in file order if a start time is missing.
+ * The features of a match are calculated before its result is applied. Ties are applied
+ * but left out of the training set, since the model only predicts a red or a blue win.
+ *
+ * @param matches The matches of the event.
+ * @param features The features of each decided match are appended to this.
+ * @param labels 1 for a red win and 0 for a blue win is appended for each decided match.
+ */
+void DatasetBuilder::BuildEvent(
+    std::vector<EventMatch> matches,
+    std::vector<MatchFeatures>& features,
+    std::vector<size_t>& labels
+)
+{
+    const bool timed = std::all_of(matches.begin(), matches.end(), [](const EventMatch& match) {
+        return !match.startTime.empty();
+    });
+
+    // ISO 8601 times in the same format sort the same as the times they stand for
+    if ( timed ) {
+        std::stable_sort(matches.begin(), matches.end(), [](const EventMatch& a, const EventMatch& b) {
+            return a.startTime < b.startTime;
+        });
+    }
+
+    // rolling state of every team, the same as FeaturePipeline::GetFeaturesBeforeMatches
+    struct TeamState {
+        double wins = 0.0;
+        int played = 0;
+    };
+
+    std::unordered_map<int, TeamState> states = {};
+    std::unordered_map<int, double> ratings = {}; // team number -> Elo rating
+
+    for ( const EventMatch& eventMatch : matches ) {
+        if ( !eventMatch.Played() )
+            continue;
+
+        const Match match = eventMatch.ToMatch();
+
+        // features as of before this match, scouting features and OPR stay at zero
+        std::array<TeamFeatures, 6> teams = {};
+        for ( int slot = 0; slot < 6; slot++ ) {
+            const int teamNum = match.teams[slot];
+            if ( teamNum == 0 ) // empty slot
+                continue;
+
+            const TeamState& state = states[teamNum];
+            teams[slot][kFeatureWinRate] = ( state.played > 0 ) ? state.wins / state.played : 0.0;
+
+            auto rating = ratings.find(teamNum);
+            teams[slot][kFeatureElo] = ( rating != ratings.end() ) ? rating->second : ELO_INITIAL_RATING;
+        }
+
+        if ( !match.IsTie() ) {
+            features.push_back(FeaturePipeline::CombineAlliances(match.teams, teams));
+            labels.push_back(match.RedWon() ? 1 : 0);
+        }
+
+        // apply the result
+        for ( int slot = 0; slot < 6; slot++ ) {
+            const int teamNum = match.teams[slot];
+            if ( teamNum == 0 ) // empty slot
+                continue;
+
+            TeamState& state = states[teamNum];
+            state.played++;
+            state.wins += match.AllianceResult(slot < 3);
+        }
+
+        EloRating::ApplyMatch(ratings, match);
+    }
+}
+
+/**
+ * @brief Builds the training set of every event, in parallel on the thread pool.
+ *
+ * Files that can't be read are logged and skipped. Runs on a background thread.
+ *
+ * @param paths Paths to the saved match results of each event.
+ * @param features Set to the features of every decided match, event by event in the order of 'paths'.
+ * @param labels Set to 1 for each red win and 0 for each blue win.
+ * @return true if at least one file was read, otherwise false.
+ */
+bool DatasetBuilder::Build(
+    const std::vector<std::string>& paths,
+    std::vector<MatchFeatures>& features,
+    std::vector<size_t>& labels
+)
+{
+    struct EventPoints {
+        bool loaded = false;
+        std::string error = "";
+        std::vector<MatchFeatures> features = {};
+        std::vector<size_t> labels = {};
+    };
+
+    std::vector<EventPoints> events(paths.size());
+    std::latch done(static_cast< std::ptrdiff_t >( paths.size() ));
+
+    for ( size_t i = 0; i < paths.size(); i++ ) {
+        m_threadPool->Submit([&paths, &events, &done, i] {
+            EventPoints& event = events[i];
+
+            std::vector<EventMatch> matches = {};
+            event.loaded = LoadEventFile(paths[i], matches, event.error);
+            if ( event.loaded )
+                BuildEvent(std::move(matches), event.features, event.labels);
+
+            done.count_down();
+        });
+    }
+
+    done.wait();
+
+    features.clear();
+    labels.clear();
+
+    bool loaded = false;
+    for ( EventPoints& event : events ) {
+        if ( !event.loaded ) {
+            m_mainFrame->CallAfter([this, msg = event.error] { m_mainFrame->LogErrorMessage(msg); });
+            continue;
+        }
+
+        loaded = true;
+        features.insert(features.end(), event.features.begin(), event.features.end());
+        labels.insert(labels.end(), event.labels.begin(), event.labels.end());
+    }
+
+    return loaded;
+}
+
+/**
+ * @brief Writes a training set in the format `RFPredictor` loads.
+ *
+ * Values are written with the fewest digits that read back as the same double,
+ * so a training set loads exactly as it was built.
+ *
+ * @param featuresPath Path to write the features to, one match per row.
+ * @param labelsPath Path to write the labels to, one match per row.
+ * @param features The features of each match.
+ * @param labels 1 for each red win and 0 for each blue win.
+ * @return true if both files were written, otherwise false.
+ */
+bool DatasetBuilder::WriteTrainingSet(
+    const std::string& featuresPath,
+    const std::string& labelsPath,
+    const std::vector<MatchFeatures>& features,
+    const std::vector<size_t>& labels
+)
+{
+    std::ofstream featuresFile(featuresPath, std::ios::binary);
+    std::ofstream labelsFile(labelsPath, std::ios::binary);
+    if ( !featuresFile || !labelsFile )
+        return false;
+
+    std::string line = "";
+    for ( const MatchFeatures& point : features ) {
+        line.clear();
+        for ( int i = 0; i < MATCH_FEATURE_COUNT; i++ ) {
+            if ( i > 0 )
+                line += ',';
+            line += std::format("{}", point[i]);
+        }
+
+        line += '\n';
+        featuresFile << line;
+    }
+
+    for ( size_t label : labels )
+        labelsFile << label << '\n';
+
+    return featuresFile.good() && labelsFile.good();
+}
@@ -0,0 +1,226 @@
+#include "elo.h"
+
+#include <algorithm> // std::sort, std::remove_if
+#include <cmath> // std::pow
+
+EloRating::EloRating(MainFrame* mainFrame, DataBase* dataBase)
+    : m_mainFrame(mainFrame), m_dataBase(dataBase)
+{
+    Load();
+}
+
+/**
+ * @brief Restores ratings from the Ratings table.
+ *
+ * The latest saved rating of each team becomes its current rating. Any played matches
+ * after the last saved match (e.g imported while the ratings weren't being kept) are
+ * processed afterwards so the ratings are up to date.
+ */
+void EloRating::Load() {
+    for ( const RatingRecord& record : m_dataBase->GetRatingHistory() ) {
+        m_history[record.teamNum].push_back(record);
+        m_ratings[record.teamNum] = record.rating; // records are ordered, so the last one wins
+        m_lastMatchNum = std::max(m_lastMatchNum, record.matchNum);
+    }
+
+    ReplayFrom(m_lastMatchNum + 1);
+}
+
+/**
+ * @brief Updates ratings after a match result is entered, changed or removed.
+ *
+ * If no later match has been processed yet the match is simply processed, which only
+ * touches the six teams in it. Otherwise the ratings are replayed from this match.
+ *
+ * @param matchNum The match number of the match whose result changed.
+ */
+void EloRating::UpdateMatch(int matchNum) {
+    if ( matchNum <= m_lastMatchNum ) {
+        ReplayFrom(matchNum);
+        return;
+    }
+
+    // an unplayed match changes no rating, so there is nothing to save
+    const std::vector<RatingRecord> records = ProcessMatch(m_dataBase->GetMatch(matchNum));
+    if ( !records.empty() )
+        m_dataBase->AddRatingHistory(records);
+}
+
+/**
+ * @brief Recalculates ratings from a match onwards.
+ *
+ * Every team is rewound to the rating it had before `matchNum` (or the initial rating),
+ * saved history from `matchNum` onwards is dropped, and every played match from
+ * `matchNum` onwards is processed again in order.
+ *
+ * @param matchNum The first match number to recalculate ratings for.
+ */
+void EloRating::ReplayFrom(int matchNum) {
+    // rewind each team to the last rating it had before 'matchNum'
+    m_lastMatchNum = 0;
+    for ( auto it = m_history.begin(); it != m_history.end(); ) {
+        std::vector<RatingRecord>& history = it->second;
+        history.erase(
+            std::remove_if(history.begin(), history.end(), [matchNum](const RatingRecord& r) { return r.matchNum >= matchNum; }),
+            history.end()
+        );
+
+        if ( history.empty() ) {
+            m_ratings.erase(it->first);
+            it = m_history.erase(it);
+            continue;
+        }
+
+        m_ratings[it->first] = history.back().rating;
+        m_lastMatchNum = std::max(m_lastMatchNum, history.back().matchNum);
+        ++it;
+    }
+
+    m_dataBase->RemoveRatingHistory(matchNum);
+
+    // process the remaining matches in order
+    std::vector<Match> matches = m_dataBase->GetMatches();
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.matchNum < b.matchNum;
+    });
+
+    std::vector<RatingRecord> records = {};
+    for ( const Match& match : matches ) {
+        if ( match.matchNum < matchNum )
+            continue;
+
+        std::vector<RatingRecord> changes = ProcessMatch(match);
+        records.insert(records.end(), changes.begin(), changes.end());
+    }
+
+    m_dataBase->AddRatingHistory(records);
+}
+
+/**
+ * @brief Retrieves the current rating of a team.
+ *
+ * @param teamNum The team number to get the rating of.
+ * @return The team's rating, or the initial rating if it hasn't played a match.
+ */
+double EloRating::GetTeamRating(int teamNum) const {
+    auto it = m_ratings.find(teamNum);
+    if ( it == m_ratings.end() )
+        return ELO_INITIAL_RATING;
+
+    return it->second;
+}
+
+/**
+ * @brief Retrieves the rating a team had after each match it played.
+ *
+ * @param teamNum The team number to get the history of.
+ * @return The team's ratings ordered by match number, empty if it hasn't played.
+ */
+std::vector<RatingRecord> EloRating::GetTeamHistory(int teamNum) const {
+    auto it = m_history.find(teamNum);
+    if ( it == m_history.end() )
+        return {};
+
+    return it->second;
+}
+
+/**
+ * @brief Calculates the chance of the red alliance winning a match.
+ *
+ * @param match The match to calculate the chance for.
+ * @return The expected score of the red alliance, between 0 and 1.
+ */
+double EloRating::RedWinProbability(const Match& match) const {
+    return RedWinProbability(m_ratings, match);
+}
+
+/**
+ * @brief Calculates the chance of the red alliance winning a match with the given ratings.
+ *
+ * @param ratings Team number -> rating. Teams that aren't in it have the initial rating.
+ * @param match The match to calculate the chance for.
+ * @return The expected score of the red alliance, between 0 and 1.
+ */
+double EloRating::RedWinProbability(const std::unordered_map<int, double>& ratings, const Match& match) {
+    const double red = AllianceRating(ratings, match, 0);
+    const double blue = AllianceRating(ratings, match, 3);
+
+    return 1.0 / ( 1.0 + std::pow(10.0, ( blue - red ) / ELO_SCALE) );
+}
+
+/**
+ * @brief Updates the ratings of the teams in a played match.
+ *
+ * Both alliances move by the same amount in opposite directions, so
+ * the total rating of the event stays the same.
+ *
+ * @param match The match to process. Unplayed matches are ignored.
+ * @return The new ratings of the teams in the match, to be saved.
+ */
+std::vector<RatingRecord> EloRating::ProcessMatch(const Match& match) {
+    if ( !match.IsPlayed() )
+        return {};
+
+    ApplyMatch(m_ratings, match);
+
+    std::vector<RatingRecord> records = {};
+    for ( int teamNum : match.teams ) {
+        if ( teamNum == 0 ) // empty slot
+            continue;
+
+        RatingRecord record = { teamNum, match.matchNum, m_ratings[teamNum] };
+        m_history[teamNum].push_back(record);
+        records.push_back(record);
+    }
+
+    m_lastMatchNum = std::max(m_lastMatchNum, match.matchNum);
+
+    return records;
+}
+
+/**
+ * @brief Moves the ratings of the teams in a played match by `K * (actual - expected)`.
+ *
+ * @param ratings Team number -> rating, updated in place. Teams that aren't in it start at the initial rating.
+ * @param match The match to apply. Unplayed matches are ignored.
+ */
+void EloRating::ApplyMatch(std::unordered_map<int, double>& ratings, const Match& match) {
+    if ( !match.IsPlayed() )
+        return;
+
+    const double change = ELO_K_FACTOR * ( match.AllianceResult(true) - RedWinProbability(ratings, match) );
+
+    for ( int i = 0; i < 6; i++ ) {
+        const int teamNum = match.teams[i];
+        if ( teamNum == 0 ) // empty slot
+            continue;
+
+        auto it = ratings.try_emplace(teamNum, ELO_INITIAL_RATING).first;
+        it->second += ( i < 3 ) ? change : -change;
+    }
+}
+
+/**
+ * @brief Calculates the average rating of an alliance.
+ *
+ * @param ratings Team number -> rating. Teams that aren't in it have the initial rating.
+ * @param match The match the alliance is in.
+ * @param firstSlot 0 for the red alliance, 3 for the blue alliance.
+ * @return The average rating of the teams on the alliance, ignoring empty slots.
+ */
+double EloRating::AllianceRating(const std::unordered_map<int, double>& ratings, const Match& match, int firstSlot) {
+    double total = 0.0;
+    int teamCount = 0;
+
+    for ( int i = firstSlot; i < firstSlot + 3; i++ ) {
+        const int teamNum = match.teams[i];
+        if ( teamNum == 0 )
+            continue;
+
+        auto it = ratings.find(teamNum);
+        total += ( it == ratings.end() ) ? ELO_INITIAL_RATING : it->second;
+        teamCount++;
+    }
+
+    return ( teamCount == 0 ) ? ELO_INITIAL_RATING : total / teamCount;
+}
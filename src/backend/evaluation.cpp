@@ -0,0 +1,328 @@
+#include "evaluation.h"
+
+#include <algorithm> // std::sort, std::shuffle, std::clamp
+#include <chrono> // std::chrono::steady_clock
+#include <cmath> // std::log, std::abs
+#include <format> // std::format
+#include <fstream> // std::ofstream
+#include <numeric> // std::iota
+#include <random> // std::mt19937_64
+
+/**
+ * @brief Counts collected while testing one fold.
+ */
+struct FoldStats {
+    size_t tested = 0;
+    size_t correct = 0;
+    double logLoss = 0.0;
+    std::array<size_t, EVAL_CALIBRATION_BINS> binCounts = {};
+    std::array<double, EVAL_CALIBRATION_BINS> binPredicted = {};
+    std::array<size_t, EVAL_CALIBRATION_BINS> binRedWins = {};
+    double trainMs = 0.0;
+    double inferenceUs = 0.0;
+    bool cancelled = false;
+};
+
+ModelEvaluator::ModelEvaluator(MainFrame* mainFrame, ThreadPool* threadPool)
+    : m_mainFrame(mainFrame), m_threadPool(threadPool)
+{
+}
+
+/**
+ * @brief Builds every combination of tree count, minimum leaf size and maximum depth searched.
+ *
+ * @return The parameters to evaluate.
+ */
+std::vector<ForestParams> ModelEvaluator::FullGrid() {
+    const size_t treeCounts[] = { 10, 20, 40, 80, 160 };
+    const size_t minLeafSizes[] = { 1, 3, 6, 12 };
+    const size_t maxDepths[] = { 0, 6, 12 }; // 0 is no limit
+
+    std::vector<ForestParams> grid = {};
+    for ( size_t treeCount : treeCounts ) {
+        for ( size_t minLeafSize : minLeafSizes ) {
+            for ( size_t maxDepth : maxDepths )
+                grid.push_back({ treeCount, minLeafSize, maxDepth });
+        }
+    }
+
+    return grid;
+}
+
+/**
+ * @brief Picks random combinations from the full grid, for a quicker search.
+ *
+ * @param count How many combinations to pick. Capped at the size of the full grid.
+ * @param seed Seed for picking the combinations.
+ * @return The parameters to evaluate.
+ */
+std::vector<ForestParams> ModelEvaluator::RandomGrid(size_t count, uint64_t seed) {
+    std::vector<ForestParams> grid = FullGrid();
+    std::mt19937_64 rng(seed);
+    std::shuffle(grid.begin(), grid.end(), rng);
+
+    grid.resize(std::min(count, grid.size()));
+    return grid;
+}
+
+/**
+ * @brief Cross-validates one set of parameters.
+ *
+ * Matches are shuffled and split into `foldCount` folds. Each fold is held out in turn while
+ * a forest is trained on the rest. Folds run one after another, the trees of each are trained
+ * in parallel on the thread pool, so however many folds there are the machine isn't oversubscribed.
+ *
+ * @param features Matches to evaluate on, one per column.
+ * @param labels 1 for each red win and 0 for each blue win.
+ * @param params The parameters to evaluate.
+ * @param foldCount The number of folds, at least 2.
+ * @param seed Seed for shuffling the folds and training the forests.
+ * @return How the parameters did across every fold.
+ */
+EvaluationResult ModelEvaluator::CrossValidate(
+    const arma::mat& features,
+    const arma::Row<size_t>& labels,
+    const ForestParams& params,
+    size_t foldCount,
+    uint64_t seed
+)
+{
+    const size_t matchCount = features.n_cols;
+    foldCount = std::clamp<size_t>(foldCount, 2, matchCount);
+
+    // the same seed gives the same folds, so every set of parameters is tested on the same splits
+    std::vector<arma::uword> order(matchCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<FoldStats> folds(foldCount);
+
+    // one fold at a time, training a fold's trees already keeps every thread of the pool busy
+    for ( size_t fold = 0; fold < foldCount; fold++ ) {
+        FoldStats& stats = folds[fold];
+
+        const size_t testBegin = fold * matchCount / foldCount;
+        const size_t testEnd = ( fold + 1 ) * matchCount / foldCount;
+
+        std::vector<arma::uword> trainIndices = {};
+        std::vector<arma::uword> testIndices = {};
+        for ( size_t i = 0; i < matchCount; i++ )
+            ( ( i >= testBegin && i < testEnd ) ? testIndices : trainIndices ).push_back(order[i]);
+
+        const arma::uvec trainCols(trainIndices);
+        const arma::mat trainFeatures = features.cols(trainCols);
+        const arma::Row<size_t> trainLabels = labels.cols(trainCols);
+
+        const auto trainStart = std::chrono::steady_clock::now();
+        std::shared_ptr<Forest> forest = Forest::Train(
+            trainFeatures, trainLabels, params, m_threadPool, seed + fold * 7919, nullptr, m_cancel
+        );
+        stats.trainMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - trainStart).count();
+
+        if ( !forest ) {
+            stats.cancelled = true;
+            break;
+        }
+
+        const auto inferenceStart = std::chrono::steady_clock::now();
+        for ( arma::uword index : testIndices ) {
+            size_t prediction = 0;
+            arma::vec probabilities;
+            forest->Classify(arma::vec(features.col(index)), prediction, probabilities);
+
+            const bool redWon = labels(index) == 1;
+            const double redWinProbability = ( probabilities.n_elem > 1 ) ? probabilities(1) : 0.0;
+            const double clipped = std::clamp(redWinProbability, EVAL_PROBABILITY_CLIP, 1.0 - EVAL_PROBABILITY_CLIP);
+
+            stats.tested++;
+            if ( prediction == labels(index) )
+                stats.correct++;
+
+            stats.logLoss -= std::log(redWon ? clipped : 1.0 - clipped);
+
+            const size_t bin = std::min<size_t>(static_cast< size_t >( redWinProbability * EVAL_CALIBRATION_BINS ), EVAL_CALIBRATION_BINS - 1);
+            stats.binCounts[bin]++;
+            stats.binPredicted[bin] += redWinProbability;
+            stats.binRedWins[bin] += redWon ? 1 : 0;
+        }
+        stats.inferenceUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - inferenceStart).count();
+    }
+
+    // merge the folds
+    EvaluationResult result = { params, 0.0, 0.0, 0.0, {}, 0.0, 0.0 };
+    FoldStats total = {};
+    for ( const FoldStats& stats : folds ) {
+        total.tested += stats.tested;
+        total.correct += stats.correct;
+        total.logLoss += stats.logLoss;
+        total.trainMs += stats.trainMs;
+        total.inferenceUs += stats.inferenceUs;
+        total.cancelled |= stats.cancelled;
+
+        for ( size_t bin = 0; bin < EVAL_CALIBRATION_BINS; bin++ ) {
+            total.binCounts[bin] += stats.binCounts[bin];
+            total.binPredicted[bin] += stats.binPredicted[bin];
+            total.binRedWins[bin] += stats.binRedWins[bin];
+        }
+    }
+
+    if ( total.cancelled || total.tested == 0 )
+        return result;
+
+    result.accuracy = 100.0 * total.correct / total.tested;
+    result.logLoss = total.logLoss / total.tested;
+    result.trainMs = total.trainMs / foldCount;
+    result.inferenceUs = total.inferenceUs / total.tested;
+
+    for ( size_t bin = 0; bin < EVAL_CALIBRATION_BINS; bin++ ) {
+        CalibrationBin& calibration = result.calibration[bin];
+        calibration.count = total.binCounts[bin];
+        if ( calibration.count == 0 )
+            continue;
+
+        calibration.meanPredicted = total.binPredicted[bin] / calibration.count;
+        calibration.observedRedWins = static_cast< double >( total.binRedWins[bin] ) / calibration.count;
+        result.calibrationError += std::abs(calibration.meanPredicted - calibration.observedRedWins) * calibration.count / total.tested;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Cross-validates every set of parameters in a grid.
+ *
+ * Blocks until the search finishes, so it should be called from a background thread.
+ *
+ * @param features Matches to evaluate on, one per column.
+ * @param labels 1 for each red win and 0 for each blue win.
+ * @param grid The parameters to evaluate.
+ * @param foldCount The number of folds.
+ * @param seed Seed for the folds and forests, shared by every set of parameters.
+ * @return The result of each set of parameters, most accurate first. Empty if cancelled.
+ */
+std::vector<EvaluationResult> ModelEvaluator::Search(
+    const arma::mat& features,
+    const arma::Row<size_t>& labels,
+    const std::vector<ForestParams>& grid,
+    size_t foldCount,
+    uint64_t seed
+)
+{
+    std::vector<EvaluationResult> results = {};
+
+    for ( size_t i = 0; i < grid.size(); i++ ) {
+        EvaluationResult result = CrossValidate(features, labels, grid[i], foldCount, seed);
+        if ( m_cancel )
+            return {};
+
+        results.push_back(result);
+
+        m_mainFrame->CallAfter([this, i, count = grid.size()] {
+            m_mainFrame->LogProgress("Evaluating model parameters", i + 1, count);
+        });
+    }
+
+    std::sort(results.begin(), results.end(), [](const EvaluationResult& a, const EvaluationResult& b) {
+        return a.accuracy > b.accuracy;
+    });
+
+    return results;
+}
+
+/**
+ * @brief Picks the smallest, fastest forest that keeps the accuracy.
+ *
+ * @param results The search results.
+ * @return The index of the result with the fewest trees (then fastest inference) whose
+ *         accuracy is within `EVAL_ACCURACY_TOLERANCE` of the best.
+ */
+size_t ModelEvaluator::Recommend(const std::vector<EvaluationResult>& results) {
+    double bestAccuracy = 0.0;
+    for ( const EvaluationResult& result : results )
+        bestAccuracy = std::max(bestAccuracy, result.accuracy);
+
+    size_t recommended = 0;
+    for ( size_t i = 0; i < results.size(); i++ ) {
+        const EvaluationResult& result = results[i];
+        if ( result.accuracy < bestAccuracy - EVAL_ACCURACY_TOLERANCE )
+            continue;
+
+        const EvaluationResult& current = results[recommended];
+        if ( current.accuracy < bestAccuracy - EVAL_ACCURACY_TOLERANCE ||
+             result.params.treeCount < current.params.treeCount ||
+             ( result.params.treeCount == current.params.treeCount && result.inferenceUs < current.inferenceUs ) )
+            recommended = i;
+    }
+
+    return recommended;
+}
+
+/**
+ * @brief Writes the search results to a text report.
+ *
+ * The report has a summary row for every set of parameters, then the
+ * calibration table of the recommended one.
+ *
+ * @param path Where to write the report.
+ * @param results The search results, most accurate first.
+ * @param matchCount The number of matches evaluated on.
+ * @return true if the report was written, otherwise false.
+ */
+bool ModelEvaluator::WriteReport(const std::string& path, const std::vector<EvaluationResult>& results, size_t matchCount) {
+    if ( results.empty() )
+        return false;
+
+    std::ofstream file(path);
+    if ( !file.is_open() )
+        return false;
+
+    const size_t recommended = Recommend(results);
+
+    file << std::format("Cross-validated on {} matches\n\n", matchCount);
+    file << std::format("{:>6}{:>9}{:>7}{:>11}{:>10}{:>8}{:>11}{:>14}\n",
+        "Trees", "MinLeaf", "Depth", "Accuracy", "LogLoss", "ECE", "Train ms", "Predict us");
+
+    for ( size_t i = 0; i < results.size(); i++ ) {
+        const EvaluationResult& result = results[i];
+        file << std::format("{:>6}{:>9}{:>7}{:>10.2f}%{:>10.4f}{:>8.4f}{:>11.1f}{:>14.2f}{}\n",
+            result.params.treeCount, result.params.minLeafSize, result.params.maxDepth,
+            result.accuracy, result.logLoss, result.calibrationError, result.trainMs, result.inferenceUs,
+            ( i == recommended ) ? "  <- recommended" : "");
+    }
+
+    const EvaluationResult& best = results[recommended];
+    file << std::format("\nCalibration of {} trees, min leaf {}, depth {}\n", best.params.treeCount, best.params.minLeafSize, best.params.maxDepth);
+    file << std::format("{:>12}{:>8}{:>12}{:>12}\n", "Predicted", "Count", "Mean", "Observed");
+
+    for ( size_t bin = 0; bin < EVAL_CALIBRATION_BINS; bin++ ) {
+        const CalibrationBin& calibration = best.calibration[bin];
+        const std::string range = std::format("{:.1f}-{:.1f}",
+            static_cast< double >( bin ) / EVAL_CALIBRATION_BINS, static_cast< double >( bin + 1 ) / EVAL_CALIBRATION_BINS);
+
+        file << std::format("{:>12}{:>8}{:>12.3f}{:>12.3f}\n", range, calibration.count, calibration.meanPredicted, calibration.observedRedWins);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Marks a run as started so only one runs at a time.
+ *
+ * @return true if no other run was in progress, otherwise false.
+ */
+bool ModelEvaluator::TryBeginRun() {
+    bool expected = false;
+    if ( !m_running.compare_exchange_strong(expected, true) )
+        return false;
+
+    m_cancel = false;
+    return true;
+}
+
+/**
+ * @brief Marks the current run as finished.
+ */
+void ModelEvaluator::EndRun() {
+    m_running = false;
+}
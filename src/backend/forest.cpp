@@ -0,0 +1,216 @@
+#include "forest.h"
+
+#include <algorithm> // std::min, std::max
+#include <latch> // std::latch
+#include <random> // std::mt19937_64, std::uniform_int_distribution
+
+/**
+ * @brief Trains a forest, one tree per thread pool task.
+ *
+ * Blocks until every tree is trained, so it should be called from a background thread.
+ *
+ * @param features Training points, one per column.
+ * @param labels Class of each training point.
+ * @param params Hyperparameters of the forest.
+ * @param threadPool Pool to train the trees on.
+ * @param seed Seed for the bootstrap samples and split dimensions. The same seed and data give the same forest.
+ * @param progress Called from a worker thread after each tree is trained. May be empty.
+ * @param cancel Checked before each tree is trained. Setting it stops training.
+ * @return The trained forest, or nullptr if training was cancelled.
+ */
+std::shared_ptr<Forest> Forest::Train(
+    const arma::mat& features,
+    const arma::Row<size_t>& labels,
+    const ForestParams& params,
+    ThreadPool* threadPool,
+    uint64_t seed,
+    const Progress& progress,
+    const std::atomic<bool>& cancel
+)
+{
+    std::shared_ptr<Forest> forest = std::make_shared<Forest>();
+    forest->m_numClasses = ( labels.n_elem == 0 ) ? 0 : labels.max() + 1;
+
+    if ( !TrainTrees(features, labels, forest->m_numClasses, params, params.treeCount, threadPool, seed, progress, cancel, forest->m_trees) )
+        return nullptr;
+
+    return forest;
+}
+
+/**
+ * @brief Builds a new forest from an existing one by retraining only some of its trees.
+ *
+ * `replaceCount` new trees are trained on the (usually grown) training set and replace the
+ * oldest trees of `base`. If `base` has fewer than `params.treeCount` trees the new trees are
+ * added instead, until it is full. `base` itself isn't modified, so it can keep predicting
+ * while the new forest is built.
+ *
+ * @param base The forest to start from.
+ * @param features Training points, one per column. Includes the points `base` was trained on.
+ * @param labels Class of each training point.
+ * @param params Hyperparameters of the forest. `treeCount` is the size the forest is kept at.
+ * @param replaceCount The number of new trees to train.
+ * @param threadPool Pool to train the trees on.
+ * @param seed Seed for the bootstrap samples and split dimensions of the new trees.
+ * @param progress Called from a worker thread after each new tree is trained. May be empty.
+ * @param cancel Checked before each tree is trained. Setting it stops training.
+ * @return The new forest, or nullptr if training was cancelled.
+ */
+std::shared_ptr<Forest> Forest::WarmStart(
+    const Forest& base,
+    const arma::mat& features,
+    const arma::Row<size_t>& labels,
+    const ForestParams& params,
+    size_t replaceCount,
+    ThreadPool* threadPool,
+    uint64_t seed,
+    const Progress& progress,
+    const std::atomic<bool>& cancel
+)
+{
+    std::shared_ptr<Forest> forest = std::make_shared<Forest>();
+    forest->m_numClasses = std::max<size_t>(base.m_numClasses, ( labels.n_elem == 0 ) ? 0 : labels.max() + 1);
+
+    std::vector<Tree> newTrees = {};
+    if ( !TrainTrees(features, labels, forest->m_numClasses, params, replaceCount, threadPool, seed, progress, cancel, newTrees) )
+        return nullptr;
+
+    // keep the newest trees of the base forest, leaving room for the new ones
+    const size_t keepCount = std::min(base.m_trees.size(), params.treeCount - std::min(params.treeCount, newTrees.size()));
+    forest->m_trees.assign(base.m_trees.end() - keepCount, base.m_trees.end());
+    forest->m_trees.insert(forest->m_trees.end(), newTrees.begin(), newTrees.end());
+
+    return forest;
+}
+
+/**
+ * @brief Trains trees on bootstrap samples of a training set, one tree per thread pool task.
+ *
+ * @param features Training points, one per column.
+ * @param labels Class of each training point.
+ * @param numClasses The number of classes the trees predict.
+ * @param params Hyperparameters of the trees.
+ * @param treeCount The number of trees to train.
+ * @param threadPool Pool to train the trees on.
+ * @param seed Seed for the bootstrap samples and split dimensions. Tree i uses seed + i.
+ * @param progress Called from a worker thread after each tree is trained. May be empty.
+ * @param cancel Checked before each tree is trained. Setting it stops training.
+ * @param trees Set to the trained trees, oldest first.
+ * @return true if every tree was trained, false if training was cancelled.
+ */
+bool Forest::TrainTrees(
+    const arma::mat& features,
+    const arma::Row<size_t>& labels,
+    size_t numClasses,
+    const ForestParams& params,
+    size_t treeCount,
+    ThreadPool* threadPool,
+    uint64_t seed,
+    const Progress& progress,
+    const std::atomic<bool>& cancel,
+    std::vector<Tree>& trees
+)
+{
+    trees.resize(treeCount);
+
+    std::atomic<size_t> treesDone = 0;
+    std::latch done(static_cast< std::ptrdiff_t >( treeCount ));
+
+    for ( size_t i = 0; i < treeCount; i++ ) {
+        threadPool->Submit([&, i] {
+            if ( !cancel ) {
+                // bootstrap sample the same size as the training set
+                std::mt19937_64 rng(seed + i);
+                std::uniform_int_distribution<arma::uword> pick(0, features.n_cols - 1);
+
+                arma::uvec sample(features.n_cols);
+                for ( arma::uword& index : sample )
+                    index = pick(rng);
+
+                const arma::mat sampleFeatures = features.cols(sample);
+                const arma::Row<size_t> sampleLabels = labels.cols(sample);
+
+                // the split dimensions are drawn from mlpack's random stream, one per worker thread,
+                // so it's seeded for this tree whichever worker runs it
+                mlpack::RandomSeed(static_cast< size_t >( seed + i ));
+
+                trees[i] = Tree(
+                    sampleFeatures, sampleLabels, numClasses,
+                    params.minLeafSize, 1e-7, params.maxDepth
+                );
+
+                const size_t count = ++treesDone;
+                if ( progress )
+                    progress(count, treeCount);
+            }
+
+            done.count_down();
+        });
+    }
+
+    done.wait();
+
+    return !cancel;
+}
+
+/**
+ * @brief Predicts the class of a point.
+ *
+ * @param point The point to classify.
+ * @return The class most trees voted for. Ties go to the lower class.
+ */
+size_t Forest::Classify(const arma::vec& point) const {
+    size_t prediction = 0;
+    arma::vec probabilities;
+    Classify(point, prediction, probabilities);
+
+    return prediction;
+}
+
+/**
+ * @brief Predicts the class of a point along with how the trees voted.
+ *
+ * @param point The point to classify.
+ * @param prediction Set to the class most trees voted for. Ties go to the lower class.
+ * @param probabilities Set to the fraction of trees that voted for each class.
+ */
+void Forest::Classify(const arma::vec& point, size_t& prediction, arma::vec& probabilities) const {
+    probabilities.zeros(m_numClasses);
+    for ( const Tree& tree : m_trees )
+        probabilities(tree.Classify(point)) += 1.0;
+
+    if ( !m_trees.empty() )
+        probabilities /= static_cast< double >( m_trees.size() );
+
+    prediction = probabilities.index_max();
+}
+
+/**
+ * @brief Predicts the class of several points.
+ *
+ * @param points The points to classify, one per column.
+ * @param predictions Set to the class of each point.
+ */
+void Forest::Classify(const arma::mat& points, arma::Row<size_t>& predictions) const {
+    predictions.set_size(points.n_cols);
+    for ( arma::uword i = 0; i < points.n_cols; i++ )
+        predictions(i) = Classify(arma::vec(points.col(i)));
+}
+
+/**
+ * @brief Predicts the class of several points along with how the trees voted.
+ *
+ * @param points The points to classify, one per column.
+ * @param predictions Set to the class of each point.
+ * @param probabilities Set to the fraction of trees that voted for each class, one column per point.
+ */
+void Forest::Classify(const arma::mat& points, arma::Row<size_t>& predictions, arma::mat& probabilities) const {
+    predictions.set_size(points.n_cols);
+    probabilities.set_size(m_numClasses, points.n_cols);
+
+    arma::vec pointProbabilities;
+    for ( arma::uword i = 0; i < points.n_cols; i++ ) {
+        Classify(arma::vec(points.col(i)), predictions(i), pointProbabilities);
+        probabilities.col(i) = pointProbabilities;
+    }
+}
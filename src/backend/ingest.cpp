@@ -0,0 +1,402 @@
+#include "ingest.h"
+
+#include <algorithm> // std::count
+#include <chrono> // std::chrono::milliseconds
+#include <format> // std::format
+#include <set> // std::set
+
+IngestServer::IngestServer(MainFrame* mainFrame, DataBase* db) : m_mainFrame(mainFrame), m_db(db) {}
+
+IngestServer::~IngestServer() {
+    Stop();
+}
+
+/**
+ * @brief Starts accepting scouting clients.
+ *
+ * @param port Port to listen on, 0 for any free port.
+ * @param loopbackOnly Only accept clients on this machine.
+ * @return true if the server is running, false if the port couldn't be listened on.
+ */
+bool IngestServer::Start(uint16_t port, bool loopbackOnly) {
+    if ( m_running )
+        return true;
+
+    m_listener = Socket::Listen(port, loopbackOnly);
+    if ( !m_listener.IsValid() ) {
+        m_mainFrame->LogErrorMessage(std::format("Failed to listen for scouting clients on port {}.", port));
+        return false;
+    }
+
+    m_port = m_listener.LocalPort();
+    m_stopping = false;
+    m_running = true;
+    m_writerThread = std::thread(&IngestServer::WriteBatches, this);
+    m_acceptThread = std::thread(&IngestServer::AcceptClients, this);
+    return true;
+}
+
+/**
+ * @brief Stops the server, dropping every client.
+ *
+ * Submissions queued but not saved yet are failed, so their clients can send them again.
+ */
+void IngestServer::Stop() {
+    if ( !m_running )
+        return;
+
+    m_stopping = true;
+    m_listener.Shutdown();
+    m_queueReady.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(m_clientMutex);
+        for ( std::unique_ptr<Client>& client : m_clients )
+            client->socket.Shutdown();
+    }
+
+    if ( m_acceptThread.joinable() )
+        m_acceptThread.join();
+    if ( m_writerThread.joinable() )
+        m_writerThread.join();
+    ReapClients(true);
+
+    m_listener.Close();
+    m_running = false;
+    m_port = 0;
+}
+
+void IngestServer::AcceptClients() {
+    while ( !m_stopping ) {
+        Socket connection = m_listener.Accept();
+        if ( !connection.IsValid() )
+            break;
+
+        ReapClients(false);
+
+        std::lock_guard<std::mutex> lock(m_clientMutex);
+        if ( m_clients.size() >= INGEST_MAX_CLIENTS ) {
+            std::vector<uint8_t> ack = {};
+            ByteWriter writer(ack);
+            writer.WriteByte(kIngestAck);
+            writer.WriteByte(0);
+            writer.WriteVarint(0);
+            writer.WriteString("Too many scouting clients are connected, try again later.");
+            connection.SendFrame(ack);
+            continue;
+        }
+
+        std::unique_ptr<Client> client = std::make_unique<Client>();
+        client->socket = std::move(connection);
+        client->socket.SetTimeout(INGEST_TIMEOUT_MS);
+        client->thread = std::thread(&IngestServer::ServeClient, this, client.get());
+        m_clients.push_back(std::move(client));
+    }
+}
+
+/**
+ * @brief Reads, validates and queues a client's submissions until it leaves.
+ *
+ * @param client The client to serve.
+ */
+void IngestServer::ServeClient(Client* client) {
+    std::vector<uint8_t> frame = {};
+
+    while ( !m_stopping && client->socket.ReceiveFrame(frame, INGEST_MAX_FRAME) ) {
+        ByteReader reader(frame.data(), frame.size());
+        uint8_t kind = 0;
+        uint64_t count = 0;
+        std::string scout = "";
+        std::string error = "";
+        std::vector<ChangeRecord> records = {};
+
+        if ( !reader.ReadByte(kind) || kind != kIngestSubmit || !reader.ReadString(scout) || !reader.ReadVarint(count) )
+            error = "Not a submission.";
+        else if ( scout.empty() )
+            error = "Submissions need the scout's name.";
+        else if ( count > INGEST_MAX_ROWS )
+            error = std::format("Submissions can hold at most {} rows.", INGEST_MAX_ROWS);
+
+        for ( uint64_t i = 0; i < count && error.empty(); i++ ) {
+            ChangeRecord record = {};
+            if ( !ReadChangeRecord(reader, record) ) {
+                error = std::format("Row {} is damaged.", i + 1);
+                break;
+            }
+
+            std::string rowError = "";
+            if ( !ValidateRecord(record, rowError) ) {
+                error = std::format("Row {}: {}", i + 1, rowError);
+                break;
+            }
+
+            records.push_back(record);
+        }
+
+        if ( error.empty() )
+            error = Enqueue(scout, std::move(records));
+
+        std::vector<uint8_t> ack = {};
+        ByteWriter writer(ack);
+        writer.WriteByte(kIngestAck);
+        writer.WriteByte(error.empty() ? 1 : 0);
+        writer.WriteVarint(count);
+        writer.WriteString(error);
+        if ( !client->socket.SendFrame(ack) )
+            break;
+    }
+
+    client->done = true;
+}
+
+/**
+ * @brief Checks a submitted row can be saved.
+ *
+ * Only rows being added or changed can be submitted, removing rows is left to the stations.
+ *
+ * @param record The row.
+ * @param error Set to why it can't be saved.
+ * @return true if it can be saved, otherwise false.
+ */
+bool IngestServer::ValidateRecord(const ChangeRecord& record, std::string& error) {
+    if ( record.kind == kChangeTeamUpsert ) {
+        const Team& team = record.team;
+        if ( team.teamNum <= 0 || team.matchNum <= 0 ) {
+            error = "team and match numbers must be positive.";
+            return false;
+        }
+
+        if ( team.hangSuccess && !team.hangAttempt ) {
+            error = "a hang can't succeed without being attempted.";
+            return false;
+        }
+
+        // ratings are on a 1-100 scale, 0 when they weren't rated
+        for ( uint16_t rating : { team.robotCycleSpeed, team.defense, team.driverSkill, team.overall } ) {
+            if ( rating > 100 ) {
+                error = "ratings must be between 0 and 100.";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if ( record.kind == kChangeMatchUpsert ) {
+        const Match& match = record.match;
+        if ( match.matchNum <= 0 ) {
+            error = "match numbers must be positive.";
+            return false;
+        }
+
+        for ( int team : match.teams ) {
+            if ( team < 0 ) {
+                error = "team numbers must be positive.";
+                return false;
+            }
+
+            const auto count = std::count(match.teams.begin(), match.teams.end(), team);
+            if ( team != 0 && count > 1 ) {
+                error = std::format("team {} is in the match more than once.", team);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    error = "only rows being added or changed can be submitted.";
+    return false;
+}
+
+/**
+ * @brief Queues a submission for the writer and waits until it's saved.
+ *
+ * @param scout The scout that submitted the rows.
+ * @param records The rows, already validated.
+ * @return Empty if the rows were saved, otherwise why they weren't.
+ */
+std::string IngestServer::Enqueue(const std::string& scout, std::vector<ChangeRecord> records) {
+    std::shared_ptr<Submission> submission = std::make_shared<Submission>();
+    submission->scout = scout;
+    submission->records = std::move(records);
+    std::future<std::string> saved = submission->saved.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if ( m_stopping )
+            return "The server is stopping.";
+
+        m_queuedRows += submission->records.size();
+        m_queue.push_back(std::move(submission));
+    }
+
+    m_queueReady.notify_all();
+    return saved.get();
+}
+
+void IngestServer::WriteBatches() {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    while ( true ) {
+        m_queueReady.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if ( m_stopping )
+            break;
+
+        // scouts submit at the end of every match, give the others a moment so they share a transaction
+        m_queueReady.wait_for(lock, std::chrono::milliseconds(INGEST_BATCH_WINDOW_MS), [this] {
+            return m_stopping || m_queuedRows >= INGEST_MAX_BATCH_ROWS;
+        });
+
+        std::vector<std::shared_ptr<Submission>> batch = {};
+        size_t rows = 0;
+        while ( !m_queue.empty() && ( batch.empty() || rows + m_queue.front()->records.size() <= INGEST_MAX_BATCH_ROWS ) ) {
+            rows += m_queue.front()->records.size();
+            batch.push_back(std::move(m_queue.front()));
+            m_queue.pop_front();
+        }
+        m_queuedRows -= rows;
+
+        lock.unlock();
+
+        std::vector<std::string> results = {};
+        const bool ran = RunOnUiThread(m_mainFrame, [&] { results = WriteBatch(batch); }, m_stopping);
+
+        for ( size_t i = 0; i < batch.size(); i++ )
+            batch[i]->saved.set_value(ran ? results[i] : "The server stopped before the rows were saved.");
+
+        lock.lock();
+    }
+
+    for ( std::shared_ptr<Submission>& submission : m_queue )
+        submission->saved.set_value("The server stopped before the rows were saved.");
+    m_queue.clear();
+    m_queuedRows = 0;
+}
+
+/**
+ * @brief Saves a batch of submissions in one transaction, then tells the UI what changed.
+ *
+ * If the batch can't be saved, each submission is saved on its own, so one bad submission
+ * doesn't fail the others.
+ *
+ * @param batch The submissions to save.
+ * @return One result per submission, empty if it was saved, otherwise why it wasn't.
+ */
+std::vector<std::string> IngestServer::WriteBatch(const std::vector<std::shared_ptr<Submission>>& batch) {
+    std::vector<std::string> results(batch.size(), "");
+
+    // rows from a scout are saved like another station's, under the scout's name
+    auto ToChangeset = [this](const Submission& submission, Changeset& changeset) {
+        changeset.origin = m_db->GetStationName();
+        for ( ChangeRecord record : submission.records ) {
+            record.scout = submission.scout;
+            changeset.records.push_back(record);
+        }
+    };
+
+    Changeset changeset = {};
+    for ( const std::shared_ptr<Submission>& submission : batch )
+        ToChangeset(*submission, changeset);
+
+    SyncReport report = {};
+    size_t applied = 0;
+    if ( m_db->ApplyChangeset(changeset, report) ) {
+        applied = report.applied;
+    }
+    else {
+        for ( size_t i = 0; i < batch.size(); i++ ) {
+            Changeset single = {};
+            ToChangeset(*batch[i], single);
+
+            if ( m_db->ApplyChangeset(single, report) )
+                applied += report.applied;
+            else
+                results[i] = "The rows couldn't be saved.";
+        }
+    }
+
+    if ( applied == 0 )
+        return results;
+
+    std::set<int> teamNums = {}, matchNums = {}, rowMatchNums = {};
+    for ( size_t i = 0; i < batch.size(); i++ ) {
+        if ( !results[i].empty() )
+            continue;
+
+        for ( const ChangeRecord& record : batch[i]->records ) {
+            if ( record.kind == kChangeTeamUpsert ) {
+                teamNums.insert(record.team.teamNum);
+                rowMatchNums.insert(record.team.matchNum);
+            }
+            else {
+                matchNums.insert(record.match.matchNum);
+                for ( int team : record.match.teams )
+                    if ( team != 0 )
+                        teamNums.insert(team);
+            }
+        }
+    }
+
+    m_mainFrame->ShowIngestedData(
+        std::vector<int>(teamNums.begin(), teamNums.end()),
+        std::vector<int>(matchNums.begin(), matchNums.end()),
+        std::vector<int>(rowMatchNums.begin(), rowMatchNums.end())
+    );
+    m_mainFrame->LogBackendMessage(std::format("Saved {} rows from {} scouting client submissions.", applied, batch.size()));
+
+    return results;
+}
+
+/**
+ * @brief Joins the threads of clients that left.
+ *
+ * @param all Join every client's thread instead, waiting for the ones still connected.
+ */
+void IngestServer::ReapClients(bool all) {
+    std::lock_guard<std::mutex> lock(m_clientMutex);
+
+    for ( auto it = m_clients.begin(); it != m_clients.end(); ) {
+        if ( !all && !( *it )->done ) {
+            it++;
+            continue;
+        }
+
+        if ( ( *it )->thread.joinable() )
+            ( *it )->thread.join();
+        it = m_clients.erase(it);
+    }
+}
+
+/**
+ * @brief Submits rows to an ingest server and waits for them to be saved.
+ *
+ * @param connection Connection to the server.
+ * @param scout The scout that recorded the rows.
+ * @param records The rows.
+ * @param error Set to why the rows weren't saved.
+ * @return true if the rows were saved, otherwise false.
+ */
+bool IngestServer::Submit(const Socket& connection, const std::string& scout, const std::vector<ChangeRecord>& records, std::string& error) {
+    std::vector<uint8_t> frame = {};
+    ByteWriter writer(frame);
+    writer.WriteByte(kIngestSubmit);
+    writer.WriteString(scout);
+    writer.WriteVarint(records.size());
+    for ( const ChangeRecord& record : records )
+        WriteChangeRecord(writer, record);
+
+    if ( !connection.SendFrame(frame) || !connection.ReceiveFrame(frame, INGEST_MAX_FRAME) ) {
+        error = "Lost the connection to the server.";
+        return false;
+    }
+
+    ByteReader reader(frame.data(), frame.size());
+    uint8_t kind = 0, saved = 0;
+    uint64_t count = 0;
+    if ( !reader.ReadByte(kind) || kind != kIngestAck || !reader.ReadByte(saved) || !reader.ReadVarint(count) || !reader.ReadString(error) ) {
+        error = "The server sent something unexpected.";
+        return false;
+    }
+
+    return saved == 1;
+}
@@ -1,5 +1,6 @@
 #include <match.h> 
 #include <iostream> // cout, endl
+#include <algorithm> // any_of
 
 /**
  * @brief Creates a Match object from an SQLite database statement.
@@ -10,8 +11,8 @@
  * @param stmt Pointer to an SQLite statement containing match data.
  * @return Match object populated with data from the database.
  *
- * @note This function initializes only the team numbers. Other team details
- *       must be retrieved separately.
+ * @note Only the team numbers are read. The scouted rows of the teams
+ *       must be retrieved separately, see `DataBase::GetMatchTeams`.
  */
 Match Match::FromSQLStatment(sqlite3_stmt* stmt) {
     Match match = {};
@@ -24,7 +25,7 @@ Match Match::FromSQLStatment(sqlite3_stmt* stmt) {
         if ( teamNum == 0 ) // Skip if there is no team number
             continue;
 
-        match.teams.at(i).teamNum = teamNum;
+        match.teams.at(i) = teamNum;
         match.teamCount++;
     }
 
@@ -41,8 +42,8 @@ bool Match::TeamInMatch(int teamNum) {
     if ( teamCount == 0 )
         return false;
 
-    for ( const Team& team : this->teams )
-        if ( team.teamNum == teamNum )
+    for ( int team : this->teams )
+        if ( team == teamNum )
             return true;
 
     return false;
@@ -54,15 +55,15 @@ bool Match::TeamInMatch(int teamNum) {
  * If the match already has 6 teams, the function prints an error message
  * and does not add the team.
  *
- * @param team The team to be added.
+ * @param teamNum The number of the team to be added.
  */
-void Match::AddCompetitor(Team team) {
+void Match::AddCompetitor(int teamNum) {
     if ( this->teamCount == 6 ) {
         std::cout << "Match is full. Cannot add more teams." << std::endl;
         return;
     }
 
-    this->teams.at(this->teamCount) = team;
+    this->teams.at(this->teamCount) = teamNum;
     this->teamCount++;
 }
 
@@ -79,9 +80,9 @@ void Match::RemoveCompetitor(int teamNum) {
         return;
     }
 
-    for ( Team& team : this->teams ) {
-        if ( team.teamNum == teamNum ) {
-            team = { 0 };
+    for ( int& team : this->teams ) {
+        if ( team == teamNum ) {
+            team = 0;
             this->teamCount--;
             break;
         }
@@ -100,8 +101,8 @@ void Match::RemoveCompetitor(int teamNum) {
  */
 bool Match::RedAllianceTeam(int teamNum) const {
     // Check if the team is on the red alliance (first 3 teams)
-    return std::any_of(this->teams.begin(), this->teams.begin() + 3, [&teamNum](const Team& t) {
-        return teamNum == t.teamNum;
+    return std::any_of(this->teams.begin(), this->teams.begin() + 3, [&teamNum](int t) {
+        return teamNum == t;
     });
 }
 
@@ -132,38 +133,64 @@ const bool Match::IsTie() const {
     return redWin == true && blueWin == true;
 }
 
+/**
+ * @brief Checks if the match has been played.
+ *
+ * Neither alliance winning is how an unplayed match is recorded.
+ *
+ * @return true if the match has a result, false otherwise.
+ */
+const bool Match::IsPlayed() const {
+    return redWin == true || blueWin == true;
+}
+
+/**
+ * @brief Scores the result of the match for one alliance.
+ *
+ * Win rates and Elo ratings count results the same way, so this is the one place that does it.
+ *
+ * @param red true for the red alliance, false for the blue alliance.
+ * @return 1 for a win, 0.5 for a tie and 0 for a loss or an unplayed match.
+ */
+double Match::AllianceResult(bool red) const {
+    if ( IsTie() )
+        return 0.5;
+
+    return ( red ? RedWon() : BlueWon() ) ? 1.0 : 0.0;
+}
+
 /**
  * @brief Retrieves the first team in the match.
- * @return Reference to the first team.
+ * @return Team number of the first team, 0 if the station is empty.
  */
-const Team& Match::Team1() const { return this->teams.at(0); }
+int Match::Team1() const { return this->teams.at(0); }
 
 /**
  * @brief Retrieves the second team in the match.
- * @return Reference to the second team.
+ * @return Team number of the second team, 0 if the station is empty.
  */
-const Team& Match::Team2() const { return this->teams.at(1); }
+int Match::Team2() const { return this->teams.at(1); }
 
 /**
  * @brief Retrieves the third team in the match.
- * @return Reference to the third team.
+ * @return Team number of the third team, 0 if the station is empty.
  */
-const Team& Match::Team3() const { return this->teams.at(2); }
+int Match::Team3() const { return this->teams.at(2); }
 
 /**
  * @brief Retrieves the fourth team in the match.
- * @return Reference to the fourth team.
+ * @return Team number of the fourth team, 0 if the station is empty.
  */
-const Team& Match::Team4() const { return this->teams.at(3); }
+int Match::Team4() const { return this->teams.at(3); }
 
 /**
  * @brief Retrieves the fifth team in the match.
- * @return Reference to the fifth team.
+ * @return Team number of the fifth team, 0 if the station is empty.
  */
-const Team& Match::Team5() const { return this->teams.at(4); }
+int Match::Team5() const { return this->teams.at(4); }
 
 /**
  * @brief Retrieves the sixth team in the match.
- * @return Reference to the sixth team.
+ * @return Team number of the sixth team, 0 if the station is empty.
  */
-const Team& Match::Team6() const { return this->teams.at(5); }
+int Match::Team6() const { return this->teams.at(5); }
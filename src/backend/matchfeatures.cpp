@@ -0,0 +1,312 @@
+#include "matchfeatures.h"
+
+#include <algorithm> // std::max, std::stable_sort
+#include <numeric> // std::iota
+
+FeaturePipeline::FeaturePipeline(MainFrame* mainFrame, DataBase* dataBase, OPRCalculator* opr, EloRating* elo)
+    : m_mainFrame(mainFrame), m_dataBase(dataBase), m_opr(opr), m_elo(elo)
+{
+}
+
+/**
+ * @brief Calculates the feature vector of a match.
+ *
+ * Empty slots are left out of the sums and maxes.
+ *
+ * @param match The match to calculate features for. It doesn't need to be in the database.
+ * @return The sums and maxes of the red alliance, followed by those of the blue alliance.
+ */
+MatchFeatures FeaturePipeline::GetMatchFeatures(const Match& match) {
+    std::array<int, 6> teamNums = {};
+    std::array<TeamFeatures, 6> teams = {};
+    for ( int slot = 0; slot < 6; slot++ ) {
+        teamNums[slot] = match.teams[slot];
+        if ( teamNums[slot] != 0 )
+            teams[slot] = GetTeamFeatures(teamNums[slot]);
+    }
+
+    return CombineAlliances(teamNums, teams);
+}
+
+/**
+ * @brief Calculates the feature vector of each match as it was before the match was played.
+ *
+ * Training points must not see their own result, so every team's features are calculated only
+ * from the matches with a lower match number and the rows scouted in them, the order `EloRating`
+ * processes matches in. This is the rule `DatasetBuilder` follows for exported datasets. Elo is
+ * the rating the team had after its last earlier match, read from the engine's history.
+ *
+ * Every match and row in the database is read once and replayed in match number order. The OPR
+ * normal equations are only solved again when an earlier match changed them. The cache isn't used.
+ *
+ * @param matches The matches to calculate features for, in any order. They don't need to be in the database.
+ * @return The feature vector of each match, in the same order as 'matches'.
+ */
+std::vector<MatchFeatures> FeaturePipeline::GetFeaturesBeforeMatches(const std::vector<Match>& matches) {
+    std::vector<MatchFeatures> features(matches.size());
+
+    std::vector<size_t> order(matches.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&matches](size_t a, size_t b) {
+        return matches[a].matchNum < matches[b].matchNum;
+    });
+
+    std::vector<Match> history = m_dataBase->GetMatches();
+    std::stable_sort(history.begin(), history.end(), [](const Match& a, const Match& b) {
+        return a.matchNum < b.matchNum;
+    });
+
+    std::vector<Team> rows = m_dataBase->GetTeams();
+    std::stable_sort(rows.begin(), rows.end(), [](const Team& a, const Team& b) {
+        return a.matchNum < b.matchNum;
+    });
+
+    std::unordered_map<int, std::vector<Team>> matchRows = {}; // match number -> rows scouted in it
+    for ( const Team& row : rows )
+        matchRows[row.matchNum].push_back(row);
+
+    // what each team did in the matches replayed so far
+    struct TeamState {
+        TeamFeatures scouting = {}; // summed scouting features of its rows
+        int rows = 0;
+        double wins = 0.0;
+        int played = 0;
+    };
+
+    std::unordered_map<int, TeamState> states = {};
+    std::unordered_map<int, size_t> teamIndex = {}; // team number -> column of the OPR normal equations
+    std::vector<std::vector<double>> normal = {}; // A^T A
+    std::vector<double> offense = {}; // A^T b
+    std::vector<double> opr = {}; // OPR of each column as of the current match
+    bool solved = true;
+
+    auto Index = [&](int teamNum) -> size_t {
+        auto it = teamIndex.find(teamNum);
+        if ( it != teamIndex.end() )
+            return it->second;
+
+        const size_t index = offense.size();
+        teamIndex.emplace(teamNum, index);
+        for ( std::vector<double>& row : normal )
+            row.push_back(0.0);
+        normal.emplace_back(index + 1, 0.0);
+        offense.push_back(0.0);
+
+        return index;
+    };
+
+    std::unordered_map<int, std::vector<RatingRecord>> ratings = {}; // team number -> rating after each match
+    auto RatingBefore = [&](int teamNum, int matchNum) -> double {
+        if ( !m_elo )
+            return ELO_INITIAL_RATING;
+
+        auto it = ratings.find(teamNum);
+        if ( it == ratings.end() )
+            it = ratings.emplace(teamNum, m_elo->GetTeamHistory(teamNum)).first;
+
+        for ( auto record = it->second.rbegin(); record != it->second.rend(); record++ ) {
+            if ( record->matchNum < matchNum )
+                return record->rating;
+        }
+
+        return ELO_INITIAL_RATING;
+    };
+
+    size_t nextRow = 0, nextMatch = 0;
+    for ( size_t i : order ) {
+        const Match& match = matches[i];
+
+        for ( ; nextRow < rows.size() && rows[nextRow].matchNum < match.matchNum; nextRow++ ) {
+            const Team& row = rows[nextRow];
+            TeamState& state = states[row.teamNum];
+            state.scouting[kFeatureCoralPoints] += row.coralPoints;
+            state.scouting[kFeatureAutonomousPoints] += row.autonomousPoints;
+            state.scouting[kFeatureHangRate] += row.hangSuccess ? 1.0 : 0.0;
+            state.scouting[kFeaturePenaltys] += row.penaltys;
+            state.scouting[kFeatureOverall] += row.overall;
+            state.rows++;
+        }
+
+        for ( ; nextMatch < history.size() && history[nextMatch].matchNum < match.matchNum; nextMatch++ ) {
+            const Match& played = history[nextMatch];
+
+            if ( !played.IsPlayed() )
+                continue;
+
+            // alliance score is the points scouted for its teams, averaged per team, like OPRCalculator
+            const std::vector<Team>& observations = matchRows[played.matchNum];
+            auto TeamPoints = [&observations](int teamNum) -> double {
+                double points = 0.0;
+                int count = 0;
+                for ( const Team& team : observations ) {
+                    if ( team.teamNum != teamNum )
+                        continue;
+
+                    points += team.PointsScored();
+                    count++;
+                }
+
+                return ( count == 0 ) ? 0.0 : points / count;
+            };
+
+            for ( int alliance = 0; alliance < 2; alliance++ ) {
+                const int firstSlot = alliance * 3;
+                const bool red = alliance == 0;
+
+                double score = 0.0;
+                std::array<size_t, 3> columns = {};
+                int teamCount = 0;
+                for ( int slot = firstSlot; slot < firstSlot + 3; slot++ ) {
+                    const int teamNum = played.teams[slot];
+                    if ( teamNum == 0 ) // empty slot
+                        continue;
+
+                    score += TeamPoints(teamNum);
+                    columns[teamCount++] = Index(teamNum);
+
+                    TeamState& state = states[teamNum];
+                    state.played++;
+                    state.wins += played.AllianceResult(red);
+                }
+
+                for ( int a = 0; a < teamCount; a++ ) {
+                    for ( int b = 0; b < teamCount; b++ )
+                        normal[columns[a]][columns[b]] += 1.0;
+
+                    offense[columns[a]] += score;
+                }
+            }
+
+            solved = false;
+        }
+
+        if ( !solved ) {
+            opr = OPRCalculator::SolveNormalEquations(normal, { offense })[0];
+            solved = true;
+        }
+
+        std::array<int, 6> teamNums = {};
+        std::array<TeamFeatures, 6> teams = {};
+        for ( int slot = 0; slot < 6; slot++ ) {
+            teamNums[slot] = match.teams[slot];
+            if ( teamNums[slot] == 0 )
+                continue;
+
+            TeamFeatures& team = teams[slot];
+            auto state = states.find(teamNums[slot]);
+            if ( state != states.end() ) {
+                if ( state->second.rows > 0 ) {
+                    for ( int feature = kFeatureCoralPoints; feature <= kFeatureOverall; feature++ )
+                        team[feature] = state->second.scouting[feature] / state->second.rows;
+                }
+
+                if ( state->second.played > 0 )
+                    team[kFeatureWinRate] = state->second.wins / state->second.played;
+            }
+
+            auto column = teamIndex.find(teamNums[slot]);
+            team[kFeatureOPR] = ( column != teamIndex.end() ) ? opr[column->second] : 0.0;
+            team[kFeatureElo] = RatingBefore(teamNums[slot], match.matchNum);
+        }
+
+        features[i] = CombineAlliances(teamNums, teams);
+    }
+
+    return features;
+}
+
+/**
+ * @brief Combines the features of the teams in a match into the feature vector of the match.
+ *
+ * Shared with `DatasetBuilder`, so datasets built outside the app have the same layout.
+ *
+ * @param teamNums Team number in each slot, red 1-3 then blue 1-3. 0 if the slot is empty.
+ * @param teams Features of the team in each slot.
+ * @return The sums and maxes of the red alliance, followed by those of the blue alliance.
+ */
+MatchFeatures FeaturePipeline::CombineAlliances(const std::array<int, 6>& teamNums, const std::array<TeamFeatures, 6>& teams) {
+    MatchFeatures features = {};
+
+    for ( int alliance = 0; alliance < 2; alliance++ ) {
+        double* sums = features.data() + alliance * kTeamFeatureCount * 2;
+        double* maxes = sums + kTeamFeatureCount;
+        bool first = true;
+
+        for ( int slot = alliance * 3; slot < alliance * 3 + 3; slot++ ) {
+            if ( teamNums[slot] == 0 ) // empty slot
+                continue;
+
+            const TeamFeatures& team = teams[slot];
+            for ( int i = 0; i < kTeamFeatureCount; i++ ) {
+                sums[i] += team[i];
+                maxes[i] = first ? team[i] : std::max(maxes[i], team[i]);
+            }
+
+            first = false;
+        }
+    }
+
+    return features;
+}
+
+/**
+ * @brief Retrieves the features of a team.
+ *
+ * The scouting averages come from the cache, calculating them first if the team
+ * isn't cached. The ratings are always the current ones.
+ *
+ * @param teamNum The team number of the team.
+ * @return The features of the team, indexed by `TeamFeatureIds`.
+ */
+TeamFeatures FeaturePipeline::GetTeamFeatures(int teamNum) {
+    auto it = m_cache.find(teamNum);
+    if ( it == m_cache.end() )
+        it = m_cache.emplace(teamNum, CalculateScoutingFeatures(teamNum)).first;
+
+    TeamFeatures features = it->second;
+    features[kFeatureOPR] = m_opr ? m_opr->GetTeamOPR(teamNum).opr : 0.0;
+    features[kFeatureElo] = m_elo ? m_elo->GetTeamRating(teamNum) : ELO_INITIAL_RATING;
+
+    return features;
+}
+
+/**
+ * @brief Calculates the scouting averages and win rate of a team from the database.
+ *
+ * Only played matches count towards the win rate. A tie counts as half a win.
+ *
+ * @param teamNum The team number of the team.
+ * @return The team's features with the ratings left at zero.
+ */
+TeamFeatures FeaturePipeline::CalculateScoutingFeatures(int teamNum) {
+    TeamFeatures features = {};
+
+    const std::vector<Team> entries = m_dataBase->GetTeamEntries(teamNum);
+    for ( const Team& entry : entries ) {
+        features[kFeatureCoralPoints] += entry.coralPoints;
+        features[kFeatureAutonomousPoints] += entry.autonomousPoints;
+        features[kFeatureHangRate] += entry.hangSuccess ? 1.0 : 0.0;
+        features[kFeaturePenaltys] += entry.penaltys;
+        features[kFeatureOverall] += entry.overall;
+    }
+
+    if ( !entries.empty() ) {
+        for ( int i = kFeatureCoralPoints; i <= kFeatureOverall; i++ )
+            features[i] /= entries.size();
+    }
+
+    double wins = 0.0;
+    int played = 0;
+    for ( const Match& match : m_dataBase->GetMatchesWithTeam(teamNum) ) {
+        if ( !match.IsPlayed() )
+            continue;
+
+        played++;
+        wins += match.AllianceResult(match.RedAllianceTeam(teamNum));
+    }
+
+    if ( played > 0 )
+        features[kFeatureWinRate] = wins / played;
+
+    return features;
+}
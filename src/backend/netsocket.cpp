@@ -0,0 +1,281 @@
+#include "netsocket.h"
+
+#ifdef _WIN32
+#include <winsock2.h> // socket, bind, listen, accept
+#include <ws2tcpip.h> // getaddrinfo
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <netdb.h> // getaddrinfo
+#include <netinet/in.h> // sockaddr_in
+#include <netinet/tcp.h> // TCP_NODELAY
+#include <sys/socket.h> // socket, bind, listen, accept
+#include <sys/time.h> // timeval
+#include <unistd.h> // close
+#endif
+
+#include <cstring> // std::memset
+#include <mutex> // std::once_flag, std::call_once
+#include <utility> // std::exchange
+
+namespace {
+#ifdef _WIN32
+    using NativeHandle = SOCKET;
+    using IoSize = int;
+
+    inline void CloseNative(NativeHandle handle) { closesocket(handle); }
+    constexpr int kShutdownBoth = SD_BOTH;
+#else
+    using NativeHandle = int;
+    using IoSize = size_t;
+
+    inline void CloseNative(NativeHandle handle) { close(handle); }
+    constexpr int kShutdownBoth = SHUT_RDWR;
+#endif
+
+    inline NativeHandle ToNative(intptr_t handle) { return static_cast< NativeHandle >( handle ); }
+
+    // send flags, so a peer that vanished fails the send instead of raising SIGPIPE
+#ifdef MSG_NOSIGNAL
+    constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int kSendFlags = 0;
+#endif
+}
+
+Socket::Socket(intptr_t handle) : m_handle(handle) {}
+
+Socket::~Socket() {
+    Close();
+}
+
+Socket::Socket(Socket&& other) noexcept : m_handle(std::exchange(other.m_handle, kInvalidHandle)) {}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if ( this != &other ) {
+        Close();
+        m_handle = std::exchange(other.m_handle, kInvalidHandle);
+    }
+
+    return *this;
+}
+
+bool Socket::Startup() {
+#ifdef _WIN32
+    static std::once_flag once;
+    static bool started = false;
+    std::call_once(once, [] {
+        WSADATA data;
+        started = ( WSAStartup(MAKEWORD(2, 2), &data) == 0 );
+    });
+
+    return started;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Opens a socket listening for connections.
+ *
+ * @param port The port to listen on, 0 for any free port.
+ * @param loopbackOnly Only accept connections from this machine.
+ * @return The listening socket, invalid if the port couldn't be bound.
+ */
+Socket Socket::Listen(uint16_t port, bool loopbackOnly) {
+    if ( !Startup() )
+        return Socket();
+
+    Socket listener(static_cast< intptr_t >( socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) ));
+    if ( !listener.IsValid() )
+        return Socket();
+
+    // let a restarted app take its port back straight away
+    int reuse = 1;
+    setsockopt(ToNative(listener.m_handle), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast< const char* >( &reuse ), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+
+    if ( bind(ToNative(listener.m_handle), reinterpret_cast< sockaddr* >( &address ), sizeof(address)) != 0 )
+        return Socket();
+    if ( listen(ToNative(listener.m_handle), SOMAXCONN) != 0 )
+        return Socket();
+
+    return listener;
+}
+
+/**
+ * @brief Connects to a listening socket.
+ *
+ * @param host Name or address of the machine to connect to.
+ * @param port The port it listens on.
+ * @return The connected socket, invalid if no address of 'host' accepted the connection.
+ */
+Socket Socket::Connect(const std::string& host, uint16_t port) {
+    if ( !Startup() )
+        return Socket();
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* addresses = nullptr;
+    if ( getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 )
+        return Socket();
+
+    Socket connection;
+    for ( addrinfo* address = addresses; address; address = address->ai_next ) {
+        Socket attempt(static_cast< intptr_t >( socket(address->ai_family, address->ai_socktype, address->ai_protocol) ));
+        if ( !attempt.IsValid() )
+            continue;
+
+        if ( connect(ToNative(attempt.m_handle), address->ai_addr, static_cast< int >( address->ai_addrlen )) == 0 ) {
+            connection = std::move(attempt);
+            break;
+        }
+    }
+
+    freeaddrinfo(addresses);
+
+    if ( connection.IsValid() ) {
+        // frames are small and answered straight away, don't hold them back to fill packets
+        int noDelay = 1;
+        setsockopt(ToNative(connection.m_handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast< const char* >( &noDelay ), sizeof(noDelay));
+    }
+
+    return connection;
+}
+
+/**
+ * @brief Waits for a peer to connect to a listening socket.
+ *
+ * @return The connection, invalid if the socket was shut down or closed.
+ */
+Socket Socket::Accept() const {
+    if ( !IsValid() )
+        return Socket();
+
+    Socket connection(static_cast< intptr_t >( accept(ToNative(m_handle), nullptr, nullptr) ));
+    if ( connection.IsValid() ) {
+        int noDelay = 1;
+        setsockopt(ToNative(connection.m_handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast< const char* >( &noDelay ), sizeof(noDelay));
+    }
+
+    return connection;
+}
+
+bool Socket::SendAll(const void* data, size_t size) const {
+    const char* bytes = reinterpret_cast< const char* >( data );
+    while ( size > 0 ) {
+        const auto sent = send(ToNative(m_handle), bytes, static_cast< IoSize >( size ), kSendFlags);
+        if ( sent <= 0 )
+            return false;
+
+        bytes += sent;
+        size -= static_cast< size_t >( sent );
+    }
+
+    return true;
+}
+
+bool Socket::ReceiveAll(void* data, size_t size) const {
+    char* bytes = reinterpret_cast< char* >( data );
+    while ( size > 0 ) {
+        const auto received = recv(ToNative(m_handle), bytes, static_cast< IoSize >( size ), 0);
+        if ( received <= 0 )
+            return false;
+
+        bytes += received;
+        size -= static_cast< size_t >( received );
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sends a frame: the payload's length as 4 little endian bytes, then the payload.
+ *
+ * @param payload The bytes to send.
+ * @return true if the whole frame was sent, otherwise false.
+ */
+bool Socket::SendFrame(const std::vector<uint8_t>& payload) const {
+    if ( payload.size() > UINT32_MAX )
+        return false;
+
+    const uint32_t size = static_cast< uint32_t >( payload.size() );
+    const uint8_t header[4] = {
+        static_cast< uint8_t >( size ), static_cast< uint8_t >( size >> 8 ),
+        static_cast< uint8_t >( size >> 16 ), static_cast< uint8_t >( size >> 24 )
+    };
+
+    return SendAll(header, sizeof(header)) && SendAll(payload.data(), payload.size());
+}
+
+/**
+ * @brief Receives a frame sent with `SendFrame`.
+ *
+ * @param payload Set to the frame's bytes.
+ * @param maxSize Largest frame accepted. A larger one is refused without reading it.
+ * @return true if a whole frame was received, otherwise false.
+ */
+bool Socket::ReceiveFrame(std::vector<uint8_t>& payload, size_t maxSize) const {
+    uint8_t header[4] = {};
+    if ( !ReceiveAll(header, sizeof(header)) )
+        return false;
+
+    const uint32_t size = header[0] | ( header[1] << 8 ) | ( header[2] << 16 ) | ( static_cast< uint32_t >( header[3] ) << 24 );
+    if ( size > maxSize )
+        return false;
+
+    payload.resize(size);
+    return ReceiveAll(payload.data(), size);
+}
+
+void Socket::SetTimeout(int milliseconds) const {
+#ifdef _WIN32
+    const DWORD timeout = static_cast< DWORD >( milliseconds );
+#else
+    timeval timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = ( milliseconds % 1000 ) * 1000;
+#endif
+
+    setsockopt(ToNative(m_handle), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast< const char* >( &timeout ), sizeof(timeout));
+    setsockopt(ToNative(m_handle), SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast< const char* >( &timeout ), sizeof(timeout));
+}
+
+uint16_t Socket::LocalPort() const {
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+
+#ifdef _WIN32
+    int length = sizeof(address);
+#else
+    socklen_t length = sizeof(address);
+#endif
+
+    if ( getsockname(ToNative(m_handle), reinterpret_cast< sockaddr* >( &address ), &length) != 0 )
+        return 0;
+
+    return ntohs(address.sin_port);
+}
+
+/**
+ * @brief Wakes any thread blocked accepting, sending or receiving on the socket.
+ *
+ * The socket stays open until `Close`, so another thread can still be using the handle safely.
+ */
+void Socket::Shutdown() {
+    if ( IsValid() )
+        shutdown(ToNative(m_handle), kShutdownBoth);
+}
+
+void Socket::Close() {
+    if ( IsValid() )
+        CloseNative(ToNative(std::exchange(m_handle, kInvalidHandle)));
+}
@@ -0,0 +1,317 @@
+#include "opr.h"
+
+#include <algorithm> // std::max
+#include <cmath> // std::sqrt
+
+OPRCalculator::OPRCalculator(MainFrame* mainFrame, DataBase* dataBase)
+    : m_mainFrame(mainFrame), m_dataBase(dataBase)
+{
+    Recompute();
+}
+
+/**
+ * @brief Rebuilds the ratings from every match in the database.
+ *
+ * All scouted team rows are read once and grouped by match number, so the
+ * database is only scanned twice regardless of how many matches were played.
+ */
+void OPRCalculator::Recompute() {
+    m_matchRows.clear();
+    m_teamIndex.clear();
+    m_teamNums.clear();
+    m_normal.clear();
+    m_offense.clear();
+    m_defense.clear();
+
+    // group scouted rows by the match they were scouted in
+    std::unordered_map<int, std::vector<Team>> observations;
+    for ( const Team& team : m_dataBase->GetTeams() )
+        observations[team.matchNum].push_back(team);
+
+    for ( const Match& match : m_dataBase->GetMatches() ) {
+        std::vector<AllianceRow> rows = BuildAllianceRows(match, observations[match.matchNum]);
+        AccumulateRows(rows, 1.0);
+        m_matchRows[match.matchNum] = std::move(rows);
+    }
+
+    Solve();
+}
+
+/**
+ * @brief Folds a new or edited match into the ratings.
+ *
+ * Whatever the match contributed before is subtracted from the normal equations
+ * and its current rows are added back in, then the system is re-solved.
+ *
+ * @param matchNum The match number of the match that was added or changed.
+ */
+void OPRCalculator::UpdateMatch(int matchNum) {
+    auto it = m_matchRows.find(matchNum);
+    if ( it != m_matchRows.end() )
+        AccumulateRows(it->second, -1.0);
+
+    const Match match = m_dataBase->GetMatch(matchNum);
+    std::vector<AllianceRow> rows = BuildAllianceRows(match, m_dataBase->GetTeamsInMatch(matchNum));
+    AccumulateRows(rows, 1.0);
+    m_matchRows[matchNum] = std::move(rows);
+
+    Solve();
+}
+
+/**
+ * @brief Folds several new or edited matches into the ratings.
+ *
+ * Like `UpdateMatch` for each match, but the matches and their scouted rows are
+ * read in one query each and the system is only re-solved once.
+ *
+ * @param matchNums The match numbers of the matches that were added or changed.
+ */
+void OPRCalculator::UpdateMatches(const std::vector<int>& matchNums) {
+    if ( matchNums.empty() )
+        return;
+
+    for ( int matchNum : matchNums ) {
+        auto it = m_matchRows.find(matchNum);
+        if ( it == m_matchRows.end() )
+            continue;
+
+        AccumulateRows(it->second, -1.0);
+        m_matchRows.erase(it);
+    }
+
+    std::unordered_map<int, std::vector<Team>> observations;
+    for ( const Team& team : m_dataBase->GetTeamsInMatches(matchNums) )
+        observations[team.matchNum].push_back(team);
+
+    for ( const Match& match : m_dataBase->GetMatches(matchNums) ) {
+        std::vector<AllianceRow> rows = BuildAllianceRows(match, observations[match.matchNum]);
+        AccumulateRows(rows, 1.0);
+        m_matchRows[match.matchNum] = std::move(rows);
+    }
+
+    Solve();
+}
+
+/**
+ * @brief Takes a removed match out of the ratings.
+ *
+ * @param matchNum The match number of the match that was removed.
+ */
+void OPRCalculator::RemoveMatch(int matchNum) {
+    auto it = m_matchRows.find(matchNum);
+    if ( it == m_matchRows.end() )
+        return;
+
+    AccumulateRows(it->second, -1.0);
+    m_matchRows.erase(it);
+
+    Solve();
+}
+
+/**
+ * @brief Retrieves the ratings calculated for a team.
+ *
+ * @param teamNum The team number to get the ratings of.
+ * @return The team's ratings, or all zeros if the team has not played a match.
+ */
+OPRResult OPRCalculator::GetTeamOPR(int teamNum) const {
+    auto it = m_results.find(teamNum);
+    if ( it == m_results.end() )
+        return {};
+
+    return it->second;
+}
+
+/**
+ * @brief Builds the design matrix rows for a match.
+ *
+ * Unplayed matches contribute no rows. The score of each alliance is the sum of the points
+ * scouted for its teams. If a team was scouted more than once in the match the observations
+ * are averaged so a team isn't counted twice.
+ *
+ * @param match The match to build rows for.
+ * @param observations The scouted team rows for the match.
+ * @return The red alliance row followed by the blue alliance row, or nothing if unplayed.
+ */
+std::vector<OPRCalculator::AllianceRow> OPRCalculator::BuildAllianceRows(
+    const Match& match,
+    const std::vector<Team>& observations
+)
+{
+    if ( !match.IsPlayed() )
+        return {};
+
+    // average the points each team was scouted with
+    auto TeamPoints = [&observations](int teamNum) -> double {
+        double points = 0;
+        int count = 0;
+        for ( const Team& team : observations ) {
+            if ( team.teamNum != teamNum )
+                continue;
+
+            points += team.PointsScored();
+            count++;
+        }
+
+        return ( count == 0 ) ? 0.0 : points / count;
+    };
+
+    AllianceRow red = {};
+    AllianceRow blue = {};
+    for ( int i = 0; i < 3; i++ ) {
+        red.teams[i] = match.teams[i];
+        blue.teams[i] = match.teams[i + 3];
+
+        red.score += TeamPoints(red.teams[i]);
+        blue.score += TeamPoints(blue.teams[i]);
+    }
+
+    red.opponentScore = blue.score;
+    blue.opponentScore = red.score;
+
+    return { red, blue };
+}
+
+/**
+ * @brief Adds rows to, or subtracts rows from, the normal equations.
+ *
+ * Each row only has ones in the columns of its (up to) three teams, so
+ * only a 3x3 block of A^T A and three entries of each A^T b change.
+ *
+ * @param rows The rows to add or subtract.
+ * @param sign 1 to add the rows, -1 to subtract them.
+ */
+void OPRCalculator::AccumulateRows(const std::vector<AllianceRow>& rows, double sign) {
+    for ( const AllianceRow& row : rows ) {
+        std::array<size_t, 3> columns = {};
+        int teamCount = 0;
+
+        for ( int teamNum : row.teams ) {
+            if ( teamNum == 0 ) // empty slot
+                continue;
+
+            columns[teamCount++] = TeamIndex(teamNum);
+        }
+
+        for ( int i = 0; i < teamCount; i++ ) {
+            for ( int j = 0; j < teamCount; j++ )
+                m_normal[columns[i]][columns[j]] += sign;
+
+            m_offense[columns[i]] += sign * row.score;
+            m_defense[columns[i]] += sign * row.opponentScore;
+        }
+    }
+}
+
+/**
+ * @brief Gets the design matrix column for a team.
+ *
+ * If the team has not been seen before a new column is added
+ * and the normal equations grow by one row and column.
+ *
+ * @param teamNum The team number to find the column of.
+ * @return The column index of the team.
+ */
+size_t OPRCalculator::TeamIndex(int teamNum) {
+    auto it = m_teamIndex.find(teamNum);
+    if ( it != m_teamIndex.end() )
+        return it->second;
+
+    const size_t index = m_teamNums.size();
+    m_teamIndex[teamNum] = index;
+    m_teamNums.push_back(teamNum);
+
+    for ( std::vector<double>& row : m_normal )
+        row.push_back(0.0);
+
+    m_normal.push_back(std::vector<double>(index + 1, 0.0));
+    m_offense.push_back(0.0);
+    m_defense.push_back(0.0);
+
+    return index;
+}
+
+/**
+ * @brief Solves the normal equations and stores the ratings of each team.
+ */
+void OPRCalculator::Solve() {
+    const size_t n = m_teamNums.size();
+    m_results.clear();
+
+    if ( n == 0 )
+        return;
+
+    const std::vector<std::vector<double>> solutions = SolveNormalEquations(m_normal, { m_offense, m_defense });
+    const std::vector<double>& opr = solutions[0];
+    const std::vector<double>& dpr = solutions[1];
+
+    for ( size_t i = 0; i < n; i++ ) {
+        // the diagonal of A^T A counts the alliance rows the team was in
+        const int matchesPlayed = static_cast< int >( m_normal[i][i] + 0.5 );
+        if ( matchesPlayed == 0 ) // every match the team was in was removed
+            continue;
+
+        m_results[m_teamNums[i]] = { opr[i], dpr[i], opr[i] - dpr[i], matchesPlayed };
+    }
+}
+
+/**
+ * @brief Solves (A^T A + ridge * I) x = rhs for each right hand side.
+ *
+ * A^T A is symmetric positive definite once the ridge term is added to its diagonal,
+ * so it is factored once with a Cholesky decomposition (L * L^T) and every right hand
+ * side is solved with a forward and a back substitution. For an 80 team event this
+ * is well under a million floating point operations.
+ *
+ * @param normal A^T A, one row per team.
+ * @param rhs The right hand sides, each with one value per team.
+ * @return The solution for each right hand side, in the same order.
+ */
+std::vector<std::vector<double>> OPRCalculator::SolveNormalEquations(
+    const std::vector<std::vector<double>>& normal,
+    const std::vector<std::vector<double>>& rhs
+)
+{
+    const size_t n = normal.size();
+
+    // factor A^T A + ridge * I into a lower triangular L
+    std::vector<std::vector<double>> lower(n, std::vector<double>(n, 0.0));
+    for ( size_t i = 0; i < n; i++ ) {
+        for ( size_t j = 0; j <= i; j++ ) {
+            double sum = normal[i][j];
+            if ( i == j )
+                sum += OPR_RIDGE;
+
+            for ( size_t k = 0; k < j; k++ )
+                sum -= lower[i][k] * lower[j][k];
+
+            if ( i == j )
+                lower[i][i] = std::sqrt(std::max(sum, OPR_RIDGE));
+            else
+                lower[i][j] = sum / lower[j][j];
+        }
+    }
+
+    // solve L * L^T * x = rhs
+    auto Substitute = [&lower, n](std::vector<double> x) -> std::vector<double> {
+        for ( size_t i = 0; i < n; i++ ) {
+            for ( size_t k = 0; k < i; k++ )
+                x[i] -= lower[i][k] * x[k];
+            x[i] /= lower[i][i];
+        }
+
+        for ( size_t i = n; i-- > 0; ) {
+            for ( size_t k = i + 1; k < n; k++ )
+                x[i] -= lower[k][i] * x[k];
+            x[i] /= lower[i][i];
+        }
+
+        return x;
+    };
+
+    std::vector<std::vector<double>> solutions = {};
+    for ( const std::vector<double>& b : rhs )
+        solutions.push_back(Substitute(b));
+
+    return solutions;
+}
@@ -0,0 +1,290 @@
+#include "rankings.h"
+
+#include <algorithm> // std::sort, std::unique, std::max
+#include <cmath> // std::lround
+
+RankingTable::RankingTable(MainFrame* mainFrame, DataBase* dataBase) : m_mainFrame(mainFrame), m_dataBase(dataBase) {
+    Reload();
+}
+
+/**
+ * @brief Rebuilds the standings from every match and scouted row in the database.
+ *
+ * Only needed when the app starts, or when the database was replaced without
+ * reporting its rows, like when a backup is restored.
+ */
+void RankingTable::Reload() {
+    m_matches.clear();
+    m_rowMatches.clear();
+    m_totals.clear();
+
+    if ( m_dataBase ) {
+        std::unordered_map<int, std::vector<Team>> rows = {}; // match number -> scouted rows
+        for ( const Team& team : m_dataBase->GetTeams() ) {
+            m_rowMatches[team.uid] = team.matchNum;
+            rows[team.matchNum].push_back(team);
+        }
+
+        for ( const Match& match : m_dataBase->GetMatches() )
+            AddMatch(match, rows[match.matchNum]);
+    }
+
+    Rank();
+}
+
+/**
+ * @brief Folds the matches and scouted rows of a change batch into the standings.
+ *
+ * Every match the batch touched, directly or through one of its scouted rows before or
+ * after the change, is taken out of the standings and added back as it is now. The
+ * matches and their rows are read in one query each, however many the batch touched.
+ *
+ * @param batch The rows of the Teams and Matches tables that changed.
+ * @return true if a match the standings are built from changed.
+ */
+bool RankingTable::ApplyChanges(const DataEventBatch& batch) {
+    if ( !m_dataBase )
+        return false;
+
+    std::vector<int> matchNums = {};
+    std::vector<int> uids = {};
+    for ( const DataEvent& event : batch.events ) {
+        if ( event.table == MATCH_TABLE ) {
+            matchNums.push_back(event.key);
+            continue;
+        }
+
+        if ( event.table != TEAM_TABLE )
+            continue;
+
+        // the match the row was in before the change
+        auto row = m_rowMatches.find(event.key);
+        if ( row != m_rowMatches.end() ) {
+            matchNums.push_back(row->second);
+            m_rowMatches.erase(row);
+        }
+
+        if ( event.op != kDataDeleted )
+            uids.push_back(event.key);
+    }
+
+    // the match the row is in now
+    if ( !uids.empty() ) {
+        for ( const Team& team : m_dataBase->GetTeams(uids) ) {
+            m_rowMatches[team.uid] = team.matchNum;
+            matchNums.push_back(team.matchNum);
+        }
+    }
+
+    if ( matchNums.empty() )
+        return false;
+
+    std::sort(matchNums.begin(), matchNums.end());
+    matchNums.erase(std::unique(matchNums.begin(), matchNums.end()), matchNums.end());
+
+    for ( int matchNum : matchNums )
+        RemoveMatch(matchNum);
+
+    std::unordered_map<int, std::vector<Team>> rows = {}; // match number -> scouted rows
+    for ( const Team& team : m_dataBase->GetTeamsInMatches(matchNums) )
+        rows[team.matchNum].push_back(team);
+
+    for ( const Match& match : m_dataBase->GetMatches(matchNums) )
+        AddMatch(match, rows[match.matchNum]);
+
+    Rank();
+    return true;
+}
+
+/**
+ * @brief Adds what a match gives each of its teams to their totals.
+ *
+ * @param match The match.
+ * @param rows  Every scouted row recorded for the match.
+ */
+void RankingTable::AddMatch(const Match& match, const std::vector<Team>& rows) {
+    MatchEntry entry = {};
+    entry.match = match;
+
+    const bool played = match.IsPlayed();
+
+    for ( int i = 0; i < 6; i++ ) {
+        if ( match.teams[i] == 0 ) // empty station
+            continue;
+
+        StationResult station = {};
+        station.teamNum = match.teams[i];
+        station.played = played;
+
+        if ( played ) {
+            const bool red = i < 3;
+            station.tied = match.IsTie();
+            station.won = !station.tied && match.RedWon() == red;
+            station.rankingPoints = ( station.tied ) ? TIE_RANKING_POINTS : ( station.won ) ? WIN_RANKING_POINTS : 0;
+
+            // what the scouts saw replaces the ranking points of the result, it includes bonus ranking points
+            int scoutedRows = 0, rankingPoints = 0;
+            double points = 0.0, autonomousPoints = 0.0;
+            for ( const Team& row : rows ) {
+                if ( row.teamNum != station.teamNum )
+                    continue;
+
+                scoutedRows++;
+                rankingPoints += row.rankingPoints;
+                points += row.PointsScored();
+                autonomousPoints += row.autonomousPoints;
+            }
+
+            if ( scoutedRows > 0 ) {
+                const int resultRankingPoints = station.rankingPoints;
+
+                station.scouted = true;
+                station.rankingPoints = static_cast< int >( std::lround(static_cast< double >( rankingPoints ) / scoutedRows) );
+                station.bonusRankingPoints = std::max(station.rankingPoints - resultRankingPoints, 0);
+                station.points = points / scoutedRows;
+                station.autonomousPoints = autonomousPoints / scoutedRows;
+            }
+        }
+
+        AddStation(station, 1);
+        entry.stations.push_back(station);
+    }
+
+    m_matches[match.matchNum] = entry;
+}
+
+/**
+ * @brief Takes what a match gave each of its teams out of their totals, if the match is in the standings.
+ *
+ * @param matchNum Match number of the match.
+ */
+void RankingTable::RemoveMatch(int matchNum) {
+    auto entry = m_matches.find(matchNum);
+    if ( entry == m_matches.end() )
+        return;
+
+    for ( const StationResult& station : entry->second.stations )
+        AddStation(station, -1);
+
+    m_matches.erase(entry);
+}
+
+/**
+ * @brief Adds or subtracts what a match gave the team in one of its stations.
+ *
+ * A team no longer scheduled in any match is dropped from the standings.
+ *
+ * @param station What the match gave the team.
+ * @param sign    1 to add it, -1 to subtract it.
+ */
+void RankingTable::AddStation(const StationResult& station, int sign) {
+    TeamTotals& totals = m_totals[station.teamNum];
+    totals.scheduled += sign;
+
+    if ( station.played ) {
+        totals.played += sign;
+        totals.wins += ( station.won ) ? sign : 0;
+        totals.ties += ( station.tied ) ? sign : 0;
+        totals.losses += ( !station.won && !station.tied ) ? sign : 0;
+        totals.rankingPoints += sign * station.rankingPoints;
+    }
+
+    if ( station.scouted ) {
+        totals.scoutedMatches += sign;
+        totals.bonusRankingPoints += sign * station.bonusRankingPoints;
+        totals.points += sign * station.points;
+        totals.autonomousPoints += sign * station.autonomousPoints;
+    }
+
+    if ( totals.scheduled <= 0 )
+        m_totals.erase(station.teamNum);
+}
+
+/**
+ * @brief Sorts the teams by ranking score and the tie-breakers, and gives each its rank.
+ */
+void RankingTable::Rank() {
+    m_standings.clear();
+    m_standings.reserve(m_totals.size());
+
+    for ( const auto& [teamNum, totals] : m_totals ) {
+        TeamStanding standing = {};
+        standing.teamNum = teamNum;
+        standing.played = totals.played;
+        standing.remaining = totals.scheduled - totals.played;
+        standing.wins = totals.wins;
+        standing.losses = totals.losses;
+        standing.ties = totals.ties;
+        standing.totalRankingPoints = totals.rankingPoints;
+
+        if ( totals.played > 0 )
+            standing.rankingScore = static_cast< double >( totals.rankingPoints ) / totals.played;
+
+        if ( totals.scoutedMatches > 0 ) {
+            standing.averagePoints = totals.points / totals.scoutedMatches;
+            standing.averageAutonomousPoints = totals.autonomousPoints / totals.scoutedMatches;
+            standing.averageBonusRankingPoints = static_cast< double >( totals.bonusRankingPoints ) / totals.scoutedMatches;
+        }
+
+        m_standings.push_back(standing);
+    }
+
+    std::sort(m_standings.begin(), m_standings.end(), RanksAbove);
+
+    m_index.clear();
+    for ( size_t i = 0; i < m_standings.size(); i++ ) {
+        m_standings[i].rank = static_cast< int >( i + 1 );
+        m_index[m_standings[i].teamNum] = i;
+    }
+}
+
+/**
+ * @brief Compares two standings by ranking score, then the tie-breakers, then team number.
+ *
+ * @param a The first standing.
+ * @param b The second standing.
+ * @return true if 'a' is ranked above 'b'.
+ */
+bool RankingTable::RanksAbove(const TeamStanding& a, const TeamStanding& b) {
+    if ( a.rankingScore != b.rankingScore )
+        return a.rankingScore > b.rankingScore;
+    if ( a.averagePoints != b.averagePoints )
+        return a.averagePoints > b.averagePoints;
+    if ( a.averageAutonomousPoints != b.averageAutonomousPoints )
+        return a.averageAutonomousPoints > b.averageAutonomousPoints;
+
+    return a.teamNum < b.teamNum;
+}
+
+/**
+ * @brief Gets where a team stands in the rankings.
+ *
+ * @param teamNum Team number of the team.
+ * @return The team's standing, all zero if it isn't scheduled in any match.
+ */
+TeamStanding RankingTable::GetStanding(int teamNum) const {
+    auto found = m_index.find(teamNum);
+    if ( found == m_index.end() )
+        return { teamNum };
+
+    return m_standings[found->second];
+}
+
+/**
+ * @brief Gets the matches still to be played, from the schedule the standings are built from.
+ *
+ * @return Every match without a result, in match number order.
+ */
+std::vector<Match> RankingTable::GetRemainingMatches() const {
+    std::vector<Match> remaining = {};
+    for ( const auto& [matchNum, entry] : m_matches ) {
+        if ( !entry.match.IsPlayed() )
+            remaining.push_back(entry.match);
+    }
+
+    std::sort(remaining.begin(), remaining.end(), [](const Match& a, const Match& b) {
+        return a.matchNum < b.matchNum;
+    });
+
+    return remaining;
+}
@@ -1,86 +1,580 @@
 #include "rfpredict.h"
 
-RFPredictor::RFPredictor(MainFrame* mainFrame, DataBase* dataBase)
-    : m_mainFrame(mainFrame), m_dataBase(dataBase)
+#include <algorithm> // std::any_of, std::find, std::min, std::sort
+#include <chrono> // std::chrono::steady_clock
+#include <format> // std::format
+#include <latch> // std::latch
+#include <random> // std::random_device
+
+RFPredictor::RFPredictor(MainFrame* mainFrame, DataBase* dataBase, FeaturePipeline* features, ThreadPool* threadPool, bool compactModel)
+    : m_compactModel(compactModel), m_mainFrame(mainFrame), m_dataBase(dataBase), m_features(features), m_threadPool(threadPool)
 {
-    if ( !LoadModel(MODEL_EXPORT_PATH) ) // No model exists at the correct path
+    if ( !LoadModel(MODEL_EXPORT_PATH, COMPACT_MODEL_EXPORT_PATH, CALIBRATION_EXPORT_PATH) ) // No model exists at the correct path
         // Train and create a model
-        TrainModel(FEATURES_CSV_PATH, LABELS_CSV_PATH);
+        StartTraining();
+}
+
+RFPredictor::~RFPredictor() {
+    CancelTraining();
+    if ( m_trainingThread.joinable() )
+        m_trainingThread.join();
+}
+
+size_t LineupHash::operator()(const Lineup& lineup) const {
+    // FNV-1a over the team numbers
+    uint64_t hash = 14695981039346656037ull;
+    for ( int teamNum : lineup ) {
+        hash ^= static_cast< uint32_t >( teamNum );
+        hash *= 1099511628211ull;
+    }
+
+    return static_cast< size_t >( hash );
 }
 
 bool RFPredictor::PredictMatchOutcome(int matchNum) {
-    if ( !m_available )
+    if ( !IsModelAvailable() )
         return false;
 
-    const Match match = m_dataBase->GetMatch(matchNum);
-    
-    // indices 0-2: red team win rates
-    // indices 3-5: blue team win rates
-    std::vector<double> winRates = {};
+    return PredictMatchOutcome(GetCachedMatch(matchNum));
+}
 
-    // calculate each teams win %
-    for ( const Team& team : match.teams ) {
-        double winRate = m_dataBase->GetTeamWinRate(team.teamNum);
-        winRates.push_back(winRate);
-    }
+// Features are the sums and maxes of each alliance's team features, see FeaturePipeline
+// Returns 1 for red win, 0 for blue win
+bool RFPredictor::PredictMatchOutcome(const Match& match) {
+    if ( !IsModelAvailable() )
+        return false;
 
-    return PredictMatchOutcome(match, winRates);
+    return PredictRedWinProbability(match) > 0.5; // return result
 }
 
-// Need data as such to make an prediction with ~82% accuracy
-// Red 1 | Red 2 | Red 3 | Blue 1 | Blue 2 | Blue 3 | Red 1 Win % | Red 2 Win % | Red 3 Win % | Blue 1 Win % | Blue 2 Win % | Blue 3 Win %
-// Returns 1 for red win, 0 for blue win
-bool RFPredictor::PredictMatchOutcome(
-    const Match& match, 
-    std::vector<double> teamWinRates
-) 
-{
+double RFPredictor::PredictRedWinProbability(int matchNum) {
+    if ( !IsModelAvailable() )
+        return 0.5;
+
+    return PredictRedWinProbability(GetCachedMatch(matchNum));
+}
+
+double RFPredictor::PredictRedWinProbability(const Match& match) {
+    return PredictRedWinProbabilities({ match }).front();
+}
+
+/**
+ * @brief Predicts the chance of a red win in each of several matches.
+ *
+ * Cached predictions are reused. The features of the rest are calculated on the calling
+ * thread, since they read from the database, then classified in chunks of
+ * `PREDICTION_BATCH_CHUNK` on the thread pool.
+ *
+ * @param matches The matches to predict. They don't need to be in the database.
+ * @return The calibrated chance of a red win in each match, 0.5 for all if no model is available.
+ */
+std::vector<double> RFPredictor::PredictRedWinProbabilities(const std::vector<Match>& matches) {
+    std::vector<double> probabilities(matches.size(), 0.5);
+
+    // read the versions before the model, so a model swapped in meanwhile
+    // leaves the entries looking stale rather than looking current
+    const uint64_t dataVersion = m_dataBase->GetDataVersion();
+    const uint64_t modelVersion = m_modelVersion;
+    const CalibrationMethod method = m_calibrationMethod;
+
+    std::vector<Lineup> lineups(matches.size());
+    std::vector<size_t> misses = {};
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        for ( size_t i = 0; i < matches.size(); i++ ) {
+            lineups[i] = MakeLineup(matches[i]);
+
+            auto it = m_predictions.find(lineups[i]);
+            if ( it != m_predictions.end() && it->second.dataVersion == dataVersion && it->second.modelVersion == modelVersion )
+                probabilities[i] = it->second.redWinProbability;
+            else
+                misses.push_back(i);
+        }
+    }
+
+    if ( misses.empty() )
+        return probabilities;
+
+    // hold on to the model, training may swap in a new one meanwhile
+    const std::shared_ptr<const Forest> forest = m_forest.load();
+    const std::shared_ptr<const CompactModel> compact = m_compact.load();
+    const std::shared_ptr<const Calibrator> calibrator = m_calibrator.load();
+    if ( ( !forest && !compact ) || !calibrator )
+        return probabilities;
+
     // data to supply the model with
-    arma::mat features(12, 1);
-
-    // teams
-    features(0, 0) = match.Team1().teamNum;
-    features(1, 0) = match.Team2().teamNum;
-    features(2, 0) = match.Team3().teamNum;
-    features(3, 0) = match.Team4().teamNum;
-    features(4, 0) = match.Team5().teamNum;
-    features(5, 0) = match.Team6().teamNum;
-
-    // win rates for red alliance teams
-    features(6, 0) = teamWinRates.at(0);
-    features(7, 0) = teamWinRates.at(1);
-    features(8, 0) = teamWinRates.at(2);
-
-    // win rates for blue alliance teams
-    features(9, 0) = teamWinRates.at(3);
-    features(10, 0) = teamWinRates.at(4);
-    features(11, 0) = teamWinRates.at(5);
-    
-    // output. the models prediction
-    arma::Row<size_t> prediction; 
-
-    // predict
-    m_rf.Classify(features, prediction);
-
-    return prediction(0); // return result
-}
-
-void RFPredictor::TrainModel(
-    const std::string& featuresPath, 
-    const std::string& labelsPath
+    arma::mat features(MATCH_FEATURE_COUNT, misses.size());
+    for ( size_t j = 0; j < misses.size(); j++ ) {
+        const MatchFeatures matchFeatures = m_features->GetMatchFeatures(matches[misses[j]]);
+        for ( int i = 0; i < MATCH_FEATURE_COUNT; i++ )
+            features(i, j) = matchFeatures[i];
+    }
+
+    // fraction of trees voting for a red win, each chunk writes its own columns
+    arma::rowvec redVotes(misses.size(), arma::fill::zeros);
+    auto ClassifyChunk = [&forest, &compact, &features, &redVotes](arma::uword first, arma::uword last) {
+        arma::Row<size_t> predictions;
+        arma::mat votes;
+        if ( compact )
+            compact->Classify(features.cols(first, last), predictions, votes);
+        else
+            forest->Classify(features.cols(first, last), predictions, votes);
+        if ( votes.n_rows > 1 )
+            redVotes.cols(first, last) = votes.row(1);
+    };
+
+    if ( misses.size() <= PREDICTION_BATCH_CHUNK ) {
+        ClassifyChunk(0, misses.size() - 1);
+    }
+    else {
+        const size_t chunkCount = ( misses.size() + PREDICTION_BATCH_CHUNK - 1 ) / PREDICTION_BATCH_CHUNK;
+        std::latch done(static_cast< std::ptrdiff_t >( chunkCount ));
+
+        for ( size_t chunk = 0; chunk < chunkCount; chunk++ ) {
+            const arma::uword first = chunk * PREDICTION_BATCH_CHUNK;
+            const arma::uword last = std::min<size_t>(first + PREDICTION_BATCH_CHUNK, misses.size()) - 1;
+            m_threadPool->Submit([&ClassifyChunk, &done, first, last] {
+                ClassifyChunk(first, last);
+                done.count_down();
+            });
+        }
+
+        done.wait();
+    }
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    if ( m_predictions.size() + misses.size() > PREDICTION_CACHE_SIZE ) {
+        // make room by dropping stale predictions first, then everything if they're all current
+        std::erase_if(m_predictions, [dataVersion, modelVersion](const auto& entry) {
+            return entry.second.dataVersion != dataVersion || entry.second.modelVersion != modelVersion;
+        });
+
+        if ( m_predictions.size() + misses.size() > PREDICTION_CACHE_SIZE )
+            m_predictions.clear();
+    }
+
+    for ( size_t j = 0; j < misses.size(); j++ ) {
+        const size_t i = misses[j];
+        probabilities[i] = calibrator->Apply(redVotes(j), method);
+
+        if ( m_predictions.size() < PREDICTION_CACHE_SIZE )
+            m_predictions[lineups[i]] = { probabilities[i], dataVersion, modelVersion };
+    }
+
+    return probabilities;
+}
+
+/**
+ * @brief Changes how vote fractions are turned into probabilities.
+ *
+ * Cached predictions made with the previous calibration are recalculated.
+ *
+ * @param method The calibration to apply to every prediction from now on.
+ */
+void RFPredictor::SetCalibration(CalibrationMethod method) {
+    m_calibrationMethod = method;
+    m_modelVersion++;
+}
+
+/**
+ * @brief Turns predicting with the compact model on or off.
+ *
+ * The current model is swapped for its other copy, as saved by the training job that made it.
+ * A model being trained is swapped in as whichever copy is turned on when it finishes.
+ *
+ * @param enabled Predict with the compact model and keep only it in memory.
+ */
+void RFPredictor::SetCompactModel(bool enabled) {
+    if ( m_compactModel.exchange(enabled) == enabled || !IsModelAvailable() )
+        return;
+
+    if ( !LoadModel(MODEL_EXPORT_PATH, COMPACT_MODEL_EXPORT_PATH, CALIBRATION_EXPORT_PATH) )
+        m_mainFrame->LogErrorMessage("Failed to load the saved model, keeping the current one.");
+}
+
+/**
+ * @brief Gets a match from the database, or the cached copy if the match hasn't changed since it was read.
+ *
+ * @param matchNum The match number of the match.
+ * @return The match.
+ */
+Match RFPredictor::GetCachedMatch(int matchNum) {
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_matches.find(matchNum);
+        if ( it != m_matches.end() )
+            return it->second;
+    }
+
+    const Match match = m_dataBase->GetMatch(matchNum);
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_matches[matchNum] = match;
+
+    return match;
+}
+
+/**
+ * @brief Drops the cached copy of a match, so it is read from the database next time it is predicted.
+ *
+ * Cached predictions don't need to be dropped, the write already made them stale.
+ *
+ * @param matchNum The match number of the match that changed.
+ */
+void RFPredictor::InvalidateMatch(int matchNum) {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_matches.erase(matchNum);
+}
+
+/**
+ * @brief Forgets every cached match and prediction.
+ *
+ * Called after changes that touch many matches at once, such as imports.
+ */
+void RFPredictor::ClearPredictionCache() {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_matches.clear();
+    m_predictions.clear();
+}
+
+/**
+ * @brief Gets the lineup of a match, the key its prediction is cached under.
+ *
+ * @param match The match.
+ * @return The team numbers of the red alliance then the blue alliance, each sorted.
+ */
+Lineup RFPredictor::MakeLineup(const Match& match) {
+    Lineup lineup = {};
+    for ( int slot = 0; slot < 6; slot++ )
+        lineup[slot] = match.teams[slot];
+
+    std::sort(lineup.begin(), lineup.begin() + 3);
+    std::sort(lineup.begin() + 3, lineup.end());
+
+    return lineup;
+}
+
+/**
+ * @brief Makes a model the one used to predict.
+ *
+ * With the compact model turned on it is kept and the full one dropped, otherwise the
+ * other way around. If only one of them is given, that one is kept.
+ * Bumps the model version, so predictions made with the previous model are recalculated.
+ *
+ * @param forest The new model. May be nullptr if 'compact' isn't.
+ * @param compact Quantized copy of the new model. May be nullptr if 'forest' isn't.
+ * @param calibrator The calibration of the new model.
+ */
+void RFPredictor::SwapModel(
+    std::shared_ptr<const Forest> forest,
+    std::shared_ptr<const CompactModel> compact,
+    std::shared_ptr<const Calibrator> calibrator
 )
 {
+    if ( m_compactModel && compact )
+        forest = nullptr;
+    else if ( forest )
+        compact = nullptr;
+
+    // calibrator first, so whoever sees the new model also sees its calibration
+    m_calibrator.store(std::move(calibrator));
+    m_compact.store(std::move(compact));
+    m_forest.store(std::move(forest));
+    m_modelVersion++;
+}
+
+/**
+ * @brief Starts training a new model in the background.
+ *
+ * The training set is built on the calling thread, since it reads from the database.
+ * The trees are then trained on the thread pool from a background thread.
+ *
+ * @return true if training started, false if a model is already being trained.
+ */
+bool RFPredictor::StartTraining() {
+    bool expected = false;
+    if ( !m_training.compare_exchange_strong(expected, true) ) {
+        m_mainFrame->LogBackendMessage("Model is already being trained.");
+        return false;
+    }
+
+    // the previous job has finished, clean up its thread
+    if ( m_trainingThread.joinable() )
+        m_trainingThread.join();
+
     arma::mat features;
     arma::Row<size_t> labels;
-    
-    try {
-        mlpack::data::Load(featuresPath, features, true);
-        mlpack::data::Load(labelsPath, labels, true);
-    } catch ( std::runtime_error& err ) {
-        m_mainFrame->LogErrorMessage("Error loading data to train model. Predictions unavailable.");
+    std::vector<int> matchNums = {};
+    if ( !GetTrainingData(features, labels, &matchNums) ) {
+        m_training = false;
+        return false;
+    }
+
+    // keep the data so results entered later can be added to it
+    m_dataFeatures = features;
+    m_dataLabels = labels;
+    m_dataMatchNums = std::move(matchNums);
+    m_dataLoaded = true;
+
+    m_cancelTraining = false;
+    m_trainingThread = std::thread(&RFPredictor::TrainModel, this, std::move(features), std::move(labels));
+
+    return true;
+}
+
+/**
+ * @brief Folds match results into the training data and warm starts the model once.
+ *
+ * A newly played match is added to the training data, a corrected one is updated
+ * in place and one that was removed or reset to unplayed is taken out. If there
+ * is no model yet, a full model is trained once there are enough matches.
+ *
+ * The features of a match are calculated from the matches before it, as in
+ * `BuildTrainingSet`, since its result has already been applied to the ratings
+ * by now. Every later match's features include it, so if the training data has
+ * later matches, the scouted matches are all built again instead.
+ *
+ * @param matchNums The match numbers of the matches whose results changed.
+ */
+void RFPredictor::UpdateWithMatches(std::vector<int> matchNums) {
+    if ( !m_onlineUpdates || matchNums.empty() )
+        return;
+
+    if ( !m_dataLoaded ) {
+        // the model was loaded from disk, start from every match played so far,
+        // which already includes these
+        LoadCurrentData();
+    }
+    else {
+        // in match number order, so each match is added after the ones its features are built from
+        std::sort(matchNums.begin(), matchNums.end());
+
+        bool changed = false;
+        for ( int matchNum : matchNums ) {
+            auto it = std::find(m_dataMatchNums.begin(), m_dataMatchNums.end(), matchNum);
+            const arma::uword col = static_cast< arma::uword >( it - m_dataMatchNums.begin() );
+
+            Match match = {};
+            if ( m_dataBase->MatchExists(matchNum) )
+                match = m_dataBase->GetMatch(matchNum);
+
+            // an unplayed match that was never trained on, nothing changed
+            if ( !match.IsPlayed() && it == m_dataMatchNums.end() )
+                continue;
+
+            const bool laterMatches = std::any_of(m_dataMatchNums.begin(), m_dataMatchNums.end(), [matchNum](int trained) {
+                return trained > matchNum;
+            });
+
+            if ( laterMatches ) {
+                // built from the database, which already has every match of the batch
+                RebuildMatchColumns();
+                changed = true;
+                break;
+            }
+
+            if ( match.RedWon() || match.BlueWon() ) {
+                const MatchFeatures matchFeatures = m_features->GetFeaturesBeforeMatches({ match }).front();
+                arma::vec features(MATCH_FEATURE_COUNT);
+                for ( int i = 0; i < MATCH_FEATURE_COUNT; i++ )
+                    features(i) = matchFeatures[i];
+
+                if ( it == m_dataMatchNums.end() ) {
+                    m_dataFeatures.insert_cols(m_dataFeatures.n_cols, features);
+                    m_dataLabels.resize(m_dataLabels.n_elem + 1);
+                    m_dataMatchNums.push_back(matchNum);
+                }
+                else {
+                    m_dataFeatures.col(col) = features;
+                }
+
+                m_dataLabels(col) = match.RedWon() ? 1 : 0;
+                changed = true;
+            }
+            else if ( it != m_dataMatchNums.end() ) {
+                m_dataFeatures.shed_col(col);
+                m_dataLabels.shed_col(col);
+                m_dataMatchNums.erase(it);
+                changed = true;
+            }
+            // otherwise a tie that was never trained on, the model only learns wins
+        }
+
+        if ( !changed )
+            return;
+    }
+
+    RefitTrainingData();
+}
+
+/**
+ * @brief Builds every scouted match of the training data again and warm starts the model once.
+ *
+ * Called after changes that touch many rows at once, such as imports, merges, syncs,
+ * bulk removals or restoring a backup, which `UpdateWithMatches` never sees.
+ */
+void RFPredictor::RebuildTrainingData() {
+    if ( !m_onlineUpdates )
+        return;
+
+    if ( m_dataLoaded )
+        RebuildMatchColumns();
+    else
+        LoadCurrentData();
+
+    RefitTrainingData();
+}
+
+/**
+ * @brief Warm starts the model on the training data after it changed.
+ *
+ * If there is no model yet, a full model is trained once there are enough matches.
+ */
+void RFPredictor::RefitTrainingData() {
+    if ( m_dataFeatures.n_cols < RF_MIN_TRAINING_MATCHES )
+        return;
+
+    if ( !IsModelAvailable() ) {
+        if ( !m_training )
+            StartTraining();
+
         return;
     }
 
+    StartWarmStart();
+}
+
+/**
+ * @brief Loads the training data without training a model.
+ *
+ * Used when the model was loaded from disk, so the data it can be updated with isn't in
+ * memory yet. The matches scouted so far are built after an exported dataset's, the same
+ * as if they had been added one by one since it was trained.
+ */
+void RFPredictor::LoadCurrentData() {
+    m_dataMatchNums.clear();
+
+    if ( LoadTrainingSet(FEATURES_CSV_PATH, LABELS_CSV_PATH, m_dataFeatures, m_dataLabels) ) {
+        m_dataMatchNums.assign(m_dataFeatures.n_cols, 0);
+        RebuildMatchColumns();
+    }
+    else {
+        BuildTrainingSet(m_dataFeatures, m_dataLabels, m_dataMatchNums);
+    }
+
+    m_dataLoaded = true;
+}
+
+/**
+ * @brief Builds the matches of the training data that were scouted in the app again.
+ *
+ * Matches from an exported dataset don't depend on this event's matches and are kept.
+ */
+void RFPredictor::RebuildMatchColumns() {
+    std::vector<arma::uword> exported = {};
+    for ( size_t col = 0; col < m_dataMatchNums.size(); col++ ) {
+        if ( m_dataMatchNums[col] == 0 )
+            exported.push_back(col);
+    }
+
+    arma::mat features;
+    arma::Row<size_t> labels;
+    std::vector<int> matchNums = {};
+    BuildTrainingSet(features, labels, matchNums);
+
+    const arma::uvec kept(exported);
+    m_dataFeatures = arma::join_rows(arma::mat(m_dataFeatures.cols(kept)), features);
+    m_dataLabels = arma::join_rows(arma::Row<size_t>(m_dataLabels.cols(kept)), labels);
+
+    m_dataMatchNums.assign(exported.size(), 0);
+    m_dataMatchNums.insert(m_dataMatchNums.end(), matchNums.begin(), matchNums.end());
+}
+
+/**
+ * @brief Retrains the oldest trees of the current model on the current training data.
+ *
+ * If the model is already training, the warm start runs once that finishes instead.
+ *
+ * @return true if the warm start started, otherwise false.
+ */
+bool RFPredictor::StartWarmStart() {
+    bool expected = false;
+    if ( !m_training.compare_exchange_strong(expected, true) ) {
+        m_pendingUpdate = true;
+        return false;
+    }
+
+    // the previous job has finished, clean up its thread
+    if ( m_trainingThread.joinable() )
+        m_trainingThread.join();
+
+    std::shared_ptr<const Forest> base = m_forest.load();
+    if ( !base ) {
+        // only the compact model is in memory, which can't be warm started, train from scratch
+        m_training = false;
+        return IsModelAvailable() && StartTraining();
+    }
+
+    m_cancelTraining = false;
+    m_trainingThread = std::thread(&RFPredictor::WarmStartModel, this, std::move(base), m_dataFeatures, m_dataLabels);
+
+    return true;
+}
+
+/**
+ * @brief Gathers the matches a model is trained on.
+ *
+ * An exported dataset built with the current features is preferred, otherwise the
+ * played matches scouted so far are used. Must be called from the thread that owns
+ * the database.
+ *
+ * @param features Set to the features of each match, one match per column.
+ * @param labels Set to 1 for each red win and 0 for each blue win.
+ * @param matchNums Optional, set to the match number of each column, 0 for matches from an exported dataset.
+ * @return true if there are at least `RF_MIN_TRAINING_MATCHES` matches, otherwise false.
+ */
+bool RFPredictor::GetTrainingData(arma::mat& features, arma::Row<size_t>& labels, std::vector<int>* matchNums) {
+    std::vector<int> columnMatchNums = {};
+    if ( LoadTrainingSet(FEATURES_CSV_PATH, LABELS_CSV_PATH, features, labels) )
+        columnMatchNums.assign(features.n_cols, 0);
+    else
+        BuildTrainingSet(features, labels, columnMatchNums);
+
+    if ( matchNums )
+        *matchNums = std::move(columnMatchNums);
+
+    if ( features.n_cols < RF_MIN_TRAINING_MATCHES ) {
+        m_mainFrame->LogErrorMessage(
+            "Not enough played matches to train a model (" + std::to_string(features.n_cols) + "/" +
+            std::to_string(RF_MIN_TRAINING_MATCHES) + ")."
+        );
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stops the current training job after the trees already being trained finish.
+ *
+ * The current model is kept.
+ */
+void RFPredictor::CancelTraining() {
+    m_cancelTraining = true;
+}
+
+/**
+ * @brief Trains, tests, calibrates and saves a model, then swaps it in for the current one.
+ *
+ * The calibration is fitted on the test split, which the forest never saw.
+ * Runs on the training thread.
+ *
+ * @param features Training points, one match per column.
+ * @param labels 1 for each red win and 0 for each blue win.
+ */
+void RFPredictor::TrainModel(arma::mat features, arma::Row<size_t> labels) {
+    const auto start = std::chrono::steady_clock::now();
+
     arma::mat trainFeatures, testFeatures;
     arma::Row<size_t> trainLabels, testLabels;
 
@@ -94,33 +588,284 @@ void RFPredictor::TrainModel(
         0.3
     );
 
-    // Train model
-    m_rf.Train(trainFeatures, trainLabels, 500, 40, 6);
+    // Train model, reporting progress in the status bar
+    const ForestParams params = { RF_TREE_COUNT, RF_MIN_LEAF_SIZE, RF_MAX_DEPTH };
+    std::shared_ptr<Forest> forest = Forest::Train(
+        trainFeatures, trainLabels, params, m_threadPool, std::random_device{}(),
+        [this](size_t treesDone, size_t treeCount) {
+            m_mainFrame->CallAfter([this, treesDone, treeCount] {
+                m_mainFrame->LogProgress("Training model", treesDone, treeCount);
+            });
+        },
+        m_cancelTraining
+    );
+
+    if ( !forest ) {
+        LogFromTraining("Model training cancelled. Keeping the current model.");
+        FinishTrainingJob();
+        return;
+    }
 
     // Predict after training
     arma::Row<size_t> predictions;
-    m_rf.Classify(testFeatures, predictions);
+    arma::mat votes;
+    forest->Classify(testFeatures, predictions, votes);
 
     // Calculate accuracy of predictions
     size_t correct = arma::accu(predictions == testLabels);
     double accuracy = (( double ) correct / ( double ) testLabels.n_elem) * 100;
-    
+
+    // Calibrate the red win vote fraction against the actual results
+    std::vector<double> redVotes = {};
+    if ( votes.n_rows > 1 )
+        redVotes = arma::conv_to<std::vector<double>>::from(votes.row(1));
+    const std::vector<size_t> actual = arma::conv_to<std::vector<size_t>>::from(testLabels);
+
+    std::shared_ptr<Calibrator> calibrator = std::make_shared<Calibrator>();
+    const bool calibrated = calibrator->Fit(redVotes, actual);
+
+    // save to file
+    mlpack::data::Save(MODEL_EXPORT_PATH, "model", *forest);
+    mlpack::data::Save(CALIBRATION_EXPORT_PATH, "calibration", *calibrator);
+
+    std::string compactSummary = "";
+    std::shared_ptr<const CompactModel> compact = BuildCompactModel(*forest, features, testFeatures, testLabels, compactSummary);
+
+    // swap in the new model
+    SwapModel(std::move(forest), std::move(compact), std::move(calibrator));
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
     // Output the accuracy of the model
-    std::string msg = "Trained RF Model with an accuracy of : " + std::to_string(accuracy) + "%";
-    m_mainFrame->LogMessage(msg);
+    LogFromTraining(
+        "Trained RF Model with an accuracy of : " + std::to_string(accuracy) + "% in " + 
+        std::to_string(elapsed.count()) + " ms" +
+        ( calibrated ? "" : ". Too few test matches to calibrate, probabilities are raw vote fractions" ) +
+        ". " + compactSummary
+    );
 
-    // mark the random forest model as usable
-    m_available = true;
+    FinishTrainingJob();
+}
+
+/**
+ * @brief Retrains the oldest trees of a model on the current training data, saves it, then swaps it in.
+ *
+ * Every match is trained on, the model was already tested when it was first trained.
+ * Runs on the training thread.
+ *
+ * @param base The model to update.
+ * @param features Training points, one match per column.
+ * @param labels 1 for each red win and 0 for each blue win.
+ */
+void RFPredictor::WarmStartModel(std::shared_ptr<const Forest> base, arma::mat features, arma::Row<size_t> labels) {
+    const auto start = std::chrono::steady_clock::now();
+
+    const ForestParams params = { RF_TREE_COUNT, RF_MIN_LEAF_SIZE, RF_MAX_DEPTH };
+    std::shared_ptr<Forest> forest = Forest::WarmStart(
+        *base, features, labels, params, RF_WARM_START_TREES, m_threadPool, std::random_device{}(),
+        [this](size_t treesDone, size_t treeCount) {
+            m_mainFrame->CallAfter([this, treesDone, treeCount] {
+                m_mainFrame->LogProgress("Updating model", treesDone, treeCount);
+            });
+        },
+        m_cancelTraining
+    );
+
+    if ( !forest ) {
+        LogFromTraining("Model update cancelled. Keeping the current model.");
+        FinishTrainingJob();
+        return;
+    }
 
     // save to file
-    mlpack::data::Save(MODEL_EXPORT_PATH, "model", m_rf);
+    mlpack::data::Save(MODEL_EXPORT_PATH, "model", *forest);
+
+    // there's no held out data left, so the compact model is only checked against what it was trained on
+    std::string compactSummary = "";
+    std::shared_ptr<const CompactModel> compact = BuildCompactModel(*forest, features, features, labels, compactSummary);
+
+    // swap in the updated model, the test split it was calibrated on is trained on now so keep the calibration
+    SwapModel(std::move(forest), std::move(compact), m_calibrator.load());
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    LogFromTraining(
+        "Updated RF Model with " + std::to_string(labels.n_elem) + " matches, retrained " +
+        std::to_string(std::min<size_t>(RF_WARM_START_TREES, RF_TREE_COUNT)) + " trees in " +
+        std::to_string(elapsed.count()) + " ms. " + compactSummary
+    );
+
+    FinishTrainingJob();
+}
+
+/**
+ * @brief Builds the compact copy of a model, checks it against the model and saves it.
+ *
+ * Runs on the training thread.
+ *
+ * @param forest The full model.
+ * @param features Training points of the model, one match per column. The compact model's
+ *                 quantization grid spans them.
+ * @param checkFeatures Matches to compare the two models on, one per column.
+ * @param checkLabels 1 for each red win and 0 for each blue win in 'checkFeatures'.
+ * @param summary Set to the size of the compact model and how closely it follows the full one.
+ * @return The compact model, or nullptr if the model couldn't be packed.
+ */
+std::shared_ptr<const CompactModel> RFPredictor::BuildCompactModel(
+    const Forest& forest,
+    const arma::mat& features,
+    const arma::mat& checkFeatures,
+    const arma::Row<size_t>& checkLabels,
+    std::string& summary
+)
+{
+    std::shared_ptr<CompactModel> compact = CompactModel::Build(forest, features);
+    if ( !compact ) {
+        summary = "Model is too large to build a compact copy of";
+        return nullptr;
+    }
+
+    if ( !compact->Save(COMPACT_MODEL_EXPORT_PATH) )
+        summary = "Couldn't save the compact model to " + std::string(COMPACT_MODEL_EXPORT_PATH) + ". ";
+
+    const CompactParity parity = compact->CheckParity(forest, checkFeatures, checkLabels);
+    summary += std::format(
+        "Compact model takes {:.1f} KB and agrees on {:.1f}% of {} matches (accuracy {:.1f}% vs {:.1f}%)",
+        compact->MemoryBytes() / 1024.0, parity.agreement * 100.0, checkFeatures.n_cols,
+        parity.compactAccuracy * 100.0, parity.fullAccuracy * 100.0
+    );
+
+    return compact;
+}
+
+/**
+ * @brief Marks the current training job as finished.
+ *
+ * If a match result changed while it ran, the model is updated again
+ * from the UI thread, where the training data is kept.
+ */
+void RFPredictor::FinishTrainingJob() {
+    m_training = false;
+
+    if ( m_pendingUpdate.exchange(false) )
+        m_mainFrame->CallAfter([this] { StartWarmStart(); });
+}
+
+/**
+ * @brief Loads an exported training set, if it was built with the current features.
+ *
+ * @param featuresPath Path to the features CSV, one match per row.
+ * @param labelsPath Path to the labels CSV, 1 for a red win and 0 for a blue win.
+ * @param features Set to the loaded features, one match per column.
+ * @param labels Set to the loaded labels.
+ * @return true if a usable training set was loaded, otherwise false.
+ */
+bool RFPredictor::LoadTrainingSet(
+    const std::string& featuresPath,
+    const std::string& labelsPath,
+    arma::mat& features,
+    arma::Row<size_t>& labels
+)
+{
+    try {
+        if ( !mlpack::data::Load(featuresPath, features, false) || !mlpack::data::Load(labelsPath, labels, false) )
+            return false;
+    } catch ( std::runtime_error& err ) {
+        return false;
+    }
+
+    if ( features.n_rows != MATCH_FEATURE_COUNT || features.n_cols != labels.n_elem ) {
+        m_mainFrame->LogBackendMessage(
+            "Training set at " + featuresPath + " has " + std::to_string(features.n_rows) + " features, expected " +
+            std::to_string(MATCH_FEATURE_COUNT) + ". Training from scouted matches instead."
+        );
+        return false;
+    }
+
+    return true;
 }
 
-bool RFPredictor::LoadModel(const std::string& modelPath) {
+/**
+ * @brief Builds a training set from the played matches in the database.
+ *
+ * The features of each match are calculated only from the matches before it, so no
+ * match's own result is in its features. Ties are left out since the model only predicts
+ * a red or a blue win.
+ *
+ * @param features Set to the features of each played match, one match per column.
+ * @param labels Set to 1 for each red win and 0 for each blue win.
+ * @param matchNums Set to the match number of each column.
+ */
+void RFPredictor::BuildTrainingSet(arma::mat& features, arma::Row<size_t>& labels, std::vector<int>& matchNums) {
+    std::vector<Match> played = {};
+    for ( const Match& match : m_dataBase->GetMatches() ) {
+        if ( match.RedWon() || match.BlueWon() )
+            played.push_back(match);
+    }
+
+    const std::vector<MatchFeatures> playedFeatures = m_features->GetFeaturesBeforeMatches(played);
+
+    features.set_size(MATCH_FEATURE_COUNT, played.size());
+    labels.set_size(played.size());
+
+    for ( size_t col = 0; col < played.size(); col++ ) {
+        for ( int i = 0; i < MATCH_FEATURE_COUNT; i++ )
+            features(i, col) = playedFeatures[col][i];
+
+        labels(col) = played[col].RedWon() ? 1 : 0;
+        matchNums.push_back(played[col].matchNum);
+    }
+}
+
+/**
+ * @brief Logs a message from the training thread.
+ *
+ * The UI can only be touched from the UI thread, so the message is logged from there.
+ *
+ * @param msg The message to log.
+ */
+void RFPredictor::LogFromTraining(const std::string& msg) {
+    m_mainFrame->CallAfter([this, msg] {
+        std::string output = msg;
+        m_mainFrame->LogMessage(output);
+    });
+}
+
+/**
+ * @brief Loads a saved model and its calibration.
+ *
+ * With the compact model turned on only the compact model is loaded, falling back to the
+ * full model if there isn't one.
+ *
+ * @param modelPath Path to the full model.
+ * @param compactPath Path to the compact copy of the model.
+ * @param calibrationPath Path to the calibration of the model.
+ * @return true if a model was loaded, otherwise false.
+ */
+bool RFPredictor::LoadModel(const std::string& modelPath, const std::string& compactPath, const std::string& calibrationPath) {
+    std::shared_ptr<const CompactModel> compact = m_compactModel ? CompactModel::Load(compactPath) : nullptr;
+    std::shared_ptr<Forest> forest = nullptr;
+
+    if ( !compact ) {
+        forest = std::make_shared<Forest>();
+        try {
+            if ( !mlpack::data::Load(modelPath, "model", *forest) )
+                return false;
+        } catch ( std::runtime_error& err ) {
+            m_mainFrame->LogErrorMessage("Error loading model. Predictions unavailable.");
+            return false;
+        }
+    }
+
+    // models saved before calibration was added predict with raw vote fractions until retrained
+    std::shared_ptr<Calibrator> calibrator = std::make_shared<Calibrator>();
     try {
-        m_available = mlpack::data::Load(modelPath, "model", m_rf);
+        if ( !mlpack::data::Load(calibrationPath, "calibration", *calibrator) )
+            *calibrator = Calibrator();
     } catch ( std::runtime_error& err ) {
-        m_mainFrame->LogErrorMessage("Error loading model. Predictions unavailable.");
+        *calibrator = Calibrator();
     }
-    return m_available;
+
+    SwapModel(std::move(forest), std::move(compact), std::move(calibrator));
+    return true;
 }
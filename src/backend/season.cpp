@@ -0,0 +1,387 @@
+#include "season.h"
+
+#include <algorithm> // std::all_of, std::remove_if, std::min
+#include <cctype> // std::islower, std::isdigit
+#include <filesystem> // std::filesystem::exists, create_directories
+#include <format> // std::format
+#include <iostream> // std::cout
+
+Season::Season(MainFrame* mainFrame, const std::string& path)
+    : m_mainFrame(mainFrame)
+{
+    if ( sqlite3_open(path.c_str(), &m_db) != SQLITE_OK ) {
+        std::cout << "Failed to open season database " << path << ". Aborting." << std::endl;
+        exit(-1);
+    }
+
+    CreateTables();
+}
+
+Season::~Season() {
+    sqlite3_close(m_db);
+}
+
+/**
+ * @brief Creates the events table.
+ *
+ * The first time, the database scouted before events were kept apart (`DB_PATH`) is
+ * listed as the default event and made current, so its rows carry on being used.
+ */
+void Season::CreateTables() {
+    const char* query =
+        "CREATE TABLE IF NOT EXISTS " SEASON_EVENT_TABLE " ("
+        "eventKey TEXT PRIMARY KEY, "
+        "name TEXT NOT NULL DEFAULT '', "
+        "path TEXT NOT NULL UNIQUE, "
+        "current INTEGER NOT NULL DEFAULT 0"
+        ");"
+
+        "INSERT OR IGNORE INTO " SEASON_EVENT_TABLE " (eventKey, name, path, current) "
+        "SELECT '" DEFAULT_EVENT_KEY "', 'Default Event', '" DB_PATH "', 1 "
+        "WHERE NOT EXISTS (SELECT 1 FROM " SEASON_EVENT_TABLE ");";
+
+    if ( sqlite3_exec(m_db, query, NULL, 0, nullptr) != SQLITE_OK ) {
+        std::cout << "Failed to create season events table. Aborting." << std::endl;
+        exit(-1);
+    }
+}
+
+/**
+ * @brief Connects to the current event's database, creating it if the event was never opened.
+ *
+ * The database is labeled with the event's key, so merging in a database of another event
+ * is refused. The default event is left unlabeled, since scouts' laptops from before events
+ * were kept apart all scout into an unlabeled `DB_PATH`.
+ *
+ * @return The database of the current event. The caller owns it.
+ */
+DataBase* Season::OpenCurrentEvent() {
+    const SeasonEvent event = GetCurrentEvent();
+
+    const std::filesystem::path folder = std::filesystem::path(event.path).parent_path();
+    if ( !folder.empty() ) {
+        std::error_code err;
+        std::filesystem::create_directories(folder, err);
+    }
+
+    DataBase* db = new DataBase(event.path, m_mainFrame);
+    if ( event.eventKey != DEFAULT_EVENT_KEY )
+        db->SetEventKey(event.eventKey);
+
+    return db;
+}
+
+/**
+ * @brief Lists a new event of the season.
+ *
+ * @param eventKey Key of the event, e.g "2025onto". Lowercase letters and digits only,
+ *                 it names the event's database file.
+ * @param name Name shown for the event.
+ * @return true if the event was listed, false if the key isn't valid or is already used.
+ */
+bool Season::AddEvent(const std::string& eventKey, const std::string& name) {
+    const bool validKey = !eventKey.empty() && eventKey.size() <= EVENT_KEY_MAX_LENGTH &&
+        std::all_of(eventKey.begin(), eventKey.end(), [](char c) {
+            return std::islower(static_cast< unsigned char >( c )) || std::isdigit(static_cast< unsigned char >( c ));
+        });
+
+    if ( !validKey ) {
+        m_mainFrame->LogErrorMessage(std::format("Event key must be 1-{} lowercase letters and digits, e.g 2025onto.", EVENT_KEY_MAX_LENGTH));
+        return false;
+    }
+
+    const std::string path = ( std::filesystem::path(SEASON_EVENT_DIR) / ( eventKey + ".db" ) ).string();
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "INSERT INTO " SEASON_EVENT_TABLE " (eventKey, name, path) VALUES (?1, ?2, ?3)", -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, eventKey.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, path.c_str(), -1, SQLITE_TRANSIENT);
+
+    const bool added = ( sqlite3_step(stmt) == SQLITE_DONE );
+    sqlite3_finalize(stmt);
+
+    if ( !added )
+        m_mainFrame->LogErrorMessage("Event " + eventKey + " is already in this season.");
+
+    return added;
+}
+
+/**
+ * @brief Makes an event the one opened when the app starts.
+ *
+ * @param eventKey Key of the event.
+ * @return true if the event is now current, false if it isn't in this season.
+ */
+bool Season::SetCurrentEvent(const std::string& eventKey) {
+    sqlite3_stmt* stmt;
+    const char* query =
+        "UPDATE " SEASON_EVENT_TABLE " SET current = ( eventKey = ?1 ) "
+        "WHERE EXISTS (SELECT 1 FROM " SEASON_EVENT_TABLE " WHERE eventKey = ?1)";
+
+    if ( sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, eventKey.c_str(), -1, SQLITE_TRANSIENT);
+
+    const bool updated = ( sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(m_db) > 0 );
+    sqlite3_finalize(stmt);
+
+    if ( !updated )
+        m_mainFrame->LogErrorMessage("Event " + eventKey + " isn't in this season.");
+
+    return updated;
+}
+
+/**
+ * @brief Retrieves the event opened when the app starts.
+ *
+ * @return The current event, the default event if none is.
+ */
+SeasonEvent Season::GetCurrentEvent() {
+    SeasonEvent event = { DEFAULT_EVENT_KEY, "Default Event", DB_PATH };
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT eventKey, name, path FROM " SEASON_EVENT_TABLE " WHERE current = 1 LIMIT 1", -1, &stmt, nullptr) != SQLITE_OK )
+        return event;
+
+    if ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        event.eventKey = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+        event.name = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 1) );
+        event.path = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 2) );
+    }
+
+    sqlite3_finalize(stmt);
+
+    return event;
+}
+
+/**
+ * @brief Retrieves every event of the season.
+ *
+ * @return The events in the order they were added.
+ */
+std::vector<SeasonEvent> Season::GetEvents() {
+    std::vector<SeasonEvent> events = {};
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, "SELECT eventKey, name, path FROM " SEASON_EVENT_TABLE " ORDER BY rowid", -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return events;
+    }
+
+    while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+        SeasonEvent event = {};
+        event.eventKey = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+        event.name = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 1) );
+        event.path = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 2) );
+        events.push_back(event);
+    }
+
+    sqlite3_finalize(stmt);
+
+    return events;
+}
+
+/**
+ * @brief Calculates each team's stats over every event it was scouted at.
+ *
+ * Each event is aggregated on its own, then the events of a team are combined, weighted
+ * by how many rows were scouted of the team at each.
+ *
+ * @return The stats of each team, best average points first. Their event key is empty.
+ */
+std::vector<EventTeamStats> Season::GetSeasonTeamStats() {
+    std::vector<EventTeamStats> stats = {};
+    if ( !CollectEventStats(0) )
+        return stats;
+
+    const char* query =
+        "SELECT teamNum, COUNT(*), SUM(rowsScouted), "
+        "SUM(points) * 1.0 / SUM(rowsScouted), SUM(rankingPoints) * 1.0 / SUM(rowsScouted), SUM(hangs) * 1.0 / SUM(rowsScouted) "
+        "FROM temp.EventTeamStats GROUP BY teamNum ORDER BY 4 DESC, teamNum";
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) == SQLITE_OK ) {
+        while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+            EventTeamStats team = {};
+            team.teamNum = sqlite3_column_int(stmt, 0);
+            team.events = sqlite3_column_int(stmt, 1);
+            team.rowsScouted = sqlite3_column_int(stmt, 2);
+            team.averagePoints = sqlite3_column_double(stmt, 3);
+            team.averageRankingPoints = sqlite3_column_double(stmt, 4);
+            team.hangRate = sqlite3_column_double(stmt, 5);
+            stats.push_back(team);
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_exec(m_db, "DROP TABLE IF EXISTS temp.EventTeamStats;", NULL, 0, nullptr);
+
+    return stats;
+}
+
+/**
+ * @brief Calculates a team's stats at each event it was scouted at.
+ *
+ * @param teamNum The team number of the team.
+ * @return The stats of the team at each event, labeled with the event's key, in the order the events were added.
+ */
+std::vector<EventTeamStats> Season::GetTeamEventStats(int teamNum) {
+    std::vector<EventTeamStats> stats = {};
+    if ( teamNum == 0 || !CollectEventStats(teamNum) )
+        return stats;
+
+    const char* query =
+        "SELECT s.eventKey, s.teamNum, s.rowsScouted, "
+        "s.points * 1.0 / s.rowsScouted, s.rankingPoints * 1.0 / s.rowsScouted, s.hangs * 1.0 / s.rowsScouted "
+        "FROM temp.EventTeamStats AS s JOIN main." SEASON_EVENT_TABLE " AS e ON e.eventKey = s.eventKey ORDER BY e.rowid";
+
+    sqlite3_stmt* stmt;
+    if ( sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) == SQLITE_OK ) {
+        while ( sqlite3_step(stmt) == SQLITE_ROW ) {
+            EventTeamStats team = {};
+            team.eventKey = reinterpret_cast< const char* >( sqlite3_column_text(stmt, 0) );
+            team.teamNum = sqlite3_column_int(stmt, 1);
+            team.events = 1;
+            team.rowsScouted = sqlite3_column_int(stmt, 2);
+            team.averagePoints = sqlite3_column_double(stmt, 3);
+            team.averageRankingPoints = sqlite3_column_double(stmt, 4);
+            team.hangRate = sqlite3_column_double(stmt, 5);
+            stats.push_back(team);
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_exec(m_db, "DROP TABLE IF EXISTS temp.EventTeamStats;", NULL, 0, nullptr);
+
+    return stats;
+}
+
+/**
+ * @brief Totals each team's scouted rows at every event into temp.EventTeamStats.
+ *
+ * The event databases are attached as many at once as SQLite allows. Each event's rows
+ * are grouped by team within its own database, through its team number index, so only
+ * one row per team and event is copied out. Events never opened have no database yet
+ * and are skipped.
+ *
+ * @param teamNum Only total the rows of this team, every team if it's 0.
+ * @return true if every event that has a database was read.
+ */
+bool Season::CollectEventStats(int teamNum) {
+    const char* create =
+        "DROP TABLE IF EXISTS temp.EventTeamStats;"
+        "CREATE TEMP TABLE EventTeamStats ("
+        "eventKey TEXT NOT NULL, "
+        "teamNum INTEGER NOT NULL, "
+        "rowsScouted INTEGER NOT NULL, "
+        "points INTEGER NOT NULL, "
+        "rankingPoints INTEGER NOT NULL, "
+        "hangs INTEGER NOT NULL"
+        ");";
+
+    if ( sqlite3_exec(m_db, create, NULL, 0, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage("Failed to create season stats table: " + std::string(sqlite3_errmsg(m_db)));
+        return false;
+    }
+
+    std::vector<SeasonEvent> events = GetEvents();
+    events.erase(std::remove_if(events.begin(), events.end(), [](const SeasonEvent& event) {
+        return !std::filesystem::exists(event.path);
+    }), events.end());
+
+    const size_t batchSize = std::max(1, sqlite3_limit(m_db, SQLITE_LIMIT_ATTACHED, -1));
+
+    bool ok = true;
+    for ( size_t first = 0; first < events.size(); first += batchSize ) {
+        const size_t last = std::min(first + batchSize, events.size());
+
+        std::vector<std::pair<std::string, std::string>> attached = {}; // schema and event key
+        for ( size_t i = first; i < last; i++ ) {
+            const std::string schema = SEASON_EVENT_SCHEMA + std::to_string(attached.size());
+            if ( AttachEvent(events[i], schema) )
+                attached.push_back({ schema, events[i].eventKey });
+            else
+                ok = false;
+        }
+
+        for ( const auto& [schema, eventKey] : attached ) {
+            const std::string query = std::format(
+                "INSERT INTO temp.EventTeamStats "
+                "SELECT ?1, teamNum, COUNT(*), SUM(coralPoints + autonomousPoints), SUM(rankingPoints), SUM(hangSuccess) "
+                "FROM {}.{} WHERE teamNum != 0 {} GROUP BY teamNum",
+                schema, TEAM_TABLE, ( teamNum != 0 ) ? "AND teamNum = ?2" : ""
+            );
+
+            sqlite3_stmt* stmt;
+            if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK ) {
+                m_mainFrame->LogErrorMessage("Failed to read event " + eventKey + ": " + std::string(sqlite3_errmsg(m_db)));
+                ok = false;
+                continue;
+            }
+
+            sqlite3_bind_text(stmt, 1, eventKey.c_str(), -1, SQLITE_TRANSIENT);
+            if ( teamNum != 0 )
+                sqlite3_bind_int(stmt, 2, teamNum);
+
+            if ( sqlite3_step(stmt) != SQLITE_DONE ) {
+                m_mainFrame->LogErrorMessage("Failed to read event " + eventKey + ": " + std::string(sqlite3_errmsg(m_db)));
+                ok = false;
+            }
+
+            sqlite3_finalize(stmt);
+        }
+
+        for ( const auto& [schema, eventKey] : attached ) {
+            const std::string query = "DETACH DATABASE " + schema;
+            sqlite3_exec(m_db, query.c_str(), NULL, 0, nullptr);
+        }
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Attaches an event's database to the season database.
+ *
+ * @param event The event to attach.
+ * @param schema The schema to attach it as.
+ * @return true if it was attached.
+ */
+bool Season::AttachEvent(const SeasonEvent& event, const std::string& schema) {
+    sqlite3_stmt* stmt;
+    const std::string query = "ATTACH DATABASE ?1 AS " + schema;
+    if ( sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK ) {
+        m_mainFrame->LogErrorMessage(
+            std::string("Failed to prepare SQL Statement") + std::string(sqlite3_errmsg(m_db))
+        );
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, event.path.c_str(), -1, SQLITE_TRANSIENT);
+
+    const int res = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if ( res != SQLITE_DONE ) {
+        m_mainFrame->LogErrorMessage("Failed to open " + event.path + " of event " + event.eventKey + ".");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,281 @@
+#include "selector.h"
+
+#include <algorithm> // std::sort, std::max
+#include <latch> // std::latch
+#include <limits> // std::numeric_limits
+#include <unordered_map> // std::unordered_map
+
+/**
+ * @brief Points an alliance is expected to score.
+ *
+ * @param teams The teams on the alliance.
+ * @param count The number of teams in 'teams' to use.
+ * @return The score of the alliance.
+ */
+static double AllianceScore(const TeamAggregate* const* teams, int count) {
+    double score = 0.0;
+    double bestDefense = 0.0;
+
+    for ( int i = 0; i < count; i++ ) {
+        score += teams[i]->expectedPoints;
+        score += teams[i]->hangRate * ALLIANCE_HANG_POINTS;
+        score -= teams[i]->penaltys * ALLIANCE_PENALTY_POINTS;
+        bestDefense = std::max(bestDefense, teams[i]->defense);
+    }
+
+    return score + bestDefense * ALLIANCE_DEFENSE_WEIGHT;
+}
+
+/**
+ * @brief The most a team could add to an alliance's score.
+ *
+ * Assumes the team becomes the alliance's best defender, so this
+ * is never less than what it actually adds.
+ *
+ * @param team The team to bound.
+ * @return The upper bound of the team's contribution.
+ */
+static double UpperBound(const TeamAggregate& team) {
+    return team.expectedPoints + team.hangRate * ALLIANCE_HANG_POINTS
+        - team.penaltys * ALLIANCE_PENALTY_POINTS + team.defense * ALLIANCE_DEFENSE_WEIGHT;
+}
+
+AllianceSelector::AllianceSelector(MainFrame* mainFrame, DataBase* dataBase, ThreadPool* threadPool, OPRCalculator* opr, RankingTable* rankings)
+    : m_mainFrame(mainFrame), m_dataBase(dataBase), m_threadPool(threadPool), m_opr(opr), m_rankings(rankings)
+{
+}
+
+/**
+ * @brief Builds the pick list for a captain from the teams that haven't been picked.
+ *
+ * Must be called from the thread that owns the database. The search itself runs on the thread pool.
+ *
+ * @param captainTeamNum The team number of the captain picking.
+ * @param redWinProbabilities Optional head-to-head predictor used to re-rank the top candidates.
+ * @return Every available team, best pick first.
+ */
+std::vector<PickCandidate> AllianceSelector::BuildPickList(int captainTeamNum, const HeadToHead& redWinProbabilities) {
+    m_captainTeamNum = captainTeamNum;
+
+    std::vector<TeamAggregate> aggregates = GetAggregates();
+
+    const TeamAggregate* captain = nullptr;
+    std::vector<const TeamAggregate*> available = {};
+    for ( const TeamAggregate& team : aggregates ) {
+        if ( team.teamNum == captainTeamNum )
+            captain = &team;
+        else if ( !IsPicked(team.teamNum) )
+            available.push_back(&team);
+    }
+
+    if ( !captain ) {
+        m_mainFrame->LogErrorMessage("Captain team " + std::to_string(captainTeamNum) + " has not been scouted.");
+        return {};
+    }
+
+    if ( available.empty() )
+        return {};
+
+    // best possible second picks first, so the search can stop early
+    std::sort(available.begin(), available.end(), [](const TeamAggregate* a, const TeamAggregate* b) {
+        return UpperBound(*a) > UpperBound(*b);
+    });
+
+    std::vector<PickCandidate> pickList(available.size());
+    std::latch done(static_cast< std::ptrdiff_t >( available.size() ));
+
+    for ( size_t i = 0; i < available.size(); i++ ) {
+        m_threadPool->Submit([&available, &pickList, &done, captain, i] {
+            const TeamAggregate* alliance[3] = { captain, available[i], nullptr };
+            const double partial = AllianceScore(alliance, 2);
+
+            PickCandidate candidate = { available[i]->teamNum, 0, partial, -1.0 };
+            double best = -std::numeric_limits<double>::infinity();
+
+            for ( size_t j = 0; j < available.size(); j++ ) {
+                if ( j == i )
+                    continue;
+
+                // no team after this one can add more, the best alliance was found
+                if ( partial + UpperBound(*available[j]) <= best )
+                    break;
+
+                alliance[2] = available[j];
+                const double score = AllianceScore(alliance, 3);
+                if ( score > best ) {
+                    best = score;
+                    candidate.partnerTeamNum = available[j]->teamNum;
+                    candidate.score = score;
+                }
+            }
+
+            pickList[i] = candidate;
+            done.count_down();
+        });
+    }
+
+    done.wait();
+
+    std::sort(pickList.begin(), pickList.end(), [](const PickCandidate& a, const PickCandidate& b) {
+        return a.score > b.score;
+    });
+
+    if ( redWinProbabilities )
+        RankHeadToHead(pickList, captainTeamNum, redWinProbabilities);
+
+    if ( m_rankings ) {
+        for ( PickCandidate& candidate : pickList )
+            candidate.rank = m_rankings->GetStanding(candidate.teamNum).rank;
+    }
+
+    return pickList;
+}
+
+/**
+ * @brief Finds the captain picking next, the highest ranked team not on an alliance yet.
+ *
+ * @return Team number of the captain, 0 if every ranked team was picked.
+ */
+int AllianceSelector::NextCaptain() const {
+    if ( !m_rankings )
+        return 0;
+
+    for ( const TeamStanding& standing : m_rankings->GetStandings() ) {
+        if ( !IsPicked(standing.teamNum) )
+            return standing.teamNum;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Leaves a team out of future pick lists.
+ *
+ * @param teamNum The team number of the team that was picked.
+ */
+void AllianceSelector::MarkPicked(int teamNum) {
+    m_picked.insert(teamNum);
+}
+
+/**
+ * @brief Makes a team available for future pick lists again, e.g after a declined pick.
+ *
+ * @param teamNum The team number of the team to make available.
+ */
+void AllianceSelector::UnmarkPicked(int teamNum) {
+    m_picked.erase(teamNum);
+}
+
+/**
+ * @brief Averages every team's scouted rows into its aggregate.
+ *
+ * Teams that have played use their OPR as their expected points, since it accounts for
+ * their partners. Teams that haven't fall back to their average scouted points.
+ *
+ * @return The aggregate of every team in the database.
+ */
+std::vector<TeamAggregate> AllianceSelector::GetAggregates() {
+    std::unordered_map<int, size_t> index = {}; // team number -> index in 'aggregates'
+    std::vector<TeamAggregate> aggregates = {};
+    std::vector<int> rowCounts = {};
+
+    for ( const Team& team : m_dataBase->GetTeams() ) {
+        auto it = index.find(team.teamNum);
+        if ( it == index.end() ) {
+            it = index.emplace(team.teamNum, aggregates.size()).first;
+            aggregates.push_back({ team.teamNum, 0.0, 0.0, 0.0, 0.0 });
+            rowCounts.push_back(0);
+        }
+
+        TeamAggregate& aggregate = aggregates[it->second];
+        aggregate.expectedPoints += team.PointsScored();
+        aggregate.hangRate += team.hangSuccess ? 1.0 : 0.0;
+        aggregate.defense += team.defense;
+        aggregate.penaltys += team.penaltys;
+        rowCounts[it->second]++;
+    }
+
+    for ( size_t i = 0; i < aggregates.size(); i++ ) {
+        TeamAggregate& aggregate = aggregates[i];
+        aggregate.expectedPoints /= rowCounts[i];
+        aggregate.hangRate /= rowCounts[i];
+        aggregate.defense /= rowCounts[i];
+        aggregate.penaltys /= rowCounts[i];
+
+        if ( m_opr ) {
+            const OPRResult result = m_opr->GetTeamOPR(aggregate.teamNum);
+            if ( result.matchesPlayed > 0 )
+                aggregate.expectedPoints = result.opr;
+        }
+    }
+
+    return aggregates;
+}
+
+/**
+ * @brief Re-ranks the top of the pick list by predicted head-to-head results.
+ *
+ * Each of the top `ALLIANCE_HEAD_TO_HEAD_COUNT` alliances plays the alliances the strongest
+ * remaining teams would form (best three together, next three together, ...), once as red
+ * and once as blue. Every match is predicted in one batch. The top candidates are then
+ * ordered by expected wins, then by score.
+ *
+ * @param pickList The pick list, sorted by score.
+ * @param captainTeamNum The team number of the captain picking.
+ * @param redWinProbabilities Predicts the chance of the red alliance winning each match.
+ */
+void AllianceSelector::RankHeadToHead(std::vector<PickCandidate>& pickList, int captainTeamNum, const HeadToHead& redWinProbabilities) {
+    const size_t candidateCount = std::min<size_t>(ALLIANCE_HEAD_TO_HEAD_COUNT, pickList.size());
+
+    std::vector<Match> matches = {};
+    std::vector<size_t> candidateOf = {}; // index of the candidate on red in each match
+
+    for ( size_t i = 0; i < candidateCount; i++ ) {
+        const PickCandidate& candidate = pickList[i];
+
+        // the strongest teams left once this alliance is formed, in pick list order
+        std::vector<int> opponents = {};
+        for ( const PickCandidate& other : pickList ) {
+            if ( other.teamNum != candidate.teamNum && other.teamNum != candidate.partnerTeamNum )
+                opponents.push_back(other.teamNum);
+        }
+
+        for ( size_t first = 0; first + 2 < opponents.size() && first < ALLIANCE_HEAD_TO_HEAD_COUNT * 3; first += 3 ) {
+            Match match = {};
+            match.teams[0] = captainTeamNum;
+            match.teams[1] = candidate.teamNum;
+            match.teams[2] = candidate.partnerTeamNum;
+            match.teams[3] = opponents[first];
+            match.teams[4] = opponents[first + 1];
+            match.teams[5] = opponents[first + 2];
+
+            matches.push_back(match);
+            candidateOf.push_back(i);
+
+            // play again on the blue side so the model's alliance colour bias cancels out
+            std::swap(match.teams[0], match.teams[3]);
+            std::swap(match.teams[1], match.teams[4]);
+            std::swap(match.teams[2], match.teams[5]);
+
+            matches.push_back(match);
+            candidateOf.push_back(i);
+        }
+    }
+
+    for ( size_t i = 0; i < candidateCount; i++ )
+        pickList[i].headToHeadWins = 0.0;
+
+    // matches come in pairs, the candidate on red then on blue
+    const std::vector<double> probabilities = redWinProbabilities(matches);
+    for ( size_t m = 0; m < matches.size(); m++ ) {
+        const bool candidateIsRed = ( m % 2 ) == 0;
+        pickList[candidateOf[m]].headToHeadWins += candidateIsRed ? probabilities[m] : 1.0 - probabilities[m];
+    }
+
+    std::stable_sort(pickList.begin(), pickList.begin() + candidateCount, [](const PickCandidate& a, const PickCandidate& b) {
+        if ( a.headToHeadWins != b.headToHeadWins )
+            return a.headToHeadWins > b.headToHeadWins;
+
+        return a.score > b.score;
+    });
+}
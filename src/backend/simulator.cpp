@@ -0,0 +1,209 @@
+#include "simulator.h"
+
+#include <algorithm> // std::sort, std::clamp
+#include <cmath> // std::floor
+#include <latch> // std::latch
+#include <numeric> // std::iota
+#include <random> // std::mt19937_64, std::uniform_real_distribution
+#include <unordered_map> // std::unordered_map
+
+/**
+ * @brief Mixes a seed so neighbouring task indices give unrelated random streams.
+ *
+ * @param x The value to mix.
+ * @return The mixed value (SplitMix64 finalizer).
+ */
+static uint64_t MixSeed(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBull;
+    return x ^ ( x >> 31 );
+}
+
+EventSimulator::EventSimulator(MainFrame* mainFrame, DataBase* dataBase, ThreadPool* threadPool, RankingTable* rankings)
+    : m_mainFrame(mainFrame), m_dataBase(dataBase), m_threadPool(threadPool), m_rankings(rankings)
+{
+}
+
+/**
+ * @brief Copies the current standings and the unplayed matches out of the ranking table.
+ *
+ * Teams start from the standings as they are, unplayed matches are kept along with the
+ * chance of red winning them. Unplayed matches tie as often as the played ones did.
+ *
+ * @param redWinProbability Gives the chance of the red alliance winning an unplayed match.
+ * @return The snapshot to pass to `Simulate`.
+ */
+EventSnapshot EventSimulator::TakeSnapshot(const WinProbability& redWinProbability) {
+    EventSnapshot snapshot = {};
+    if ( !m_rankings )
+        return snapshot;
+
+    std::unordered_map<int, int> teamIndex = {}; // team number -> index in snapshot.teamNums
+    int played = 0, ties = 0;
+    for ( const TeamStanding& standing : m_rankings->GetStandings() ) {
+        teamIndex[standing.teamNum] = static_cast< int >( snapshot.teamNums.size() );
+        snapshot.teamNums.push_back(standing.teamNum);
+        snapshot.standings.push_back(standing);
+
+        played += standing.played;
+        ties += standing.ties;
+    }
+
+    if ( played > 0 )
+        snapshot.tieProbability = static_cast< double >( ties ) / played;
+
+    for ( const Match& match : m_rankings->GetRemainingMatches() ) {
+        std::array<int, 6> teams = {};
+        for ( int i = 0; i < 6; i++ ) {
+            auto it = teamIndex.find(match.teams[i]);
+            teams[i] = ( it != teamIndex.end() ) ? it->second : -1; // -1 for an empty slot
+        }
+
+        const double probability = std::clamp(redWinProbability(match), 0.0, 1.0);
+        snapshot.remaining.push_back({ teams, probability });
+    }
+
+    return snapshot;
+}
+
+/**
+ * @brief Plays out the rest of the event many times and counts where each team finishes.
+ *
+ * Work is split into tasks of `SIMULATIONS_PER_TASK` which run on the thread pool. Each task
+ * keeps its own counts and they are merged once every task has finished, so the workers never
+ * contend with each other while simulating.
+ *
+ * @param snapshot The event to simulate, from `TakeSnapshot`.
+ * @param simulationCount How many times to simulate the event.
+ * @param seed Seed for the run. The same seed and snapshot always give the same projections.
+ * @return The projection of each team, ordered by average rank.
+ */
+std::vector<TeamProjection> EventSimulator::Simulate(const EventSnapshot& snapshot, size_t simulationCount, uint64_t seed) {
+    const size_t teamCount = snapshot.teamNums.size();
+    if ( teamCount == 0 || simulationCount == 0 )
+        return {};
+
+    struct TaskCounts {
+        std::vector<uint64_t> rankCounts; // team index * teamCount + rank -> times finished there
+        std::vector<uint64_t> rankingPoints; // team index -> total ranking points
+    };
+
+    const size_t taskCount = ( simulationCount + SIMULATIONS_PER_TASK - 1 ) / SIMULATIONS_PER_TASK;
+    std::vector<TaskCounts> tasks(taskCount);
+    std::latch done(static_cast< std::ptrdiff_t >( taskCount ));
+
+    for ( size_t task = 0; task < taskCount; task++ ) {
+        const size_t first = task * SIMULATIONS_PER_TASK;
+        const size_t count = std::min<size_t>(SIMULATIONS_PER_TASK, simulationCount - first);
+
+        m_threadPool->Submit([&snapshot, &tasks, &done, teamCount, task, count, seed] {
+            TaskCounts& counts = tasks[task];
+            counts.rankCounts.assign(teamCount * teamCount, 0);
+            counts.rankingPoints.assign(teamCount, 0);
+
+            std::mt19937_64 rng(MixSeed(seed + task));
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+            // bonus ranking points of a match are the whole part, plus one as often as the fraction
+            std::vector<int> bonusWhole(teamCount);
+            std::vector<double> bonusFraction(teamCount);
+            for ( size_t i = 0; i < teamCount; i++ ) {
+                const double bonus = snapshot.standings[i].averageBonusRankingPoints;
+                bonusWhole[i] = static_cast< int >( std::floor(bonus) );
+                bonusFraction[i] = bonus - bonusWhole[i];
+            }
+
+            std::vector<TeamStanding> standings = snapshot.standings;
+            std::vector<int> points(teamCount);
+            std::vector<int> played(teamCount);
+            std::vector<int> order(teamCount);
+
+            for ( size_t sim = 0; sim < count; sim++ ) {
+                for ( size_t i = 0; i < teamCount; i++ ) {
+                    points[i] = snapshot.standings[i].totalRankingPoints;
+                    played[i] = snapshot.standings[i].played;
+                }
+
+                for ( const EventSnapshot::RemainingMatch& match : snapshot.remaining ) {
+                    const bool tie = uniform(rng) < snapshot.tieProbability;
+                    const bool redWon = !tie && uniform(rng) < match.redWinProbability;
+
+                    for ( int i = 0; i < 6; i++ ) {
+                        const int team = match.teams[i];
+                        if ( team == -1 )
+                            continue;
+
+                        const bool won = !tie && redWon == ( i < 3 );
+                        points[team] += ( tie ) ? TIE_RANKING_POINTS : ( won ) ? WIN_RANKING_POINTS : 0;
+                        points[team] += bonusWhole[team] + ( ( uniform(rng) < bonusFraction[team] ) ? 1 : 0 );
+                        played[team]++;
+                    }
+                }
+
+                for ( size_t i = 0; i < teamCount; i++ ) {
+                    standings[i].totalRankingPoints = points[i];
+                    standings[i].rankingScore = ( played[i] > 0 ) ? static_cast< double >( points[i] ) / played[i] : 0.0;
+                }
+
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&standings](int a, int b) {
+                    return RankingTable::RanksAbove(standings[a], standings[b]);
+                });
+
+                for ( size_t rank = 0; rank < teamCount; rank++ ) {
+                    const int team = order[rank];
+                    counts.rankCounts[team * teamCount + rank]++;
+                    counts.rankingPoints[team] += points[team];
+                }
+            }
+
+            done.count_down();
+        });
+    }
+
+    done.wait();
+
+    // merge the counts of every task
+    std::vector<TeamProjection> projections = {};
+    for ( size_t team = 0; team < teamCount; team++ ) {
+        TeamProjection projection = { snapshot.teamNums[team], 0.0, 0.0, std::vector<double>(teamCount, 0.0) };
+
+        for ( const TaskCounts& counts : tasks ) {
+            projection.averageRankingPoints += static_cast< double >( counts.rankingPoints[team] );
+            for ( size_t rank = 0; rank < teamCount; rank++ )
+                projection.rankProbabilities[rank] += static_cast< double >( counts.rankCounts[team * teamCount + rank] );
+        }
+
+        projection.averageRankingPoints /= simulationCount;
+        for ( size_t rank = 0; rank < teamCount; rank++ ) {
+            projection.rankProbabilities[rank] /= simulationCount;
+            projection.averageRank += ( rank + 1 ) * projection.rankProbabilities[rank];
+        }
+
+        projections.push_back(projection);
+    }
+
+    std::sort(projections.begin(), projections.end(), [](const TeamProjection& a, const TeamProjection& b) {
+        return a.averageRank < b.averageRank;
+    });
+
+    return projections;
+}
+
+/**
+ * @brief Marks a run as started so only one runs at a time.
+ *
+ * @return true if no other run was in progress, otherwise false.
+ */
+bool EventSimulator::TryBeginRun() {
+    bool expected = false;
+    return m_running.compare_exchange_strong(expected, true);
+}
+
+/**
+ * @brief Marks the current run as finished.
+ */
+void EventSimulator::EndRun() {
+    m_running = false;
+}
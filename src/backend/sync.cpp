@@ -0,0 +1,387 @@
+#include "sync.h"
+
+#include <format> // std::format
+#include <fstream> // std::ifstream, std::ofstream
+#include <iterator> // std::istreambuf_iterator
+#include <vector> // std::vector
+
+SyncService::SyncService(MainFrame* mainFrame, DataBase* db) : m_mainFrame(mainFrame), m_db(db) {}
+
+SyncService::~SyncService() {
+    StopServer();
+
+    // wake a sync waiting on the other station instead of waiting out its timeout
+    m_stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if ( m_outbound )
+            m_outbound->Shutdown();
+    }
+
+    if ( m_syncThread.joinable() )
+        m_syncThread.join();
+}
+
+/**
+ * @brief Writes the rows changed since the last export to a changeset file.
+ *
+ * @param path Path of the file to write.
+ * @param everything Write every row instead, for a station that missed earlier files.
+ * @param count Set to the number of rows written.
+ * @return true if the file was written, otherwise false.
+ */
+bool SyncService::ExportChangesToFile(const std::string& path, bool everything, size_t& count) {
+    const uint64_t from = everything ? 0 : m_db->GetSentSeq(SYNC_FILE_PEER);
+    const Changeset changeset = m_db->GetChangesSince(from);
+    const std::vector<uint8_t> bytes = changeset.Encode();
+
+    std::ofstream file(path, std::ios::binary);
+    if ( !file.is_open() ) {
+        m_mainFrame->LogErrorMessage("Failed to open file: " + path);
+        return false;
+    }
+
+    file.write(reinterpret_cast< const char* >( bytes.data() ), static_cast< std::streamsize >( bytes.size() ));
+    file.close();
+
+    if ( !file ) {
+        m_mainFrame->LogErrorMessage("Failed to write changes to: " + path);
+        return false;
+    }
+
+    // the next export starts where this one ended, even if this one was of everything
+    if ( changeset.toSeq > m_db->GetSentSeq(SYNC_FILE_PEER) )
+        m_db->SetSentSeq(SYNC_FILE_PEER, changeset.toSeq);
+
+    m_db->CompactChangeLog();
+
+    count = changeset.records.size();
+    return true;
+}
+
+/**
+ * @brief Applies a changeset file exported by another station.
+ *
+ * @param path Path of the file to read.
+ * @param report Set to the number of rows read and the number that changed something.
+ * @return true if the whole changeset was applied, otherwise false.
+ */
+bool SyncService::ApplyChangesFromFile(const std::string& path, SyncReport& report) {
+    std::ifstream file(path, std::ios::binary);
+    if ( !file.is_open() ) {
+        m_mainFrame->LogErrorMessage("Failed to open file: " + path);
+        return false;
+    }
+
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Changeset changeset = {};
+    if ( !Changeset::Decode(bytes.data(), bytes.size(), changeset) ) {
+        m_mainFrame->LogErrorMessage(path + " is not a changeset file, or is from another version of " APP_NAME ".");
+        return false;
+    }
+
+    return m_db->ApplyChangeset(changeset, report);
+}
+
+/**
+ * @brief Starts listening for other stations syncing with this one.
+ *
+ * @param port Port to listen on, 0 for any free port.
+ * @param loopbackOnly Only accept stations on this machine.
+ * @return true if the server is running, false if the port couldn't be listened on.
+ */
+bool SyncService::StartServer(uint16_t port, bool loopbackOnly) {
+    if ( m_serving )
+        return true;
+
+    if ( m_serverThread.joinable() )
+        m_serverThread.join();
+
+    m_listener = Socket::Listen(port, loopbackOnly);
+    if ( !m_listener.IsValid() ) {
+        m_mainFrame->LogErrorMessage(std::format("Failed to listen for syncs on port {}.", port));
+        return false;
+    }
+
+    m_serverPort = m_listener.LocalPort();
+    m_stopping = false;
+    m_serving = true;
+    m_serverThread = std::thread(&SyncService::ServeConnections, this);
+    return true;
+}
+
+/**
+ * @brief Stops listening for syncs, dropping a sync being served.
+ *
+ * A dropped sync applies nothing the listening station hadn't finished applying, and the
+ * connecting station just runs it again.
+ */
+void SyncService::StopServer() {
+    if ( !m_serving && !m_serverThread.joinable() )
+        return;
+
+    m_stopping = true;
+    m_listener.Shutdown();
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if ( m_connection )
+            m_connection->Shutdown();
+    }
+
+    if ( m_serverThread.joinable() )
+        m_serverThread.join();
+
+    m_listener.Close();
+    m_serving = false;
+    m_serverPort = 0;
+}
+
+void SyncService::ServeConnections() {
+    while ( !m_stopping ) {
+        Socket connection = m_listener.Accept();
+        if ( !connection.IsValid() )
+            break;
+
+        connection.SetTimeout(SYNC_TIMEOUT_MS);
+        {
+            std::lock_guard<std::mutex> lock(m_connectionMutex);
+            m_connection = &connection;
+        }
+
+        // stations are served one at a time, so their changes are applied in the order they arrived
+        ServeConnection(connection);
+
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        m_connection = nullptr;
+    }
+
+    m_serving = false;
+}
+
+/**
+ * @brief Serves one sync, from HELLO to REPLY.
+ *
+ * @param connection The connecting station.
+ * @return true if the sync finished, false if the station left or sent something unexpected.
+ */
+bool SyncService::ServeConnection(const Socket& connection) {
+    std::vector<uint8_t> frame = {};
+    uint8_t kind = 0;
+
+    // HELLO
+    std::string peer = "";
+    if ( !connection.ReceiveFrame(frame) )
+        return false;
+
+    ByteReader hello(frame.data(), frame.size());
+    if ( !hello.ReadByte(kind) || kind != kSyncHello || !hello.ReadString(peer) || peer.empty() )
+        return false;
+
+    // WELCOME
+    std::string station = "";
+    uint64_t receivedSeq = 0;
+    if ( !RunOnUiThread(m_mainFrame, [&] { station = m_db->GetStationName(); receivedSeq = m_db->GetReceivedSeq(peer); }, m_stopping) )
+        return false;
+
+    std::vector<uint8_t> welcome = {};
+    ByteWriter welcomeWriter(welcome);
+    welcomeWriter.WriteByte(kSyncWelcome);
+    welcomeWriter.WriteString(station);
+    welcomeWriter.WriteVarint(receivedSeq);
+    if ( !connection.SendFrame(welcome) )
+        return false;
+
+    // CHANGES
+    if ( !connection.ReceiveFrame(frame) )
+        return false;
+
+    ByteReader changes(frame.data(), frame.size());
+    uint64_t pullFrom = 0;
+    if ( !changes.ReadByte(kind) || kind != kSyncChanges || !changes.ReadVarint(pullFrom) )
+        return false;
+
+    Changeset incoming = {};
+    if ( !Changeset::Decode(changes.Position(), changes.Remaining(), incoming) || incoming.origin != peer )
+        return false;
+
+    // REPLY, collected in the same call so it's based on what was just applied
+    SyncReport report = {};
+    bool applied = false;
+    Changeset outgoing = {};
+    const bool ran = RunOnUiThread(m_mainFrame, [&] {
+        applied = m_db->ApplyChangeset(incoming, report);
+        outgoing = m_db->GetChangesSince(pullFrom, peer);
+    }, m_stopping);
+    if ( !ran || !applied )
+        return false;
+
+    std::vector<uint8_t> reply = {};
+    ByteWriter replyWriter(reply);
+    replyWriter.WriteByte(kSyncReply);
+    replyWriter.WriteBytes(outgoing.Encode());
+    const bool sent = connection.SendFrame(reply);
+
+    report.sent = outgoing.records.size();
+    m_mainFrame->CallAfter([this, peer, report, sent, toSeq = outgoing.toSeq] {
+        if ( sent )
+            m_db->SetSentSeq(peer, toSeq);
+
+        m_mainFrame->LogBackendMessage(std::format(
+            "Synced with {}: {} rows received ({} changed something here), {} rows sent.",
+            peer, report.received, report.applied, sent ? report.sent : 0
+        ));
+
+        if ( report.applied > 0 )
+            m_mainFrame->ReloadAllData();
+    });
+
+    return sent;
+}
+
+/**
+ * @brief Syncs with another station in the background, logging the result when it's done.
+ *
+ * @param host Name or address of the station.
+ * @param port Port it listens for syncs on.
+ * @return true if the sync was started, false if one is already running.
+ */
+bool SyncService::StartSync(const std::string& host, uint16_t port) {
+    if ( m_syncing.exchange(true) )
+        return false;
+
+    if ( m_syncThread.joinable() )
+        m_syncThread.join();
+
+    m_syncThread = std::thread([this, host, port] {
+        SyncReport report = {};
+        const bool synced = SyncWith(host, port, report);
+
+        m_mainFrame->CallAfter([this, host, port, synced, report] {
+            if ( !synced ) {
+                m_mainFrame->LogErrorMessage(std::format("Failed to sync with {}:{}.", host, port));
+                return;
+            }
+
+            m_mainFrame->LogBackendMessage(std::format(
+                "Synced with {}: {} rows sent, {} rows received ({} changed something here).",
+                host, report.sent, report.received, report.applied
+            ));
+
+            if ( report.applied > 0 )
+                m_mainFrame->ReloadAllData();
+        });
+
+        m_syncing = false;
+    });
+
+    return true;
+}
+
+/**
+ * @brief Sends this station's changes to another station and applies the other station's changes here.
+ *
+ * Each side only sends what the other hasn't applied yet, going by the other's own watermark,
+ * so nothing is resent after a sync that was interrupted once the other side had applied it.
+ *
+ * @param host Name or address of the station.
+ * @param port Port it listens for syncs on.
+ * @param report Set to the number of rows sent, received, and received rows that changed something here.
+ * @return true if both sides applied the other's changes, otherwise false.
+ */
+bool SyncService::SyncWith(const std::string& host, uint16_t port, SyncReport& report) {
+    report = {};
+
+    Socket connection = Socket::Connect(host, port);
+    if ( !connection.IsValid() )
+        return false;
+
+    connection.SetTimeout(SYNC_TIMEOUT_MS);
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        m_outbound = &connection;
+    }
+
+    const bool synced = ExchangeWith(connection, report);
+
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    m_outbound = nullptr;
+
+    return synced;
+}
+
+/**
+ * @brief Runs the connecting side of a sync over an open connection, from HELLO to REPLY.
+ *
+ * @param connection The connection to the listening station.
+ * @param report Set to the number of rows sent, received, and received rows that changed something here.
+ * @return true if both sides applied the other's changes, otherwise false.
+ */
+bool SyncService::ExchangeWith(const Socket& connection, SyncReport& report) {
+    std::string station = "";
+    if ( !RunOnUiThread(m_mainFrame, [&] { station = m_db->GetStationName(); }, m_stopping) )
+        return false;
+
+    // HELLO
+    std::vector<uint8_t> hello = {};
+    ByteWriter helloWriter(hello);
+    helloWriter.WriteByte(kSyncHello);
+    helloWriter.WriteString(station);
+    if ( !connection.SendFrame(hello) )
+        return false;
+
+    // WELCOME
+    std::vector<uint8_t> frame = {};
+    if ( !connection.ReceiveFrame(frame) )
+        return false;
+
+    ByteReader welcome(frame.data(), frame.size());
+    uint8_t kind = 0;
+    std::string peer = "";
+    uint64_t peerHasSeq = 0;
+    if ( !welcome.ReadByte(kind) || kind != kSyncWelcome || !welcome.ReadString(peer) || !welcome.ReadVarint(peerHasSeq) )
+        return false;
+
+    if ( peer == station ) {
+        RunOnUiThread(m_mainFrame, [this] { m_mainFrame->LogErrorMessage("Can't sync a station with itself."); }, m_stopping);
+        return false;
+    }
+
+    // CHANGES
+    Changeset outgoing = {};
+    uint64_t pullFrom = 0;
+    if ( !RunOnUiThread(m_mainFrame, [&] { outgoing = m_db->GetChangesSince(peerHasSeq, peer); pullFrom = m_db->GetReceivedSeq(peer); }, m_stopping) )
+        return false;
+
+    std::vector<uint8_t> changes = {};
+    ByteWriter changesWriter(changes);
+    changesWriter.WriteByte(kSyncChanges);
+    changesWriter.WriteVarint(pullFrom);
+    changesWriter.WriteBytes(outgoing.Encode());
+    if ( !connection.SendFrame(changes) )
+        return false;
+
+    // REPLY, only sent once our changes were applied
+    if ( !connection.ReceiveFrame(frame) )
+        return false;
+
+    ByteReader replyReader(frame.data(), frame.size());
+    Changeset incoming = {};
+    if ( !replyReader.ReadByte(kind) || kind != kSyncReply ||
+         !Changeset::Decode(replyReader.Position(), replyReader.Remaining(), incoming) || incoming.origin != peer )
+        return false;
+
+    report.sent = outgoing.records.size();
+
+    bool applied = false;
+    const bool ran = RunOnUiThread(m_mainFrame, [&] {
+        m_db->SetSentSeq(peer, outgoing.toSeq);
+
+        SyncReport received = {};
+        applied = m_db->ApplyChangeset(incoming, received);
+        report.received = received.received;
+        report.applied = received.applied;
+    }, m_stopping);
+
+    return ran && applied;
+}
@@ -27,4 +27,13 @@ Team Team::FromSQLStatment(sqlite3_stmt* stmt) {
     team.rankingPoints = sqlite3_column_int(stmt, 12);
 
     return team;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Calculates the points the team scored in the match it was scouted in.
+ *
+ * @return The sum of the team's coral points and autonomous points.
+ */
+int Team::PointsScored() const {
+    return this->coralPoints + this->autonomousPoints;
+}
@@ -0,0 +1,138 @@
+#include "threadpool.h"
+
+// Index of the worker running on the current thread, or -1 if
+// the current thread isn't one of this pool's workers.
+static thread_local const ThreadPool* t_pool = nullptr;
+static thread_local size_t t_workerIndex = static_cast< size_t >( -1 );
+
+/**
+ * @brief Constructs a ThreadPool and starts its worker threads.
+ *
+ * @param threadCount The number of worker threads to start. Defaults to one per
+ *                    hardware thread. At least one worker is always started.
+ */
+ThreadPool::ThreadPool(size_t threadCount) {
+    if ( threadCount == 0 )
+        threadCount = 1;
+
+    for ( size_t i = 0; i < threadCount; i++ )
+        m_queues.push_back(std::make_unique<TaskQueue>());
+
+    for ( size_t i = 0; i < threadCount; i++ )
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+/**
+ * @brief Stops every worker thread.
+ *
+ * Tasks that are still queued are finished before the workers exit.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_taskAvailable.notify_all();
+
+    for ( std::thread& thread : m_threads )
+        thread.join();
+}
+
+/**
+ * @brief Queues a task to run on one of the workers.
+ *
+ * @param task The task to run.
+ */
+void ThreadPool::Submit(std::function<void()> task) {
+    size_t index = 0;
+    if ( t_pool == this )
+        index = t_workerIndex; // keep work spawned by a task on the same worker
+    else
+        index = m_nextQueue++ % m_queues.size();
+
+    {
+        // hold the pool mutex so a worker can't miss the wake up
+        // between checking for tasks and going to sleep
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+
+    m_taskAvailable.notify_one();
+}
+
+/**
+ * @brief Runs tasks from the worker's own queue, stealing from others when it is empty.
+ *
+ * @param index The index of the worker and its queue.
+ */
+void ThreadPool::WorkerLoop(size_t index) {
+    t_pool = this;
+    t_workerIndex = index;
+
+    while ( true ) {
+        std::function<void()> task;
+        if ( PopTask(index, task) || StealTask(index, task) ) {
+            m_queued--;
+            task();
+            continue;
+        }
+
+        // nothing to run anywhere, sleep until a task is submitted
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_taskAvailable.wait(lock, [this] { return m_queued > 0 || m_stopping; });
+
+        if ( m_stopping && m_queued == 0 )
+            return;
+    }
+}
+
+/**
+ * @brief Takes the most recently submitted task from a worker's own queue.
+ *
+ * @param index The index of the worker.
+ * @param task Set to the task that was taken.
+ * @return true if a task was taken, otherwise false.
+ */
+bool ThreadPool::PopTask(size_t index, std::function<void()>& task) {
+    TaskQueue& queue = *m_queues[index];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if ( queue.tasks.empty() )
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task from another worker's queue.
+ *
+ * Queues are tried in order starting from the worker after the thief, so
+ * thieves don't all pile onto the same victim.
+ *
+ * @param thief The index of the worker looking for a task.
+ * @param task Set to the task that was stolen.
+ * @return true if a task was stolen, otherwise false.
+ */
+bool ThreadPool::StealTask(size_t thief, std::function<void()>& task) {
+    for ( size_t i = 1; i < m_queues.size(); i++ ) {
+        TaskQueue& queue = *m_queues[( thief + i ) % m_queues.size()];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if ( queue.tasks.empty() )
+            continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,226 @@
+#include "trend.h"
+
+#include <algorithm> // std::sort, std::min, std::reverse
+#include <iterator> // std::prev
+
+TrendIndex::TrendIndex(MainFrame* mainFrame, DataBase* dataBase) : m_mainFrame(mainFrame), m_dataBase(dataBase) {
+    Reload();
+}
+
+/**
+ * @brief Rebuilds the index from every scouted row in the database.
+ *
+ * Only needed when the app starts, or when the database was replaced without
+ * reporting its rows, like when a backup is restored.
+ */
+void TrendIndex::Reload() {
+    m_teams.clear();
+    m_rows.clear();
+
+    if ( !m_dataBase )
+        return;
+
+    std::unordered_map<int, int> changedFrom = {};
+    for ( const Team& team : m_dataBase->GetTeams() )
+        AddRow(team, changedFrom);
+
+    for ( const auto& [teamNum, fromMatchNum] : changedFrom )
+        Update(teamNum, fromMatchNum);
+}
+
+/**
+ * @brief Folds the scouted rows of a change batch into the index.
+ *
+ * What a changed row added before is taken out using what the index remembers of it,
+ * then the rows that still exist are read again in one query. Only the teams the rows
+ * belong to, before or after the change, are updated.
+ *
+ * @param batch The rows of the Teams and Matches tables that changed.
+ * @return true if a team's history changed.
+ */
+bool TrendIndex::ApplyChanges(const DataEventBatch& batch) {
+    if ( !m_dataBase )
+        return false;
+
+    std::unordered_map<int, int> changedFrom = {}; // team number -> earliest match number that changed
+    std::vector<int> uids = {};
+    for ( const DataEvent& event : batch.events ) {
+        if ( event.table != TEAM_TABLE )
+            continue;
+
+        RemoveRow(event.key, changedFrom);
+        if ( event.op != kDataDeleted )
+            uids.push_back(event.key);
+    }
+
+    if ( !uids.empty() ) {
+        for ( const Team& team : m_dataBase->GetTeams(uids) )
+            AddRow(team, changedFrom);
+    }
+
+    for ( const auto& [teamNum, fromMatchNum] : changedFrom )
+        Update(teamNum, fromMatchNum);
+
+    return !changedFrom.empty();
+}
+
+/**
+ * @brief Adds the points of a scouted row to its team's match.
+ *
+ * @param team        The scouted row.
+ * @param changedFrom Earliest match number changed of each team, lowered to the row's match.
+ */
+void TrendIndex::AddRow(const Team& team, std::unordered_map<int, int>& changedFrom) {
+    const double points = team.PointsScored();
+
+    MatchPoints& match = m_teams[team.teamNum].matches[team.matchNum];
+    match.total += points;
+    match.rows++;
+
+    m_rows[team.uid] = { team.teamNum, team.matchNum, points };
+
+    auto changed = changedFrom.try_emplace(team.teamNum, team.matchNum).first;
+    changed->second = std::min(changed->second, team.matchNum);
+}
+
+/**
+ * @brief Takes the points a scouted row added out of its team's match, if the row was in the index.
+ *
+ * @param uid         uid of the scouted row.
+ * @param changedFrom Earliest match number changed of each team, lowered to the row's match.
+ */
+void TrendIndex::RemoveRow(int uid, std::unordered_map<int, int>& changedFrom) {
+    auto row = m_rows.find(uid);
+    if ( row == m_rows.end() )
+        return;
+
+    const RowPoints removed = row->second;
+    m_rows.erase(row);
+
+    auto history = m_teams.find(removed.teamNum);
+    if ( history == m_teams.end() )
+        return;
+
+    auto match = history->second.matches.find(removed.matchNum);
+    if ( match != history->second.matches.end() ) {
+        match->second.total -= removed.points;
+        if ( --match->second.rows <= 0 )
+            history->second.matches.erase(match);
+    }
+
+    auto changed = changedFrom.try_emplace(removed.teamNum, removed.matchNum).first;
+    changed->second = std::min(changed->second, removed.matchNum);
+}
+
+/**
+ * @brief Rolls a team's weighted mean forward from the earliest match that changed, then recalculates its trend.
+ *
+ * The matches before 'fromMatchNum' kept their weighted means, so the roll starts from the
+ * one before it. A new match after every other is a single step.
+ *
+ * @param teamNum       Team number of the team.
+ * @param fromMatchNum  Earliest match number whose points changed.
+ */
+void TrendIndex::Update(int teamNum, int fromMatchNum) {
+    auto found = m_teams.find(teamNum);
+    if ( found == m_teams.end() )
+        return;
+
+    TeamHistory& history = found->second;
+    if ( history.matches.empty() ) {
+        m_teams.erase(found);
+        return;
+    }
+
+    auto match = history.matches.lower_bound(fromMatchNum);
+    bool first = ( match == history.matches.begin() );
+    double weightedMean = ( first ) ? 0.0 : std::prev(match)->second.weightedMean;
+    for ( ; match != history.matches.end(); match++ ) {
+        const double points = match->second.Points();
+        weightedMean = ( first ) ? points : TREND_EWMA_ALPHA * points + ( 1.0 - TREND_EWMA_ALPHA ) * weightedMean;
+        match->second.weightedMean = weightedMean;
+        first = false;
+    }
+
+    // the last TREND_WINDOW matches, oldest first
+    std::vector<double> window = {};
+    for ( auto it = history.matches.rbegin(); it != history.matches.rend() && window.size() < TREND_WINDOW; it++ )
+        window.push_back(it->second.Points());
+    std::reverse(window.begin(), window.end());
+
+    TeamTrend& trend = history.trend;
+    trend.teamNum = teamNum;
+    trend.matches = static_cast< int >( history.matches.size() );
+    trend.lastMatchNum = history.matches.rbegin()->first;
+    trend.lastPoints = window.back();
+    trend.weightedMean = history.matches.rbegin()->second.weightedMean;
+
+    // least squares line through the window, points against how many matches ago
+    const double n = static_cast< double >( window.size() );
+    const double meanX = ( n - 1.0 ) / 2.0;
+    double sum = 0.0;
+    for ( double points : window )
+        sum += points;
+    trend.windowAverage = sum / n;
+
+    double covariance = 0.0, variance = 0.0;
+    for ( size_t i = 0; i < window.size(); i++ ) {
+        covariance += ( i - meanX ) * ( window[i] - trend.windowAverage );
+        variance += ( i - meanX ) * ( i - meanX );
+    }
+    trend.slope = ( variance > 0.0 ) ? covariance / variance : 0.0;
+}
+
+/**
+ * @brief Gets how a team has been doing over its most recent matches.
+ *
+ * @param teamNum Team number of the team.
+ * @return The team's trend, all zero if it wasn't scouted.
+ */
+TeamTrend TrendIndex::GetTeamTrend(int teamNum) const {
+    auto found = m_teams.find(teamNum);
+    if ( found == m_teams.end() )
+        return { teamNum };
+
+    return found->second.trend;
+}
+
+/**
+ * @brief Gets the trend of every scouted team.
+ *
+ * @return The trends, steepest slope first.
+ */
+std::vector<TeamTrend> TrendIndex::GetTrends() const {
+    std::vector<TeamTrend> trends = {};
+    trends.reserve(m_teams.size());
+    for ( const auto& [teamNum, history] : m_teams )
+        trends.push_back(history.trend);
+
+    std::sort(trends.begin(), trends.end(), [](const TeamTrend& a, const TeamTrend& b) {
+        return ( a.slope != b.slope ) ? a.slope > b.slope : a.teamNum < b.teamNum;
+    });
+
+    return trends;
+}
+
+/**
+ * @brief Gets the points a team was scouted for in each of its matches.
+ *
+ * @param teamNum Team number of the team.
+ * @param count   How many of the most recent matches to get, every match if 0.
+ * @return Match number and points of each match, oldest first.
+ */
+std::vector<std::pair<int, double>> TrendIndex::GetTeamHistory(int teamNum, size_t count) const {
+    std::vector<std::pair<int, double>> points = {};
+
+    auto found = m_teams.find(teamNum);
+    if ( found == m_teams.end() )
+        return points;
+
+    const std::map<int, MatchPoints>& matches = found->second.matches;
+    for ( auto it = matches.rbegin(); it != matches.rend() && ( count == 0 || points.size() < count ); it++ )
+        points.push_back({ it->first, it->second.Points() });
+    std::reverse(points.begin(), points.end());
+
+    return points;
+}
@@ -0,0 +1,148 @@
+#include "frontend/datalistview.h"
+
+#include <wx/eventfilter.h> // wxEventBlocker
+
+#include <algorithm> // std::min
+
+DataListView::DataListView(wxWindow* parent, wxWindowID id)
+    : wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxBORDER_NONE) {
+    m_evenAttr.SetFont(wxFontInfo(9));
+    m_oddAttr.SetFont(wxFontInfo(9));
+}
+
+/**
+ * @brief Sets the background colours rows alternate between, for readability.
+ *
+ * @param even Colour of the first row and every other row after it.
+ * @param odd Colour of the rows in between.
+ */
+void DataListView::SetRowColours(const wxColour& even, const wxColour& odd) {
+    m_evenAttr.SetBackgroundColour(even);
+    m_oddAttr.SetBackgroundColour(odd);
+}
+
+/**
+ * @brief Shows the rows with these keys, in this order.
+ *
+ * Rows already read are kept, so re-sorting or filtering only reads rows that weren't drawn
+ * before. Rows selected before are selected again wherever they moved, without sending
+ * selection events, since the user didn't select anything.
+ *
+ * @param keys Key of each row, as returned by a list query.
+ */
+void DataListView::SetRows(std::vector<int> keys) {
+    wxEventBlocker blocker(this);
+
+    const std::vector<int> selected = SelectedKeys();
+    for ( int key : selected )
+        SetItemState(RowOf(key), 0, wxLIST_STATE_SELECTED);
+
+    m_keys = std::move(keys);
+    m_rows.clear();
+    m_rows.reserve(m_keys.size());
+    for ( size_t row = 0; row < m_keys.size(); row++ )
+        m_rows[m_keys[row]] = static_cast< long >( row );
+
+    SetItemCount(RowCount());
+
+    for ( int key : selected ) {
+        const long row = RowOf(key);
+        if ( row != -1 )
+            SetItemState(row, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
+    }
+
+    Refresh();
+}
+
+void DataListView::ForgetRow(int key) {
+    m_cells.erase(key);
+}
+
+/**
+ * @brief Selects a row on its own and scrolls it into view, without sending selection events.
+ *
+ * @param key Key of the row.
+ * @return The row, -1 if it isn't shown.
+ */
+long DataListView::SelectKey(int key) {
+    wxEventBlocker blocker(this);
+
+    for ( long row = GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED); row != -1; row = GetNextItem(row, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED) )
+        SetItemState(row, 0, wxLIST_STATE_SELECTED);
+
+    const long row = RowOf(key);
+    if ( row == -1 )
+        return -1;
+
+    SetItemState(row, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
+    EnsureVisible(row);
+    return row;
+}
+
+int DataListView::KeyAt(long row) const {
+    if ( row < 0 || row >= RowCount() )
+        return 0;
+
+    return m_keys[row];
+}
+
+long DataListView::RowOf(int key) const {
+    auto it = m_rows.find(key);
+    return ( it != m_rows.end() ) ? it->second : -1;
+}
+
+std::vector<int> DataListView::SelectedKeys() const {
+    std::vector<int> keys = {};
+    for ( long row = GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED); row != -1; row = GetNextItem(row, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED) )
+        keys.push_back(KeyAt(row));
+
+    return keys;
+}
+
+wxString DataListView::OnGetItemText(long item, long column) const {
+    const int key = KeyAt(item);
+
+    auto it = m_cells.find(key);
+    if ( it == m_cells.end() ) {
+        FetchPage(item);
+        it = m_cells.find(key);
+    }
+
+    if ( it == m_cells.end() || column < 0 || column >= static_cast< long >( it->second.size() ) )
+        return "";
+
+    return it->second[column];
+}
+
+wxItemAttr* DataListView::OnGetItemAttr(long item) const {
+    return ( item % 2 == 0 ) ? &m_evenAttr : &m_oddAttr;
+}
+
+/**
+ * @brief Reads every row not read yet in the page of rows 'row' is in.
+ *
+ * Rows that don't exist anymore are remembered as empty, so they aren't read again on every draw.
+ *
+ * @param row A row being drawn.
+ */
+void DataListView::FetchPage(long row) const {
+    if ( !m_fetcher )
+        return;
+
+    const long first = row - row % LIST_PAGE_ROWS;
+    const long last = std::min(first + LIST_PAGE_ROWS, RowCount());
+
+    std::vector<int> missing = {};
+    for ( long i = first; i < last; i++ ) {
+        if ( m_cells.find(m_keys[i]) == m_cells.end() )
+            missing.push_back(m_keys[i]);
+    }
+
+    if ( missing.empty() )
+        return;
+
+    m_fetcher(missing, m_cells);
+
+    for ( int key : missing )
+        m_cells.try_emplace(key);
+}
@@ -3,13 +3,40 @@
 #include "backend/team.h"
 #include "backend/match.h"
 #include "backend/rfpredict.h"
+#include "backend/opr.h"
+#include "backend/elo.h"
+#include "backend/matchfeatures.h"
+#include "backend/simulator.h"
+#include "backend/selector.h"
+#include "backend/evaluation.h"
+#include "backend/dataset.h"
+#include "backend/sync.h"
+#include "backend/ingest.h"
+#include "backend/season.h"
+#include "backend/backup.h"
+#include "backend/trend.h"
+#include "backend/rankings.h"
 
 // Frontend
 #include "frontend/mainframe.h"
 #include "frontend/wxids.h"
 
+#include <wx/numdlg.h> // wxGetNumberFromUser
+#include <wx/textdlg.h> // wxGetTextFromUser
+#include <wx/choicdlg.h> // wxGetSingleChoiceIndex
+#include <wx/stdpaths.h> // wxStandardPaths
+#include <wx/config.h> // wxConfigBase
+
 // STD
 #include <fstream>
+#include <algorithm> // std::sort, std::find_if, std::remove_if, std::unique, std::min_element
+#include <cctype> // std::isdigit
+#include <format> // std::format
+#include <filesystem> // std::filesystem::absolute
+#include <chrono> // std::chrono::steady_clock
+#include <random> // std::random_device
+#include <future> // std::async, std::future
+#include <unordered_map> // std::unordered_map
 
 /**
  * @brief Handles left-click events on a team row.
@@ -57,17 +84,26 @@ void MainFrame::OnMatchRowLeftClicked(wxCommandEvent& event) {
 /**
  * @brief Handles right-click events on a team row.
  *
- * Displays a context menu with an option to delete the selected team.
+ * Displays a context menu with an option to delete the selected teams.
  *
  * @param event The wxCommandEvent triggered by the user right-clicking a team row.
  */
 void MainFrame::OnTeamRowRightClicked(wxCommandEvent& event) {
+    const int selected = m_teamListView->GetSelectedItemCount();
+
     wxMenu rightClickMenu;
-    rightClickMenu.Append(wxID_DELETE, "Delete Team");
+    rightClickMenu.Append(wxID_DELETE, ( selected > 1 ) ? wxString::Format("Delete %d Teams", selected) : wxString("Delete Team"));
     rightClickMenu.Append(wxID_DUPLICATE, "Duplicate Team");
+    rightClickMenu.AppendSeparator();
+    rightClickMenu.Append(kMarkTeamPicked, "Mark/Unmark as Picked");
+    rightClickMenu.Append(kShowTeamSeason, "Show Stats At Each Event");
+    rightClickMenu.Append(kShowTeamHistory, "Show Match History");
 
     rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnDeleteTeam, this, wxID_DELETE);
     rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnDuplicateTeam, this, wxID_DUPLICATE);
+    rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnMarkTeamPicked, this, kMarkTeamPicked);
+    rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnShowTeamSeason, this, kShowTeamSeason);
+    rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnShowTeamHistory, this, kShowTeamHistory);
 
     PopupMenu(&rightClickMenu);
 }
@@ -75,15 +111,17 @@ void MainFrame::OnTeamRowRightClicked(wxCommandEvent& event) {
 /**
  * @brief Handles right-click events on a match row.
  *
- * Displays a context menu with an option to delete the selected match.
+ * Displays a context menu with an option to delete the selected matches.
  *
  * @param event The wxCommandEvent triggered by the user right-clicking a match row.
  */
 void MainFrame::OnMatchRowRightClicked(wxCommandEvent& event) {
+    const int selected = m_matchListView->GetSelectedItemCount();
+
     wxMenu rightClickMenu;
     rightClickMenu.Append(kPredictMatch, "Predict Outcome");
     rightClickMenu.AppendSeparator();
-    rightClickMenu.Append(wxID_DELETE, "Delete Match");
+    rightClickMenu.Append(wxID_DELETE, ( selected > 1 ) ? wxString::Format("Delete %d Matches", selected) : wxString("Delete Match"));
     rightClickMenu.Append(wxID_DUPLICATE, "Duplicate Match");
 
     rightClickMenu.Bind(wxEVT_MENU, &MainFrame::OnPredictMatch, this, kPredictMatch);
@@ -117,6 +155,117 @@ void MainFrame::OnListViewRightClick(wxCommandEvent& event) {
     PopupMenu(&rightClickMenu);
 }
 
+/**
+ * @brief Sorts a list view by the column whose header was clicked.
+ *
+ * Clicking the column the list is already sorted by flips the order.
+ * The rows are sorted by the database, only the rows drawn are read again.
+ *
+ * @param event The wxListEvent triggered by the user clicking a column header.
+ */
+void MainFrame::OnListColumnClicked(wxListEvent& event) {
+    const bool isTeamList = ( event.GetId() == kTeamListView );
+    const int columnCount = ( isTeamList ) ? kRowRankingPoints + 1 : kRowBlue6 + 1;
+    const int column = event.GetColumn();
+    if ( column < 0 || column >= columnCount ) // the trend column isn't in the database, nor is the blank column at the end
+        return;
+
+    ListQuery& query = ( isTeamList ) ? m_teamQuery : m_matchQuery;
+    DataListView* listView = ( isTeamList ) ? m_teamListView : m_matchListView;
+
+    query.ascending = ( query.sortColumn == column ) ? !query.ascending : true;
+    query.sortColumn = column;
+    listView->ShowSortIndicator(column, query.ascending);
+
+    if ( isTeamList )
+        RequeryTeamList();
+    else
+        RequeryMatchList();
+}
+
+/**
+ * @brief Asks for a range of values to filter a list view by, in the column whose header was right clicked.
+ *
+ * A range is typed as "min-max", or a single number to only keep rows with that value.
+ * Leaving it empty shows every row again. Yes/no columns hold 1 for yes and 0 for no.
+ *
+ * @param event The wxListEvent triggered by the user right clicking a column header.
+ */
+void MainFrame::OnListColumnRightClicked(wxListEvent& event) {
+    const bool isTeamList = ( event.GetId() == kTeamListView );
+    const int columnCount = ( isTeamList ) ? kRowRankingPoints + 1 : kRowBlue6 + 1;
+    const int column = event.GetColumn();
+    if ( column < 0 || column >= columnCount )
+        return;
+
+    ListQuery& query = ( isTeamList ) ? m_teamQuery : m_matchQuery;
+    DataListView* listView = ( isTeamList ) ? m_teamListView : m_matchListView;
+
+    // the filter already on this column, if any
+    auto existing = std::find_if(query.ranges.begin(), query.ranges.end(), [column](const RangeFilter& range) { return range.column == column; });
+    wxString current = "";
+    if ( existing != query.ranges.end() )
+        current = wxString::Format("%d-%d", existing->min, existing->max);
+
+    wxListItem header;
+    header.SetMask(wxLIST_MASK_TEXT);
+    listView->GetColumn(column, header);
+
+    wxString text = wxGetTextFromUser("Only show rows with a value between (e.g 10-40), leave empty to show every row:", "Filter " + header.GetText(), current, this);
+    text.Trim(true).Trim(false);
+
+    RangeFilter range = { column, 0, 0 };
+    const bool hasRange = !text.IsEmpty();
+    if ( hasRange ) {
+        wxString maxText = ( text.Find('-') != wxNOT_FOUND ) ? text.AfterFirst('-') : text;
+        if ( !text.BeforeFirst('-').Trim().ToInt(&range.min) || !maxText.Trim(false).ToInt(&range.max) ) {
+            LogErrorMessage("Filter must be a number or a range like 10-40.");
+            return;
+        }
+
+        if ( range.min > range.max )
+            std::swap(range.min, range.max);
+    }
+
+    query.ranges.erase(std::remove_if(query.ranges.begin(), query.ranges.end(), [column](const RangeFilter& range) { return range.column == column; }), query.ranges.end());
+    if ( hasRange )
+        query.ranges.push_back(range);
+
+    if ( isTeamList )
+        RequeryTeamList();
+    else
+        RequeryMatchList();
+}
+
+/**
+ * @brief Only shows the rows of a list view with a team number starting with the digits typed in its search box.
+ *
+ * @param event The wxCommandEvent triggered by the text of a search box changing.
+ */
+void MainFrame::OnListSearch(wxCommandEvent& event) {
+    wxWindow* searchBox = static_cast< wxWindow* >( event.GetEventObject() );
+    if ( !searchBox )
+        return;
+
+    const int listId = reinterpret_cast< std::intptr_t >( searchBox->GetClientData() );
+
+    // the validator stops most other characters, pasted text can still get through
+    std::string digits = "";
+    for ( char c : event.GetString().ToStdString() ) {
+        if ( std::isdigit(static_cast< unsigned char >( c )) )
+            digits += c;
+    }
+
+    if ( listId == kTeamListView ) {
+        m_teamQuery.teamSearch = digits;
+        RequeryTeamList();
+    }
+    else if ( listId == kMatchListView ) {
+        m_matchQuery.teamSearch = digits;
+        RequeryMatchList();
+    }
+}
+
 /**
  * @brief Toggles the edit mode for modifying team or match details.
  *
@@ -199,8 +348,10 @@ void MainFrame::OnCreateNewTeam(wxCommandEvent& event) {
     team.uid = db->GetNextTeamUID();
     team.teamNum = m_displayedTeamCount + 1;
 
-    CreateTeamRow(team);
     db->AddTeam(team);
+    db->FlushChanges(); // show the row before it's edited
+    m_selectedTeamRow = m_teamListView->SelectKey(team.uid);
+    RefreshTeamAnalysis(team.teamNum);
     PromptTeamEdit(team);
 }
 
@@ -216,8 +367,6 @@ void MainFrame::OnCreateNewMatch(wxCommandEvent& event) {
     Match match = {};
     match.matchNum = m_displayedMatchCount + 1;
 
-    CreateMatchRow(match);
-
     // data base check
     if ( !m_dataBase ) {
         LogErrorMessage("Database not available, cannot save team. Closing this app will delete all progress.");
@@ -226,6 +375,8 @@ void MainFrame::OnCreateNewMatch(wxCommandEvent& event) {
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
     db->AddMatch(match);
+    db->FlushChanges(); // show the row before it's edited
+    m_selectedMatchRow = m_matchListView->SelectKey(match.matchNum);
 
     PromptMatchEdit(match);
 }
@@ -256,8 +407,14 @@ void MainFrame::OnDuplicateTeam(wxCommandEvent& event) {
     newTeam.uid = db->GetNextTeamUID();
 
     db->AddTeam(newTeam);
+    db->FlushChanges(); // show the row before it's edited
+    m_selectedTeamRow = m_teamListView->SelectKey(newTeam.uid);
+
+    if ( m_opr )
+        reinterpret_cast< OPRCalculator* >( m_opr )->UpdateMatch(newTeam.matchNum);
+
+    RefreshTeamAnalysis(newTeam.teamNum);
 
-    CreateTeamRow(newTeam);
     PromptTeamEdit(newTeam);
 }
 
@@ -275,7 +432,6 @@ void MainFrame::OnDuplicateMatch(wxCommandEvent& event) {
 
     Match newMatch = match;
     newMatch.matchNum = m_displayedMatchCount + 1;
-    CreateMatchRow(newMatch);
 
     // data base check
     if ( !m_dataBase ) {
@@ -285,71 +441,94 @@ void MainFrame::OnDuplicateMatch(wxCommandEvent& event) {
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
     db->AddMatch(newMatch);
+    db->FlushChanges(); // show the row before it's edited
+    m_selectedMatchRow = m_matchListView->SelectKey(newMatch.matchNum);
+
+    RefreshMatchAnalysis(newMatch.matchNum);
+
     PromptMatchEdit(newMatch);
 }
 
 /**
- * @brief Deletes the currently selected team.
+ * @brief Deletes every selected team row.
  *
- * Prompts the user for confirmation, removes the team from the database
- * if available, and updates the list view accordingly.
+ * Prompts the user for confirmation, then removes the rows, and their teams from every
+ * match they were in, from the database in one transaction. The list views follow the
+ * database, so they update themselves once it's done.
  *
- * @param event The wxCommandEvent triggered when deleting a team.
+ * @param event The wxCommandEvent triggered when deleting teams.
  */
 void MainFrame::OnDeleteTeam(wxCommandEvent& event) {
-    int opt = MessageBoxA(NULL, "Delete Team", "Are you sure?", MB_YESNOCANCEL | MB_ICONWARNING);
-    if ( opt != IDYES )
+    const std::vector<int> uids = m_teamListView->SelectedKeys();
+    if ( uids.empty() )
         return;
 
-    // get team number
-    const Team team = GetTeamFromRow(m_selectedTeamRow);
-    if ( team.teamNum == 0 )
+    const std::string prompt = ( uids.size() == 1 ) ? "Delete Team" : std::format("Delete {} Teams", uids.size());
+    int opt = MessageBoxA(NULL, prompt.c_str(), "Are you sure?", MB_YESNOCANCEL | MB_ICONWARNING);
+    if ( opt != IDYES )
         return;
 
-    // remove team from database
+    // remove teams from database
     if ( !m_dataBase ) {
         LogBackendMessage("Database not available, cannot delete team.");
         return;
     }
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->RemoveTeam(team.uid);
+    db->RemoveTeams(uids);
 
-    // remove team from list view
-    m_teamListView->DeleteItem(m_selectedTeamRow);
-    m_displayedTeamCount--;
+    // removing a team also removes it from every match it was in
+    RefreshAllAnalysis();
 }
 
 /**
- * @brief Deletes the currently selected match.
+ * @brief Deletes every selected match.
  *
- * Prompts the user for confirmation, removes the match from the database
- * if available, and updates the list view accordingly.
+ * Prompts the user for confirmation, then removes the matches from the database
+ * in one statement. The list views update themselves once it's done.
  *
- * @param event The wxCommandEvent triggered when deleting a match.
+ * @param event The wxCommandEvent triggered when deleting matches.
  */
 void MainFrame::OnDeleteMatch(wxCommandEvent& event) {
-    int opt = MessageBoxA(NULL, "Delete Match", "Are you sure?", MB_YESNOCANCEL | MB_ICONWARNING);
-    if ( opt != IDYES )
+    const std::vector<int> matchNums = m_matchListView->SelectedKeys();
+    if ( matchNums.empty() )
         return;
 
-    // get match number
-    const int matchNum = GetSelectedRowMatchNum();
-    if ( matchNum == 0 )
+    const std::string prompt = ( matchNums.size() == 1 ) ? "Delete Match" : std::format("Delete {} Matches", matchNums.size());
+    int opt = MessageBoxA(NULL, prompt.c_str(), "Are you sure?", MB_YESNOCANCEL | MB_ICONWARNING);
+    if ( opt != IDYES )
         return;
 
-    // remove match from database
+    // remove matches from database
     if ( !m_dataBase ) {
         LogBackendMessage("Database not available, cannot delete match.");
         return;
     }
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->RemoveMatch(matchNum);
+    db->RemoveMatches(matchNums);
+
+    if ( matchNums.size() == 1 )
+        RefreshMatchAnalysis(matchNums.front());
+    else
+        RefreshAllAnalysis();
+}
+
+/**
+ * @brief Deletes the selected rows of a list view when the delete key is pressed.
+ *
+ * @param event The wxListEvent triggered by a key being pressed in a list view.
+ */
+void MainFrame::OnListKeyDown(wxListEvent& event) {
+    if ( event.GetKeyCode() != WXK_DELETE ) {
+        event.Skip();
+        return;
+    }
 
-    // remove match from list view
-    m_matchListView->DeleteItem(m_selectedMatchRow);
-    m_displayedMatchCount--;
+    if ( event.GetId() == kTeamListView )
+        OnDeleteTeam(event);
+    else if ( event.GetId() == kMatchListView )
+        OnDeleteMatch(event);
 }
 
 /**
@@ -358,7 +537,7 @@ void MainFrame::OnDeleteMatch(wxCommandEvent& event) {
  * This function opens a file dialog for the user to select the path and file name to save the team data as a CSV file.
  * It checks if the database is available, and if not, logs an error message. If the database is available, it exports
  * the team data from the database to the CSV file. After saving the file, it reads the CSV file into a string and generates
- * a QR code based on the CSV data, saving the QR code as an image file ("TeamData.png").
+ * a QR code based on the CSV data, saving the QR code as an image file ("TeamData.png"). The export runs in the background.
  *
  * @param event The wxCommandEvent triggered by the user action (e.g., button click).
  */
@@ -376,15 +555,18 @@ void MainFrame::OnExportTeamDataCSV(wxCommandEvent& event) {
         return;
     }
 
+    // exported in the background on a read-only connection, so scouts can keep entering data
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->ExportTableToCSV(TEAM_TABLE, path.ToStdString());
+    RunInBackground([db, path = path.ToStdString()] {
+        db->ExportTableToCSV(TEAM_TABLE, path);
 
-    // Read csv file into a string
-    std::ifstream file(path.ToStdString());
-    std::string csvData(( std::istreambuf_iterator< char >(file) ), std::istreambuf_iterator< char >());
-    file.close();
+        // Read csv file into a string
+        std::ifstream file(path);
+        std::string csvData(( std::istreambuf_iterator< char >(file) ), std::istreambuf_iterator< char >());
+        file.close();
 
-    db->ExportTOQRCode(csvData, "TeamData.png");
+        db->ExportTOQRCode(csvData, "TeamData.png");
+    });
 }
 
 /**
@@ -393,7 +575,7 @@ void MainFrame::OnExportTeamDataCSV(wxCommandEvent& event) {
  * This function opens a file dialog for the user to select the path and file name to save the match data as a CSV file.
  * It checks if the database is available, and if not, logs an error message. If the database is available, it exports
  * the match data from the database to the CSV file. After saving the file, it reads the CSV file into a string and generates
- * a QR code based on the CSV data, saving the QR code as an image file ("MatchData.png").
+ * a QR code based on the CSV data, saving the QR code as an image file ("MatchData.png"). The export runs in the background.
  *
  * @param event The wxCommandEvent triggered by the user action (e.g., button click).
  */
@@ -411,15 +593,18 @@ void MainFrame::OnExportMatchDataCSV(wxCommandEvent& event) {
         return;
     }
 
+    // exported in the background on a read-only connection, so scouts can keep entering data
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->ExportTableToCSV(MATCH_TABLE, path.ToStdString());
+    RunInBackground([db, path = path.ToStdString()] {
+        db->ExportTableToCSV(MATCH_TABLE, path);
 
-    // Read csv file into a string
-    std::ifstream file(path.ToStdString());
-    std::string csvData(( std::istreambuf_iterator< char >(file) ), std::istreambuf_iterator< char >());
-    file.close();
+        // Read csv file into a string
+        std::ifstream file(path);
+        std::string csvData(( std::istreambuf_iterator< char >(file) ), std::istreambuf_iterator< char >());
+        file.close();
 
-    db->ExportTOQRCode(csvData, "MatchData.png");
+        db->ExportTOQRCode(csvData, "MatchData.png");
+    });
 }
 
 /**
@@ -444,7 +629,7 @@ void MainFrame::OnExportTeamDataJSON(wxCommandEvent& event) {
     }
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->ExportTableToJSON(TEAM_TABLE, path.ToStdString());
+    RunInBackground([db, path = path.ToStdString()] { db->ExportTableToJSON(TEAM_TABLE, path); });
 }
 
 /**
@@ -470,7 +655,7 @@ void MainFrame::OnExportMatchDataJSON(wxCommandEvent& event) {
     }
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    db->ExportTableToJSON(MATCH_TABLE, path.ToStdString());
+    RunInBackground([db, path = path.ToStdString()] { db->ExportTableToJSON(MATCH_TABLE, path); });
 }
 
 /**
@@ -504,6 +689,8 @@ void MainFrame::OnGridCellChange(wxGridEvent& event) {
 
     if ( editingTeam ) {
         Team team = GetTeamFromRow(m_selectedTeamRow);
+        const int previousTeamNum = team.teamNum;
+        const int previousMatchNum = team.matchNum;
         switch ( row ) {
         case kRowTeamNum:
             // team number
@@ -556,7 +743,20 @@ void MainFrame::OnGridCellChange(wxGridEvent& event) {
         }
 
         db->UpdateTeam(team);
-        RefreshTeamRow(team.uid);
+        db->FlushChanges(); // the row is read back for the next edit
+
+        // the points scouted for the team count towards its alliance's score
+        if ( m_opr ) {
+            OPRCalculator* opr = reinterpret_cast< OPRCalculator* >( m_opr );
+            opr->UpdateMatch(team.matchNum);
+            if ( previousMatchNum != team.matchNum )
+                opr->UpdateMatch(previousMatchNum);
+        }
+
+        RefreshTeamAnalysis(team.teamNum);
+        if ( previousTeamNum != team.teamNum )
+            RefreshTeamAnalysis(previousTeamNum);
+
         return;
     }
 
@@ -575,27 +775,28 @@ void MainFrame::OnGridCellChange(wxGridEvent& event) {
         match.blueWin = ( val == "Y" );
         break;
     case kRowRed1:
-        match.teams[0].teamNum = std::stoi(val.ToStdString());
+        match.teams[0] = std::stoi(val.ToStdString());
         break;
     case kRowRed2:
-        match.teams[1].teamNum = std::stoi(val.ToStdString());
+        match.teams[1] = std::stoi(val.ToStdString());
         break;
     case kRowRed3:
-        match.teams[2].teamNum = std::stoi(val.ToStdString());
+        match.teams[2] = std::stoi(val.ToStdString());
         break;
     case kRowBlue4:
-        match.teams[3].teamNum = std::stoi(val.ToStdString());
+        match.teams[3] = std::stoi(val.ToStdString());
         break;
     case kRowBlue5:
-        match.teams[4].teamNum = std::stoi(val.ToStdString());
+        match.teams[4] = std::stoi(val.ToStdString());
         break;
     case kRowBlue6:
-        match.teams[5].teamNum = std::stoi(val.ToStdString());
+        match.teams[5] = std::stoi(val.ToStdString());
         break;
     }
 
     db->UpdateMatch(match);
-    RefreshMatchRow(match.matchNum);
+    db->FlushChanges(); // the row is read back for the next edit
+    RefreshMatchAnalysis(match.matchNum);
 }
 
 /**
@@ -639,12 +840,8 @@ void MainFrame::OnImportTeamDataCSV(wxCommandEvent& event) {
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
     db->ImportTableFromCSV(TEAM_TABLE, path.ToStdString());
 
-    // Refresh the team list view
-    m_teamListView->DeleteAllItems();
-    m_displayedTeamCount = 0;
-    std::vector<Team> teams = db->GetTeams();
-    for ( const Team& team : teams )
-        CreateTeamRow(team);
+    // the imported rows reach the team list view as one batch of change events
+    RefreshAllAnalysis();
 }
 
 void MainFrame::OnImportMatchDataCSV(wxCommandEvent& event) {
@@ -664,12 +861,275 @@ void MainFrame::OnImportMatchDataCSV(wxCommandEvent& event) {
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
     db->ImportTableFromCSV(MATCH_TABLE, path.ToStdString());
 
-    // Refresh the match list view
-    m_matchListView->DeleteAllItems();
-    m_displayedMatchCount = 0;
-    std::vector<Match> matches = db->GetMatches();
-    for ( const Match& match : matches )
-        CreateMatchRow(match);
+    // the imported rows reach the match list view as one batch of change events
+    RefreshAllAnalysis();
+}
+
+/**
+ * @brief Builds the prediction model's training set from saved FRC API match results.
+ *
+ * Each selected file is one event, as saved by `scripts/match_details.py`. The training set is
+ * built in the background and written over the one the model trains from. The current model
+ * is kept until it is retrained.
+ *
+ * @param event The wxCommandEvent triggered by the import menu item.
+ */
+void MainFrame::OnBuildTrainingSet(wxCommandEvent& event) {
+    wxFileDialog fileDialog(
+        this, "Select FRC API Match Results", "", "", "JSON files (*.json)|*.json",
+        wxFD_OPEN | wxFD_FILE_MUST_EXIST | wxFD_MULTIPLE
+    );
+
+    int res = fileDialog.ShowModal();
+    if ( res != wxID_OK )
+        return;
+
+    if ( !m_threadPool ) {
+        LogErrorMessage("Thread pool not available, cannot build training set.");
+        return;
+    }
+
+    wxArrayString selected;
+    fileDialog.GetPaths(selected);
+
+    // sorted so the same files always give the same training set
+    std::vector<std::string> paths = {};
+    for ( const wxString& path : selected )
+        paths.push_back(path.ToStdString());
+    std::sort(paths.begin(), paths.end());
+
+    LogBackendMessage(std::format("Building training set from {} events...", paths.size()));
+
+    ThreadPool* threadPool = reinterpret_cast< ThreadPool* >( m_threadPool );
+    RunInBackground([this, threadPool, paths = std::move(paths)] {
+        const auto start = std::chrono::steady_clock::now();
+
+        DatasetBuilder builder(this, threadPool);
+        std::vector<MatchFeatures> features = {};
+        std::vector<size_t> labels = {};
+
+        std::string msg = "No match results could be read, training set not built.";
+        if ( builder.Build(paths, features, labels) ) {
+            if ( DatasetBuilder::WriteTrainingSet(FEATURES_CSV_PATH, LABELS_CSV_PATH, features, labels) ) {
+                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                msg = std::format(
+                    "Built training set of {} matches in {} ms. Retrain the model to use it.",
+                    labels.size(), elapsed.count()
+                );
+            }
+            else {
+                msg = std::format("Failed to write training set to {}", FEATURES_CSV_PATH);
+            }
+        }
+
+        CallAfter([this, msg] { LogBackendMessage(msg); });
+    });
+}
+
+/**
+ * @brief Merges other scouts' databases into this one.
+ *
+ * Asks whether rows that differ between the databases should be replaced with the merged
+ * ones, then merges every selected database and reloads the lists and analysis once.
+ *
+ * @param event The wxCommandEvent triggered by the import menu item.
+ */
+void MainFrame::OnMergeDataBases(wxCommandEvent& event) {
+    wxFileDialog fileDialog(
+        this, "Select Scouting Databases To Merge", "", "", "Database files (*.db)|*.db",
+        wxFD_OPEN | wxFD_FILE_MUST_EXIST | wxFD_MULTIPLE
+    );
+
+    int res = fileDialog.ShowModal();
+    if ( res != wxID_OK )
+        return;
+
+    if ( !m_dataBase ) {
+        LogErrorMessage("Database not available, cannot merge databases.");
+        return;
+    }
+
+    const int answer = wxMessageBox(
+        "When a merged database has a different value for a row already here, replace it with the merged value?\n\n"
+        "Yes replaces it, No keeps the value already here.",
+        "Merge Scouting Databases", wxYES_NO | wxCANCEL | wxICON_QUESTION, this
+    );
+    if ( answer == wxCANCEL )
+        return;
+
+    wxArrayString selected;
+    fileDialog.GetPaths(selected);
+
+    std::vector<std::string> paths = {};
+    for ( const wxString& path : selected )
+        paths.push_back(path.ToStdString());
+
+    const auto start = std::chrono::steady_clock::now();
+
+    DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
+    MergeReport report = {};
+    db->MergeDataBases(paths, ( answer == wxYES ) ? kMergeTakeIncoming : kMergeKeepExisting, report);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LogBackendMessage(std::format(
+        "Merged {} of {} databases in {} ms: {} scouted rows added ({} already here, {} differed), "
+        "{} matches added, {} updated ({} differed).",
+        report.databasesMerged, paths.size(), elapsed.count(), report.teamsAdded, report.teamsSkipped,
+        report.teamConflicts, report.matchesAdded, report.matchesUpdated, report.matchConflicts
+    ));
+
+    // the merged rows reach the list views as one batch of change events
+    RefreshAllAnalysis();
+}
+
+void MainFrame::OnExportChanges(wxCommandEvent& event) {
+    if ( !m_sync ) {
+        LogErrorMessage("Database not available, cannot export changes.");
+        return;
+    }
+
+    const int answer = wxMessageBox(
+        "Only export the rows changed since the last export?\n\n"
+        "Yes exports only those, No exports every row for a station that missed earlier exports.",
+        "Export Changes", wxYES_NO | wxCANCEL | wxICON_QUESTION, this
+    );
+    if ( answer == wxCANCEL )
+        return;
+
+    wxFileDialog fileDialog(
+        this, "Export Changes For Other Stations", "", "changes." SYNC_FILE_EXTENSION,
+        "Changeset files (*." SYNC_FILE_EXTENSION ")|*." SYNC_FILE_EXTENSION, wxFD_SAVE | wxFD_OVERWRITE_PROMPT
+    );
+
+    int res = fileDialog.ShowModal();
+    if ( res != wxID_OK )
+        return;
+
+    const std::string path = fileDialog.GetPath().ToStdString();
+
+    SyncService* sync = reinterpret_cast< SyncService* >( m_sync );
+    size_t count = 0;
+    if ( sync->ExportChangesToFile(path, answer == wxNO, count) )
+        LogBackendMessage(std::format("Exported {} changed rows to {}.", count, path));
+}
+
+void MainFrame::OnApplyChanges(wxCommandEvent& event) {
+    wxFileDialog fileDialog(
+        this, "Apply Changes From Another Station", "", "",
+        "Changeset files (*." SYNC_FILE_EXTENSION ")|*." SYNC_FILE_EXTENSION, wxFD_OPEN | wxFD_FILE_MUST_EXIST
+    );
+
+    int res = fileDialog.ShowModal();
+    if ( res != wxID_OK )
+        return;
+
+    if ( !m_sync ) {
+        LogErrorMessage("Database not available, cannot apply changes.");
+        return;
+    }
+
+    const std::string path = fileDialog.GetPath().ToStdString();
+
+    SyncService* sync = reinterpret_cast< SyncService* >( m_sync );
+    SyncReport report = {};
+    if ( !sync->ApplyChangesFromFile(path, report) )
+        return;
+
+    LogBackendMessage(std::format(
+        "Applied {}: {} rows read, {} changed something here.", path, report.received, report.applied
+    ));
+
+    if ( report.applied > 0 )
+        ReloadAllData();
+}
+
+/**
+ * @brief Syncs with another station in the background.
+ *
+ * Asks for the station's address as "host" or "host:port", with `SYNC_PORT` as the default port.
+ *
+ * @param event The wxCommandEvent triggered by the menu item.
+ */
+void MainFrame::OnSyncWithStation(wxCommandEvent& event) {
+    if ( !m_sync ) {
+        LogErrorMessage("Database not available, cannot sync.");
+        return;
+    }
+
+    const std::string address = wxGetTextFromUser(
+        "Address of the station to sync with, e.g 192.168.1.20 or scout-laptop:7022",
+        "Sync With Station", "", this
+    ).ToStdString();
+    if ( address.empty() )
+        return;
+
+    std::string host = address;
+    uint16_t port = SYNC_PORT;
+
+    const size_t colon = address.rfind(':');
+    if ( colon != std::string::npos ) {
+        host = address.substr(0, colon);
+
+        try {
+            const int parsed = std::stoi(address.substr(colon + 1));
+            if ( parsed <= 0 || parsed > 65535 )
+                throw std::out_of_range("port");
+            port = static_cast< uint16_t >( parsed );
+        }
+        catch ( const std::exception& ) {
+            LogErrorMessage("Invalid port in address: " + address);
+            return;
+        }
+    }
+
+    SyncService* sync = reinterpret_cast< SyncService* >( m_sync );
+    if ( !sync->StartSync(host, port) ) {
+        LogErrorMessage("A sync is already running.");
+        return;
+    }
+
+    LogBackendMessage("Syncing with " + address + "...");
+}
+
+void MainFrame::OnToggleServeSync(wxCommandEvent& event) {
+    if ( !m_sync )
+        return;
+
+    SyncService* sync = reinterpret_cast< SyncService* >( m_sync );
+    if ( !event.IsChecked() ) {
+        sync->StopServer();
+        LogBackendMessage("Other stations can no longer sync with this one.");
+        return;
+    }
+
+    if ( !sync->StartServer(SYNC_PORT, false) ) {
+        GetMenuBar()->Check(kServeSync, false);
+        return;
+    }
+
+    DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
+    LogBackendMessage(std::format(
+        "Other stations can sync with this one ({}) on port {}.", db->GetStationName(), sync->ServerPort()
+    ));
+}
+
+void MainFrame::OnToggleIngest(wxCommandEvent& event) {
+    if ( !m_ingest )
+        return;
+
+    IngestServer* ingest = reinterpret_cast< IngestServer* >( m_ingest );
+    if ( !event.IsChecked() ) {
+        ingest->Stop();
+        LogBackendMessage("No longer accepting rows from scouting clients.");
+        return;
+    }
+
+    if ( !ingest->Start(INGEST_PORT, false) ) {
+        GetMenuBar()->Check(kServeIngest, false);
+        return;
+    }
+
+    LogBackendMessage(std::format("Accepting rows from scouting clients on port {}.", ingest->Port()));
 }
 
 void MainFrame::OnPredictMatch(wxCommandEvent& event) {
@@ -694,11 +1154,936 @@ void MainFrame::OnPredictMatch(wxCommandEvent& event) {
     LogMessage(firstMsg);
 
     // predict based on match data and team win rates
-    bool redWin = predictor->PredictMatchOutcome(matchNum);
+    const double redWinProbability = predictor->PredictRedWinProbability(matchNum);
+    const bool redWin = redWinProbability > 0.5;
     std::string winnerAllianceName = ( redWin ) ? "red" : "blue";
 
     std::string predictionMsg = "The results are in. The team to predicted to win match " + std::to_string(matchNum) +
-        " is the " + winnerAllianceName + " team!\n\n";
+        " is the " + winnerAllianceName + " team!" +
+        std::format(" ({:.1f}% chance)\n\n", ( redWin ? redWinProbability : 1.0 - redWinProbability ) * 100.0);
 
     LogMessage(predictionMsg);
 }
+
+/**
+ * @brief Keeps match based ratings up to date after a match changes.
+ *
+ * Called after a match is added, edited or removed. A removed match
+ * is read back as an unplayed match, which takes it out of the ratings.
+ *
+ * @param matchNum The match number of the match that changed.
+ */
+void MainFrame::RefreshMatchAnalysis(int matchNum) {
+    if ( m_opr )
+        reinterpret_cast< OPRCalculator* >( m_opr )->UpdateMatch(matchNum);
+
+    if ( m_elo )
+        reinterpret_cast< EloRating* >( m_elo )->UpdateMatch(matchNum);
+
+    // the result or teams of the match changed, which changes the win rate of
+    // every team that is or was in it. the previous teams aren't known here
+    if ( m_features )
+        reinterpret_cast< FeaturePipeline* >( m_features )->InvalidateAll();
+
+    // features are rebuilt first so the model is updated with the new result
+    if ( m_predictor ) {
+        RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+        predictor->InvalidateMatch(matchNum);
+        predictor->UpdateWithMatch(matchNum);
+    }
+}
+
+/**
+ * @brief Recalculates every match based rating.
+ *
+ * Called after changes that touch many matches at once, such as
+ * imports or removing a team from every match it was in. The
+ * predictor's training data is built again, as no single match
+ * update covers them.
+ */
+void MainFrame::RefreshAllAnalysis() {
+    if ( m_opr )
+        reinterpret_cast< OPRCalculator* >( m_opr )->Recompute();
+
+    if ( m_elo )
+        reinterpret_cast< EloRating* >( m_elo )->ReplayFrom(0);
+
+    if ( m_features )
+        reinterpret_cast< FeaturePipeline* >( m_features )->InvalidateAll();
+
+    if ( m_predictor ) {
+        RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+        predictor->ClearPredictionCache();
+        predictor->RebuildTrainingData(); // does nothing with online updates off
+    }
+}
+
+/**
+ * @brief Recalculates the analysis.
+ *
+ * Called after another station's changes were applied, since they can touch any row.
+ * The list views already follow the rows they changed through the database's change events.
+ */
+void MainFrame::ReloadAllData() {
+    RefreshAllAnalysis();
+}
+
+/**
+ * @brief Updates the analysis of the teams and matches scouting clients submitted rows for.
+ *
+ * Called once per batch the ingest server saves, however many scouts the batch came from,
+ * so the ratings are brought up to date once per batch: OPR is solved once, Elo is replayed
+ * once from the earliest changed match and the model is warm started once. The rows
+ * themselves reach the list views through the database's change events.
+ *
+ * @param teamNums Teams with a row or match that changed.
+ * @param matchNums Matches that changed.
+ * @param rowMatchNums Matches a scouted row was submitted for.
+ */
+void MainFrame::ShowIngestedData(const std::vector<int>& teamNums, const std::vector<int>& matchNums, const std::vector<int>& rowMatchNums) {
+    // the points scouted for a team count towards its alliance's score
+    if ( m_opr ) {
+        std::vector<int> oprMatchNums = matchNums;
+        oprMatchNums.insert(oprMatchNums.end(), rowMatchNums.begin(), rowMatchNums.end());
+        std::sort(oprMatchNums.begin(), oprMatchNums.end());
+        oprMatchNums.erase(std::unique(oprMatchNums.begin(), oprMatchNums.end()), oprMatchNums.end());
+
+        reinterpret_cast< OPRCalculator* >( m_opr )->UpdateMatches(oprMatchNums);
+    }
+
+    if ( !matchNums.empty() ) {
+        if ( m_elo )
+            reinterpret_cast< EloRating* >( m_elo )->ReplayFrom(*std::min_element(matchNums.begin(), matchNums.end()));
+
+        // the win rate of every team that is or was in the matches changed, the previous teams aren't known here
+        if ( m_features )
+            reinterpret_cast< FeaturePipeline* >( m_features )->InvalidateAll();
+
+        // features are rebuilt first so the model is updated with the new results
+        if ( m_predictor ) {
+            RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+            for ( int matchNum : matchNums )
+                predictor->InvalidateMatch(matchNum);
+
+            predictor->UpdateWithMatches(matchNums);
+        }
+    }
+
+    for ( int teamNum : teamNums )
+        RefreshTeamAnalysis(teamNum);
+}
+
+/**
+ * @brief Drops the cached features of a team.
+ *
+ * Called after one of the team's scouted rows is added or edited, so the
+ * next prediction involving the team uses its new averages.
+ *
+ * @param teamNum The team number of the team that changed.
+ */
+void MainFrame::RefreshTeamAnalysis(int teamNum) {
+    if ( m_features )
+        reinterpret_cast< FeaturePipeline* >( m_features )->Invalidate(teamNum);
+}
+
+/**
+ * @brief Logs the OPR, DPR and CCWM of every team that has played a match.
+ *
+ * The ratings are kept up to date as matches and teams are edited, so this
+ * only sorts and prints them. Teams are listed from highest to lowest OPR.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnCalculateOPR(wxCommandEvent& event) {
+    if ( !m_opr ) {
+        LogErrorMessage("OPR calculator not available.");
+        return;
+    }
+
+    OPRCalculator* opr = reinterpret_cast< OPRCalculator* >( m_opr );
+
+    std::vector<std::pair<int, OPRResult>> ratings(opr->GetResults().begin(), opr->GetResults().end());
+    if ( ratings.empty() ) {
+        LogBackendMessage("No played matches to calculate OPR from.");
+        return;
+    }
+
+    std::sort(ratings.begin(), ratings.end(), [](const auto& a, const auto& b) {
+        return a.second.opr > b.second.opr;
+    });
+
+    std::string msg = std::format("{:>8}{:>10}{:>10}{:>10}{:>10}\n", "Team #", "OPR", "DPR", "CCWM", "Played");
+    for ( const auto& [teamNum, rating] : ratings )
+        msg += std::format("{:>8}{:>10.2f}{:>10.2f}{:>10.2f}{:>10}\n", teamNum, rating.opr, rating.dpr, rating.ccwm, rating.matchesPlayed);
+
+    msg += "\n";
+    LogMessage(msg);
+}
+
+/**
+ * @brief Logs the Elo rating of every team that has played a match.
+ *
+ * Teams are listed from highest to lowest rating, along with the
+ * change in rating from their most recent match.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnShowEloRatings(wxCommandEvent& event) {
+    if ( !m_elo ) {
+        LogErrorMessage("Elo ratings not available.");
+        return;
+    }
+
+    EloRating* elo = reinterpret_cast< EloRating* >( m_elo );
+
+    std::vector<std::pair<int, double>> ratings(elo->GetRatings().begin(), elo->GetRatings().end());
+    if ( ratings.empty() ) {
+        LogBackendMessage("No played matches to calculate Elo ratings from.");
+        return;
+    }
+
+    std::sort(ratings.begin(), ratings.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+
+    std::string msg = std::format("{:>8}{:>10}{:>10}{:>10}\n", "Team #", "Elo", "Last", "Played");
+    for ( const auto& [teamNum, rating] : ratings ) {
+        const std::vector<RatingRecord> history = elo->GetTeamHistory(teamNum);
+
+        // change caused by the team's most recent match
+        double lastChange = rating - ELO_INITIAL_RATING;
+        if ( history.size() > 1 )
+            lastChange = rating - history[history.size() - 2].rating;
+
+        msg += std::format("{:>8}{:>10.1f}{:>+10.1f}{:>10}\n", teamNum, rating, lastChange, history.size());
+    }
+
+    msg += "\n";
+    LogMessage(msg);
+}
+
+/**
+ * @brief Logs the current qualification rankings.
+ *
+ * Read from the ranking table, which follows the database as matches change,
+ * so no match is read to show them.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnShowRankings(wxCommandEvent& event) {
+    if ( !m_rankings ) {
+        LogErrorMessage("Rankings not available.");
+        return;
+    }
+
+    const std::vector<TeamStanding>& standings = reinterpret_cast< RankingTable* >( m_rankings )->GetStandings();
+    if ( standings.empty() ) {
+        LogBackendMessage("No scheduled matches to rank teams from.");
+        return;
+    }
+
+    std::string msg = std::format("{:>6}{:>8}{:>8}{:>10}{:>6}{:>8}{:>8}{:>8}{:>6}\n", "Rank", "Team #", "RS", "W-L-T", "RP", "Points", "Auto", "Played", "Left");
+    for ( const TeamStanding& standing : standings ) {
+        msg += std::format(
+            "{:>6}{:>8}{:>8.2f}{:>10}{:>6}{:>8.1f}{:>8.1f}{:>8}{:>6}\n", standing.rank, standing.teamNum, standing.rankingScore,
+            std::format("{}-{}-{}", standing.wins, standing.losses, standing.ties), standing.totalRankingPoints,
+            standing.averagePoints, standing.averageAutonomousPoints, standing.played, standing.remaining
+        );
+    }
+
+    msg += "\n";
+    LogMessage(msg);
+}
+
+/**
+ * @brief Logs how every scouted team has been doing over its recent matches.
+ *
+ * Teams are listed from most improving to most declining, going by the slope of their
+ * points over their last `TREND_WINDOW` matches. Read from the trend index, so it
+ * costs nothing however many rows were scouted.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnShowTeamTrends(wxCommandEvent& event) {
+    if ( !m_trends ) {
+        LogErrorMessage("Team trends not available.");
+        return;
+    }
+
+    const std::vector<TeamTrend> trends = reinterpret_cast< TrendIndex* >( m_trends )->GetTrends();
+    if ( trends.empty() ) {
+        LogBackendMessage("No scouted teams to show trends of.");
+        return;
+    }
+
+    std::string msg = std::format("{:>8}{:>9}{:>8}{:>10}{:>8}{:>12}\n", "Team #", "Matches", "Last", std::format("Last {}", TREND_WINDOW), "EWMA", "Per Match");
+    for ( const TeamTrend& trend : trends )
+        msg += std::format("{:>8}{:>9}{:>8.1f}{:>10.1f}{:>8.1f}{:>+12.2f}\n", trend.teamNum, trend.matches, trend.lastPoints, trend.windowAverage, trend.weightedMean, trend.slope);
+
+    msg += "\n";
+    LogMessage(msg);
+}
+
+/**
+ * @brief Projects where every team will finish the qualification rankings.
+ *
+ * The schedule is copied out of the database on the UI thread, then the event is simulated
+ * `DEFAULT_SIMULATION_COUNT` times on the thread pool from a background thread so the UI stays
+ * responsive. Unplayed matches are decided using the Elo ratings. The results are logged back
+ * on the UI thread once the run finishes.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnSimulateEvent(wxCommandEvent& event) {
+    if ( !m_simulator || !m_elo || !m_rankings ) {
+        LogErrorMessage("Event simulator not available.");
+        return;
+    }
+
+    EventSimulator* simulator = reinterpret_cast< EventSimulator* >( m_simulator );
+    EloRating* elo = reinterpret_cast< EloRating* >( m_elo );
+
+    if ( !simulator->TryBeginRun() ) {
+        LogBackendMessage("Event simulation already running.");
+        return;
+    }
+
+    // use the prediction model when there is one, predicting every remaining match at once
+    std::unordered_map<int, double> modelProbabilities = {};
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    if ( predictor && predictor->IsModelAvailable() ) {
+        const std::vector<Match> remaining = reinterpret_cast< RankingTable* >( m_rankings )->GetRemainingMatches();
+        const std::vector<double> probabilities = predictor->PredictRedWinProbabilities(remaining);
+        for ( size_t i = 0; i < remaining.size(); i++ )
+            modelProbabilities[remaining[i].matchNum] = probabilities[i];
+    }
+
+    EventSnapshot snapshot = simulator->TakeSnapshot([elo, &modelProbabilities](const Match& match) {
+        auto it = modelProbabilities.find(match.matchNum);
+        if ( it != modelProbabilities.end() )
+            return it->second;
+
+        return elo->RedWinProbability(match);
+    });
+
+    if ( snapshot.teamNums.empty() ) {
+        simulator->EndRun();
+        LogBackendMessage("No matches to simulate.");
+        return;
+    }
+
+    LogBackendMessage(std::format(
+        "Simulating {} events with {} matches remaining, using {} win probabilities...",
+        DEFAULT_SIMULATION_COUNT, snapshot.remaining.size(), modelProbabilities.empty() ? "Elo" : "prediction model"
+    ));
+
+    const uint64_t seed = std::random_device{}();
+    RunInBackground([this, simulator, snapshot = std::move(snapshot), seed] {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<TeamProjection> projections = simulator->Simulate(snapshot, DEFAULT_SIMULATION_COUNT, seed);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::string msg = std::format("{:>8}{:>10}{:>10}{:>10}{:>10}\n", "Team #", "Avg Rank", "Avg RP", "Top 8", "1st");
+        for ( const TeamProjection& projection : projections ) {
+            double topEight = 0.0;
+            for ( size_t rank = 0; rank < 8 && rank < projection.rankProbabilities.size(); rank++ )
+                topEight += projection.rankProbabilities[rank];
+
+            msg += std::format("{:>8}{:>10.2f}{:>10.2f}{:>9.1f}%{:>9.1f}%\n", projection.teamNum, projection.averageRank,
+                projection.averageRankingPoints, topEight * 100.0, projection.rankProbabilities[0] * 100.0);
+        }
+
+        msg += std::format("Simulated in {} ms (seed {})\n\n", elapsed.count(), seed);
+
+        simulator->EndRun();
+        CallAfter([this, msg]() mutable { LogMessage(msg); });
+    });
+}
+
+/**
+ * @brief Asks for the captain picking and logs their pick list.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnBuildPickList(wxCommandEvent& event) {
+    if ( !m_selector ) {
+        LogErrorMessage("Alliance selector not available.");
+        return;
+    }
+
+    AllianceSelector* selector = reinterpret_cast< AllianceSelector* >( m_selector );
+
+    // the highest ranked team left picks first
+    const int suggestedCaptain = ( selector->GetCaptain() != 0 ) ? selector->GetCaptain() : selector->NextCaptain();
+
+    const long captainTeamNum = wxGetNumberFromUser(
+        "Team number of the alliance captain picking.", "Captain:", "Build Pick List",
+        suggestedCaptain, 1, 99999, this
+    );
+
+    if ( captainTeamNum == -1 ) // cancelled
+        return;
+
+    LogPickList(static_cast< int >( captainTeamNum ));
+}
+
+/**
+ * @brief Makes every picked team available for pick lists again.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnResetPicks(wxCommandEvent& event) {
+    if ( !m_selector ) {
+        LogErrorMessage("Alliance selector not available.");
+        return;
+    }
+
+    reinterpret_cast< AllianceSelector* >( m_selector )->ResetPicks();
+    LogBackendMessage("Every team is available to pick again.");
+}
+
+/**
+ * @brief Marks the selected team as picked, or available again if it already was.
+ *
+ * The pick list of the last captain is logged again without the team.
+ *
+ * @param event The wxCommandEvent triggered by the team right click context menu.
+ */
+void MainFrame::OnMarkTeamPicked(wxCommandEvent& event) {
+    if ( !m_selector ) {
+        LogErrorMessage("Alliance selector not available.");
+        return;
+    }
+
+    const Team team = GetTeamFromRow(m_selectedTeamRow);
+    if ( team.teamNum == 0 )
+        return;
+
+    AllianceSelector* selector = reinterpret_cast< AllianceSelector* >( m_selector );
+    if ( selector->IsPicked(team.teamNum) ) {
+        selector->UnmarkPicked(team.teamNum);
+        LogBackendMessage(std::format("Team {} is available to pick again.", team.teamNum));
+    }
+    else {
+        selector->MarkPicked(team.teamNum);
+        LogBackendMessage(std::format("Team {} marked as picked.", team.teamNum));
+    }
+
+    if ( selector->GetCaptain() != 0 )
+        LogPickList(selector->GetCaptain());
+}
+
+/**
+ * @brief Builds and logs the pick list for a captain.
+ *
+ * If the prediction model is available the top of the list is
+ * re-ranked by predicted head-to-head results.
+ *
+ * @param captainTeamNum The team number of the captain picking.
+ */
+void MainFrame::LogPickList(int captainTeamNum) {
+    AllianceSelector* selector = reinterpret_cast< AllianceSelector* >( m_selector );
+
+    AllianceSelector::HeadToHead redWinProbabilities = nullptr;
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    if ( predictor && predictor->IsModelAvailable() ) {
+        redWinProbabilities = [predictor](const std::vector<Match>& matches) {
+            return predictor->PredictRedWinProbabilities(matches);
+        };
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<PickCandidate> pickList = selector->BuildPickList(captainTeamNum, redWinProbabilities);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    if ( pickList.empty() ) {
+        LogBackendMessage("No teams available to pick.");
+        return;
+    }
+
+    std::string msg = std::format("Pick list for team {}\n", captainTeamNum);
+    msg += std::format("{:>6}{:>8}{:>6}{:>10}{:>10}{:>8}\n", "Pick", "Team #", "Rank", "Partner", "Score", "H2H");
+    for ( size_t i = 0; i < pickList.size(); i++ ) {
+        const PickCandidate& candidate = pickList[i];
+        const std::string headToHead = ( candidate.headToHeadWins < 0 ) ? "-" : std::format("{:.1f}", candidate.headToHeadWins);
+        const std::string rank = ( candidate.rank == 0 ) ? "-" : std::to_string(candidate.rank);
+
+        msg += std::format("{:>6}{:>8}{:>6}{:>10}{:>10.1f}{:>8}\n", i + 1, candidate.teamNum, rank, candidate.partnerTeamNum, candidate.score, headToHead);
+    }
+
+    msg += std::format("Built in {} ms\n\n", elapsed.count());
+    LogMessage(msg);
+}
+
+/**
+ * @brief Trains a new prediction model in the background.
+ *
+ * The current model keeps being used until the new one is finished.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnRetrainModel(wxCommandEvent& event) {
+    if ( !m_predictor ) {
+        LogErrorMessage("Predictor not available, cannot train model.");
+        return;
+    }
+
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    if ( predictor->StartTraining() )
+        LogBackendMessage("Training prediction model in the background.");
+}
+
+/**
+ * @brief Cancels the prediction model being trained, and any model evaluation.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnCancelTraining(wxCommandEvent& event) {
+    if ( !m_predictor ) {
+        LogErrorMessage("Predictor not available.");
+        return;
+    }
+
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    ModelEvaluator* evaluator = reinterpret_cast< ModelEvaluator* >( m_evaluator );
+
+    const bool evaluating = evaluator && evaluator->IsRunning();
+    if ( !predictor->IsTraining() && !evaluating ) {
+        LogBackendMessage("No model is being trained.");
+        return;
+    }
+
+    predictor->CancelTraining();
+    if ( evaluating )
+        evaluator->Cancel();
+}
+
+/**
+ * @brief Cross-validates a grid of prediction model parameters in the background.
+ *
+ * The training data is gathered on the UI thread, then every set of parameters is
+ * cross-validated on a background thread. The report is written to `EVAL_REPORT_PATH`
+ * and the recommended parameters are logged once the search finishes. Cancelling model
+ * training also cancels the search.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnEvaluateModel(wxCommandEvent& event) {
+    if ( !m_predictor || !m_evaluator ) {
+        LogErrorMessage("Model evaluator not available.");
+        return;
+    }
+
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    ModelEvaluator* evaluator = reinterpret_cast< ModelEvaluator* >( m_evaluator );
+
+    if ( !evaluator->TryBeginRun() ) {
+        LogBackendMessage("Model parameters are already being evaluated.");
+        return;
+    }
+
+    arma::mat features;
+    arma::Row<size_t> labels;
+    if ( !predictor->GetTrainingData(features, labels) ) {
+        evaluator->EndRun();
+        return;
+    }
+
+    const std::vector<ForestParams> grid = ModelEvaluator::FullGrid();
+    LogBackendMessage(std::format("Cross-validating {} sets of parameters on {} matches...", grid.size(), features.n_cols));
+
+    RunInBackground([this, evaluator, features = std::move(features), labels = std::move(labels), grid] {
+        const std::vector<EvaluationResult> results = evaluator->Search(features, labels, grid, EVAL_FOLD_COUNT, std::random_device{}());
+
+        std::string msg = "Model evaluation cancelled.\n\n";
+        if ( !results.empty() ) {
+            const EvaluationResult& best = results[ModelEvaluator::Recommend(results)];
+            msg = std::format(
+                "Recommended {} trees, min leaf {}, depth {}: {:.2f}% accuracy, {:.4f} log-loss, {:.2f} us per prediction\n",
+                best.params.treeCount, best.params.minLeafSize, best.params.maxDepth, best.accuracy, best.logLoss, best.inferenceUs
+            );
+
+            if ( ModelEvaluator::WriteReport(EVAL_REPORT_PATH, results, features.n_cols) )
+                msg += std::format("Full report written to {}\n\n", EVAL_REPORT_PATH);
+            else
+                msg += std::format("Failed to write report to {}\n\n", EVAL_REPORT_PATH);
+        }
+
+        evaluator->EndRun();
+        CallAfter([this, msg]() mutable { LogMessage(msg); });
+    });
+}
+
+/**
+ * @brief Turns updating the prediction model as match results are entered on or off.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnToggleOnlineUpdates(wxCommandEvent& event) {
+    if ( !m_predictor ) {
+        LogErrorMessage("Predictor not available.");
+        return;
+    }
+
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    predictor->SetOnlineUpdates(event.IsChecked());
+
+    LogBackendMessage(event.IsChecked() ? "Model will update as results arrive." : "Model will only update when retrained.");
+}
+
+/**
+ * @brief Turns predicting with the compact model on or off, remembering it for the next run.
+ *
+ * @param event The wxCommandEvent triggered by the checkable analysis menu item.
+ */
+void MainFrame::OnToggleCompactModel(wxCommandEvent& event) {
+    if ( !m_predictor ) {
+        LogErrorMessage("Predictor not available.");
+        return;
+    }
+
+    RFPredictor* predictor = reinterpret_cast< RFPredictor* >( m_predictor );
+    predictor->SetCompactModel(event.IsChecked());
+    wxConfigBase::Get()->Write(COMPACT_MODEL_CONFIG_KEY, event.IsChecked());
+
+    LogBackendMessage(event.IsChecked() ? "Predicting with the compact model." : "Predicting with the full model.");
+}
+
+/**
+ * @brief Adds an event to the season, asking whether to start scouting it.
+ *
+ * @param event The wxCommandEvent triggered by the file menu item.
+ */
+void MainFrame::OnNewEvent(wxCommandEvent& event) {
+    if ( !m_season ) {
+        LogErrorMessage("Season not available, cannot add an event.");
+        return;
+    }
+
+    wxString eventKey = wxGetTextFromUser("Key of the event, lowercase letters and digits (e.g 2025onto):", "New Event", "", this);
+    eventKey.Trim(true).Trim(false);
+    if ( eventKey.IsEmpty() )
+        return;
+
+    wxString name = wxGetTextFromUser("Name of the event:", "New Event", eventKey, this);
+    name.Trim(true).Trim(false);
+
+    Season* season = reinterpret_cast< Season* >( m_season );
+    if ( !season->AddEvent(eventKey.ToStdString(), name.ToStdString()) )
+        return;
+
+    LogBackendMessage("Added event " + eventKey.ToStdString() + " to the season.");
+
+    const int answer = wxMessageBox("Start scouting " + eventKey + " now? The app restarts in it.", "New Event", wxYES_NO | wxICON_QUESTION, this);
+    if ( answer == wxYES )
+        RestartInEvent(eventKey.ToStdString());
+}
+
+/**
+ * @brief Asks for another event of the season to scout, and restarts the app in it.
+ *
+ * @param event The wxCommandEvent triggered by the file menu item.
+ */
+void MainFrame::OnSwitchEvent(wxCommandEvent& event) {
+    if ( !m_season ) {
+        LogErrorMessage("Season not available, cannot switch events.");
+        return;
+    }
+
+    Season* season = reinterpret_cast< Season* >( m_season );
+    const std::vector<SeasonEvent> events = season->GetEvents();
+    const std::string current = season->GetCurrentEvent().eventKey;
+
+    wxArrayString choices;
+    int selected = 0;
+    for ( size_t i = 0; i < events.size(); i++ ) {
+        choices.Add(events[i].eventKey + " - " + events[i].name);
+        if ( events[i].eventKey == current )
+            selected = static_cast< int >( i );
+    }
+
+    const int choice = wxGetSingleChoiceIndex("Event to scout:", "Switch Event", choices, selected, this);
+    if ( choice < 0 || events[choice].eventKey == current )
+        return;
+
+    RestartInEvent(events[choice].eventKey);
+}
+
+/**
+ * @brief Makes an event current and starts the app again, so everything is loaded from its database.
+ *
+ * @param eventKey The key of the event to scout.
+ */
+void MainFrame::RestartInEvent(const std::string& eventKey) {
+    Season* season = reinterpret_cast< Season* >( m_season );
+    if ( !season->SetCurrentEvent(eventKey) )
+        return;
+
+    // rows waiting to be shown are already saved, the new instance reads them again
+    const wxString executable = "\"" + wxStandardPaths::Get().GetExecutablePath() + "\"";
+    if ( wxExecute(executable, wxEXEC_ASYNC) == 0 ) {
+        LogErrorMessage("Failed to restart, " + eventKey + " is scouted the next time the app starts.");
+        return;
+    }
+
+    Close(true);
+}
+
+/**
+ * @brief Logs each team's stats over every event of the season it was scouted at.
+ *
+ * @param event The wxCommandEvent triggered by the analysis menu item.
+ */
+void MainFrame::OnShowSeasonStats(wxCommandEvent& event) {
+    if ( !m_season ) {
+        LogErrorMessage("Season not available, cannot show season stats.");
+        return;
+    }
+
+    Season* season = reinterpret_cast< Season* >( m_season );
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<EventTeamStats> stats = season->GetSeasonTeamStats();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    if ( stats.empty() ) {
+        LogBackendMessage("No teams scouted at any event of the season.");
+        return;
+    }
+
+    std::string msg = std::format("{:>8}{:>8}{:>8}{:>10}{:>10}{:>8}\n", "Team #", "Events", "Rows", "Points", "RP", "Hang");
+    for ( const EventTeamStats& team : stats )
+        msg += std::format("{:>8}{:>8}{:>8}{:>10.1f}{:>10.2f}{:>7.0f}%\n", team.teamNum, team.events, team.rowsScouted, team.averagePoints, team.averageRankingPoints, team.hangRate * 100.0);
+
+    msg += "\n";
+    LogMessage(msg);
+
+    LogBackendMessage(std::format("Read {} events in {} ms.", season->GetEvents().size(), elapsed.count()));
+}
+
+/**
+ * @brief Logs the selected team's stats at each event of the season it was scouted at.
+ *
+ * @param event The wxCommandEvent triggered by the right click context menu button.
+ */
+void MainFrame::OnShowTeamSeason(wxCommandEvent& event) {
+    if ( !m_season ) {
+        LogErrorMessage("Season not available, cannot show season stats.");
+        return;
+    }
+
+    const Team team = GetTeamFromRow(m_selectedTeamRow);
+    if ( team.teamNum == 0 )
+        return;
+
+    Season* season = reinterpret_cast< Season* >( m_season );
+    const std::vector<EventTeamStats> stats = season->GetTeamEventStats(team.teamNum);
+    if ( stats.empty() ) {
+        LogBackendMessage(std::format("Team {} wasn't scouted at any event of the season.", team.teamNum));
+        return;
+    }
+
+    std::string msg = std::format("Team {}\n{:>12}{:>8}{:>10}{:>10}{:>8}\n", team.teamNum, "Event", "Rows", "Points", "RP", "Hang");
+    for ( const EventTeamStats& row : stats )
+        msg += std::format("{:>12}{:>8}{:>10.1f}{:>10.2f}{:>7.0f}%\n", row.eventKey, row.rowsScouted, row.averagePoints, row.averageRankingPoints, row.hangRate * 100.0);
+
+    msg += "\n";
+    LogMessage(msg);
+}
+
+/**
+ * @brief Logs the points the selected team was scouted for in each of its matches, with its trend.
+ *
+ * @param event The wxCommandEvent triggered by the right click context menu button.
+ */
+void MainFrame::OnShowTeamHistory(wxCommandEvent& event) {
+    if ( !m_trends ) {
+        LogErrorMessage("Team trends not available.");
+        return;
+    }
+
+    const Team team = GetTeamFromRow(m_selectedTeamRow);
+    if ( team.teamNum == 0 )
+        return;
+
+    TrendIndex* trends = reinterpret_cast< TrendIndex* >( m_trends );
+    const std::vector<std::pair<int, double>> history = trends->GetTeamHistory(team.teamNum);
+    if ( history.empty() ) {
+        LogBackendMessage(std::format("Team {} wasn't scouted in any match.", team.teamNum));
+        return;
+    }
+
+    std::string msg = std::format("Team {}\n{:>8}{:>10}\n", team.teamNum, "Match #", "Points");
+    for ( const auto& [matchNum, points] : history )
+        msg += std::format("{:>8}{:>10.1f}\n", matchNum, points);
+
+    const TeamTrend trend = trends->GetTeamTrend(team.teamNum);
+    msg += std::format(
+        "Last {} average {:.1f}, EWMA {:.1f}, {:+.2f} points per match\n\n",
+        TREND_WINDOW, trend.windowAverage, trend.weightedMean, trend.slope
+    );
+    LogMessage(msg);
+}
+
+/**
+ * @brief Takes a snapshot of the database now, e.g before handing the laptop to someone else.
+ *
+ * @param event The wxCommandEvent triggered by the file menu item.
+ */
+void MainFrame::OnBackUpNow(wxCommandEvent& event) {
+    if ( !m_backup ) {
+        LogErrorMessage("Backups not available.");
+        return;
+    }
+
+    BackupService* backup = reinterpret_cast< BackupService* >( m_backup );
+
+    std::string path;
+    if ( backup->TakeSnapshot(path) )
+        LogBackendMessage("Backed up the database to " + std::filesystem::absolute(path).string());
+}
+
+/**
+ * @brief Asks for a snapshot to rewind the database to, and restores it.
+ *
+ * The database as it was before is snapshotted first, so the restore shows up in the list
+ * and can be undone. Every row may have changed, so the lists and analysis are reloaded.
+ *
+ * @param event The wxCommandEvent triggered by the file menu item.
+ */
+void MainFrame::OnRestoreBackup(wxCommandEvent& event) {
+    if ( !m_backup ) {
+        LogErrorMessage("Backups not available.");
+        return;
+    }
+
+    BackupService* backup = reinterpret_cast< BackupService* >( m_backup );
+    const std::vector<BackupSnapshot> snapshots = backup->GetSnapshots();
+    if ( snapshots.empty() ) {
+        LogBackendMessage("No backups of this database yet.");
+        return;
+    }
+
+    wxArrayString choices;
+    for ( const BackupSnapshot& snapshot : snapshots ) {
+        const wxDateTime taken(static_cast< time_t >( std::chrono::system_clock::to_time_t(snapshot.taken) ));
+        choices.Add(taken.Format("%Y-%m-%d %H:%M:%S") + wxString::Format("  (%llu KB)", static_cast< unsigned long long >( snapshot.bytes / 1024 )));
+    }
+
+    const int choice = wxGetSingleChoiceIndex("Rewind the database to the backup taken at:", "Restore From Backup", choices, 0, this);
+    if ( choice < 0 )
+        return;
+
+    const int answer = wxMessageBox(
+        "Every change made after " + choices[choice] + " will be undone. The database as it is now is backed up first.",
+        "Restore From Backup", wxOK | wxCANCEL | wxICON_WARNING, this
+    );
+    if ( answer != wxOK )
+        return;
+
+    if ( !backup->RestoreSnapshot(snapshots[choice].path) )
+        return;
+
+    // every row may have changed, and the database reported none of them
+    if ( m_trends )
+        reinterpret_cast< TrendIndex* >( m_trends )->Reload();
+    if ( m_rankings )
+        reinterpret_cast< RankingTable* >( m_rankings )->Reload();
+
+    m_teamListView->ForgetRows();
+    m_matchListView->ForgetRows();
+    DisplayExistingData();
+    DefaultEditGrid();
+    RefreshAllAnalysis();
+
+    LogBackendMessage("Restored the backup taken at " + choices[choice].ToStdString());
+}
+
+/**
+ * @brief Turns the background snapshots on or off.
+ *
+ * @param event The wxCommandEvent triggered by the checkable file menu item.
+ */
+void MainFrame::OnToggleAutoBackup(wxCommandEvent& event) {
+    if ( !m_backup ) {
+        LogErrorMessage("Backups not available.");
+        return;
+    }
+
+    BackupService* backup = reinterpret_cast< BackupService* >( m_backup );
+    if ( event.IsChecked() )
+        backup->Start();
+    else
+        backup->Stop();
+
+    LogBackendMessage(event.IsChecked() ? std::format("Backing up every {} minutes.", BACKUP_INTERVAL_S / 60) : std::string("Automatic backups off."));
+}
+
+/**
+ * @brief Stops every background service and deletes the backend before the window goes.
+ *
+ * Background threads log and hand calls to the UI thread through this window, so they are
+ * all stopped and joined first. The backend is then deleted in the reverse order it was
+ * created in, and the calls those threads queued for the UI thread are dropped, since
+ * what they reference is gone.
+ *
+ * @param event The wxCloseEvent triggered by closing the window.
+ */
+void MainFrame::OnClose(wxCloseEvent& event) {
+    if ( m_ingest )
+        reinterpret_cast< IngestServer* >( m_ingest )->Stop();
+    if ( m_sync )
+        reinterpret_cast< SyncService* >( m_sync )->StopServer();
+    if ( m_backup )
+        reinterpret_cast< BackupService* >( m_backup )->Stop();
+    if ( m_predictor )
+        reinterpret_cast< RFPredictor* >( m_predictor )->CancelTraining();
+    if ( m_evaluator )
+        reinterpret_cast< ModelEvaluator* >( m_evaluator )->Cancel();
+
+    // exports and analysis hold on to the backend, wait for them to finish
+    for ( std::future<void>& task : m_backgroundTasks )
+        task.wait();
+    m_backgroundTasks.clear();
+
+    // each destructor joins whatever thread of its own is still running
+    delete reinterpret_cast< BackupService* >( m_backup );
+    delete reinterpret_cast< IngestServer* >( m_ingest );
+    delete reinterpret_cast< SyncService* >( m_sync );
+    delete reinterpret_cast< ModelEvaluator* >( m_evaluator );
+    delete reinterpret_cast< AllianceSelector* >( m_selector );
+    delete reinterpret_cast< EventSimulator* >( m_simulator );
+    delete reinterpret_cast< RFPredictor* >( m_predictor );
+    delete reinterpret_cast< ThreadPool* >( m_threadPool );
+    delete reinterpret_cast< FeaturePipeline* >( m_features );
+    delete reinterpret_cast< RankingTable* >( m_rankings );
+    delete reinterpret_cast< EloRating* >( m_elo );
+    delete reinterpret_cast< OPRCalculator* >( m_opr );
+    delete reinterpret_cast< TrendIndex* >( m_trends );
+    delete reinterpret_cast< DataBase* >( m_dataBase );
+    delete reinterpret_cast< Season* >( m_season );
+
+    m_backup = m_ingest = m_sync = m_evaluator = m_selector = m_simulator = nullptr;
+    m_predictor = m_threadPool = m_features = m_rankings = m_elo = m_opr = m_trends = nullptr;
+    m_dataBase = m_season = nullptr;
+
+    DeletePendingEvents();
+    Destroy();
+}
+
+/**
+ * @brief Runs a task on a thread of its own, so the UI stays usable while it runs.
+ *
+ * The task is kept until it finishes, so closing the window waits for it instead of
+ * deleting the backend out from under it.
+ *
+ * @param task The task to run. It may only touch the UI through `CallAfter`.
+ */
+void MainFrame::RunInBackground(std::function<void()> task) {
+    // forget the tasks that have finished
+    std::erase_if(m_backgroundTasks, [](const std::future<void>& running) {
+        return running.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+
+    m_backgroundTasks.push_back(std::async(std::launch::async, std::move(task)));
+}
@@ -72,6 +72,23 @@ void MainFrame::LogBackendMessage(std::string msg) {
     LogMessage(msg, *wxBLUE);
 }
 
+/**
+ * @brief Shows how far along a background task is in the status bar.
+ *
+ * Must be called from the UI thread. Background tasks should
+ * call it through `CallAfter`.
+ *
+ * @param task The name of the task, e.g "Training model".
+ * @param done The number of steps finished.
+ * @param total The number of steps in the task.
+ */
+void MainFrame::LogProgress(const std::string& task, size_t done, size_t total) {
+    if ( total == 0 )
+        return;
+
+    SetStatusText(wxString::Format("%s - %zu/%zu (%zu%%)", task, done, total, done * 100 / total));
+}
+
 /*
  * @brief Clears the output in the SQL history text box.
  *
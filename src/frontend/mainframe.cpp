@@ -1,15 +1,35 @@
 ﻿// Frontend
 #include "frontend/mainframe.h" // MainFrame class
 
+// WX Components
+#include <wx/config.h> // wxConfigBase
+#include <wx/srchctrl.h> // wxSearchCtrl
+#include <wx/valtext.h> // wxTextValidator
+
 // Backend
 #include "backend/data.h" // DataBase class
 #include "backend/team.h"
 #include "backend/match.h"
 #include "backend/rfpredict.h"
+#include "backend/opr.h"
+#include "backend/elo.h"
+#include "backend/matchfeatures.h"
+#include "backend/threadpool.h"
+#include "backend/simulator.h"
+#include "backend/selector.h"
+#include "backend/evaluation.h"
+#include "backend/sync.h"
+#include "backend/ingest.h"
+#include "backend/season.h"
+#include "backend/backup.h"
+#include "backend/trend.h"
+#include "backend/rankings.h"
 
 // STD
+#include <algorithm> // std::min, std::max
 #include <filesystem> // exists(), absolute()
 #include <string>
+#include <unordered_map> // std::unordered_map
 
 /**
  * @brief Constructor for the MainFrame class, initializing the main window with a specified title.
@@ -39,13 +59,18 @@ MainFrame::MainFrame(const wxString& title, bool darkModeEnabled)
     // colours to DARK_GRAY instead of the correct LIGHT_GRAY_X_ACCENT's
     CreateMenuBar();
 
-    // Create global database
-    DataBase* db = new DataBase(DB_PATH, this);
+    // Create global season, every event is scouted in a database of its own
+    Season* season = new Season(this, SEASON_DB_PATH);
+    m_season = reinterpret_cast< void* >( season );
+
+    // Create global database, of the event being scouted
+    DataBase* db = season->OpenCurrentEvent();
     m_dataBase = reinterpret_cast< void* >( db );
 
-    // set the window title to app name - database path
-    // e.g: "FRCScout - C:\Users\user\Desktop\data.db"
-    this->SetTitle(std::string(APP_NAME) + " - " + std::filesystem::absolute(DB_PATH).string());
+    // set the window title to app name - event key - database path
+    // e.g: "FRCScout - 2025onto - C:\Users\user\Desktop\events\2025onto.db"
+    const SeasonEvent currentEvent = season->GetCurrentEvent();
+    this->SetTitle(std::string(APP_NAME) + " - " + currentEvent.eventKey + " - " + std::filesystem::absolute(currentEvent.path).string());
 
     // Panels
     wxPanel* panel = new wxPanel(this, wxID_ANY);
@@ -57,8 +82,26 @@ MainFrame::MainFrame(const wxString& title, bool darkModeEnabled)
     leftSizer->Add(CreateListPanel(panel, kMatchListView, "Matches", "View and modify individual fields of a match.", 0), 1, wxEXPAND | wxALL, 10);
 
     // Get list views
-    m_teamListView = ( wxListCtrl* ) FindWindow(kTeamListView);
-    m_matchListView = ( wxListCtrl* ) FindWindow(kMatchListView);
+    m_teamListView = ( DataListView* ) FindWindow(kTeamListView);
+    m_matchListView = ( DataListView* ) FindWindow(kMatchListView);
+
+    // rows are read from the database as they're drawn
+    m_teamListView->SetRowFetcher([this](const std::vector<int>& uids, std::unordered_map<int, std::vector<wxString>>& cells) {
+        if ( !m_dataBase ) // closing
+            return;
+
+        DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
+        for ( const Team& team : db->GetTeams(uids) )
+            cells[team.uid] = TeamRowCells(team);
+    });
+    m_matchListView->SetRowFetcher([this](const std::vector<int>& matchNums, std::unordered_map<int, std::vector<wxString>>& cells) {
+        if ( !m_dataBase ) // closing
+            return;
+
+        DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
+        for ( const Match& match : db->GetMatches(matchNums) )
+            cells[match.matchNum] = MatchRowCells(match);
+    });
 
     // Add columns to list views
     AddTeamListColumns();
@@ -90,10 +133,69 @@ MainFrame::MainFrame(const wxString& title, bool darkModeEnabled)
     UpdateStatusBar();
     DisplayExistingData();
 
-    // Create global predictor
-    RFPredictor* predictor = new RFPredictor(this, db);
+    // Create global trend index, every team's points match by match
+    TrendIndex* trends = new TrendIndex(this, db);
+    m_trends = reinterpret_cast< void* >( trends );
+
+    // from here on the lists follow the database, whatever writes to it
+    db->SubscribeToChanges([this](const DataEventBatch& batch) { ShowChangedRows(batch); });
+
+    // Create global OPR calculator
+    OPRCalculator* opr = new OPRCalculator(this, db);
+    m_opr = reinterpret_cast< void* >( opr );
+
+    // Create global Elo ratings
+    EloRating* elo = new EloRating(this, db);
+    m_elo = reinterpret_cast< void* >( elo );
+
+    // Create global ranking table, following the database like the lists do
+    RankingTable* rankings = new RankingTable(this, db);
+    m_rankings = reinterpret_cast< void* >( rankings );
+    db->SubscribeToChanges([rankings](const DataEventBatch& batch) { rankings->ApplyChanges(batch); });
+
+    // Create global feature pipeline, shared by training and prediction
+    FeaturePipeline* features = new FeaturePipeline(this, db, opr, elo);
+    m_features = reinterpret_cast< void* >( features );
+
+    // Create global thread pool, shared by the CPU heavy analysis
+    ThreadPool* threadPool = new ThreadPool();
+    m_threadPool = reinterpret_cast< void* >( threadPool );
+
+    // Create global predictor, training a model in the background if none is saved.
+    // Laptops short on memory keep the compact model turned on between runs
+    const bool compactModel = wxConfigBase::Get()->ReadBool(COMPACT_MODEL_CONFIG_KEY, false);
+    GetMenuBar()->Check(kCompactModel, compactModel);
+
+    RFPredictor* predictor = new RFPredictor(this, db, features, threadPool, compactModel);
     m_predictor = reinterpret_cast< void* >( predictor );
 
+    // Create global event simulator
+    EventSimulator* simulator = new EventSimulator(this, db, threadPool, rankings);
+    m_simulator = reinterpret_cast< void* >( simulator );
+
+    // Create global alliance selector
+    AllianceSelector* selector = new AllianceSelector(this, db, threadPool, opr, rankings);
+    m_selector = reinterpret_cast< void* >( selector );
+
+    // Create global model evaluator
+    ModelEvaluator* evaluator = new ModelEvaluator(this, threadPool);
+    m_evaluator = reinterpret_cast< void* >( evaluator );
+
+    // Create global sync service, other stations can only sync with this one once it's turned on
+    SyncService* sync = new SyncService(this, db);
+    m_sync = reinterpret_cast< void* >( sync );
+
+    // Create global ingest server, scouting clients can only submit rows once it's turned on
+    IngestServer* ingest = new IngestServer(this, db);
+    m_ingest = reinterpret_cast< void* >( ingest );
+
+    // Create global backup service, snapshotting the database every few minutes
+    BackupService* backup = new BackupService(this, db);
+    m_backup = reinterpret_cast< void* >( backup );
+    backup->Start();
+
+    Bind(wxEVT_CLOSE_WINDOW, &MainFrame::OnClose, this);
+
     if ( m_darkModeTheme )
         this->SetBackgroundColour(DARK_GRAY_1);
 }
@@ -108,8 +210,10 @@ MainFrame::MainFrame(const wxString& title, bool darkModeEnabled)
  *
  * The layout is as follows:
  * - A vertical stack that contains:
- *   - A horizontal stack for the title and description
- *   - A list view (`wxListCtrl`) that fills the remaining space of the panel.
+ *   - A horizontal stack for the title and description, a team number search box and an add button
+ *   - A list view (`DataListView`) that fills the remaining space of the panel.
+ *
+ * Clicking a column header sorts the list by it, right clicking one filters the list by it.
  *
  * The function returns a `wxBoxSizer` that contains the entire layout.
  *
@@ -149,19 +253,37 @@ wxBoxSizer* MainFrame::CreateListPanel(wxWindow* parent, int listId, wxString ti
         addButton->SetFont(wxFontInfo(9).Bold());
     }
 
+    // only digits can be typed, rows are searched by team number
+    wxSearchCtrl* searchBox = new wxSearchCtrl(parent, wxID_ANY, "", wxDefaultPosition, wxSize(120, 30), 0, wxTextValidator(wxFILTER_DIGITS));
+    searchBox->SetDescriptiveText("Team #");
+    searchBox->SetClientData(reinterpret_cast< void* >( listId )); // save list id in metadata, e.g kTeamListView
+    searchBox->Bind(wxEVT_TEXT, &MainFrame::OnListSearch, this);
+
     // Add elements to the horizontal top sizer
     topSizer->Add(textSizer, 1, wxALIGN_LEFT | wxALIGN_CENTER_VERTICAL);  // Add title + desc stack
     topSizer->AddSpacer(10);  // Some space before buttons
+    topSizer->Add(searchBox, 0, wxALIGN_BOTTOM | wxRIGHT, 5);
     topSizer->Add(addButton, 0, wxALIGN_BOTTOM | wxALIGN_RIGHT);
 
     // List view
-    wxListCtrl* listCtrl = new wxListCtrl(parent, listId, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxBORDER_NONE);
+    DataListView* listCtrl = new DataListView(parent, listId);
 
     // Add topSizer and list view to listSizer
     listSizer->Add(topSizer, 0, wxEXPAND | wxBOTTOM, 5);
     listSizer->Add(listCtrl, 1, wxEXPAND);
 
     listCtrl->Bind(wxEVT_CONTEXT_MENU, &MainFrame::OnListViewRightClick, this);
+    listCtrl->Bind(wxEVT_LIST_ITEM_SELECTED, ( listId == kTeamListView ) ? &MainFrame::OnTeamRowLeftClicked : &MainFrame::OnMatchRowLeftClicked, this);
+    listCtrl->Bind(wxEVT_LIST_ITEM_RIGHT_CLICK, ( listId == kTeamListView ) ? &MainFrame::OnTeamRowRightClicked : &MainFrame::OnMatchRowRightClicked, this);
+    listCtrl->Bind(wxEVT_LIST_COL_CLICK, &MainFrame::OnListColumnClicked, this);
+    listCtrl->Bind(wxEVT_LIST_COL_RIGHT_CLICK, &MainFrame::OnListColumnRightClicked, this);
+    listCtrl->Bind(wxEVT_LIST_KEY_DOWN, &MainFrame::OnListKeyDown, this);
+
+    // change the background colour of every other row for readability
+    if ( m_darkModeTheme )
+        listCtrl->SetRowColours(DARK_GRAY_2, DARK_GRAY_3);
+    else
+        listCtrl->SetRowColours(LIGHT_GRAY_ACCENT_1, LIGHT_GRAY_ACCENT_2);
 
     if ( m_darkModeTheme )
         listCtrl->SetBackgroundColour(DARK_GRAY_5);
@@ -203,6 +325,7 @@ void MainFrame::AddTeamListColumns() {
     m_teamListView->AppendColumn("Driver Skill", wxLIST_FORMAT_CENTER, wxLIST_AUTOSIZE_USEHEADER);
     m_teamListView->AppendColumn("Penaltys", wxLIST_FORMAT_CENTER, wxLIST_AUTOSIZE_USEHEADER);
     m_teamListView->AppendColumn("Rank Points", wxLIST_FORMAT_CENTER, wxLIST_AUTOSIZE_USEHEADER);
+    m_teamListView->AppendColumn("Trend", wxLIST_FORMAT_LEFT, 90);
     m_teamListView->SetColumnWidth(0, teamListWidth * 0.2);
 
     m_teamListView->AppendColumn("", wxLIST_FORMAT_CENTER, 180);
@@ -257,40 +380,52 @@ void MainFrame::AddMatchListColumns() {
 /**
  * @brief Populates the UI with existing team and match data from the database.
  *
- * This function retrieves all teams and matches from the database (`g_DataBase`)
- * and updates the UI list views (`m_teamListView` and `m_matchListView`).
- * If either of these list views is uninitialized or if the global database
- * pointer (`g_DataBase`) is null, the function returns early.
- *
- * @note This function assumes `g_DataBase` is a valid pointer to a `DataBase` instance.
- *       If `g_DataBase` is incorrectly set or uninitialized, this may lead to undefined behavior.
- *
- * @warning `g_DataBase` is a `void*` and requires a `reinterpret_cast` to `DataBase*`.
- *          Ensure `g_DataBase` actually points to a valid `DataBase` object before calling this function.
- *
+ * This function asks the database which rows each list view keeps, in which order,
+ * and hands them to the list views, which read the rows they draw as they draw them.
+ * If either of these list views is uninitialized or if the database is null,
+ * that list is left empty.
  */
 void MainFrame::DisplayExistingData() {
+    RequeryTeamList();
+    RequeryMatchList();
+}
+
+/**
+ * @brief Shows the team rows m_teamQuery keeps in the team list view, sorted the way it asks.
+ *
+ * Sorting, searching and filtering all happen in the database, the list view only gets the
+ * uid of each row and reads the ones it draws. The selected row stays selected if it's still kept.
+ */
+void MainFrame::RequeryTeamList() {
     if ( !m_teamListView || !m_dataBase )
         return;
 
-    m_teamListView->DeleteAllItems();
-
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase ); // cast database
 
-    // show teams
-    std::vector<Team> teams = db->GetTeams();
-    for ( const auto& team : teams )
-        CreateTeamRow(team);
+    m_teamListView->SetRows(db->QueryTeamRows(m_teamQuery));
+    m_displayedTeamCount = m_teamListView->RowCount();
+    m_selectedTeamRow = m_teamListView->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
 
-    if ( !m_matchListView )
+    UpdateStatusBar();
+}
+
+/**
+ * @brief Shows the match rows m_matchQuery keeps in the match list view, sorted the way it asks.
+ *
+ * Sorting, searching and filtering all happen in the database, the list view only gets the
+ * match number of each row and reads the ones it draws. The selected row stays selected if it's still kept.
+ */
+void MainFrame::RequeryMatchList() {
+    if ( !m_matchListView || !m_dataBase )
         return;
 
-    m_matchListView->DeleteAllItems();
+    DataBase* db = reinterpret_cast< DataBase* >( m_dataBase ); // cast database
 
-    // show matches
-    std::vector<Match> matches = db->GetMatches();
-    for ( const auto& match : matches )
-        CreateMatchRow(match);
+    m_matchListView->SetRows(db->QueryMatchRows(m_matchQuery));
+    m_displayedMatchCount = m_matchListView->RowCount();
+    m_selectedMatchRow = m_matchListView->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+
+    UpdateStatusBar();
 }
 
 inline void MainFrame::UpdateStatusBar() {
@@ -613,12 +748,12 @@ void MainFrame::PromptMatchEdit(const Match& match) {
     grid->SetCellValue(kRowMatchNum, 0, matchNum);
     grid->SetCellValue(kRowRedWin, 0, ( match.redWin ) ? "Y" : "N");
     grid->SetCellValue(kRowBlueWin, 0, ( match.blueWin ) ? "Y" : "N");
-    grid->SetCellValue(kRowRed1, 0, std::to_string(match.Team1().teamNum));
-    grid->SetCellValue(kRowRed2, 0, std::to_string(match.Team2().teamNum));
-    grid->SetCellValue(kRowRed3, 0, std::to_string(match.Team3().teamNum));
-    grid->SetCellValue(kRowBlue4, 0, std::to_string(match.Team4().teamNum));
-    grid->SetCellValue(kRowBlue5, 0, std::to_string(match.Team5().teamNum));
-    grid->SetCellValue(kRowBlue6, 0, std::to_string(match.Team6().teamNum));
+    grid->SetCellValue(kRowRed1, 0, std::to_string(match.Team1()));
+    grid->SetCellValue(kRowRed2, 0, std::to_string(match.Team2()));
+    grid->SetCellValue(kRowRed3, 0, std::to_string(match.Team3()));
+    grid->SetCellValue(kRowBlue4, 0, std::to_string(match.Team4()));
+    grid->SetCellValue(kRowBlue5, 0, std::to_string(match.Team5()));
+    grid->SetCellValue(kRowBlue6, 0, std::to_string(match.Team6()));
 
     // Set grid editor
     grid->SetCellEditor(kRowMatchNum, 0, new wxGridCellNumberEditor(0, 20000));
@@ -680,6 +815,7 @@ wxMenuBar* MainFrame::CreateMenuBar() {
     wxMenu* menuFile = new wxMenu;
     wxMenu* menuExport = new wxMenu;
     wxMenu* menuImport = new wxMenu;
+    wxMenu* menuAnalysis = new wxMenu;
 
     ///// Exporting options
 
@@ -707,6 +843,13 @@ wxMenuBar* MainFrame::CreateMenuBar() {
     menuExport->Append(exportTeamDataJSON);
     menuExport->Append(exportMatchDataJSON);
 
+    /// Changesets
+    wxMenuItem* exportChanges = new wxMenuItem(NULL, kExportChanges, "Changes For Other Stations...");
+    Bind(wxEVT_MENU, &MainFrame::OnExportChanges, this, kExportChanges);
+
+    menuExport->AppendSeparator();
+    menuExport->Append(exportChanges);
+
     // TODO: Import options
     wxMenuItem* importTeamDataCSV = new wxMenuItem(NULL, kImportTeamDataCSV, "Import Team Data From CSV");
     wxMenuItem* importMatchDataCSV = new wxMenuItem(NULL, kImportMatchDataCSV, "Import Match Data From CSV");
@@ -714,14 +857,124 @@ wxMenuBar* MainFrame::CreateMenuBar() {
     Bind(wxEVT_MENU, &MainFrame::OnImportTeamDataCSV, this, kImportTeamDataCSV);
     Bind(wxEVT_MENU, &MainFrame::OnImportMatchDataCSV, this, kImportMatchDataCSV);
 
+    wxMenuItem* buildTrainingSet = new wxMenuItem(NULL, kBuildTrainingSet, "Build Training Set From FRC API Results...");
+    Bind(wxEVT_MENU, &MainFrame::OnBuildTrainingSet, this, kBuildTrainingSet);
+
+    wxMenuItem* mergeDataBases = new wxMenuItem(NULL, kMergeDataBases, "Merge Scouting Databases...");
+    Bind(wxEVT_MENU, &MainFrame::OnMergeDataBases, this, kMergeDataBases);
+
+    wxMenuItem* applyChanges = new wxMenuItem(NULL, kApplyChanges, "Apply Changes From Another Station...");
+    Bind(wxEVT_MENU, &MainFrame::OnApplyChanges, this, kApplyChanges);
+
+    wxMenuItem* syncWithStation = new wxMenuItem(NULL, kSyncWithStation, "Sync With Station...");
+    Bind(wxEVT_MENU, &MainFrame::OnSyncWithStation, this, kSyncWithStation);
+
+    wxMenuItem* serveSync = new wxMenuItem(NULL, kServeSync, "Let Other Stations Sync With This One", "", wxITEM_CHECK);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleServeSync, this, kServeSync);
+
+    wxMenuItem* serveIngest = new wxMenuItem(NULL, kServeIngest, "Accept Rows From Scouting Clients", "", wxITEM_CHECK);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleIngest, this, kServeIngest);
+
     menuImport->Append(importTeamDataCSV);
     menuImport->Append(importMatchDataCSV);
+    menuImport->Append(mergeDataBases);
+    menuImport->AppendSeparator();
+    menuImport->Append(applyChanges);
+    menuImport->Append(syncWithStation);
+    menuImport->Append(serveSync);
+    menuImport->Append(serveIngest);
+    menuImport->AppendSeparator();
+    menuImport->Append(buildTrainingSet);
+
+    ///// Analysis options
+    wxMenuItem* calculateOPR = new wxMenuItem(NULL, kCalculateOPR, "Calculate OPR, DPR and CCWM");
+    Bind(wxEVT_MENU, &MainFrame::OnCalculateOPR, this, kCalculateOPR);
+
+    wxMenuItem* showEloRatings = new wxMenuItem(NULL, kShowEloRatings, "Show Elo Ratings");
+    Bind(wxEVT_MENU, &MainFrame::OnShowEloRatings, this, kShowEloRatings);
+
+    wxMenuItem* showRankings = new wxMenuItem(NULL, kShowRankings, "Show Rankings");
+    Bind(wxEVT_MENU, &MainFrame::OnShowRankings, this, kShowRankings);
+
+    wxMenuItem* showTeamTrends = new wxMenuItem(NULL, kShowTeamTrends, "Show Team Trends");
+    Bind(wxEVT_MENU, &MainFrame::OnShowTeamTrends, this, kShowTeamTrends);
+
+    wxMenuItem* simulateEvent = new wxMenuItem(NULL, kSimulateEvent, "Simulate Event Rankings");
+    Bind(wxEVT_MENU, &MainFrame::OnSimulateEvent, this, kSimulateEvent);
+
+    wxMenuItem* buildPickList = new wxMenuItem(NULL, kBuildPickList, "Build Pick List...");
+    Bind(wxEVT_MENU, &MainFrame::OnBuildPickList, this, kBuildPickList);
+
+    wxMenuItem* resetPicks = new wxMenuItem(NULL, kResetPicks, "Reset Picked Teams");
+    Bind(wxEVT_MENU, &MainFrame::OnResetPicks, this, kResetPicks);
+
+    wxMenuItem* retrainModel = new wxMenuItem(NULL, kRetrainModel, "Retrain Prediction Model");
+    Bind(wxEVT_MENU, &MainFrame::OnRetrainModel, this, kRetrainModel);
+
+    wxMenuItem* cancelTraining = new wxMenuItem(NULL, kCancelTraining, "Cancel Model Training");
+    Bind(wxEVT_MENU, &MainFrame::OnCancelTraining, this, kCancelTraining);
+
+    wxMenuItem* evaluateModel = new wxMenuItem(NULL, kEvaluateModel, "Evaluate Model Parameters");
+    Bind(wxEVT_MENU, &MainFrame::OnEvaluateModel, this, kEvaluateModel);
+
+    wxMenuItem* onlineUpdates = new wxMenuItem(NULL, kOnlineModelUpdates, "Update Model As Results Arrive", "", wxITEM_CHECK);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleOnlineUpdates, this, kOnlineModelUpdates);
+
+    wxMenuItem* compactModel = new wxMenuItem(NULL, kCompactModel, "Predict With Compact Model (Less Memory)", "", wxITEM_CHECK);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleCompactModel, this, kCompactModel);
+
+    menuAnalysis->Append(calculateOPR);
+    menuAnalysis->Append(showEloRatings);
+    menuAnalysis->Append(showRankings);
+    menuAnalysis->Append(showTeamTrends);
+    menuAnalysis->Append(simulateEvent);
+    menuAnalysis->AppendSeparator();
+    menuAnalysis->Append(buildPickList);
+    menuAnalysis->Append(resetPicks);
+    menuAnalysis->AppendSeparator();
+    menuAnalysis->Append(retrainModel);
+    menuAnalysis->Append(cancelTraining);
+    menuAnalysis->Append(evaluateModel);
+    menuAnalysis->Append(onlineUpdates);
+    onlineUpdates->Check(true);
+    menuAnalysis->Append(compactModel);
+
+    ///// Event options
+    wxMenuItem* newEvent = new wxMenuItem(NULL, kNewEvent, "New Event...");
+    Bind(wxEVT_MENU, &MainFrame::OnNewEvent, this, kNewEvent);
+
+    wxMenuItem* switchEvent = new wxMenuItem(NULL, kSwitchEvent, "Switch Event...");
+    Bind(wxEVT_MENU, &MainFrame::OnSwitchEvent, this, kSwitchEvent);
+
+    wxMenuItem* backUpNow = new wxMenuItem(NULL, kBackUpNow, "Back Up Now");
+    Bind(wxEVT_MENU, &MainFrame::OnBackUpNow, this, kBackUpNow);
+
+    wxMenuItem* restoreBackup = new wxMenuItem(NULL, kRestoreBackup, "Restore From Backup...");
+    Bind(wxEVT_MENU, &MainFrame::OnRestoreBackup, this, kRestoreBackup);
+
+    wxMenuItem* autoBackup = new wxMenuItem(NULL, kAutoBackup, "Back Up Automatically", "", wxITEM_CHECK);
+    Bind(wxEVT_MENU, &MainFrame::OnToggleAutoBackup, this, kAutoBackup);
+
+    menuFile->Append(newEvent);
+    menuFile->Append(switchEvent);
+    menuFile->AppendSeparator();
+    menuFile->Append(backUpNow);
+    menuFile->Append(restoreBackup);
+    menuFile->Append(autoBackup);
+    autoBackup->Check(true);
+
+    wxMenuItem* showSeasonStats = new wxMenuItem(NULL, kShowSeasonStats, "Show Season Stats Across Events");
+    Bind(wxEVT_MENU, &MainFrame::OnShowSeasonStats, this, kShowSeasonStats);
+
+    menuAnalysis->AppendSeparator();
+    menuAnalysis->Append(showSeasonStats);
 
     // Setup Menu Bar
     wxMenuBar* menuBar = new wxMenuBar;
     menuBar->Append(menuFile, "&File");
     menuBar->Append(menuExport, "&Export");
     menuBar->Append(menuImport, "&Import");
+    menuBar->Append(menuAnalysis, "&Analysis");
 
     SetMenuBar(menuBar);
     
@@ -745,11 +998,11 @@ wxMenuBar* MainFrame::CreateMenuBar() {
  * @return A Team object corresponding to the row, or an empty Team object if the row index is invalid.
  */
 const Team MainFrame::GetTeamFromRow(int row) {
-    if ( row > this->m_displayedTeamCount || !m_dataBase )
+    if ( row < 0 || row >= m_teamListView->RowCount() || !m_dataBase )
         return {};
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    int uid = m_teamListView->GetItemData(row);
+    int uid = m_teamListView->KeyAt(row);
 
     return db->GetTeam(uid);
 }
@@ -765,240 +1018,148 @@ const Team MainFrame::GetTeamFromRow(int row) {
  * @return A Match object corresponding to the row, or an empty Match object if the row index is invalid.
  */
 const Match MainFrame::GetMatchFromRow(int row) {
-    if ( row > this->m_displayedMatchCount || !m_dataBase )
+    if ( row < 0 || row >= m_matchListView->RowCount() || !m_dataBase )
         return {};
 
     DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-
-    wxString colText = m_matchListView->GetItemText(row);
-    int matchNumber = std::stoi(colText.ToStdString());
+    int matchNumber = m_matchListView->KeyAt(row);
 
     return db->GetMatch(matchNumber);
 }
 
 const int MainFrame::GetSelectedRowMatchNum() {
-    wxString colText = m_matchListView->GetItemText(m_selectedMatchRow, 0);
-    if ( !colText.IsNumber() )
-        return 0;
-
-    return std::stoi(colText.ToStdWstring());
+    return m_matchListView->KeyAt(m_selectedMatchRow);
 }
 
 /**
- * @brief Creates and inserts a new row in the team list view.
+ * @brief Shows the rows a batch of database writes touched in the list views.
  *
- * This function creates a new row in the list view for displaying a team's data. It initializes the row
- * with the team number and various statistics such as overall score, elimination status, robot cycle speed,
- * and other relevant team data. The function also alternates the background color for each row for better readability.
+ * Rows the batch touched are read again the next time they're drawn, every other row is
+ * left alone. A list the batch touched is queried again, since a new or changed row may
+ * sort to another place or stop passing the filters, once however many rows the batch holds.
  *
- * @param team The team object containing the data to be displayed in the row.
+ * The trend index is updated first. A changed row can move the sparkline of every row of
+ * its team, so when a team's history changed every team row is read again as it's drawn.
  *
- * @note The item id for each row is automatically incremented based on how many rows are currently displayed.
- *       The font for each item is set to 9pt and non-bold.
- *       Each column in the list item is populated with the team’s data, converting numerical values to strings.
- *       The background color alternates between two shades of light gray based on the row index (odd/even).
+ * @param batch The rows that changed since the last batch.
  */
-void MainFrame::CreateTeamRow(const Team& team) {
-    const int itemId = m_displayedTeamCount++; // item id is always how many rows displayed + 1
-
-    // Insert the actual row item
-    wxListItem item;
-    item.SetId(itemId);
-    m_teamListView->InsertItem(item);
-
-    // Set the font to not be bold
-    m_teamListView->SetItemFont(itemId, wxFontInfo(9));
-
-    m_teamListView->EnsureVisible(itemId);
-
-    // Set each column value in the item
-    FillTeamRow(itemId, team);
-
-    m_teamListView->Bind(wxEVT_LIST_ITEM_SELECTED, &MainFrame::OnTeamRowLeftClicked, this);
-    m_teamListView->Bind(wxEVT_LIST_ITEM_RIGHT_CLICK, &MainFrame::OnTeamRowRightClicked, this);
+void MainFrame::ShowChangedRows(const DataEventBatch& batch) {
+    if ( !m_teamListView || !m_matchListView || !m_dataBase )
+        return;
 
-    m_selectedTeamRow = m_displayedTeamCount;
-    m_teamListView->SetItemData(itemId, team.uid);
+    if ( m_trends && reinterpret_cast< TrendIndex* >( m_trends )->ApplyChanges(batch) )
+        m_teamListView->ForgetRows();
 
-    UpdateStatusBar();
-    
-    // change the background colour of the 
-    // row depending on itemId for readability
-    if ( itemId % 2 == 0 ) {
-        wxColour colour = ( m_darkModeTheme ) ? DARK_GRAY_2 : LIGHT_GRAY_ACCENT_1;
-        m_teamListView->SetItemBackgroundColour(itemId, colour);
-    }
-    else {
-        wxColour colour = ( m_darkModeTheme ) ? DARK_GRAY_3 : LIGHT_GRAY_ACCENT_2;
-        m_teamListView->SetItemBackgroundColour(itemId, colour);
+    bool teamsChanged = false, matchesChanged = false;
+    for ( const DataEvent& event : batch.events ) {
+        if ( event.table == TEAM_TABLE ) {
+            m_teamListView->ForgetRow(event.key);
+            teamsChanged = true;
+        }
+        else if ( event.table == MATCH_TABLE ) {
+            m_matchListView->ForgetRow(event.key);
+            matchesChanged = true;
+        }
     }
-}
-
-/**
- * @brief Creates and adds a match entry to the match list view.
- *
- * This function inserts a new row into the match list, populating it with match details
- * such as match number, whether the match was played, which alliance won, and the team numbers.
- * The background color of the row alternates between two shades for readability.
- *
- * @param match The match data containing match number, status, and team information.
- */
-void MainFrame::CreateMatchRow(const Match& match) {
-    const int itemId = m_displayedMatchCount++; // item id is always how many rows displayed + 1
-
-    // Insert the actual row item
-    wxListItem item;
-    item.SetId(itemId);
-    m_matchListView->InsertItem(item);
 
-    // Set the font to not be bold
-    m_matchListView->SetItemFont(itemId, wxFontInfo(9));
-
-    m_matchListView->EnsureVisible(itemId);
-
-    // Set each column value in the item
-    FillMatchRow(itemId, match);
-
-    m_matchListView->Bind(wxEVT_LIST_ITEM_SELECTED, &MainFrame::OnMatchRowLeftClicked, this);
-    m_matchListView->Bind(wxEVT_LIST_ITEM_RIGHT_CLICK, &MainFrame::OnMatchRowRightClicked, this);
-
-    m_selectedMatchRow = m_displayedMatchCount;
-
-    UpdateStatusBar();
-
-    // change the background colour of the 
-    // row depending on itemId for readability
-    if ( itemId % 2 == 0 ) {
-        wxColour colour = ( m_darkModeTheme ) ? DARK_GRAY_2 : LIGHT_GRAY_ACCENT_1;
-        m_matchListView->SetItemBackgroundColour(itemId, colour);
-    }
-    else {
-        wxColour colour = ( m_darkModeTheme ) ? DARK_GRAY_3 : LIGHT_GRAY_ACCENT_2;
-        m_matchListView->SetItemBackgroundColour(itemId, colour);
-    }
+    if ( teamsChanged )
+        RequeryTeamList();
+    if ( matchesChanged )
+        RequeryMatchList();
 }
 
 /**
- * @brief Refreshes the row displaying a team's data in the team list view.
- *
- * This function retrieves the latest data for a given team from the database
- * and updates the corresponding row in the team list view.
+ * @brief Gets the text of each column of a team row from a Team object.
  *
- * @param uid The UID of the team to refresh
+ * This function formats details such as team number, performance metrics,
+ * match statistics, and ranking points, in the order of the team list view's columns.
  *
- * @note If the team is not found in the displayed list, the function exits without making changes.
+ * @param team The Team object containing the data to populate the row.
  *
- * @see FillTeamRow
+ * @return The text of each column, indexed by the column's kRow id.
  */
-void MainFrame::RefreshTeamRow(int uid) {
-    if ( !m_teamListView || !m_dataBase )
-        return;
-
-    DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    const Team team = db->GetTeam(uid);
-
-    // Find the row with the team number
-    int row = -1;
-    for ( int tempRow = 0; tempRow < m_displayedTeamCount; tempRow++ ) {
-        // check item data (saved team uid) is equal to team uid to update
-        if ( m_teamListView->GetItemData(tempRow) == uid ) {
-            row = tempRow;
-            break;
-        }
-    }
-
-    if ( row == -1 )
-        return;
-
-    // Update the row with the new team data
-    FillTeamRow(row, team);
+std::vector<wxString> MainFrame::TeamRowCells(const Team& team) {
+    std::vector<wxString> cells(kRowTrend + 1);
+
+    cells[kRowTeamNum] = std::to_string(team.teamNum);
+    cells[kRowInMatchNum] = std::to_string(team.matchNum);
+    cells[kRowOverall] = std::to_string(team.overall);
+    cells[kRowHangAttempt] = ( team.hangAttempt ) ? "Y" : "N";
+    cells[kRowHangSuccess] = ( team.hangSuccess ) ? "Y" : "N";
+    cells[kRowRobotCycleSpeed] = std::to_string(team.robotCycleSpeed);
+    cells[kRowCoralPoints] = std::to_string(team.coralPoints);
+    cells[kRowDefense] = std::to_string(team.defense);
+    cells[kRowAutonomousPoints] = std::to_string(team.autonomousPoints);
+    cells[kRowDriverSkill] = std::to_string(team.driverSkill);
+    cells[kRowPenaltys] = std::to_string(team.penaltys);
+    cells[kRowRankingPoints] = std::to_string(team.rankingPoints);
+    cells[kRowTrend] = TrendSparkline(team.teamNum);
+
+    return cells;
 }
 
 /**
- * @brief Refreshes the row displaying a match's data in the match list view.
+ * @brief Draws the points a team scored in its last `TREND_SPARKLINE_MATCHES` matches as a row of bars.
  *
- * This function retrieves the latest data for a given match from the database
- * and updates the corresponding row in the match list view.
+ * Bars are scaled between the lowest and highest of those matches, and followed
+ * by an arrow pointing the way the team's trend slope does.
  *
- * @param matchNum The match number to refresh.
+ * @param teamNum Team number of the team.
  *
- * @note If the match is not found in the displayed list, the function exits without making changes.
- *
- * @see FillMatchRow
+ * @return The sparkline, empty if the team wasn't scouted.
  */
-void MainFrame::RefreshMatchRow(int matchNum) {
-    if ( !m_matchListView || !m_dataBase )
-        return;
-
-    DataBase* db = reinterpret_cast< DataBase* >( m_dataBase );
-    const Match match = db->GetMatch(matchNum);
-
-    // Find the row with the match number
-    int row = -1;
-    for ( int i = 0; i < m_displayedMatchCount; i++ ) {
-        if ( m_matchListView->GetItemText(i) == std::to_string(matchNum) ) {
-            row = i;
-            break;
-        }
+wxString MainFrame::TrendSparkline(int teamNum) {
+    if ( !m_trends )
+        return "";
+
+    TrendIndex* trends = reinterpret_cast< TrendIndex* >( m_trends );
+    const std::vector<std::pair<int, double>> history = trends->GetTeamHistory(teamNum, TREND_SPARKLINE_MATCHES);
+    if ( history.empty() )
+        return "";
+
+    double low = history.front().second, high = history.front().second;
+    for ( const auto& [matchNum, points] : history ) {
+        low = std::min(low, points);
+        high = std::max(high, points);
     }
 
-    if ( row == -1 )
-        return;
-
-    // Update the row with the new team data
-    FillMatchRow(row, match);
-}
+    // U+2581 to U+2588, lower one eighth block to full block
+    wxString sparkline = "";
+    for ( const auto& [matchNum, points] : history ) {
+        const int level = ( high > low ) ? static_cast< int >( ( points - low ) / ( high - low ) * 7.0 + 0.5 ) : 3;
+        sparkline += wxUniChar(0x2581 + level);
+    }
 
-/**
- * @brief Fills a row in the team list view with data from a Team object.
- *
- * This function updates the list view with details such as team number, performance metrics,
- * match statistics, and ranking points.
- *
- * @param row The row index to update in the team list view.
- * @param team The Team object containing the data to populate the row.
- *
- * @note If the list view is not initialized, the function exits without making changes.
- */
-void MainFrame::FillTeamRow(int row, const Team& team) {
-    if ( !m_teamListView )
-        return;
+    // U+2191 up arrow, U+2193 down arrow, U+2192 right arrow
+    const double slope = trends->GetTeamTrend(teamNum).slope;
+    sparkline += " ";
+    sparkline += wxUniChar(( slope > 0.5 ) ? 0x2191 : ( slope < -0.5 ) ? 0x2193 : 0x2192);
 
-    m_teamListView->SetItem(row, kRowTeamNum, std::to_string(team.teamNum));
-    m_teamListView->SetItem(row, kRowInMatchNum, std::to_string(team.matchNum));
-    m_teamListView->SetItem(row, kRowOverall, std::to_string(team.overall));
-    m_teamListView->SetItem(row, kRowHangAttempt, ( team.hangAttempt ) ? "Y" : "N");
-    m_teamListView->SetItem(row, kRowHangSuccess, ( team.hangSuccess ) ? "Y" : "N");
-    m_teamListView->SetItem(row, kRowRobotCycleSpeed, std::to_string(team.robotCycleSpeed));
-    m_teamListView->SetItem(row, kRowCoralPoints, std::to_string(team.coralPoints));
-    m_teamListView->SetItem(row, kRowDefense, std::to_string(team.defense));
-    m_teamListView->SetItem(row, kRowAutonomousPoints, std::to_string(team.autonomousPoints));
-    m_teamListView->SetItem(row, kRowDriverSkill, std::to_string(team.driverSkill));
-    m_teamListView->SetItem(row, kRowPenaltys, std::to_string(team.penaltys));
-    m_teamListView->SetItem(row, kRowRankingPoints, std::to_string(team.rankingPoints));
+    return sparkline;
 }
 
 /**
- * @brief Fills a row in the match list view with data from a Match object.
+ * @brief Gets the text of each column of a match row from a Match object.
  *
- * This function updates the list view with details such as match number, teams, and match outcomes.
+ * This function formats details such as match number, teams, and match outcomes,
+ * in the order of the match list view's columns.
  *
- * @param row The row index to update in the match list view.
  * @param match The Match object containing the data to populate the row.
  *
- * @note If the list view is not initialized, the function exits without making changes.
+ * @return The text of each column, indexed by the column's kRow id.
  */
-void MainFrame::FillMatchRow(int row, const Match& match) {
-    if ( !m_matchListView )
-        return;
-
-    m_matchListView->SetItem(row, 0, std::to_string(match.matchNum));
-    m_matchListView->SetItem(row, 1, ( match.redWin ) ? "Y" : "N");
-    m_matchListView->SetItem(row, 2, ( match.blueWin ) ? "Y" : "N");
-    m_matchListView->SetItem(row, 3, std::to_string(match.Team1().teamNum));
-    m_matchListView->SetItem(row, 4, std::to_string(match.Team2().teamNum));
-    m_matchListView->SetItem(row, 5, std::to_string(match.Team3().teamNum));
-    m_matchListView->SetItem(row, 6, std::to_string(match.Team4().teamNum));
-    m_matchListView->SetItem(row, 7, std::to_string(match.Team5().teamNum));
-    m_matchListView->SetItem(row, 8, std::to_string(match.Team6().teamNum));
+std::vector<wxString> MainFrame::MatchRowCells(const Match& match) {
+    std::vector<wxString> cells(kRowBlue6 + 1);
+
+    cells[kRowMatchNum] = std::to_string(match.matchNum);
+    cells[kRowRedWin] = ( match.redWin ) ? "Y" : "N";
+    cells[kRowBlueWin] = ( match.blueWin ) ? "Y" : "N";
+    cells[kRowRed1] = std::to_string(match.Team1());
+    cells[kRowRed2] = std::to_string(match.Team2());
+    cells[kRowRed3] = std::to_string(match.Team3());
+    cells[kRowBlue4] = std::to_string(match.Team4());
+    cells[kRowBlue5] = std::to_string(match.Team5());
+    cells[kRowBlue6] = std::to_string(match.Team6());
+
+    return cells;
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+// Backend
+#include "backend/data.h"
+
+#include "testframe.h"
+
+#include <filesystem> // std::filesystem
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+ * @brief A write outside a transaction is delivered once the changes are flushed.
+ */
+int TestCommittedWrite(MainFrame* frame, const std::string& path) {
+    DataBase db(path, frame);
+
+    std::vector<DataEvent> delivered = {};
+    db.SubscribeToChanges([&delivered](const DataEventBatch& batch) {
+        delivered.insert(delivered.end(), batch.events.begin(), batch.events.end());
+    });
+
+    Match match = {};
+    match.matchNum = 1;
+    db.AddMatch(match);
+    db.FlushChanges();
+
+    TEST_CHECK(delivered.size() == 1);
+    TEST_CHECK(delivered[0].table == MATCH_TABLE);
+    TEST_CHECK(delivered[0].key == 1);
+    TEST_CHECK(delivered[0].op == kDataInserted);
+    return 0;
+}
+
+/**
+ * @brief The rows a rolled back transaction wrote are never delivered.
+ *
+ * The changeset's first row is written before its second one fails, which rolls back
+ * the transaction applying it.
+ */
+int TestRolledBackWrite(MainFrame* frame, const std::string& path) {
+    DataBase db(path, frame);
+
+    // fails the insert of match 999, on another connection like any other change to the schema
+    sqlite3* connection = nullptr;
+    sqlite3_open(path.c_str(), &connection);
+    const int created = sqlite3_exec(
+        connection,
+        "CREATE TRIGGER FailMatch BEFORE INSERT ON " MATCH_TABLE " WHEN NEW.matchNum = 999 BEGIN "
+        "SELECT RAISE(ABORT, 'match 999 is rejected'); "
+        "END;",
+        NULL, 0, nullptr
+    );
+    sqlite3_close(connection);
+    TEST_CHECK(created == SQLITE_OK);
+
+    std::vector<DataEvent> delivered = {};
+    db.SubscribeToChanges([&delivered](const DataEventBatch& batch) {
+        delivered.insert(delivered.end(), batch.events.begin(), batch.events.end());
+    });
+
+    ChangeRecord team = {};
+    team.kind = kChangeTeamUpsert;
+    team.team.teamNum = 254;
+    team.team.matchNum = 1;
+
+    ChangeRecord match = {};
+    match.kind = kChangeMatchUpsert;
+    match.match.matchNum = 999;
+
+    Changeset changeset = {};
+    changeset.origin = "other station";
+    changeset.records = { team, match };
+
+    SyncReport report = {};
+    TEST_CHECK(!db.ApplyChangeset(changeset, report));
+    db.FlushChanges();
+
+    TEST_CHECK(db.GetTeams().empty());
+    TEST_CHECK(delivered.empty());
+    return 0;
+}
+
+/**
+ * Tests of the change events the database delivers.
+ *
+ * Built by DataEventsTest.vcxproj with the backend sources, the wx libraries and testframe.cpp
+ * in place of the frontend, and run after every build. Exits with the number of failed tests.
+ */
+int main(int argc, char** argv) {
+    MainFrame* frame = StartTestFrame(argc, argv);
+    if ( !frame )
+        return 1;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+
+    int failed = 0;
+    for ( auto test : { &TestCommittedWrite, &TestRolledBackWrite } ) {
+        const std::filesystem::path path = directory / "frcscout_dataevents_test.db";
+        std::filesystem::remove(path);
+
+        failed += test(frame, path.string());
+
+        std::filesystem::remove(path);
+    }
+
+    StopTestFrame(frame);
+    std::cout << ( ( failed == 0 ) ? "data event tests passed" : "data event tests failed" ) << std::endl;
+    return failed;
+}
@@ -0,0 +1,99 @@
+// Backend
+#include "backend/data.h"
+#include "backend/ingest.h"
+
+#include "testframe.h"
+
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::milliseconds
+#include <filesystem> // std::filesystem
+#include <string> // std::string
+#include <thread> // std::thread
+
+/**
+ * @brief Both alliances winning is how a tie is recorded, so it passes validation.
+ */
+int TestTieIsValid() {
+    ChangeRecord record = {};
+    record.kind = kChangeMatchUpsert;
+    record.match.matchNum = 1;
+    record.match.teams = { 1, 2, 3, 4, 5, 6 };
+    record.match.redWin = true;
+    record.match.blueWin = true;
+
+    std::string error = "";
+    TEST_CHECK(IngestServer::ValidateRecord(record, error));
+    TEST_CHECK(error.empty());
+    return 0;
+}
+
+/**
+ * @brief A tied match submitted by a scouting client is saved as a tie.
+ */
+int TestSubmitTiedMatch(MainFrame* frame) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "frcscout_ingest_test.db";
+    std::filesystem::remove(path);
+
+    int failed = 0;
+    {
+        DataBase db(path.string(), frame);
+        IngestServer server(frame, &db);
+        TEST_CHECK(server.Start(0, true));
+
+        ChangeRecord record = {};
+        record.kind = kChangeMatchUpsert;
+        record.match.matchNum = 7;
+        record.match.teams = { 254, 1678, 118, 971, 2056, 4414 };
+        record.match.redWin = true;
+        record.match.blueWin = true;
+
+        // submitting blocks until the rows are saved on the UI thread, which is this one
+        std::atomic<bool> done = false;
+        bool saved = false;
+        std::string error = "";
+        std::thread client([&] {
+            Socket connection = Socket::Connect("127.0.0.1", server.Port());
+            saved = IngestServer::Submit(connection, "tester", { record }, error);
+            done = true;
+        });
+
+        while ( !done ) {
+            RunUiCalls();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        client.join();
+        server.Stop();
+
+        if ( !saved ) {
+            std::cerr << "submission rejected: " << error << "\n";
+            failed = 1;
+        }
+        else if ( !db.GetMatch(7).IsTie() ) {
+            std::cerr << "match 7 wasn't saved as a tie\n";
+            failed = 1;
+        }
+    }
+
+    std::filesystem::remove(path);
+    return failed;
+}
+
+/**
+ * Tests of the ingest server.
+ *
+ * Built by IngestTest.vcxproj with the backend sources, the wx libraries and testframe.cpp
+ * in place of the frontend, and run after every build. Exits with the number of failed tests.
+ */
+int main(int argc, char** argv) {
+    MainFrame* frame = StartTestFrame(argc, argv);
+    if ( !frame )
+        return 1;
+
+    int failed = 0;
+    failed += TestTieIsValid();
+    failed += TestSubmitTiedMatch(frame);
+
+    StopTestFrame(frame);
+    std::cout << ( ( failed == 0 ) ? "ingest tests passed" : "ingest tests failed" ) << std::endl;
+    return failed;
+}
@@ -0,0 +1,88 @@
+// Backend
+#include "backend/data.h"
+
+#include "testframe.h"
+
+#include <algorithm> // std::count_if
+#include <filesystem> // std::filesystem
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+ * @brief Two laptops' data.db that both scouted the same team in the same match keep both rows.
+ *
+ * Every laptop's database has the same file name, so only their station names tell their rows apart.
+ */
+int TestMergeSameFileName(MainFrame* frame, const std::filesystem::path& directory) {
+    const std::filesystem::path laptops[2] = { directory / "laptop1", directory / "laptop2" };
+    std::vector<std::string> paths = {};
+    std::vector<std::string> stations = {};
+
+    for ( int i = 0; i < 2; i++ ) {
+        std::filesystem::create_directories(laptops[i]);
+        const std::string path = ( laptops[i] / "data.db" ).string();
+
+        DataBase laptop(path, frame);
+
+        Team team = {};
+        team.teamNum = 254;
+        team.matchNum = 1;
+        team.coralPoints = static_cast< uint16_t >( 10 + i );
+        laptop.AddTeam(team);
+
+        paths.push_back(path);
+        stations.push_back(laptop.GetStationName());
+    }
+
+    TEST_CHECK(stations[0] != stations[1]);
+
+    DataBase db(( directory / "main.db" ).string(), frame);
+
+    MergeReport report = {};
+    db.MergeDataBases(paths, kMergeKeepExisting, report);
+
+    TEST_CHECK(report.failed.empty());
+    TEST_CHECK(report.databasesMerged == 2);
+    TEST_CHECK(report.teamsAdded == 2);
+
+    const std::vector<Team> rows = db.GetTeamsInMatch(1);
+    TEST_CHECK(rows.size() == 2);
+    for ( int i = 0; i < 2; i++ ) {
+        TEST_CHECK(std::count_if(rows.begin(), rows.end(), [i](const Team& row) {
+            return row.teamNum == 254 && row.coralPoints == 10 + i;
+        }) == 1);
+    }
+
+    // merging the same databases again finds every row already there
+    db.MergeDataBases(paths, kMergeKeepExisting, report);
+    TEST_CHECK(report.teamsAdded == 0);
+    TEST_CHECK(db.GetTeamsInMatch(1).size() == 2);
+    return 0;
+}
+
+/**
+ * Tests of merging other scouts' databases.
+ *
+ * Built by MergeTest.vcxproj with the backend sources, the wx libraries and testframe.cpp
+ * in place of the frontend, and run after every build. Exits with the number of failed tests.
+ */
+int main(int argc, char** argv) {
+    MainFrame* frame = StartTestFrame(argc, argv);
+    if ( !frame )
+        return 1;
+
+    int failed = 0;
+    for ( auto test : { &TestMergeSameFileName } ) {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "frcscout_merge_test";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        failed += test(frame, directory);
+
+        std::filesystem::remove_all(directory);
+    }
+
+    StopTestFrame(frame);
+    std::cout << ( ( failed == 0 ) ? "merge tests passed" : "merge tests failed" ) << std::endl;
+    return failed;
+}
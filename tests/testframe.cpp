@@ -0,0 +1,77 @@
+#include "testframe.h"
+
+/**
+ * The backend tests link this file in place of the frontend.
+ *
+ * The backend only logs through the main window and hands calls to the UI thread with
+ * CallAfter, so the main window here is an empty frame that's never shown, writing its
+ * logs to the console. The tests run the calls handed to the UI thread themselves with
+ * `RunUiCalls`, there's no event loop.
+ */
+
+class TestApp : public wxApp {
+public:
+    bool OnInit() override { return true; }
+};
+
+wxIMPLEMENT_APP_NO_MAIN(TestApp);
+
+MainFrame::MainFrame(const wxString& title, bool darkModeEnabled)
+    : wxFrame(nullptr, wxID_ANY, title), m_darkModeTheme(darkModeEnabled) {}
+
+void MainFrame::LogMessage(std::string& msg, wxColour colour) {
+    std::cout << msg;
+}
+
+void MainFrame::LogSQLQuery(std::string query) {}
+
+void MainFrame::LogErrorMessage(std::string errorMsg) {
+    std::cerr << "ERROR> " << errorMsg << std::endl;
+}
+
+void MainFrame::LogBackendMessage(std::string msg) {
+    std::cout << "MSG> " << msg << std::endl;
+}
+
+void MainFrame::LogProgress(const std::string& task, size_t done, size_t total) {}
+
+void MainFrame::ReloadAllData() {}
+
+void MainFrame::ShowIngestedData(
+    const std::vector<int>& teamNums,
+    const std::vector<int>& matchNums,
+    const std::vector<int>& rowMatchNums
+) {}
+
+/**
+ * @brief Starts wx and creates the main window the backend is handed.
+ *
+ * @param argc Argument count of main.
+ * @param argv Arguments of main.
+ * @return The main window, nullptr if wx couldn't be started.
+ */
+MainFrame* StartTestFrame(int argc, char** argv) {
+    if ( !wxEntryStart(argc, argv) || !wxTheApp->CallOnInit() )
+        return nullptr;
+
+    return new MainFrame(APP_NAME " tests", false);
+}
+
+/**
+ * @brief Runs the calls background threads handed to the UI thread with CallAfter so far.
+ */
+void RunUiCalls() {
+    wxTheApp->ProcessPendingEvents();
+}
+
+/**
+ * @brief Destroys the main window and shuts wx down.
+ *
+ * @param frame The main window from `StartTestFrame`.
+ */
+void StopTestFrame(MainFrame* frame) {
+    if ( frame )
+        frame->Destroy();
+
+    wxEntryCleanup();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Frontend
+#include "frontend/mainframe.h"
+
+#include <iostream> // std::cerr
+
+/**
+ * @brief Fails the test it's in, printing the condition and where it is, if 'cond' is false.
+ *
+ * Only used in functions returning the number of failed checks as an int.
+ */
+#define TEST_CHECK(cond) \
+    do { \
+        if ( !( cond ) ) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; \
+            return 1; \
+        } \
+    } while ( 0 )
+
+MainFrame* StartTestFrame(int argc, char** argv); // start wx and create the main window the backend is handed, never shown
+void RunUiCalls(); // run the calls background threads handed to the UI thread so far
+void StopTestFrame(MainFrame* frame);